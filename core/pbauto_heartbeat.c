@@ -21,7 +21,11 @@
 #include "core/pubnub_assert.h"
 #include "core/pbpal.h"
 #include "core/pubnub_helper.h"
+#if PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS
+#include "core/pbpal_ntf_sync_wait.h"
+#endif
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -29,11 +33,33 @@
 #define PUBNUB_MIN_HEARTBEAT_PERIOD                                            \
     (PUBNUB_MIN_TRANSACTION_TIMER / UNIT_IN_MILLI)
 
+#if PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS                                          \
+    && (PUBNUB_MAX_HEARTBEAT_THUMPERS > PBPAL_SYNC_WAIT_ANY_MAX)
+#error "PUBNUB_MAX_HEARTBEAT_THUMPERS sockets are more than can be waited on"
+#endif
+
 
 static struct HeartbeatWatcherData m_watcher;
 
 static void heartbeat_thump(pubnub_t* pb, pubnub_t* heartbeat_pb);
 
+
+/** Gets the watcher thread out of its wait for the next timer to expire,
+    so it can look at what has changed.
+  */
+static void wake_watcher(void)
+{
+    pubnub_mutex_lock(m_watcher.timerlock);
+    m_watcher.wakeup_pending = true;
+    pbauto_heartbeat_signal(&m_watcher);
+#if PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS && !defined(_WIN32)
+    if (m_watcher.wakeup.read_fd != -1) {
+        pbpal_ntf_callback_wakeup_signal(&m_watcher.wakeup);
+    }
+#endif
+    pubnub_mutex_unlock(m_watcher.timerlock);
+}
+
 static void start_heartbeat_timer(unsigned thumper_index)
 {
     pubnub_mutex_lock(m_watcher.mutw);
@@ -77,6 +103,8 @@ static void start_heartbeat_timer(unsigned thumper_index)
     m_watcher.heartbeat_timers[thumper_index] = period_sec * UNIT_IN_MILLI;
     m_watcher.timer_index_array[m_watcher.active_timers++] = thumper_index;
     pubnub_mutex_unlock(m_watcher.timerlock);
+
+    wake_watcher();
 }
 
 
@@ -153,6 +181,9 @@ static void add_heartbeat_in_progress(unsigned thumper_index)
     m_watcher.heartbeat_in_progress_index_array
         [m_watcher.heartbeats_in_progress++] = thumper_index;
     pubnub_mutex_unlock(m_watcher.mutw);
+
+    /* Sync transactions advance only while the watcher polls them */
+    wake_watcher();
 }
 #endif
 
@@ -341,11 +372,15 @@ void pbauto_take_the_node_out(
 }
 
 #if defined(PUBNUB_CALLBACK_API) && !defined(PUBNUB_NTF_RUNTIME_SELECTION)
-#define handle_heartbeats_in_progress()
+#define handle_heartbeats_in_progress() 0
 #else
-static void handle_heartbeats_in_progress(void)
+/** Polls the (sync) heartbeat transactions in progress.
+    @return Number of those still in progress
+  */
+static unsigned handle_heartbeats_in_progress(void)
 {
     unsigned                      i;
+    unsigned                      in_progress;
     enum pubnub_res               result;
     struct pubnub_heartbeat_data* heartbeat_data = m_watcher.heartbeat_data;
     unsigned* heartbeat_indexes = m_watcher.heartbeat_in_progress_index_array;
@@ -370,10 +405,53 @@ static void handle_heartbeats_in_progress(void)
             ++i;
         }
     }
+    in_progress = m_watcher.heartbeats_in_progress;
     pubnub_mutex_unlock(m_watcher.mutw);
+
+    return in_progress;
 }
 #endif
 
+#if PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS
+/** Waits until a socket of the (sync) heartbeat transactions in
+    progress is ready, for at most @p ms milliseconds (if not negative),
+    or until woken up. Has to be called with `timerlock` locked, which
+    is unlocked while waiting on the sockets.
+  */
+static void wait_heartbeats_in_progress(int ms)
+{
+    pubnub_t* heartbeat_pbs[PUBNUB_MAX_HEARTBEAT_THUMPERS];
+    unsigned  i;
+    unsigned  n;
+    int       rslt;
+#if defined(_WIN32)
+    struct pbpal_ntf_callback_wakeup* wakeup = NULL;
+#else
+    struct pbpal_ntf_callback_wakeup* wakeup = &m_watcher.wakeup;
+#endif
+
+    pubnub_mutex_lock(m_watcher.mutw);
+    n = m_watcher.heartbeats_in_progress;
+    for (i = 0; i < n; ++i) {
+        unsigned const thumper_index =
+            m_watcher.heartbeat_in_progress_index_array[i];
+        heartbeat_pbs[i] = m_watcher.heartbeat_data[thumper_index].heartbeat_pb;
+    }
+    pubnub_mutex_unlock(m_watcher.mutw);
+    if (0 == n) { return; }
+
+    pubnub_mutex_unlock(m_watcher.timerlock);
+    rslt = pbpal_ntf_sync_wait_any(heartbeat_pbs, n, wakeup, ms);
+    pubnub_mutex_lock(m_watcher.timerlock);
+    if ((rslt != 0) && !m_watcher.wakeup_pending) {
+        /* Can't wait on the sockets, so poll the transactions */
+        pbauto_heartbeat_wait(&m_watcher, 1);
+    }
+}
+#else
+#define wait_heartbeats_in_progress(ms) pbauto_heartbeat_wait(&m_watcher, 1)
+#endif
+
 static void handle_heartbeat_timers(int elapsed_ms)
 {
     unsigned  i;
@@ -421,6 +499,27 @@ static void handle_heartbeat_timers(int elapsed_ms)
 }
 
 
+/** Returns the time until the first of the active heartbeat timers
+    expires, or -1 if there are no active timers. Has to be called with
+    `timerlock` locked.
+  */
+static int next_heartbeat_timer_ms(void)
+{
+    unsigned i;
+    size_t   rslt = (size_t)INT_MAX;
+
+    if (0 == m_watcher.active_timers) { return -1; }
+    for (i = 0; i < m_watcher.active_timers; ++i) {
+        unsigned const thumper_index = m_watcher.timer_index_array[i];
+        if (m_watcher.heartbeat_timers[thumper_index] < rslt) {
+            rslt = m_watcher.heartbeat_timers[thumper_index];
+        }
+    }
+
+    return (int)rslt;
+}
+
+
 pubnub_watcher_t pbauto_heartbeat_watcher_thread(void* arg)
 {
     pubnub_timespec_t prev_timspec;
@@ -433,6 +532,8 @@ pubnub_watcher_t pbauto_heartbeat_watcher_thread(void* arg)
     for (;;) {
         pubnub_timespec_t timspec;
         int               elapsed;
+        int               wait_ms;
+        unsigned          in_progress;
         bool              stop_thread;
 
         pubnub_mutex_lock(m_watcher.stoplock);
@@ -440,8 +541,7 @@ pubnub_watcher_t pbauto_heartbeat_watcher_thread(void* arg)
         pubnub_mutex_unlock(m_watcher.stoplock);
         if (stop_thread) { break; }
         /** Used in sync environment while in callback it is an empty macro */
-        handle_heartbeats_in_progress();
-        pb_sleep_ms(1);
+        in_progress = handle_heartbeats_in_progress();
 #if !defined(_WIN32)
         monotonic_clock_get_time(&timspec);
 #else
@@ -449,12 +549,25 @@ pubnub_watcher_t pbauto_heartbeat_watcher_thread(void* arg)
 #endif
 
         elapsed = pbtimespec_elapsed_ms(prev_timspec, timspec);
+        pubnub_mutex_lock(m_watcher.timerlock);
         if (elapsed > 0) {
-            pubnub_mutex_lock(m_watcher.timerlock);
             handle_heartbeat_timers(elapsed);
-            pubnub_mutex_unlock(m_watcher.timerlock);
             prev_timspec = timspec;
         }
+        /* Sleep until the next heartbeat is due, or one of the sync
+           heartbeat transactions in progress can advance, unless we
+           were woken up in the meantime. */
+        wait_ms = next_heartbeat_timer_ms();
+        if (!m_watcher.wakeup_pending && (wait_ms != 0)) {
+            if (in_progress > 0) {
+                wait_heartbeats_in_progress(wait_ms);
+            }
+            else {
+                pbauto_heartbeat_wait(&m_watcher, wait_ms);
+            }
+        }
+        m_watcher.wakeup_pending = false;
+        pubnub_mutex_unlock(m_watcher.timerlock);
     }
 
 #if !defined _WIN32
@@ -901,6 +1014,7 @@ void pbauto_heartbeat_stop(void)
     pubnub_mutex_lock(m_watcher.stoplock);
     m_watcher.stop_heartbeat_watcher_thread = true;
     pubnub_mutex_unlock(m_watcher.stoplock);
+    wake_watcher();
 }
 
 #endif // PUBNUB_USE_AUTO_HEARTBEAT
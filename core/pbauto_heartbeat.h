@@ -7,12 +7,14 @@
 typedef DWORD    pubnub_thread_t;
 typedef FILETIME pubnub_timespec_t;
 typedef void     pubnub_watcher_t;
+typedef CONDITION_VARIABLE pubnub_cond_t;
 #define thread_handle_field() HANDLE thread_handle;
 #define UNIT_IN_MILLI 1000
 #else
 typedef pthread_t       pubnub_thread_t;
 typedef struct timespec pubnub_timespec_t;
 typedef void*           pubnub_watcher_t;
+typedef pthread_cond_t  pubnub_cond_t;
 #define thread_handle_field()
 #endif
 
@@ -21,6 +23,16 @@ typedef void*           pubnub_watcher_t;
 #define PUBNUB_MAX_HEARTBEAT_THUMPERS 16
 #define UNASSIGNED PUBNUB_MAX_HEARTBEAT_THUMPERS
 
+/** If true, while there are (sync) heartbeat transactions in progress,
+    the watcher thread waits on their sockets, instead of polling them.
+  */
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET                                                \
+    && (!defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION))
+#define PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS 1
+#else
+#define PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS 0
+#endif
+
 struct pubnub_heartbeat_data {
     pubnub_t* pb;
     pubnub_t* heartbeat_pb;
@@ -45,6 +57,19 @@ struct HeartbeatWatcherData {
     /** Number of active thumper timers */
     unsigned active_timers pubnub_guarded_by(timerlock);
     bool stop_heartbeat_watcher_thread pubnub_guarded_by(stoplock);
+    /** Set when the watcher thread should not wait for the next timer
+        to expire, because something changed (timer started, heartbeat
+        began, stop requested...). Cleared by the watcher thread. */
+    bool wakeup_pending pubnub_guarded_by(timerlock);
+    /** The watcher thread waits on this (with `timerlock`) until the
+        next timer expires, or it is woken up */
+    pubnub_cond_t                      timer_cond;
+#if PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS && !defined(_WIN32)
+    /** Signalled (along with `timer_cond`) to get the watcher thread
+        out of its wait on the sockets of the heartbeat transactions in
+        progress. `read_fd` is -1 if it couldn't be created. */
+    struct pbpal_ntf_callback_wakeup   wakeup;
+#endif
     pubnub_mutex_t                     mutw;
     pubnub_mutex_t                     timerlock;
     pubnub_mutex_t                     stoplock;
@@ -89,6 +114,16 @@ pubnub_watcher_t pbauto_heartbeat_watcher_thread(void* arg);
 /** Initializes and starts auto heartbeat watcher thread. Different on different platforms */
 int pbauto_heartbeat_init(pubnub_t* pb, struct HeartbeatWatcherData* m_watcher);
 
+/** Waits on the `timer_cond` of @p m_watcher, which has to be called with
+    `timerlock` locked (just once), for at most @p ms milliseconds, or until
+    signalled. If @p ms < 0, waits until signalled. Different on different
+    platforms.
+  */
+void pbauto_heartbeat_wait(struct HeartbeatWatcherData* m_watcher, int ms);
+
+/** Signals the `timer_cond` of @p m_watcher. Different on different platforms */
+void pbauto_heartbeat_signal(struct HeartbeatWatcherData* m_watcher);
+
 /** Gives notice to auto heartbeat module that subscribe, or heartbeat transaction has begun */
 void pbauto_heartbeat_transaction_ongoing(pubnub_t const* pb);
 
@@ -567,6 +567,7 @@ enum pubnub_res pbcc_parse_actions_api_response(struct pbcc_context* pb)
     int                                  replylen = pb->http_buf_len;
     struct pbjson_elem                   elem;
     struct pbjson_elem                   parsed;
+    struct pbcc_response_class           rclass;
     enum pbjson_object_name_parse_result json_rslt;
 
     PBCC_LOG_TRACE(
@@ -596,7 +597,8 @@ enum pubnub_res pbcc_parse_actions_api_response(struct pbcc_context* pb)
         return PNR_FORMAT_ERROR;
     }
     elem.start = reply;
-    if (pbjson_value_for_field_found(&elem, "status", "403")) {
+    rclass = pbcc_classify_response(&elem);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             pb->logger_manager,
             "Access denied\n  - response: %.*s",
@@ -606,8 +608,8 @@ enum pubnub_res pbcc_parse_actions_api_response(struct pbcc_context* pb)
     }
     json_rslt = pbjson_get_object_value(&elem, "data", &parsed);
     if (jonmpKeyNotFound == json_rslt) {
-        json_rslt = pbjson_get_object_value(&elem, "error", &parsed);
-        if (json_rslt != jonmpOK) {
+        parsed = rclass.error;
+        if (NULL == parsed.start) {
             PBCC_LOG_ERROR(
                 pb->logger_manager,
                 "Malformed service response: 'error' field is "
@@ -679,7 +681,7 @@ enum pubnub_res pbcc_parse_history_with_actions_response(
         return PNR_FORMAT_ERROR;
     }
     elem.start = reply;
-    if (pbjson_value_for_field_found(&elem, "status", "403")) {
+    if (403 == pbcc_classify_response(&elem).status) {
         PBCC_LOG_ERROR(
             pb->logger_manager,
             "Access denied\n  - response: %.*s",
@@ -113,6 +113,7 @@ enum pubnub_res pbcc_parse_message_counts_response(struct pbcc_context* p)
     enum pbjson_object_name_parse_result jpresult;
     struct pbjson_elem                   el;
     struct pbjson_elem                   found;
+    struct pbcc_response_class           rclass;
     char*                                reply    = p->http_reply;
     int                                  replylen = p->http_buf_len;
 
@@ -129,7 +130,8 @@ enum pubnub_res pbcc_parse_message_counts_response(struct pbcc_context* p)
     }
     el.start = reply;
     el.end   = reply + replylen;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    rclass = pbcc_classify_response(&el);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Access denied\n  - response: %.*s",
@@ -137,9 +139,8 @@ enum pubnub_res pbcc_parse_message_counts_response(struct pbcc_context* p)
             reply);
         return PNR_ACCESS_DENIED;
     }
-    jpresult = pbjson_get_object_value(&el, "error", &found);
-    if (jonmpOK == jpresult) {
-        if (pbjson_elem_equals_string(&found, "false")) {
+    if (rclass.error.start != NULL) {
+        if (pbjson_elem_equals_string(&rclass.error, "false")) {
             /* If found, object's 'end' field points to the first character
                behind its end */
             jpresult = pbjson_get_object_value(&el, "channels", &found);
@@ -827,11 +828,10 @@ pubnub_chamebl_t pbcc_get_delete_messages_response(struct pbcc_context* pb)
 
 enum pubnub_res pbcc_parse_delete_messages_response(struct pbcc_context* pb)
 {
-    enum pbjson_object_name_parse_result jpresult;
-    struct pbjson_elem                   el;
-    struct pbjson_elem                   found;
-    char*                                reply     = pb->http_reply;
-    int                                  reply_len = pb->http_buf_len;
+    struct pbjson_elem         el;
+    struct pbcc_response_class rclass;
+    char*                      reply     = pb->http_reply;
+    int                        reply_len = pb->http_buf_len;
 
     PBCC_LOG_TRACE(
         pb->logger_manager, "Parsing delete messages service response...");
@@ -846,7 +846,8 @@ enum pubnub_res pbcc_parse_delete_messages_response(struct pbcc_context* pb)
     }
     el.start = reply;
     el.end   = reply + reply_len;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    rclass = pbcc_classify_response(&el);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             pb->logger_manager,
             "Access denied\n  - response: %.*s",
@@ -854,9 +855,8 @@ enum pubnub_res pbcc_parse_delete_messages_response(struct pbcc_context* pb)
             reply);
         return PNR_ACCESS_DENIED;
     }
-    jpresult = pbjson_get_object_value(&el, "error", &found);
-    if (jonmpOK == jpresult) {
-        if (pbjson_elem_equals_string(&found, "true")) {
+    if (rclass.error.start != NULL) {
+        if (pbjson_elem_equals_string(&rclass.error, "true")) {
             return PNR_ERROR_ON_SERVER;
         }
     }
@@ -16,6 +16,13 @@
 #include <string.h>
 #include <openssl/rand.h>
 
+
+/** Encrypted messages that decode to this many octets, or less, are
+    decoded on the stack, to avoid an allocation.
+ */
+#define PBCC_DECRYPT_LOCAL_BUFFER_SIZE 512
+
+
 int pbcc_cipher_key_hash(const uint8_t* cipher_key, uint8_t* hash)
 {
     uint8_t digest[32];
@@ -252,19 +259,7 @@ int pbcc_memory_encode(
     buffer.ptr[buffer.size] = '\0';
 #endif
 
-    int max_size = base64_max_size(buffer.size);
-    if (*n + 1 < (size_t)max_size) { return -1; }
-    char* base64_output = (char*)malloc(max_size);
-    if (base64encode(base64_output, max_size, buffer.ptr, buffer.size) != 0) {
-        free(base64_output);
-        return -1;
-    }
-    int result = snprintf(base64_str, *n, "%s", base64_output);
-    *n         = (size_t)strlen(base64_str);
-
-    free(base64_output);
-
-    return result >= 0 ? 0 : -1;
+    return pbbase64_encode_std(buffer, base64_str, n);
 }
 
 int pbcc_legacy_decrypt(
@@ -292,16 +287,16 @@ int pbcc_legacy_decrypt(
 
 const char* pbcc_base64_encode(struct pbcc_context* pb, pubnub_bymebl_t buffer)
 {
-    int max_size = base64_max_size(buffer.size);
+    size_t n = pbbase64_char_array_size_for_encoding(buffer.size);
 
-    char* result = (char*)malloc(max_size);
+    char* result = (char*)malloc(n);
     if (result == NULL) {
         PBCC_LOG_ERROR(
             pb->logger_manager, "Failed to allocate memory for result.");
         return NULL;
     }
 
-    if (base64encode(result, max_size, buffer.ptr, buffer.size) != 0) {
+    if (pbbase64_encode_std(buffer, result, &n) != 0) {
         PBCC_LOG_ERROR(
             pb->logger_manager, "Failed to encode %zu bytes.", buffer.size);
         free(result);
@@ -316,6 +311,14 @@ pubnub_bymebl_t pbcc_base64_decode(const char* buffer)
     return pbbase64_decode_alloc_std_str(buffer);
 }
 
+int pbcc_base64_decode_buffered(
+    const char*      buffer,
+    size_t           length,
+    pubnub_bymebl_t* data)
+{
+    return pbbase64_decode_std(buffer, length, data);
+}
+
 void pbcc_set_crypto_module(
     struct pbcc_context*             ctx,
     struct pubnub_crypto_provider_t* crypto_provider)
@@ -335,21 +338,28 @@ const char* pbcc_decrypt_message(
     size_t               len,
     size_t*              out_len)
 {
-    char* trimmed = (char*)malloc(len + 1); // same length as message
-    if (NULL == trimmed) {
-        PBCC_LOG_ERROR(
-            pb->logger_manager,
-            "Failed to allocate memory for trimmed string.");
-        return NULL;
+    uint8_t         local[PBCC_DECRYPT_LOCAL_BUFFER_SIZE];
+    pubnub_bymebl_t encrypted;
+    char const*     end = (char const*)memchr(message, '\0', len);
+
+    if (end != NULL) { len = end - message; }
+    /* Decoded without the quotes, to the local buffer if it fits */
+    encrypted.size = pbbase64_decoded_length(len < 2 ? 0 : len - 2);
+    encrypted.ptr  = local;
+    if (encrypted.size > sizeof local) {
+        encrypted.ptr = (uint8_t*)malloc(encrypted.size);
+        if (NULL == encrypted.ptr) {
+            PBCC_LOG_ERROR(
+                pb->logger_manager,
+                "Failed to allocate memory for decoded message.");
+            return NULL;
+        }
     }
-    snprintf(trimmed, len + 1, "%s", message);
-
-    trimmed[strlen(trimmed) - 1] = '\0';
-
-    pubnub_bymebl_t encrypted = pbcc_base64_decode(trimmed + 1);
-    free(trimmed);
 
-    if (NULL == encrypted.ptr) {
+    if ((len < 2)
+        || (0
+            != pbcc_base64_decode_buffered(message + 1, len - 2, &encrypted))) {
+        if (encrypted.ptr != local) { free(encrypted.ptr); }
         PBCC_LOG_WARNING(
             pb->logger_manager,
             "Base64 decoding failed. Returning original message.");
@@ -380,7 +390,7 @@ const char* pbcc_decrypt_message(
 
     pubnub_bymebl_t rslt_block =
         pb->crypto_module->decrypt(pb->crypto_module, encrypted);
-    free(encrypted.ptr);
+    if (encrypted.ptr != local) { free(encrypted.ptr); }
     if (NULL == rslt_block.ptr) {
         PBCC_LOG_WARNING(
             pb->logger_manager,
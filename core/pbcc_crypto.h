@@ -284,6 +284,23 @@ const char* pbcc_base64_encode(struct pbcc_context* pb, pubnub_bymebl_t buffer);
 */
 pubnub_bymebl_t pbcc_base64_decode(const char* buffer);
 
+/**
+    Decodes the encrypted data from base64, to a user provided memory
+    block, so nothing is allocated.
+
+    @param buffer The encrypted data to decode
+    @param length The length of the encrypted data (doesn't have to be
+    NUL terminated)
+    @param data The memory block to decode to. Needs to have at least
+    `pbbase64_decoded_length(length)` octets. On success, its size
+    is updated to the number of decoded octets.
+
+    @return 0 on success, non-zero on error
+*/
+int pbcc_base64_decode_buffered(const char*      buffer,
+                                size_t           length,
+                                pubnub_bymebl_t* data);
+
 
 /**
    Set the crypto module to be used by the pubnub context.
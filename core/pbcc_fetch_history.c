@@ -120,9 +120,10 @@ enum pubnub_res pbcc_fetch_history_prep(
 
 enum pubnub_res pbcc_parse_fetch_history_response(struct pbcc_context* pb)
 {
-    char*              reply    = pb->http_reply;
-    int                replylen = pb->http_buf_len;
-    struct pbjson_elem elem;
+    char*                      reply    = pb->http_reply;
+    int                        replylen = pb->http_buf_len;
+    struct pbjson_elem         elem;
+    struct pbcc_response_class rclass;
 
     PBCC_LOG_TRACE(
         pb->logger_manager, "Parsing fetch history service response...");
@@ -144,7 +145,8 @@ enum pubnub_res pbcc_parse_fetch_history_response(struct pbcc_context* pb)
     }
     elem.start = reply;
 
-    if (pbjson_value_for_field_found(&elem, "status", "403")) {
+    rclass = pbcc_classify_response(&elem);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             pb->logger_manager,
             "Fetch history access denied:\n  - response: %.*s",
@@ -153,7 +155,7 @@ enum pubnub_res pbcc_parse_fetch_history_response(struct pbcc_context* pb)
         return PNR_ACCESS_DENIED;
     }
 
-    if (pbjson_value_for_field_found(&elem, "error", "true")) {
+    if (pbjson_elem_equals_string(&rclass.error, "true")) {
         PBCC_LOG_ERROR(
             pb->logger_manager,
             "Service returned error:\n  - response: %.*s",
@@ -119,6 +119,7 @@ enum pubnub_res pbcc_parse_grant_token_api_response(struct pbcc_context* pb)
     int                                  replylen = pb->http_buf_len;
     struct pbjson_elem                   elem;
     struct pbjson_elem                   parsed;
+    struct pbcc_response_class           rclass;
     enum pbjson_object_name_parse_result json_rslt;
 
     PBCC_LOG_TRACE(
@@ -141,7 +142,8 @@ enum pubnub_res pbcc_parse_grant_token_api_response(struct pbcc_context* pb)
     }
     elem.start = reply;
 
-    if (pbjson_value_for_field_found(&elem, "status", "403")) {
+    rclass = pbcc_classify_response(&elem);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             pb->logger_manager,
             "Grant token access denied:\n  - response: %.*s",
@@ -152,8 +154,8 @@ enum pubnub_res pbcc_parse_grant_token_api_response(struct pbcc_context* pb)
 
     json_rslt = pbjson_get_object_value(&elem, "data", &parsed);
     if (jonmpKeyNotFound == json_rslt) {
-        json_rslt = pbjson_get_object_value(&elem, "error", &parsed);
-        if (json_rslt != jonmpOK) {
+        parsed = rclass.error;
+        if (NULL == parsed.start) {
             PBCC_LOG_ERROR(
                 pb->logger_manager,
                 "Malformed service response: missing 'error' field\n  - "
@@ -48,14 +48,16 @@ typedef void*           pubnub_watcher_t;
 #define thread_handle_field()
 #endif
 
-/** Failed requests retry timer definition. */
+/**
+ * @brief Failed requests retry timer definition.
+ *
+ * In callback mode, the delay is the context's timer of the callback watcher
+ * (the one used for the transaction timeout, which is not running while
+ * waiting for retry), so retries don't need any threads of their own.
+ */
 struct pbcc_request_retry_timer {
     /** PubNub context for which timer will restart requests. */
     pubnub_t* pb;
-#if defined(PUBNUB_CALLBACK_API)
-    /** Timer's run thread. */
-    pubnub_thread_t timer_thread;
-#endif // #if defined(PUBNUB_CALLBACK_API)
     /** Whether timer is running at this moment or not. */
     volatile bool running;
     /** Active timer delay value in milliseconds. */
@@ -70,6 +72,7 @@ struct pbcc_request_retry_timer {
 // ----------------------------------------------
 
 
+#if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
 /**
  * @brief Run request retry timer.
  *
@@ -79,6 +82,7 @@ struct pbcc_request_retry_timer {
  * @param timer Pointer to the timer which should run.
  */
 static void* pbcc_request_retry_timer_run_(pbcc_request_retry_timer_t* timer);
+#endif // #if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
 
 
 // ----------------------------------------------
@@ -89,9 +93,6 @@ pbcc_request_retry_timer_t* pbcc_request_retry_timer_alloc(pubnub_t* pb)
 {
     PBCC_ALLOCATE_TYPE(timer, pbcc_request_retry_timer_t, true, NULL);
     pubnub_mutex_init(timer->mutw);
-#if defined(PUBNUB_CALLBACK_API)
-    timer->timer_thread = NULL;
-#endif // #if defined(PUBNUB_CALLBACK_API)
     timer->running = false;
     timer->pb      = pb;
 
@@ -134,27 +135,9 @@ void pbcc_request_retry_timer_start(
     else {
 #endif
 #if defined(PUBNUB_CALLBACK_API)
-        if (pthread_create(
-                &timer->timer_thread,
-                NULL,
-                (void* (*)(void*))pbcc_request_retry_timer_run_,
-                timer)) {
-            PUBNUB_LOG_ERROR(timer->pb, "Unable to create thread");
-
-            /**
-             * To not stall FSM we let it retry request right away if thread
-             * can't be created.
-             */
-            pubnub_mutex_lock(timer->mutw);
-            timer->running = false;
-            pubnub_mutex_unlock(timer->mutw);
-            pubnub_mutex_lock(timer->pb->monitor);
-            if (PBS_WAIT_RETRY == timer->pb->state) {
-                timer->pb->state = PBS_RETRY;
-                pbnc_fsm(timer->pb);
-            }
-            pubnub_mutex_unlock(timer->pb->monitor);
-        }
+        pubnub_mutex_lock(timer->pb->monitor);
+        pbntf_start_wait_retry_timer(timer->pb, delay);
+        pubnub_mutex_unlock(timer->pb->monitor);
 #if defined(PUBNUB_NTF_RUNTIME_SELECTION)
     } /* if (PNA_SYNC == timer->pb->api_policy) */
 #endif
@@ -165,19 +148,42 @@ void pbcc_request_retry_timer_start(
 
 void pbcc_request_retry_timer_stop(pbcc_request_retry_timer_t* timer)
 {
+    bool was_running;
+
     if (NULL == timer) { return; }
 
     pubnub_mutex_lock(timer->mutw);
+    was_running    = timer->running;
+    timer->running = false;
+    pubnub_mutex_unlock(timer->mutw);
+
 #if defined(PUBNUB_CALLBACK_API)
-    if (NULL != timer->timer_thread) {
-        pthread_join(timer->timer_thread, NULL);
-        timer->timer_thread = NULL;
-    }
+#if defined(PUBNUB_NTF_RUNTIME_SELECTION)
+    if (PNA_CALLBACK == timer->pb->api_policy)
+#endif
+    if (was_running) { pbntf_stop_wait_retry_timer(timer->pb); }
+#else
+    (void)was_running;
 #endif // #if defined(PUBNUB_CALLBACK_API)
+}
+
+#if defined(PUBNUB_CALLBACK_API)
+void pbcc_request_retry_timer_expired(pbcc_request_retry_timer_t* timer)
+{
+    PUBNUB_ASSERT_OPT(timer != NULL);
+
+    pubnub_mutex_lock(timer->mutw);
     timer->running = false;
     pubnub_mutex_unlock(timer->mutw);
+
+    if (PBS_WAIT_RETRY == timer->pb->state) {
+        timer->pb->state = PBS_RETRY;
+        pbnc_fsm(timer->pb);
+    }
 }
+#endif // #if defined(PUBNUB_CALLBACK_API)
 
+#if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
 void* pbcc_request_retry_timer_run_(pbcc_request_retry_timer_t* timer)
 {
     const pbmsref_t t0      = pbms_start();
@@ -210,3 +216,4 @@ void* pbcc_request_retry_timer_run_(pbcc_request_retry_timer_t* timer)
 
     return NULL;
 }
+#endif // #if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
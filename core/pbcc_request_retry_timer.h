@@ -71,5 +71,18 @@ void pbcc_request_retry_timer_start(
  * @param timer Pointer to the timer which should stop earlier that timeout.
  */
 void pbcc_request_retry_timer_stop(pbcc_request_retry_timer_t* timer);
+
+#if defined(PUBNUB_CALLBACK_API)
+/**
+ * @brief Handle request retry timer expiry.
+ *
+ * Called by the callback watcher, with the context's monitor locked, when the
+ * timer started with `pbntf_start_wait_retry_timer` expires. Restarts the
+ * request if context still waits for the retry.
+ *
+ * @param timer Pointer to the timer which expired.
+ */
+void pbcc_request_retry_timer_expired(pbcc_request_retry_timer_t* timer);
+#endif // #if defined(PUBNUB_CALLBACK_API)
 #endif // #if PUBNUB_USE_RETRY_CONFIGURATION
 #endif // #ifndef PBCC_REQUEST_RETRY_TIMER_H
@@ -360,6 +360,13 @@ pbcc_event_listener_t* pbcc_subscribe_ee_event_listener(
     return ee->event_listener;
 }
 
+bool pbcc_subscribe_ee_handles_outcomes(const pbcc_subscribe_ee_t* ee)
+{
+    if (NULL == ee) { return false; }
+
+    return (pubnub_callback_t)pbcc_subscribe_callback_ == ee->pb->cb;
+}
+
 pbcc_ee_data_t* pbcc_subscribe_ee_current_state_context(
     const pbcc_subscribe_ee_t* ee)
 {
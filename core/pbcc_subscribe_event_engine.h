@@ -62,6 +62,20 @@ void pbcc_subscribe_ee_free(pbcc_subscribe_ee_t** ee);
 pbcc_event_listener_t* pbcc_subscribe_ee_event_listener(
     const pbcc_subscribe_ee_t* ee);
 
+/**
+ * @brief Check whether Subscribe Event Engine handles transaction outcomes.
+ *
+ * Subscribe Event Engine registers itself as the callback of the PubNub
+ * context, so received messages are delivered to its listeners until user
+ * registers a different callback.
+ *
+ * @param ee Pointer to the Subscribe Event Engine, which should be checked.
+ *           Can be `NULL`.
+ * @return `true` if the PubNub context reports transaction outcomes to the
+ *         Subscribe Event Engine.
+ */
+bool pbcc_subscribe_ee_handles_outcomes(const pbcc_subscribe_ee_t* ee);
+
 /**
  * @brief Get current state context.
  *
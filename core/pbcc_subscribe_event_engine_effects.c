@@ -18,6 +18,9 @@
 /** Maximum channel name length */
 #define PBCC_SUBSCRIBE_EE_CHANNEL_MAXIMUM_LENGTH 2100
 
+/** Maximum number of received messages to get from the context at once */
+#define PBCC_SUBSCRIBE_EE_MESSAGES_BATCH 16
+
 
 // ----------------------------------------------
 //               Function prototypes
@@ -87,29 +90,41 @@ void pbcc_subscribe_ee_emit_messages_effect(
     pbcc_ee_data_t*                            context,
     const pbcc_ee_effect_completion_function_t cb)
 {
-    char            subscribable_name[PBCC_SUBSCRIBE_EE_CHANNEL_MAXIMUM_LENGTH];
     pbcc_ee_data_t* context_copy            = pbcc_ee_data_copy(context);
     const pbcc_subscribe_ee_context_t* ctx  = pbcc_ee_data_value(context_copy);
-    const pbcc_subscribe_ee_t* subscribe_ee = ctx->pb->core.subscribe_ee;
+    pbcc_subscribe_ee_t*       subscribe_ee = ctx->pb->core.subscribe_ee;
     pubnub_t*                  pb           = ctx->pb;
+    struct pubnub_v2_message   msgs[PBCC_SUBSCRIBE_EE_MESSAGES_BATCH];
+    size_t                     count;
 
-    for (struct pubnub_v2_message msg = pubnub_get_v2(pb); msg.payload.size > 0;
-         msg                          = pubnub_get_v2(pb)) {
-        struct pubnub_char_mem_block subscribable;
-        if (msg.match_or_group.size) { subscribable = msg.match_or_group; }
-        else {
-            subscribable = msg.channel;
+    while ((count = pubnub_get_v2_batch(
+                pb, msgs, PBCC_SUBSCRIBE_EE_MESSAGES_BATCH)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            pbcc_subscribe_ee_emit_message(subscribe_ee, msgs[i]);
         }
-        memcpy(subscribable_name, subscribable.ptr, subscribable.size);
-        subscribable_name[subscribable.size] = '\0';
-        pbcc_event_listener_emit_message(
-            subscribe_ee->event_listener, subscribable_name, msg);
     }
 
     cb(subscribe_ee->ee, invocation, false);
     pbcc_ee_data_free(context_copy);
 }
 
+void pbcc_subscribe_ee_emit_message(
+    const pbcc_subscribe_ee_t*     subscribe_ee,
+    const struct pubnub_v2_message msg)
+{
+    char subscribable_name[PBCC_SUBSCRIBE_EE_CHANNEL_MAXIMUM_LENGTH];
+    struct pubnub_char_mem_block subscribable;
+
+    if (msg.match_or_group.size) { subscribable = msg.match_or_group; }
+    else {
+        subscribable = msg.channel;
+    }
+    memcpy(subscribable_name, subscribable.ptr, subscribable.size);
+    subscribable_name[subscribable.size] = '\0';
+    pbcc_event_listener_emit_message(
+        subscribe_ee->event_listener, subscribable_name, msg);
+}
+
 void pbcc_subscribe_ee_cancel_effect(
     pbcc_ee_invocation_t*                      invocation,
     pbcc_ee_data_t*                            context,
@@ -12,6 +12,8 @@
  * @brief Subscribe Event Engine states transition events.
 */
 
+#include "core/pbcc_subscribe_event_engine.h"
+#include "core/pubnub_subscribe_v2_message.h"
 #include "core/pbcc_event_engine.h"
 
 
@@ -87,6 +89,22 @@ void pbcc_subscribe_ee_emit_messages_effect(
     pbcc_ee_data_t* context,
     pbcc_ee_effect_completion_function_t cb);
 
+/**
+ * @brief Notify real-time updates listeners about single received message.
+ *
+ * Used by the messages emitting effect for each message of the subscribe
+ * response and for each message of the subscribe response which is streamed
+ * (given to the listeners as soon as it has been received).
+ *
+ * @param subscribe_ee Pointer to the Subscribe Event Engine with Event Listener
+ *                     which should notify real-time update listeners.
+ * @param msg          Received message which should be delivered to the
+ *                     listeners.
+ */
+void pbcc_subscribe_ee_emit_message(
+    const pbcc_subscribe_ee_t* subscribe_ee,
+    struct pubnub_v2_message   msg);
+
 /**
  * @brief Cancel previously started HTTP operation.
  *
@@ -138,6 +138,7 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
     enum pbjson_object_name_parse_result jpresult;
     struct pbjson_elem                   el;
     struct pbjson_elem                   found;
+    struct pbcc_response_class           rclass;
     char*                                reply    = p->http_reply;
     int                                  replylen = p->http_buf_len;
 
@@ -147,7 +148,8 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
 
     el.start = reply;
     el.end   = reply + replylen;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    rclass   = pbcc_classify_response(&el);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Subscribe access denied:\n  - response: %.*s",
@@ -156,12 +158,10 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
         return PNR_ACCESS_DENIED;
     }
 
-    if (pbjson_value_for_field_found(&el, "status", "400")) {
-        char* msgtext = pbjson_get_status_400_message_value(&el);
-        if (msgtext != NULL && strcmp(
-                                   msgtext,
-                                   "\"Channel group or groups result in empty "
-                                   "subscription set\"") == 0) {
+    if (400 == rclass.status) {
+        if (pbjson_elem_equals_string(&rclass.message,
+                                      "\"Channel group or groups result in "
+                                      "empty subscription set\"")) {
             return PNR_GROUP_EMPTY;
         }
         else {
@@ -169,7 +169,8 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
         }
     }
 
-    if ((reply[0] != '{') || (reply[p->http_buf_len - 1] != '}')) {
+    if (((rclass.shape != pbrsEnvelope) && (rclass.shape != pbrsObject))
+        || (reply[p->http_buf_len - 1] != '}')) {
         return PNR_FORMAT_ERROR;
     }
 
@@ -230,15 +231,70 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
 }
 
 
+/** Keys of a message object (in the subscribe V2 response) that we
+    take values of */
+enum v2_message_key {
+    v2mkPayload,
+    v2mkChannel,
+    v2mkType,
+    v2mkCustomType,
+    v2mkPublishTimetoken,
+    v2mkMatchOrGroup,
+    v2mkMetadata,
+    v2mkPublisher,
+    v2mkFlags,
+    /** Any other key, its value is ignored */
+    v2mkOther
+};
+
+
+static enum v2_message_key v2_message_key(struct pbjson_elem const* key)
+{
+    switch (key->end - key->start) {
+    case 1:
+        switch (*key->start) {
+        case 'd':
+            return v2mkPayload;
+        case 'c':
+            return v2mkChannel;
+        case 'e':
+            return v2mkType;
+        case 'p':
+            return v2mkPublishTimetoken;
+        case 'b':
+            return v2mkMatchOrGroup;
+        case 'u':
+            return v2mkMetadata;
+        case 'i':
+            return v2mkPublisher;
+        case 'f':
+            return v2mkFlags;
+        default:
+            break;
+        }
+        break;
+    case 3:
+        if (0 == memcmp(key->start, "cmt", 3)) { return v2mkCustomType; }
+        break;
+    default:
+        break;
+    }
+    return v2mkOther;
+}
+
+
 struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
 {
     enum pbjson_object_name_parse_result jpresult;
     struct pbjson_elem                   el;
+    struct pbjson_elem                   key;
     struct pbjson_elem                   found;
+    struct pbjson_elem                   value[v2mkOther];
     struct pubnub_v2_message             rslt;
     char const*                          start;
     char const*                          end;
     char const*                          seeker;
+    char const*                          cursor = NULL;
 
     memset(&rslt, 0, sizeof rslt);
 
@@ -262,12 +318,20 @@ struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
     el.start   = start;
     el.end     = seeker;
 
-    /* @todo We should iterate over elements of JSON message object,
-       instead of looking from the start, again and again.
-    */
+    /* Values of all the keys are taken in one pass over the message
+       object, the first one if a key is repeated, as if each was
+       looked for from the start. */
+    memset(value, 0, sizeof value);
+    for (;;) {
+        enum v2_message_key k;
+        jpresult = pbjson_get_next_key_value(&el, &cursor, &key, &found);
+        if (jpresult != jonmpOK) { break; }
+        k = v2_message_key(&key);
+        if ((k != v2mkOther) && (NULL == value[k].start)) { value[k] = found; }
+    }
 
-    jpresult = pbjson_get_object_value(&el, "d", &found);
-    if (jonmpOK == jpresult) {
+    found = value[v2mkPayload];
+    if (found.start != NULL) {
 #if PUBNUB_CRYPTO_API
         if (NULL != p->crypto_module) {
             rslt.payload.ptr = (char*)pbcc_decrypt_message(
@@ -291,8 +355,8 @@ struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
         return rslt;
     }
 
-    jpresult = pbjson_get_object_value(&el, "c", &found);
-    if (jonmpOK == jpresult) {
+    found = value[v2mkChannel];
+    if (found.start != NULL) {
         rslt.channel.ptr  = (char*)found.start + 1;
         rslt.channel.size = found.end - found.start - 2;
     }
@@ -302,8 +366,8 @@ struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
         return rslt;
     }
 
-    jpresult = pbjson_get_object_value(&el, "e", &found);
-    if (jonmpOK == jpresult) {
+    found = value[v2mkType];
+    if (found.start != NULL) {
         if (pbjson_elem_equals_string(&found, "1")) {
             rslt.message_type = pbsbSignal;
         }
@@ -324,13 +388,14 @@ struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
         rslt.message_type = pbsbPublished;
     }
 
-    if (jonmpOK == pbjson_get_object_value(&el, "cmt", &found)) {
+    found = value[v2mkCustomType];
+    if (found.start != NULL) {
         rslt.custom_message_type.ptr  = (char*)found.start + 1;
         rslt.custom_message_type.size = found.end - found.start - 2;
     }
 
-    jpresult = pbjson_get_object_value(&el, "p", &found);
-    if (jonmpOK == jpresult) {
+    found = value[v2mkPublishTimetoken];
+    if (found.start != NULL) {
         struct pbjson_elem titel;
         if (jonmpOK == pbjson_get_object_value(&found, "t", &titel)) {
             if ((*titel.start != '"') || (titel.end[-1] != '"')) {
@@ -352,22 +417,26 @@ struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
         return rslt;
     }
 
-    if (jonmpOK == pbjson_get_object_value(&el, "b", &found)) {
+    found = value[v2mkMatchOrGroup];
+    if (found.start != NULL) {
         rslt.match_or_group.ptr  = (char*)found.start + 1;
         rslt.match_or_group.size = found.end - found.start - 2;
     }
 
-    if (jonmpOK == pbjson_get_object_value(&el, "u", &found)) {
+    found = value[v2mkMetadata];
+    if (found.start != NULL) {
         rslt.metadata.ptr  = (char*)found.start;
         rslt.metadata.size = found.end - found.start;
     }
 
-    if (jonmpOK == pbjson_get_object_value(&el, "i", &found)) {
+    found = value[v2mkPublisher];
+    if (found.start != NULL) {
         rslt.publisher.ptr  = (char*)found.start + 1;
         rslt.publisher.size = found.end - found.start - 2;
     }
 
-    if (jonmpOK == pbjson_get_object_value(&el, "f", &found)) {
+    found = value[v2mkFlags];
+    if (found.start != NULL) {
         rslt.flags = strtol(found.start, NULL, 0);
     }
 
@@ -377,4 +446,214 @@ struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
     return rslt;
 }
 
+
+size_t pbcc_get_msgs_v2(struct pbcc_context*      p,
+                        struct pubnub_v2_message* msgs,
+                        size_t                    n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i) {
+        msgs[i] = pbcc_get_msg_v2(p);
+        if (NULL == msgs[i].payload.ptr) { break; }
+    }
+
+    return i;
+}
+
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+void pbcc_subscribe_v2_stream_start(struct pbcc_context* p)
+{
+    memset(&p->v2_stream, 0, sizeof p->v2_stream);
+    p->v2_stream.state = pbsv2sEnvelope;
+}
+
+
+void pbcc_subscribe_v2_stream_stop(struct pbcc_context* p)
+{
+    p->v2_stream.state = pbsv2sIdle;
+}
+
+
+bool pbcc_subscribe_v2_streaming(struct pbcc_context const* p)
+{
+    return p->v2_stream.state != pbsv2sIdle;
+}
+
+
+/** Checks that the response in @p p, up to the key of the message
+    array, has the timetoken and region, taking the region.
+    Timetoken is taken when the whole response is parsed.
+ */
+static bool stream_timetoken_found(struct pbcc_context* p)
+{
+    struct pbjson_elem el;
+    struct pbjson_elem found;
+    struct pbjson_elem titel;
+
+    el.start = p->http_reply;
+    el.end   = p->http_reply + p->v2_stream.key_ofs;
+    if ((jonmpOK != pbjson_get_object_value(&el, "t", &found))
+        || (jonmpOK != pbjson_get_object_value(&found, "t", &titel))
+        || (jonmpOK != pbjson_get_object_value(&found, "r", &titel))) {
+        return false;
+    }
+    p->region = strtol(titel.start, NULL, 0);
+
+    return true;
+}
+
+
+/** Parses the octet @p c of the response object, outside of the
+    message array (and strings), looking for the array.
+    @retval true Keep parsing
+    @retval false Stop parsing
+ */
+static bool stream_envelope(struct pbcc_context* p, char c)
+{
+    struct pbcc_subscribe_v2_stream* s = &p->v2_stream;
+
+    if ((1 == s->level) && s->key_is_m && (c != ':')) {
+        if (('[' == c) && stream_timetoken_found(p)) {
+            s->state     = pbsv2sArray;
+            s->level     = 2;
+            s->array_ofs = s->drop_ofs = s->scan_ofs + 1;
+            return true;
+        }
+        /* Not as expected, leave it to be parsed as a whole */
+        PBCC_LOG_DEBUG(
+            p->logger_manager,
+            "Subscribe V2 response can't be parsed as it's received");
+        s->state = pbsv2sIdle;
+        return false;
+    }
+    switch (c) {
+    case '"':
+        s->in_string = true;
+        if ((1 == s->level) && s->expect_key) {
+            s->expect_key = false;
+            s->in_key     = true;
+            s->key_ofs    = s->scan_ofs;
+        }
+        break;
+    case '{':
+    case '[':
+        if ((0 == s->level) && (c != '{')) {
+            s->state = pbsv2sIdle;
+            return false;
+        }
+        s->expect_key = (0 == s->level++);
+        break;
+    case '}':
+    case ']':
+        if ((0 == s->level) || (0 == --s->level)) {
+            /* No message array, nothing to stream */
+            s->state = pbsv2sDone;
+            return false;
+        }
+        break;
+    case ',':
+        s->expect_key = (1 == s->level);
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+
+bool pbcc_subscribe_v2_stream_next(struct pbcc_context* p)
+{
+    struct pbcc_subscribe_v2_stream* s = &p->v2_stream;
+
+    for (; s->scan_ofs < p->http_buf_len; ++s->scan_ofs) {
+        char const c = p->http_reply[s->scan_ofs];
+
+        if (s->in_string) {
+            if (s->escaped) {
+                s->escaped = false;
+            }
+            else if ('\\' == c) {
+                s->escaped = true;
+            }
+            else if ('"' == c) {
+                s->in_string = false;
+                if (s->in_key) {
+                    s->in_key   = false;
+                    s->key_is_m = (s->scan_ofs == s->key_ofs + 2)
+                                  && ('m' == p->http_reply[s->key_ofs + 1]);
+                }
+            }
+            continue;
+        }
+        if ((' ' == c) || ('\t' == c) || ('\r' == c) || ('\n' == c)) {
+            if (pbsv2sArray == s->state) { s->drop_ofs = s->scan_ofs + 1; }
+            continue;
+        }
+        switch (s->state) {
+        case pbsv2sEnvelope:
+            if (!stream_envelope(p, c)) { return false; }
+            break;
+        case pbsv2sArray:
+            if (',' == c) {
+                s->drop_ofs = s->scan_ofs + 1;
+            }
+            else if ('{' == c) {
+                s->state     = pbsv2sMessage;
+                s->msg_start = s->scan_ofs;
+                s->level     = 3;
+            }
+            else {
+                /* End of the array, or not a message object, which
+                   is left to be parsed as a whole */
+                s->state = (']' == c) ? pbsv2sDone : pbsv2sIdle;
+                return false;
+            }
+            break;
+        case pbsv2sMessage:
+            if ('"' == c) {
+                s->in_string = true;
+            }
+            else if (('{' == c) || ('[' == c)) {
+                ++s->level;
+            }
+            else if ((('}' == c) || (']' == c)) && (2 == --s->level)) {
+                s->state    = pbsv2sArray;
+                p->msg_ofs  = s->msg_start;
+                p->msg_end  = ++s->scan_ofs;
+                s->drop_ofs = s->scan_ofs;
+                return true;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return false;
+}
+
+
+unsigned pbcc_subscribe_v2_stream_drop(struct pbcc_context* p)
+{
+    struct pbcc_subscribe_v2_stream* s       = &p->v2_stream;
+    unsigned const                   dropped = s->drop_ofs - s->array_ofs;
+
+    if (0 == dropped) { return 0; }
+    memmove(
+        p->http_reply + s->array_ofs,
+        p->http_reply + s->drop_ofs,
+        p->http_buf_len - s->drop_ofs);
+    p->http_buf_len -= dropped;
+    s->scan_ofs -= dropped;
+    if (pbsv2sMessage == s->state) { s->msg_start -= dropped; }
+    s->drop_ofs = s->array_ofs;
+    p->msg_ofs = p->msg_end = 0;
+
+    return dropped;
+}
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
 #endif /* PUBNUB_USE_SUBSCRIBE_V2 */
@@ -7,6 +7,8 @@
 
 #include "pubnub_subscribe_v2_message.h"
 
+#include <stdbool.h>
+
 struct pbcc_context;
 
 /** Prepares the Subscribe_v2 operation (transaction), mostly by
@@ -38,6 +40,50 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p);
 struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p);
 
 
+/** Gets up to @p n next v2 messages from the Pubnub C Core context
+    @p p to @p msgs, stopping at the first one that has no payload, as
+    if pbcc_get_msg_v2() was called repeatedly.
+    @return The number of messages put to @p msgs
+  */
+size_t pbcc_get_msgs_v2(struct pbcc_context*      p,
+                        struct pubnub_v2_message* msgs,
+                        size_t                    n);
+
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+/** Starts parsing the subscribe V2 response in the reply buffer of
+    @p p as it is received (its body is yet to be received).
+ */
+void pbcc_subscribe_v2_stream_start(struct pbcc_context* p);
+
+/** Stops parsing the response in the reply buffer of @p p as it is
+    received, so it's received (and parsed) as a whole.
+ */
+void pbcc_subscribe_v2_stream_stop(struct pbcc_context* p);
+
+/** Returns whether the response in the reply buffer of @p p is being
+    parsed as it is received.
+ */
+bool pbcc_subscribe_v2_streaming(struct pbcc_context const* p);
+
+/** Parses the response received so far in @p p, from where the last
+    call stopped, up to the end of the next message.
+
+    @retval true A message was received, to get it with pbcc_get_msg_v2()
+    @retval false No (more) messages received so far
+ */
+bool pbcc_subscribe_v2_stream_next(struct pbcc_context* p);
+
+/** Drops the messages given by pbcc_subscribe_v2_stream_next() from
+    the reply buffer of @p p, moving the rest of the response (received
+    so far) in their place.
+
+    @return The number of octets dropped
+ */
+unsigned pbcc_subscribe_v2_stream_drop(struct pbcc_context* p);
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
+
 #endif /* !defined INC_PBCC_SUBSCRIBE_V2 */
 
 #endif /* PUBNUB_USE_SUBSCRIBE_V2 */
@@ -0,0 +1,61 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBCONN_POOL
+#define INC_PBCONN_POOL
+
+#if PUBNUB_USE_CONNECTION_POOL
+
+#include "core/pubnub_api_types.h"
+#include "pubnub_get_native_socket.h"
+
+#include <stdbool.h>
+
+
+/** A connection taken from a context, kept in the connection pool
+    until some context borrows it. This is enough for the PALs that
+    support the pool.
+ */
+struct pbpal_pooled_connection {
+    /** The socket of the (TCP) connection */
+    pbpal_native_socket_t socket;
+    /** The TLS/SSL session on the socket, if any (PAL specific) */
+    void* tls;
+};
+
+/** Moves the connection of @p pb to @p conn, leaving @p pb without a
+    connection (closed), but with all the rest of its PAL data (like
+    the TLS/SSL context or session) intact.
+ */
+void pbpal_detach_connection(pubnub_t* pb, struct pbpal_pooled_connection* conn);
+
+/** Moves the connection @p conn to @p pb, which should be without a
+    connection.
+ */
+void pbpal_attach_connection(pubnub_t* pb, struct pbpal_pooled_connection const* conn);
+
+/** Closes the connection @p conn, which is not attached to any
+    context.
+ */
+void pbpal_close_detached_connection(struct pbpal_pooled_connection* conn);
+
+
+/** Gives the (kept alive) connection of @p pb to the pool.
+
+    @retval true Connection given to the pool, @p pb doesn't have it
+                 anymore
+    @retval false @p pb can't use the pool, keeps its connection
+ */
+bool pbconn_pool_put(pubnub_t* pb);
+
+/** Borrows an idle connection from the pool for @p pb, which doesn't
+    have a connection.
+
+    @retval true Connection borrowed, @p pb should use it as a
+                 connection it kept alive
+    @retval false No suitable connection in the pool
+ */
+bool pbconn_pool_take(pubnub_t* pb);
+
+
+#endif /* PUBNUB_USE_CONNECTION_POOL */
+
+#endif /* !defined INC_PBCONN_POOL */
@@ -4,15 +4,37 @@
 
 #include "pubnub_internal.h"
 
+#include "core/pubnub_gzip_compress.h"
 #include "core/pubnub_assert.h"
-#include "lib/miniz/miniz_tdef.h"
+#include "lib/miniz/miniz.h"
 #include "lib/pbcrc32.h"
 
+#include <stdlib.h>
+
 #define GZIP_HEADER_LENGTH_BYTES 10
 #define GZIP_FOOTER_LENGTH_BYTES 8
 /* Percents 'off' message length after compression */
 #define PUBNUB_MINIMAL_ACCEPTABLE_COMPRESSION_RATIO 10
 
+
+static int miniz_strategy(enum pubnub_gzip_strategy strategy)
+{
+    switch (strategy) {
+    case pbgzsFiltered:
+        return MZ_FILTERED;
+    case pbgzsHuffmanOnly:
+        return MZ_HUFFMAN_ONLY;
+    case pbgzsRLE:
+        return MZ_RLE;
+    case pbgzsFixed:
+        return MZ_FIXED;
+    case pbgzsDefault:
+    default:
+        return MZ_DEFAULT_STRATEGY;
+    }
+}
+
+
 static enum pubnub_res deflate_total_to_context_buffer(
     pubnub_t*   pb,
     char const* message,
@@ -21,12 +43,32 @@ static enum pubnub_res deflate_total_to_context_buffer(
     size_t unpacked_size = message_size;
     size_t compressed    = sizeof pb->core.gzip_msg_buf -
                         (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES);
-    char*            gzip_msg_buf = pb->core.gzip_msg_buf;
-    tdefl_compressor comp;
+    char*                     gzip_msg_buf = pb->core.gzip_msg_buf;
+    struct pbgzip_compressor* p            = &pb->gzip_compressor;
+    tdefl_status              status;
 
-    tdefl_init(&comp, NULL, NULL, TDEFL_DEFAULT_MAX_PROBES);
-    tdefl_status status = tdefl_compress(
-        &comp,
+    if (NULL == p->comp) {
+        p->comp = (tdefl_compressor*)calloc(1, sizeof *p->comp);
+        if (NULL == p->comp) {
+            PUBNUB_LOG_WARNING(
+                pb, "Failed to allocate compressor, not compressing");
+            return PNR_STARTED;
+        }
+    }
+    /* As the compressor is reused, its (some 100KB of) hash and
+       dictionary need not be cleared for each message - matches are
+       looked for only in the current message anyway, it's just that
+       they may be found a little differently.
+     */
+    tdefl_init(
+        p->comp,
+        NULL,
+        NULL,
+        (int)tdefl_create_comp_flags_from_zip_params(
+            p->level, -MZ_DEFAULT_WINDOW_BITS, miniz_strategy(p->strategy))
+            | TDEFL_NONDETERMINISTIC_PARSING_FLAG);
+    status = tdefl_compress(
+        p->comp,
         message,
         &message_size,
         gzip_msg_buf + GZIP_HEADER_LENGTH_BYTES,
@@ -42,7 +84,7 @@ static enum pubnub_res deflate_total_to_context_buffer(
 
             PUBNUB_LOG_TRACE(
                 pb,
-                "%lu bytes compressed to %s bytes with %ld compression rate",
+                "%lu bytes compressed to %lu bytes with %ld compression rate",
                 (unsigned long)unpacked_size,
                 (unsigned long)packed_size,
                 ((long)(diff * 1000) / (long)unpacked_size));
@@ -114,7 +156,14 @@ enum pubnub_res pbgzip_compress(pubnub_t* pb, char const* message)
     PUBNUB_ASSERT_OPT(message != NULL);
 
     pb->core.gzip_msg_len = 0;
-    data                  = pb->core.gzip_msg_buf;
+    size                  = strlen(message);
+    if ((0 == pb->gzip_compressor.level)
+        || (size < pb->gzip_compressor.min_size)) {
+        PUBNUB_LOG_TRACE(
+            pb, "Not compressing %lu bytes message", (unsigned long)size);
+        return PNR_STARTED;
+    }
+    data = pb->core.gzip_msg_buf;
     /* Gzip format */
     data[0] = 0x1f;
     data[1] = 0x8b;
@@ -122,11 +171,53 @@ enum pubnub_res pbgzip_compress(pubnub_t* pb, char const* message)
     data[2] = 8;
     /* flags: no file_name, no f_extras, no f_comment, no f_hcrc */
     memset(data + 3, '\0', 7);
-    size = strlen(message);
     PUBNUB_LOG_TRACE(
         pb, "Length before compression: %lu bytes", (long unsigned int)size);
 
     return deflate_total_to_context_buffer(pb, message, size);
 }
 
+
+void pbgzip_compress_init(pubnub_t* pb)
+{
+    struct pbgzip_compressor* p = &pb->gzip_compressor;
+
+    p->comp     = NULL;
+    p->level    = PUBNUB_GZIP_COMPRESSION_LEVEL;
+    p->strategy = pbgzsDefault;
+    p->min_size = PUBNUB_GZIP_MIN_MESSAGE_SIZE;
+}
+
+
+void pbgzip_compress_free(pubnub_t* pb)
+{
+    free(pb->gzip_compressor.comp);
+    pb->gzip_compressor.comp = NULL;
+}
+
+
+void pubnub_set_gzip_compression(
+    pubnub_t*                 pb,
+    int                       level,
+    enum pubnub_gzip_strategy strategy)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT((level >= 0) && (level <= 10));
+
+    pubnub_mutex_lock(pb->monitor);
+    pb->gzip_compressor.level    = level;
+    pb->gzip_compressor.strategy = strategy;
+    pubnub_mutex_unlock(pb->monitor);
+}
+
+
+void pubnub_set_gzip_min_size(pubnub_t* pb, size_t min_size)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    pb->gzip_compressor.min_size = min_size;
+    pubnub_mutex_unlock(pb->monitor);
+}
+
 #endif /* PUBNUB_USE_GZIP_COMPRESSION */
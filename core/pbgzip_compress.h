@@ -6,6 +6,10 @@
 #define INC_PUBNUB_COMPRESSION
 
 #include "pubnub_api_types.h"
+#include "core/pubnub_gzip_compress.h"
+#include "lib/miniz/miniz_tdef.h"
+
+#include <stddef.h>
 
 /** Compresses(deflates) @p message into gzip-formatted data stored in context buffer.
     @retval PNR_OK on success,
@@ -14,6 +18,25 @@
  */
 enum pubnub_res pbgzip_compress(pubnub_t *pb, char const* message);
 
+/** Settings and state of gzip compression of a context */
+struct pbgzip_compressor {
+    /** Compressor, allocated on first use and reused afterwards (it's
+        too big for the stack, some 300KB) */
+    tdefl_compressor* comp;
+    /** Compression level, 0 - don't compress */
+    int level;
+    /** Compression strategy */
+    enum pubnub_gzip_strategy strategy;
+    /** Messages shorter than this are not compressed */
+    size_t min_size;
+};
+
+/** Initializes gzip compression of @p pb to the defaults */
+void pbgzip_compress_init(pubnub_t* pb);
+
+/** Frees the (reusable) compressor of @p pb, if it was allocated */
+void pbgzip_compress_free(pubnub_t* pb);
+
 #endif /* INC_PUBNUB_COMPRESSION */
 
 #endif /* PUBNUB_USE_GZIP_COMPRESSION */
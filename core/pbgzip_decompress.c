@@ -7,6 +7,8 @@
 #include "core/pubnub_assert.h"
 #include "lib/miniz/miniz_tinfl.h"
 
+#include <string.h>
+
 #define GZIP_HEADER_LENGTH_BYTES 10
 #define GZIP_FOOTER_LENGTH_BYTES 8
 
@@ -76,12 +78,15 @@ PUBNUB_STATIC_ASSERT(
 static void swap_reply_buffer(pubnub_t* pb)
 {
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
-    char*  aux_buf             = pb->core.http_reply;
-    size_t aux_buf_len         = pb->core.http_buf_len;
-    pb->core.http_reply        = pb->core.decomp_http_reply;
-    pb->core.http_buf_len      = pb->core.decomp_buf_size;
-    pb->core.decomp_http_reply = aux_buf;
-    pb->core.decomp_buf_size   = aux_buf_len;
+    char*  aux_buf                  = pb->core.http_reply;
+    size_t aux_buf_len              = pb->core.http_buf_len;
+    size_t aux_buf_size             = pb->core.http_reply_size;
+    pb->core.http_reply             = pb->core.decomp_http_reply;
+    pb->core.http_buf_len           = pb->core.decomp_buf_size;
+    pb->core.http_reply_size        = pb->core.decomp_http_reply_size;
+    pb->core.decomp_http_reply      = aux_buf;
+    pb->core.decomp_buf_size        = aux_buf_len;
+    pb->core.decomp_http_reply_size = aux_buf_size;
 #else
     PUBNUB_ASSERT(pb->core.decomp_buf_size < sizeof pb->core.decomp_http_reply);
     memcpy(
@@ -102,7 +107,7 @@ static enum pubnub_res inflate_total(
 {
     enum pubnub_res result;
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
-    if (pb->core.decomp_buf_size < out_len) {
+    if (pb->core.decomp_http_reply_size < out_len + 1) {
         char* newbuf = (char*)realloc(pb->core.decomp_http_reply, out_len + 1);
         if (NULL == newbuf) {
             PUBNUB_LOG_ERROR(
@@ -111,7 +116,8 @@ static enum pubnub_res inflate_total(
                 (unsigned long)out_len);
             return PNR_REPLY_TOO_BIG;
         }
-        pb->core.decomp_http_reply = newbuf;
+        pb->core.decomp_http_reply      = newbuf;
+        pb->core.decomp_http_reply_size = out_len + 1;
     }
 #else
     if (out_len >= sizeof pb->core.decomp_http_reply) {
@@ -133,14 +139,9 @@ static enum pubnub_res inflate_total(
 }
 
 
-enum pubnub_res pbgzip_decompress(pubnub_t* pb)
+static enum pubnub_res check_header(pubnub_t* pb, uint8_t const* data)
 {
-    const uint8_t* data = (uint8_t*)pb->core.http_reply;
-    size_t         size = (size_t)pb->core.http_buf_len;
-    uint32_t       unpacked_size;
-
-    if ((size < (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES)) ||
-        (data[0] != 0x1f) || (data[1] != 0x8b)) {
+    if ((data[0] != 0x1f) || (data[1] != 0x8b)) {
         PUBNUB_LOG_ERROR(pb, "Compressed data format is not gzip.");
         return PNR_BAD_COMPRESSION_FORMAT;
     }
@@ -156,13 +157,183 @@ enum pubnub_res pbgzip_decompress(pubnub_t* pb)
             pb, "GZIP flags should be 0, but are %uX", (unsigned)data[3]);
         return PNR_BAD_COMPRESSION_FORMAT;
     }
-    /* Unpacked message size is placed at the end of the 'gzip' formated message
-       in the last four bytes
-     */
-    unpacked_size = (uint32_t)data[size - 4];
-    unpacked_size |= (uint32_t)data[size - 3] << 8;
-    unpacked_size |= (uint32_t)data[size - 2] << 16;
-    unpacked_size |= (uint32_t)data[size - 1] << 24;
+    return PNR_OK;
+}
+
+
+/* Unpacked message size is placed at the end of the 'gzip' formated message
+   in the last four bytes
+ */
+static uint32_t unpacked_size_from_footer(uint8_t const* footer)
+{
+    uint32_t unpacked_size;
+
+    unpacked_size = (uint32_t)footer[4];
+    unpacked_size |= (uint32_t)footer[5] << 8;
+    unpacked_size |= (uint32_t)footer[6] << 16;
+    unpacked_size |= (uint32_t)footer[7] << 24;
+
+    return unpacked_size;
+}
+
+
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+void pbgzip_inflate_start(pubnub_t* pb)
+{
+    struct pbgzip_inflate* p = &pb->gzip_inflate;
+
+    p->active = (compressionGZIP == pb->data_compressed);
+    if (p->active) {
+        tinfl_init(&p->decomp);
+        p->dict_ofs   = 0;
+        p->out_len    = 0;
+        p->header_len = 0;
+        p->footer_len = 0;
+        p->done       = false;
+    }
+}
+
+
+bool pbgzip_inflating(pubnub_t const* pb)
+{
+    return pb->gzip_inflate.active;
+}
+
+
+/** Inflates what it can of the deflated data at @p data, consuming
+    it, appending the inflated data to the reply buffer */
+static enum pubnub_res inflate_piece(
+    pubnub_t*       pb,
+    uint8_t const** data,
+    size_t*         len)
+{
+    struct pbgzip_inflate* p = &pb->gzip_inflate;
+
+    for (;;) {
+        size_t       in_len  = *len;
+        size_t       out_len = TINFL_LZ_DICT_SIZE - p->dict_ofs;
+        tinfl_status status  = tinfl_decompress(
+            &p->decomp,
+            (const mz_uint8*)*data,
+            &in_len,
+            p->dict,
+            p->dict + p->dict_ofs,
+            &out_len,
+            TINFL_FLAG_HAS_MORE_INPUT);
+
+        *data += in_len;
+        *len -= in_len;
+        if (out_len > 0) {
+            size_t const reply_len = pb->core.http_buf_len;
+            if (0 != pbcc_realloc_reply_buffer(&pb->core, reply_len + out_len)) {
+                PUBNUB_LOG_ERROR(
+                    pb,
+                    "Failed to reallocate reply buffer for %lu inflated bytes",
+                    (unsigned long)(reply_len + out_len));
+                return PNR_REPLY_TOO_BIG;
+            }
+            memcpy(
+                pb->core.http_reply + reply_len, p->dict + p->dict_ofs, out_len);
+            pb->core.http_buf_len = reply_len + out_len;
+            p->out_len += (uint32_t)out_len;
+            p->dict_ofs = (p->dict_ofs + out_len) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+        switch (status) {
+        case TINFL_STATUS_DONE:
+            p->done = true;
+            return PNR_OK;
+        case TINFL_STATUS_NEEDS_MORE_INPUT:
+            return PNR_OK;
+        case TINFL_STATUS_HAS_MORE_OUTPUT:
+            break;
+        default:
+            PUBNUB_LOG_ERROR(
+                pb, "Decompression failed with error code: %d", status);
+            return PNR_BAD_COMPRESSION_FORMAT;
+        }
+    }
+}
+
+
+enum pubnub_res pbgzip_inflate(pubnub_t* pb, uint8_t const* data, size_t len)
+{
+    struct pbgzip_inflate* p = &pb->gzip_inflate;
+
+    PUBNUB_ASSERT_OPT(p->active);
+
+    if (p->header_len < GZIP_HEADER_LENGTH_BYTES) {
+        size_t to_copy = GZIP_HEADER_LENGTH_BYTES - p->header_len;
+        if (to_copy > len) { to_copy = len; }
+        memcpy(p->header + p->header_len, data, to_copy);
+        p->header_len += (uint8_t)to_copy;
+        data += to_copy;
+        len -= to_copy;
+        if (p->header_len < GZIP_HEADER_LENGTH_BYTES) { return PNR_OK; }
+        if (check_header(pb, p->header) != PNR_OK) {
+            return PNR_BAD_COMPRESSION_FORMAT;
+        }
+    }
+    if (!p->done && (len > 0)) {
+        enum pubnub_res const rslt = inflate_piece(pb, &data, &len);
+        if (rslt != PNR_OK) { return rslt; }
+    }
+    if (len > GZIP_FOOTER_LENGTH_BYTES - (size_t)p->footer_len) {
+        PUBNUB_LOG_ERROR(pb, "Data after the end of the gzip footer");
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    memcpy(p->footer + p->footer_len, data, len);
+    p->footer_len += (uint8_t)len;
+
+    return PNR_OK;
+}
+
+
+static enum pubnub_res inflate_finish(pubnub_t* pb)
+{
+    struct pbgzip_inflate* p = &pb->gzip_inflate;
+    uint32_t               unpacked_size;
+
+    p->active = false;
+    if (!p->done || (p->footer_len < GZIP_FOOTER_LENGTH_BYTES)) {
+        PUBNUB_LOG_ERROR(pb, "Compressed data ended prematurely");
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    unpacked_size = unpacked_size_from_footer(p->footer);
+    if (unpacked_size != p->out_len) {
+        PUBNUB_LOG_ERROR(
+            pb,
+            "Decompressed length (%lu bytes) doesn't match unpacked size (%lu "
+            "bytes).",
+            (unsigned long)p->out_len,
+            (unsigned long)unpacked_size);
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    PUBNUB_LOG_TRACE(
+        pb, "Inflated to %lu bytes as received", (unsigned long)unpacked_size);
+
+    return PNR_OK;
+}
+#endif /* PUBNUB_RECEIVE_GZIP_STREAMING */
+
+
+enum pubnub_res pbgzip_decompress(pubnub_t* pb)
+{
+    const uint8_t*  data = (uint8_t*)pb->core.http_reply;
+    size_t          size = (size_t)pb->core.http_buf_len;
+    uint32_t        unpacked_size;
+    enum pubnub_res rslt;
+
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+    if (pb->gzip_inflate.active) { return inflate_finish(pb); }
+#endif
+    if (size < (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES)) {
+        PUBNUB_LOG_ERROR(pb, "Compressed data format is not gzip.");
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    rslt = check_header(pb, data);
+    if (rslt != PNR_OK) { return rslt; }
+    unpacked_size =
+        unpacked_size_from_footer(data + size - GZIP_FOOTER_LENGTH_BYTES);
     PUBNUB_LOG_TRACE(
         pb,
         "%lu bytes decompressed to %lu bytes",
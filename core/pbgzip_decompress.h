@@ -7,6 +7,13 @@
 
 #include "pubnub_api_types.h"
 
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+#include "lib/miniz/miniz_tinfl.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
 /* Types of compressed data format */
 enum pubnub_data_compressionType{
     compressionNONE,
@@ -21,6 +28,50 @@ enum pubnub_data_compressionType{
  */
 enum pubnub_res pbgzip_decompress(pubnub_t *pb);
 
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+/** State of inflating a gzip response as it is received */
+struct pbgzip_inflate {
+    tinfl_decompressor decomp;
+    /** The last inflated data, which the data yet to inflate may
+        refer to - wraps around */
+    uint8_t dict[TINFL_LZ_DICT_SIZE];
+    /** Where the next inflated data goes in `dict` */
+    size_t dict_ofs;
+    /** Total length of inflated data (modulo 2^32) */
+    uint32_t out_len;
+    /** gzip header (as it's received) */
+    uint8_t header[10];
+    /** gzip footer (as it's received), after the deflated data */
+    uint8_t footer[8];
+    uint8_t header_len;
+    uint8_t footer_len;
+    /** Inflating the response being received */
+    bool active;
+    /** All deflated data was inflated */
+    bool done;
+};
+
+/** Starts inflating the body of the response of @p pb as it's
+    received, if it's compressed. To be called when all the response
+    headers were received.
+ */
+void pbgzip_inflate_start(pubnub_t* pb);
+
+/** Returns whether the body of the response of @p pb is inflated as
+    it's received.
+ */
+bool pbgzip_inflating(pubnub_t const* pb);
+
+/** Inflates the @p len octets of the body of the response of @p pb
+    (received) at @p data, appending the inflated data to the reply
+    buffer.
+    @retval PNR_OK on success,
+    @retval PNR_REPLY_TOO_BIG lack of memory,
+    @retval PNR_BAD_COMPRESSION_FORMAT on error
+ */
+enum pubnub_res pbgzip_inflate(pubnub_t* pb, uint8_t const* data, size_t len);
+#endif /* PUBNUB_RECEIVE_GZIP_STREAMING */
+
 #endif /* INC_PUBNUB_DECOMPRESSION */
 
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
@@ -10,6 +10,12 @@
 
 #include "pubnub_assert.h"
 #include "pubnub_helper.h"
+#if PUBNUB_USE_PIPELINING
+#include "core/pbpipeline.h"
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+#include "core/pbpublish_queue.h"
+#endif
 #ifdef PUBNUB_NTF_RUNTIME_SELECTION
 #include "pubnub_ntf_enforcement.h"
 #endif
@@ -34,6 +40,9 @@ void pbntf_trans_outcome(pubnub_t* pb, enum pubnub_state state)
     pb->flags.sent_queries = 0;
 #if PUBNUB_USE_RETRY_CONFIGURATION
     if (NULL != pb->core.retry_configuration &&
+#if PUBNUB_USE_PIPELINING
+        !pbpipeline_active(pb) &&
+#endif
         pubnub_retry_configuration_retryable_result_(pb)) {
         uint16_t delay = pubnub_retry_configuration_delay_(pb);
 
@@ -58,6 +67,12 @@ void pbntf_trans_outcome(pubnub_t* pb, enum pubnub_state state)
         pbcc_request_retry_timer_free(&pb->core.retry_timer);
     }
 #endif // #if PUBNUB_USE_RETRY_CONFIGURATION
+#if PUBNUB_USE_PIPELINING
+    pbpipeline_trans_ended(pb);
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+    pbpublish_queue_trans_ended(pb);
+#endif
     if (pb->cb != NULL) {
         PUBNUB_LOG_TRACE(
             pb,
@@ -66,6 +81,12 @@ void pbntf_trans_outcome(pubnub_t* pb, enum pubnub_state state)
             pubnub_res_2_string(pb->core.last_result));
         pb->cb(pb, pb->trans, pb->core.last_result, pb->user_data);
     }
+#if PUBNUB_USE_PIPELINING
+    pbpipeline_dispatch(pb);
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+    pbpublish_queue_dispatch(pb);
+#endif
 }
 
 MAYBE_INLINE void pbnc_tr_cxt_state_reset_callback(pubnub_t* pb)
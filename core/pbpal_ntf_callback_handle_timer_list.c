@@ -4,25 +4,31 @@
 #include "pbpal_ntf_callback_handle_timer_list.h"
 
 #include "pubnub_timer_list.h"
+#include "pubnub_timer_wheel.h"
 #include "pubnub_assert.h"
 
 
-void pbntf_handle_timer_list(int ms_elapsed, pubnub_t** head)
+static void stop_expired(pubnub_t* expired)
 {
-    pubnub_t* expired;
-
-    PUBNUB_ASSERT_OPT(head != NULL);
-    PUBNUB_ASSERT_OPT(ms_elapsed > 0);
-
-    expired = pubnub_timer_list_as_time_goes_by(head, ms_elapsed);
     while (expired != NULL) {
         pubnub_t* next;
 
         pubnub_mutex_lock(expired->monitor);
         next = expired->next;
-        pbnc_stop(expired, PNR_TIMEOUT);
+        /* Unlink before stopping, as stopping may start a new timer */
         expired->next     = NULL;
         expired->previous = NULL;
+#if PUBNUB_USE_RETRY_CONFIGURATION
+        if ((PBS_WAIT_RETRY == expired->state)
+            && (expired->core.retry_timer != NULL)) {
+            /* Not a transaction timeout, time to retry */
+            pbcc_request_retry_timer_expired(expired->core.retry_timer);
+        }
+        else
+#endif
+        {
+            pbnc_stop(expired, PNR_TIMEOUT);
+        }
         pubnub_mutex_unlock(expired->monitor);
 
         expired = next;
@@ -30,6 +36,24 @@ void pbntf_handle_timer_list(int ms_elapsed, pubnub_t** head)
 }
 
 
+void pbntf_handle_timer_list(int ms_elapsed, pubnub_t** head)
+{
+    PUBNUB_ASSERT_OPT(head != NULL);
+    PUBNUB_ASSERT_OPT(ms_elapsed > 0);
+
+    stop_expired(pubnub_timer_list_as_time_goes_by(head, ms_elapsed));
+}
+
+
+void pbntf_handle_timer_wheel(int ms_elapsed, struct pubnub_timer_wheel* wheel)
+{
+    PUBNUB_ASSERT_OPT(wheel != NULL);
+    PUBNUB_ASSERT_OPT(ms_elapsed > 0);
+
+    stop_expired(pubnub_timer_wheel_as_time_goes_by(wheel, ms_elapsed));
+}
+
+
 void pbpal_remove_timer_safe(pubnub_t* to_remove, pubnub_t** from_head)
 {
     PUBNUB_ASSERT_OPT(to_remove != NULL);
@@ -1,5 +1,6 @@
 /* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
 typedef struct pubnub_ pubnub_t;
+struct pubnub_timer_wheel;
 
 /** Checks the timer list with the given @p head for any expired
     timers, assuming that @p ms_elapsed since last check.
@@ -9,6 +10,11 @@ typedef struct pubnub_ pubnub_t;
  */
 void pbntf_handle_timer_list(int ms_elapsed, pubnub_t** head);
 
+/** Same as pbntf_handle_timer_list(), but for the timers kept in the
+    timer @p wheel.
+ */
+void pbntf_handle_timer_wheel(int ms_elapsed, struct pubnub_timer_wheel* wheel);
+
 /** Removes the context @p to_remove @p from_head list, in a "safe"
     manner. That is, it handles ("ignores") if @p to_remove is not in
     @p from_head.
@@ -68,9 +68,20 @@ int pbpal_ntf_watch_in_events(struct pbpal_poll_data* data, pubnub_t* pbp);
     that this function would call for each context that needs
     processing - but, we basically know what we want to do and it's
     not configurable.
+
+    Waits for at most @p ms milliseconds for some event, or until
+    pbpal_ntf_callback_poller_wakeup() is called. If @p ms < 0, waits
+    without a timeout.
  */
 int pbpal_ntf_poll_away(struct pbpal_poll_data* data, int ms);
 
+/** Wakes up the poller @p data, if it's waiting in
+    pbpal_ntf_poll_away(), otherwise makes the next call to it return
+    immediately. Unlike other functions of the poller, this can be
+    called from any thread, without any locking.
+ */
+void pbpal_ntf_callback_poller_wakeup(struct pbpal_poll_data* data);
+
 /** Deinitialize and deellocate the poller data */
 void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data);
 
@@ -4,114 +4,130 @@
 #include "pbpal_ntf_callback_queue.h"
 
 #include "pubnub_assert.h"
+#include "pubnub_atomic.h"
 
 
 void pbpal_ntf_callback_queue_init(struct pbpal_ntf_callback_queue* queue)
 {
-    pubnub_mutex_init(queue->monitor);
-    queue->size = sizeof queue->apb / sizeof queue->apb[0];
-    queue->head = queue->tail = 0;
+    queue->head = NULL;
 }
 
 
 void pbpal_ntf_callback_queue_deinit(struct pbpal_ntf_callback_queue* queue)
 {
-    pubnub_mutex_destroy(queue->monitor);
-    queue->head = queue->tail = 0;
+    queue->head = NULL;
+}
+
+
+static void push(struct pbpal_ntf_callback_queue* queue, pubnub_t* pb)
+{
+    void* head;
+
+    do {
+        head           = pubnub_atomic_load_ptr(&queue->head);
+        pb->queue_next = (pubnub_t*)head;
+    } while (!pubnub_atomic_cas_ptr(&queue->head, head, (void*)pb));
 }
 
 
 int pbpal_ntf_callback_enqueue_for_processing(struct pbpal_ntf_callback_queue* queue,
                                               pubnub_t* pb)
 {
-    int    result;
-    size_t next_head;
-
     PUBNUB_ASSERT_OPT(queue != NULL);
     PUBNUB_ASSERT_OPT(pb != NULL);
 
-    pubnub_mutex_lock(queue->monitor);
-    next_head = queue->head + 1;
-    if (next_head == queue->size) {
-        next_head = 0;
-    }
-    if (next_head != queue->tail) {
-        queue->apb[queue->head] = pb;
-        queue->head             = next_head;
-        result                  = +1;
-    }
-    else {
-        result = -1;
-    }
-    pubnub_mutex_unlock(queue->monitor);
+    pbpal_ntf_callback_requeue_for_processing(queue, pb);
 
-    return result;
+    return +1;
 }
 
 
 int pbpal_ntf_callback_requeue_for_processing(struct pbpal_ntf_callback_queue* queue,
                                               pubnub_t* pb)
 {
-    bool   found = false;
-    size_t i;
-
+    PUBNUB_ASSERT_OPT(queue != NULL);
     PUBNUB_ASSERT_OPT(pb != NULL);
 
-    pubnub_mutex_lock(queue->monitor);
-    for (i = queue->tail; i != queue->head;
-         i = (((i + 1) == queue->size) ? 0 : i + 1)) {
-        if (queue->apb[i] == pb) {
-            found = true;
-            break;
+    for (;;) {
+        if (pubnub_atomic_cas(&pb->queue_state,
+                              PBPAL_NTF_CALLBACK_QUEUE_NOT_QUEUED,
+                              PBPAL_NTF_CALLBACK_QUEUE_QUEUED)) {
+            push(queue, pb);
+            return +1;
         }
+        /* Still linked in the queue, just "revive" it */
+        if (pubnub_atomic_cas(&pb->queue_state,
+                              PBPAL_NTF_CALLBACK_QUEUE_REMOVED,
+                              PBPAL_NTF_CALLBACK_QUEUE_QUEUED)) {
+            return +1;
+        }
+        if (PBPAL_NTF_CALLBACK_QUEUE_QUEUED
+            == pubnub_atomic_load(&pb->queue_state)) {
+            return 0;
+        }
+        /* State changed in between (dequeued by the consumer), retry */
     }
-    pubnub_mutex_unlock(queue->monitor);
-
-    return !found ? pbpal_ntf_callback_enqueue_for_processing(queue, pb) : 0;
 }
 
 
 void pbpal_ntf_callback_remove_from_queue(struct pbpal_ntf_callback_queue* queue,
                                           pubnub_t*                        pb)
 {
-    size_t i;
-
     PUBNUB_ASSERT_OPT(queue != NULL);
     PUBNUB_ASSERT_OPT(pb != NULL);
 
-    pubnub_mutex_lock(queue->monitor);
-    for (i = queue->tail; i != queue->head;
-         i = (((i + 1) == queue->size) ? 0 : i + 1)) {
-        if (queue->apb[i] == pb) {
-            queue->apb[i] = NULL;
-            break;
+    pubnub_atomic_cas(&pb->queue_state,
+                      PBPAL_NTF_CALLBACK_QUEUE_QUEUED,
+                      PBPAL_NTF_CALLBACK_QUEUE_REMOVED);
+}
+
+
+static void process_batch(pubnub_t* batch)
+{
+    pubnub_t* fifo = NULL;
+
+    /* Producers push in LIFO order, reverse to process in FIFO */
+    while (batch != NULL) {
+        pubnub_t* next    = batch->queue_next;
+        batch->queue_next = fifo;
+        fifo              = batch;
+        batch             = next;
+    }
+
+    while (fifo != NULL) {
+        pubnub_t* pbp = fifo;
+        long      state;
+
+        /* Take the link before the context is released, as it may be
+           queued again (or freed) while being processed.
+         */
+        fifo  = pbp->queue_next;
+        state = pubnub_atomic_exchange(&pbp->queue_state,
+                                       PBPAL_NTF_CALLBACK_QUEUE_NOT_QUEUED);
+        if (state != PBPAL_NTF_CALLBACK_QUEUE_QUEUED) { continue; }
+
+        pubnub_mutex_lock(pbp->monitor);
+        if (pbp->state == PBS_NULL) {
+            pubnub_mutex_unlock(pbp->monitor);
+            pballoc_free_at_last(pbp);
+        }
+        else {
+            pbnc_fsm(pbp);
+            pubnub_mutex_unlock(pbp->monitor);
         }
     }
-    pubnub_mutex_unlock(queue->monitor);
 }
 
 
 void pbpal_ntf_callback_process_queue(struct pbpal_ntf_callback_queue* queue)
 {
-    pubnub_mutex_lock(queue->monitor);
-    while (queue->head != queue->tail) {
-        pubnub_t* pbp = queue->apb[queue->tail++];
-        if (queue->tail == queue->size) {
-            queue->tail = 0;
-        }
-        if (pbp != NULL) {
-            pubnub_mutex_unlock(queue->monitor);
-            pubnub_mutex_lock(pbp->monitor);
-            if (pbp->state == PBS_NULL) {
-                pubnub_mutex_unlock(pbp->monitor);
-                pballoc_free_at_last(pbp);
-            }
-            else {
-                pbnc_fsm(pbp);
-                pubnub_mutex_unlock(pbp->monitor);
-            }
-            pubnub_mutex_lock(queue->monitor);
-        }
+    pubnub_t* batch;
+
+    PUBNUB_ASSERT_OPT(queue != NULL);
+
+    while (NULL
+           != (batch = (pubnub_t*)pubnub_atomic_exchange_ptr(&queue->head,
+                                                             NULL))) {
+        process_batch(batch);
     }
-    pubnub_mutex_unlock(queue->monitor);
 }
@@ -2,7 +2,7 @@
 #if !defined(INC_PBPAL_NTF_CALLBACK_QUEUE)
 #define INC_PBPAL_NTF_CALLBACK_QUEUE
 
-#include "pubnub_mutex.h"
+#include "pubnub_api_types.h"
 
 
 /** @file pbpal_ntf_callback_queue.h
@@ -19,17 +19,30 @@
  */
 
 
-#define PBPAL_NTF_CALLBACK_QUEUE_LIMIT 1024
+/** States of a context w.r.t. the queue (`pubnub_t::queue_state`) */
+enum pbpal_ntf_callback_queue_state {
+    /** Not in the queue */
+    PBPAL_NTF_CALLBACK_QUEUE_NOT_QUEUED,
+    /** In the queue, will be processed */
+    PBPAL_NTF_CALLBACK_QUEUE_QUEUED,
+    /** In the queue, but removed from it, so will be skipped */
+    PBPAL_NTF_CALLBACK_QUEUE_REMOVED
+};
+
+/** The queue data. It's a lock-free, intrusive, "multiple producers,
+    single consumer" queue of contexts, linked through
+    `pubnub_t::queue_next`. Producers push to the (LIFO) list at @p
+    head, while the consumer takes the whole list at once and
+    processes it in FIFO order.
 
-/** The queue data. It's a simple circular buffer of (pointers to)
-    contexts, with a mutex as a monitor for multithreading.
+    Since it's intrusive, it has no capacity limit and never allocates.
+    Each context carries its own state (`pubnub_t::queue_state`), so
+    it is never in the queue more than once and checking that takes
+    no searching.
  */
 struct pbpal_ntf_callback_queue {
-    pubnub_mutex_t monitor;
-    size_t         size;
-    size_t         head;
-    size_t         tail;
-    pubnub_t*      apb[PBPAL_NTF_CALLBACK_QUEUE_LIMIT];
+    /** Last pushed context (a `pubnub_t*`), NULL if queue is empty */
+    void* volatile head;
 };
 
 
@@ -41,7 +54,10 @@ void pbpal_ntf_callback_queue_init(struct pbpal_ntf_callback_queue* queue);
 void pbpal_ntf_callback_queue_deinit(struct pbpal_ntf_callback_queue* queue);
 
 
-/** Enqueue Pubnub context @p pb for processing in the @p queue */
+/** Enqueue Pubnub context @p pb for processing in the @p queue. If
+    it's already in the queue, it stays there (only once).
+    @return +1: context enqueued (it will be processed)
+ */
 int pbpal_ntf_callback_enqueue_for_processing(struct pbpal_ntf_callback_queue* queue,
                                               pubnub_t* pb);
 
@@ -49,17 +65,27 @@ int pbpal_ntf_callback_enqueue_for_processing(struct pbpal_ntf_callback_queue* q
 /** Requeue Pubnub context @p pb for processing in the @p queue. That
     is, if context is already in queue, let it be. If it's not,
     enqueue it.
+    @retval 0 context was already in the queue
+    @retval +1 context enqueued
  */
 int pbpal_ntf_callback_requeue_for_processing(struct pbpal_ntf_callback_queue* queue,
                                               pubnub_t* pb);
 
 
-/** Remove Pubnub context @p pb from @p queue */
+/** Remove Pubnub context @p pb from @p queue. It is not unlinked,
+    just marked as removed, so it will be skipped when processing,
+    unless it is enqueued again.
+ */
 void pbpal_ntf_callback_remove_from_queue(struct pbpal_ntf_callback_queue* queue,
                                           pubnub_t*                        pb);
 
 
-/** Process all the context in the @p queue. */
+/** Process all the context in the @p queue, until it's empty. The
+    contexts are taken from the queue in batches - all that are in the
+    queue at the time - so producers and the consumer contend only
+    once per batch. Must be called from one thread at a time (the
+    "consumer").
+ */
 void pbpal_ntf_callback_process_queue(struct pbpal_ntf_callback_queue* queue);
 
 
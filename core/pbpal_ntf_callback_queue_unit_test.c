@@ -0,0 +1,205 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include "pubnub_internal.h"
+#include "pbpal_ntf_callback_queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* A less chatty cgreen :) */
+
+#define attest assert_that
+#define equals is_equal_to
+#define differs is_not_equal_to
+
+
+#define MAX_PROCESSED 2048
+
+static struct pbpal_ntf_callback_queue m_queue;
+
+/* Contexts in the order they were processed */
+static pubnub_t* m_processed[MAX_PROCESSED];
+static size_t    m_processed_count;
+
+/* Context to requeue when it's processed (from "inside" the FSM) */
+static pubnub_t* m_requeue_on_process;
+
+static pubnub_t* m_freed;
+
+
+int pbnc_fsm(pubnub_t* pb)
+{
+    if (m_processed_count < MAX_PROCESSED) {
+        m_processed[m_processed_count++] = pb;
+    }
+    if (pb == m_requeue_on_process) {
+        m_requeue_on_process = NULL;
+        pbpal_ntf_callback_requeue_for_processing(&m_queue, pb);
+    }
+    return 0;
+}
+
+
+void pballoc_free_at_last(pubnub_t* pb)
+{
+    m_freed = pb;
+}
+
+
+static pubnub_t* alloc_contexts(size_t n)
+{
+    pubnub_t* rslt = (pubnub_t*)calloc(n, sizeof *rslt);
+    size_t    i;
+
+    for (i = 0; i < n; ++i) {
+        pubnub_mutex_init(rslt[i].monitor);
+        rslt[i].state = PBS_IDLE;
+    }
+    return rslt;
+}
+
+
+Describe(pbpal_ntf_callback_queue);
+
+
+BeforeEach(pbpal_ntf_callback_queue)
+{
+    pbpal_ntf_callback_queue_init(&m_queue);
+    m_processed_count    = 0;
+    m_requeue_on_process = NULL;
+    m_freed              = NULL;
+}
+
+
+AfterEach(pbpal_ntf_callback_queue)
+{
+    pbpal_ntf_callback_queue_deinit(&m_queue);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, processes_in_fifo_order)
+{
+    pubnub_t* pb = alloc_contexts(3);
+
+    attest(pbpal_ntf_callback_enqueue_for_processing(&m_queue, &pb[1]), equals(+1));
+    attest(pbpal_ntf_callback_enqueue_for_processing(&m_queue, &pb[0]), equals(+1));
+    attest(pbpal_ntf_callback_enqueue_for_processing(&m_queue, &pb[2]), equals(+1));
+    pbpal_ntf_callback_process_queue(&m_queue);
+
+    attest(m_processed_count, equals(3));
+    attest(m_processed[0], equals(&pb[1]));
+    attest(m_processed[1], equals(&pb[0]));
+    attest(m_processed[2], equals(&pb[2]));
+
+    free(pb);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, context_is_queued_only_once)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    attest(pbpal_ntf_callback_requeue_for_processing(&m_queue, pb), equals(+1));
+    attest(pbpal_ntf_callback_requeue_for_processing(&m_queue, pb), equals(0));
+    attest(pbpal_ntf_callback_enqueue_for_processing(&m_queue, pb), equals(+1));
+    pbpal_ntf_callback_process_queue(&m_queue);
+    attest(m_processed_count, equals(1));
+
+    /* Once processed, it can be queued again */
+    attest(pbpal_ntf_callback_requeue_for_processing(&m_queue, pb), equals(+1));
+    pbpal_ntf_callback_process_queue(&m_queue);
+    attest(m_processed_count, equals(2));
+
+    free(pb);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, removed_context_is_skipped)
+{
+    pubnub_t* pb = alloc_contexts(2);
+
+    pbpal_ntf_callback_enqueue_for_processing(&m_queue, &pb[0]);
+    pbpal_ntf_callback_enqueue_for_processing(&m_queue, &pb[1]);
+    pbpal_ntf_callback_remove_from_queue(&m_queue, &pb[0]);
+    pbpal_ntf_callback_process_queue(&m_queue);
+
+    attest(m_processed_count, equals(1));
+    attest(m_processed[0], equals(&pb[1]));
+
+    /* Removing a context that is not in the queue is harmless */
+    pbpal_ntf_callback_remove_from_queue(&m_queue, &pb[0]);
+    pbpal_ntf_callback_process_queue(&m_queue);
+    attest(m_processed_count, equals(1));
+
+    free(pb);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, removed_context_can_be_queued_again)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    pbpal_ntf_callback_enqueue_for_processing(&m_queue, pb);
+    pbpal_ntf_callback_remove_from_queue(&m_queue, pb);
+    attest(pbpal_ntf_callback_requeue_for_processing(&m_queue, pb), equals(+1));
+    pbpal_ntf_callback_process_queue(&m_queue);
+
+    attest(m_processed_count, equals(1));
+    attest(m_processed[0], equals(pb));
+
+    free(pb);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, context_requeued_while_processed_is_processed_again)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    m_requeue_on_process = pb;
+    pbpal_ntf_callback_enqueue_for_processing(&m_queue, pb);
+    pbpal_ntf_callback_process_queue(&m_queue);
+
+    attest(m_processed_count, equals(2));
+    attest(m_processed[0], equals(pb));
+    attest(m_processed[1], equals(pb));
+
+    free(pb);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, null_state_context_is_freed)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    pb->state = PBS_NULL;
+    pbpal_ntf_callback_requeue_for_processing(&m_queue, pb);
+    pbpal_ntf_callback_process_queue(&m_queue);
+
+    attest(m_processed_count, equals(0));
+    attest(m_freed, equals(pb));
+
+    free(pb);
+}
+
+
+Ensure(pbpal_ntf_callback_queue, has_no_capacity_limit)
+{
+    size_t const n  = 1500;
+    pubnub_t*    pb = alloc_contexts(n);
+    size_t       i;
+
+    for (i = 0; i < n; ++i) {
+        attest(pbpal_ntf_callback_enqueue_for_processing(&m_queue, &pb[i]),
+               equals(+1));
+    }
+    pbpal_ntf_callback_process_queue(&m_queue);
+
+    attest(m_processed_count, equals(n));
+    attest(m_processed[0], equals(&pb[0]));
+    attest(m_processed[n - 1], equals(&pb[n - 1]));
+
+    free(pb);
+}
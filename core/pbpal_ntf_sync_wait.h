@@ -0,0 +1,81 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined(INC_PBPAL_NTF_SYNC_WAIT)
+#define      INC_PBPAL_NTF_SYNC_WAIT
+
+
+/** @file pbpal_ntf_sync_wait.h
+
+    Waiting of the sync interface for the socket of a context. Instead
+    of running the transaction FSM over and over until it's done,
+    `pubnub_await()` runs it once, then waits here until the socket is
+    ready for what the FSM is waiting for (as told by
+    `pbntf_watch_in_events()` / `pbntf_watch_out_events()`), the
+    transaction times out or `pubnub_cancel()` is called.
+
+    While in `pubnub_await()`, non-blocking I/O is used (regardless of
+    pubnub_set_blocking_io()), otherwise the FSM would block on the
+    socket and could not be interrupted by `pubnub_cancel()`.
+
+    Used only if #PUBNUB_SYNC_WAIT_FOR_SOCKET is true.
+ */
+
+struct pubnub_;
+struct pbpal_ntf_callback_wakeup;
+
+
+/** Maximum number of contexts pbpal_ntf_sync_wait_any() can wait on */
+#define PBPAL_SYNC_WAIT_ANY_MAX 16
+
+
+/** Starts the waiting of `pubnub_await()` on @p pb: switches it to
+    non-blocking I/O. Should be called with the monitor of @p pb
+    locked.
+ */
+void pbpal_ntf_sync_wait_start(struct pubnub_* pb);
+
+/** Ends the waiting of `pubnub_await()` on @p pb: restores its
+    blocking I/O setting. Should be called with the monitor of @p pb
+    locked.
+ */
+void pbpal_ntf_sync_wait_stop(struct pubnub_* pb);
+
+/** Waits until the socket of @p pb is ready, @p ms milliseconds pass
+    or the wait is interrupted by pbpal_ntf_sync_wait_interrupt().
+    Should be called with the monitor of @p pb locked.
+
+    @retval 0 Done waiting, FSM should be run
+    @retval -1 Can't wait (no socket or error), FSM should be run anyway
+ */
+int pbpal_ntf_sync_wait(struct pubnub_* pb, int ms);
+
+/** Waits until the socket of any of the @p n contexts in @p pbs is
+    ready, @p ms milliseconds pass (waits until ready if @p ms < 0) or
+    @p wakeup (if not NULL) is signalled. Used to advance several
+    transactions from one thread, like the auto heartbeat watcher
+    does. Unlike pbpal_ntf_sync_wait(), should be called with the
+    monitors of the contexts _unlocked_, so that they are not held
+    while waiting.
+
+    There is no @p wakeup on Windows, so the wait there is shortened
+    to a "slice" instead.
+
+    @retval 0 Done waiting, FSMs should be run
+    @retval -1 Can't wait (a context has no socket, or error), FSMs
+    should be run anyway
+ */
+int pbpal_ntf_sync_wait_any(struct pubnub_* const*            pbs,
+                            unsigned                          n,
+                            struct pbpal_ntf_callback_wakeup* wakeup,
+                            int                               ms);
+
+/** Gets the waiting for the socket of @p pb, if any, to end as soon as
+    possible. Should be called with the `cancel_monitor` of @p pb
+    locked.
+ */
+void pbpal_ntf_sync_wait_interrupt(struct pubnub_* pb);
+
+/** Releases the resources used for waiting on the socket of @p pb */
+void pbpal_ntf_sync_wait_deinit(struct pubnub_* pb);
+
+
+#endif  /* !defined(INC_PBPAL_NTF_SYNC_WAIT) */
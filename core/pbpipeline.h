@@ -0,0 +1,65 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBPIPELINE
+#define INC_PBPIPELINE
+
+#if PUBNUB_USE_PIPELINING
+
+#include "core/pubnub_api_types.h"
+
+#include <stdbool.h>
+
+
+/** Returns whether the current transaction of @p pb is a pipelined
+    one.
+ */
+bool pbpipeline_active(pubnub_t const* pb);
+
+/** To be called when a request of @p pb was sent (without a body), to
+    prepare the next one to pipeline, if any. If it returns true, the
+    next request is in the HTTP buffer, to be sent right away.
+ */
+bool pbpipeline_prepare_next_request(pubnub_t* pb);
+
+/** To be called when a response was read on the connection of @p pb
+    and the connection should be kept alive. If there are more
+    responses to read on it, returns true - @p pb should then read the
+    next response. The outcome of the (pipelined) transaction that was
+    answered is reported from pbpipeline_should_resume().
+ */
+bool pbpipeline_next_response(pubnub_t* pb);
+
+/** To be called when the connection of @p pb was lost while sending
+    requests or reading responses. If pipelined requests were sent on
+    it, those that are not idempotent are marked to fail when it's
+    their turn. If the current one is idempotent, prepares it to be
+    sent again and returns true - @p pb should then close the
+    connection and make a new one (as if the connection was kept
+    alive). Otherwise, returns false and the current one fails.
+ */
+bool pbpipeline_connection_lost(pubnub_t* pb);
+
+/** To be called when a transaction of @p pb ended, before its
+    outcome is reported.
+ */
+void pbpipeline_trans_ended(pubnub_t* pb);
+
+/** To be called after the outcome of a transaction of @p pb was
+    reported, to start the next queued request, if any.
+ */
+void pbpipeline_dispatch(pubnub_t* pb);
+
+/** To be called when the FSM of @p pb is done with a state. Reports
+    the outcome of a pipelined transaction that was answered, if any,
+    and returns whether the FSM should go on reading the next
+    response (it shouldn't if the callback cancelled). Resets the
+    indication.
+ */
+bool pbpipeline_should_resume(pubnub_t* pb);
+
+/** Frees all the requests queued on @p pb */
+void pbpipeline_free(pubnub_t* pb);
+
+
+#endif /* PUBNUB_USE_PIPELINING */
+
+#endif /* !defined INC_PBPIPELINE */
@@ -0,0 +1,32 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBPUBLISH_QUEUE
+#define INC_PBPUBLISH_QUEUE
+
+#if PUBNUB_USE_PUBLISH_QUEUE
+
+#include "core/pubnub_api_types.h"
+
+
+/** Initializes the (empty) publish queue of @p pb */
+void pbpublish_queue_init(pubnub_t* pb);
+
+/** To be called when a transaction of @p pb ended, before its
+    outcome is reported.
+ */
+void pbpublish_queue_trans_ended(pubnub_t* pb);
+
+/** To be called after the outcome of a transaction of @p pb was
+    reported, to start the next queued publish, if any.
+ */
+void pbpublish_queue_dispatch(pubnub_t* pb);
+
+/** Frees all the publishes queued on @p pb, without reporting them,
+    and the rest of the queue. Those waiting for room in it fail, and
+    this waits for them to stop waiting. Call with the monitor of
+    @p pb locked (once). */
+void pbpublish_queue_free(pubnub_t* pb);
+
+
+#endif /* PUBNUB_USE_PUBLISH_QUEUE */
+
+#endif /* !defined INC_PBPUBLISH_QUEUE */
@@ -0,0 +1,50 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBSUBSCRIBE_V2_STREAM
+#define INC_PBSUBSCRIBE_V2_STREAM
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+
+#include "core/pubnub_api_types.h"
+
+#include <stdbool.h>
+
+
+/** Returns whether the body of the response being received by @p pb
+    would be streamed (parsed and given to the user as it is received),
+    as far as it's known from the response headers received so far.
+ */
+bool pbsubscribe_v2_stream_wanted(pubnub_t const* pb);
+
+/** To be called when all the response headers were received by
+    @p pb, to start streaming the body, if it should be. If it
+    was wanted, but can't be streamed, the reply buffer is
+    allocated for the whole body (of known length), like it would
+    be if it was not wanted.
+
+    @retval 0 OK
+    @retval -1 Failed to allocate the reply buffer
+ */
+int pbsubscribe_v2_stream_start(pubnub_t* pb);
+
+/** Returns whether the body of the response being received by @p pb
+    is streamed.
+ */
+bool pbsubscribe_v2_streaming(pubnub_t const* pb);
+
+/** To be called when a piece of the (streamed) body was received in
+    the reply buffer of @p pb, to give the messages received so far
+    to the user and drop them from the reply buffer.
+
+    @return The number of octets dropped from the reply buffer
+ */
+unsigned pbsubscribe_v2_stream_feed(pubnub_t* pb);
+
+/** To be called when the (successful) response was parsed as a whole,
+    to give the messages that were not streamed to the user.
+ */
+void pbsubscribe_v2_stream_rest(pubnub_t* pb);
+
+
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
+#endif /* !defined INC_PBSUBSCRIBE_V2_STREAM */
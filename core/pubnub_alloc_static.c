@@ -4,6 +4,13 @@
 #include "pubnub_assert.h"
 
 #include "pbpal.h"
+#include "pbpal_ntf_sync_wait.h"
+#if PUBNUB_USE_PIPELINING
+#include "pbpipeline.h"
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+#include "pbpublish_queue.h"
+#endif
 #ifdef PUBNUB_NTF_RUNTIME_SELECTION
 #include "pubnub_ntf_enforcement.h"
 #endif
@@ -55,11 +62,23 @@ void pballoc_free_at_last(pubnub_t* pb)
 
     PUBNUB_ASSERT_OPT(pb->state == PBS_NULL);
 
+#if PUBNUB_USE_PIPELINING
+    pbpipeline_free(pb);
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+    pbpublish_queue_free(pb);
+#endif
+#if PUBNUB_USE_GZIP_COMPRESSION
+    pbgzip_compress_free(pb);
+#endif
     pbcc_deinit(&pb->core);
     pbpal_free(pb);
     pubnub_mutex_unlock(pb->monitor);
     pubnub_mutex_destroy(pb->monitor);
 #if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pbpal_ntf_sync_wait_deinit(pb);
+#endif
     pubnub_mutex_destroy(pb->cancel_monitor);
 #endif
 #if PUBNUB_USE_AUTO_HEARTBEAT
@@ -0,0 +1,52 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_ATOMIC
+#define      INC_PUBNUB_ATOMIC
+
+
+/** @file pubnub_atomic.h
+
+    Minimal set of atomic operations, for the (few) places where we
+    don't want to take a mutex. All operations are "sequentially
+    consistent" (full barrier).
+
+    Atomic integers are `long`, atomic pointers are `void*`, both
+    should be declared `volatile`. pubnub_atomic_add() returns the new
+    value.
+ */
+
+
+#if defined(_MSC_VER)
+
+#include <windows.h>
+
+#define pubnub_atomic_load(p) InterlockedCompareExchange((p), 0, 0)
+#define pubnub_atomic_exchange(p, v) InterlockedExchange((p), (v))
+#define pubnub_atomic_add(p, v) (InterlockedExchangeAdd((p), (v)) + (v))
+#define pubnub_atomic_cas(p, expected, desired)                                \
+    (InterlockedCompareExchange((p), (desired), (expected)) == (expected))
+
+#define pubnub_atomic_load_ptr(p) InterlockedCompareExchangePointer((p), NULL, NULL)
+#define pubnub_atomic_exchange_ptr(p, v) InterlockedExchangePointer((p), (v))
+#define pubnub_atomic_cas_ptr(p, expected, desired)                            \
+    (InterlockedCompareExchangePointer((p), (desired), (expected))             \
+     == (expected))
+
+#elif defined(__GNUC__) || defined(__clang__)
+
+#define pubnub_atomic_load(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define pubnub_atomic_exchange(p, v) __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define pubnub_atomic_add(p, v) __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define pubnub_atomic_cas(p, expected, desired)                                \
+    __sync_bool_compare_and_swap((p), (expected), (desired))
+
+#define pubnub_atomic_load_ptr(p) pubnub_atomic_load(p)
+#define pubnub_atomic_exchange_ptr(p, v) pubnub_atomic_exchange((p), (v))
+#define pubnub_atomic_cas_ptr(p, expected, desired)                            \
+    pubnub_atomic_cas((p), (expected), (desired))
+
+#else
+#error Atomic operations are not available for this compiler
+#endif
+
+
+#endif /* !defined INC_PUBNUB_ATOMIC */
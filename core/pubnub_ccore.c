@@ -24,7 +24,7 @@ static enum pubnub_res simple_parse_response(struct pbcc_context* p)
 
     el.start = reply;
     el.end   = reply + replylen;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    if (403 == pbcc_classify_response(&el).status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Access denied:\n  - response: %.*s",
@@ -61,16 +61,16 @@ enum pubnub_res pbcc_parse_history_response(struct pbcc_context* p)
 
 enum pubnub_res pbcc_parse_presence_response(struct pbcc_context* p)
 {
-    struct pbjson_elem                   el;
-    struct pbjson_elem                   parsed;
-    enum pbjson_object_name_parse_result json_rslt;
-    char*                                reply    = p->http_reply;
-    int                                  replylen = p->http_buf_len;
+    struct pbjson_elem         el;
+    struct pbcc_response_class rclass;
+    char*                      reply    = p->http_reply;
+    int                        replylen = p->http_buf_len;
     if (replylen < 2) { return PNR_FORMAT_ERROR; }
 
     el.start = reply;
     el.end   = reply + replylen;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    rclass   = pbcc_classify_response(&el);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Presence access denied:\n  - response: %.*s",
@@ -79,22 +79,19 @@ enum pubnub_res pbcc_parse_presence_response(struct pbcc_context* p)
         return PNR_ACCESS_DENIED;
     }
 
-    if ((reply[0] != '{') || (reply[replylen - 1] != '}')) {
+    if ((rclass.shape != pbrsObject) || (reply[replylen - 1] != '}')) {
         return PNR_FORMAT_ERROR;
     }
 
     /* Check for error field (typically present when status is 400) */
-    json_rslt = pbjson_get_object_value(&el, "error", &parsed);
-    if (jonmpOK == json_rslt) {
+    if (rclass.error.start != NULL) {
         /* Server returned an error - try to extract the message */
-        struct pbjson_elem msg_elem;
-        json_rslt = pbjson_get_object_value(&el, "message", &msg_elem);
-        if (jonmpOK == json_rslt) {
+        if (rclass.message.start != NULL) {
             PBCC_LOG_ERROR(
                 p->logger_manager,
                 "Service returned error: %.*s",
-                (int)(msg_elem.end - msg_elem.start),
-                msg_elem.start);
+                (int)(rclass.message.end - rclass.message.start),
+                rclass.message.start);
         }
         else {
             PBCC_LOG_ERROR(
@@ -117,13 +114,13 @@ enum pubnub_res pbcc_parse_presence_response(struct pbcc_context* p)
 
 enum pubnub_res pbcc_parse_channel_registry_response(struct pbcc_context* p)
 {
-    enum pbjson_object_name_parse_result result;
-    struct pbjson_elem                   el;
-    struct pbjson_elem                   found;
+    struct pbjson_elem         el;
+    struct pbcc_response_class rclass;
 
     el.start = p->http_reply;
     el.end   = p->http_reply + p->http_buf_len;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    rclass   = pbcc_classify_response(&el);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Channel registry access denied:\n  - response: %.*s",
@@ -140,9 +137,10 @@ enum pubnub_res pbcc_parse_channel_registry_response(struct pbcc_context* p)
        with value "channel-registry".  Maybe even that there is a key
        "status" (with value 200).
     */
-    result = pbjson_get_object_value(&el, "error", &found);
-    if (jonmpOK == result) {
-        if (pbjson_elem_equals_string(&found, "false")) { return PNR_OK; }
+    if (rclass.error.start != NULL) {
+        if (pbjson_elem_equals_string(&rclass.error, "false")) {
+            return PNR_OK;
+        }
         else {
             return PNR_CHANNEL_REGISTRY_ERROR;
         }
@@ -27,6 +27,11 @@
 #include <stdlib.h>
 
 
+/** Number of (top level) array separators that pbcc_split_array()
+    looks for at once */
+#define PBCC_SPLIT_ARRAY_CHUNK 32
+
+
 void pbcc_init(
     struct pbcc_context* p,
     const char*          publish_key,
@@ -43,10 +48,12 @@ void pbcc_init(
     p->sdk_version_suffix = NULL;
     p->msg_ofs            = p->msg_end = 0;
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
-    p->http_reply = NULL;
+    p->http_reply      = NULL;
+    p->http_reply_size = 0;
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
-    p->decomp_buf_size   = (size_t)0;
-    p->decomp_http_reply = NULL;
+    p->decomp_buf_size        = (size_t)0;
+    p->decomp_http_reply      = NULL;
+    p->decomp_http_reply_size = 0;
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 #endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
     p->message_to_send = NULL;
@@ -121,12 +128,14 @@ void pbcc_deinit(struct pbcc_context* p)
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
     if (p->http_reply != NULL) {
         free(p->http_reply);
-        p->http_reply = NULL;
+        p->http_reply      = NULL;
+        p->http_reply_size = 0;
     }
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
     if (p->decomp_http_reply != NULL) {
         free(p->decomp_http_reply);
-        p->decomp_http_reply = NULL;
+        p->decomp_http_reply      = NULL;
+        p->decomp_http_reply_size = 0;
     }
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 #endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
@@ -162,9 +171,21 @@ void pbcc_deinit(struct pbcc_context* p)
 int pbcc_realloc_reply_buffer(struct pbcc_context* p, unsigned bytes)
 {
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
-    char* newbuf = (char*)realloc(p->http_reply, bytes + 1);
+    size_t size;
+    char*  newbuf;
+
+    if (bytes < p->http_reply_size) { return 0; }
+    size = p->http_reply_size + p->http_reply_size / 2;
+    if (size < (size_t)bytes + 1) { size = (size_t)bytes + 1; }
+    newbuf = (char*)realloc(p->http_reply, size);
+    if ((NULL == newbuf) && (size > (size_t)bytes + 1)) {
+        /* Maybe there's enough memory for just what's needed */
+        size   = (size_t)bytes + 1;
+        newbuf = (char*)realloc(p->http_reply, size);
+    }
     if (NULL == newbuf) { return -1; }
-    p->http_reply = newbuf;
+    p->http_reply      = newbuf;
+    p->http_reply_size = size;
     return 0;
 #else
     if (bytes < sizeof p->http_reply / sizeof p->http_reply[0]) { return 0; }
@@ -180,12 +201,38 @@ bool pbcc_ensure_reply_buffer(struct pbcc_context* p)
         /* Need just one byte for string end */
         p->http_reply = (char*)malloc(1);
         if (NULL == p->http_reply) { return false; }
+        p->http_reply_size = 1;
     }
 #endif
     return true;
 }
 
 
+void pbcc_trim_reply_buffer(struct pbcc_context* p, size_t bytes)
+{
+#if PUBNUB_DYNAMIC_REPLY_BUFFER
+    if (p->http_reply_size > bytes + 1) {
+        char* newbuf = (char*)realloc(p->http_reply, bytes + 1);
+        if (newbuf != NULL) {
+            p->http_reply      = newbuf;
+            p->http_reply_size = bytes + 1;
+        }
+    }
+#if PUBNUB_RECEIVE_GZIP_RESPONSE
+    if (p->decomp_http_reply_size > bytes + 1) {
+        free(p->decomp_http_reply);
+        p->decomp_http_reply      = NULL;
+        p->decomp_http_reply_size = 0;
+        p->decomp_buf_size        = 0;
+    }
+#endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
+#else
+    PUBNUB_UNUSED(p);
+    PUBNUB_UNUSED(bytes);
+#endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
+}
+
+
 char const* pbcc_get_msg(struct pbcc_context* pb)
 {
 #if PUBNUB_CRYPTO_API
@@ -283,39 +330,86 @@ static int find_string_start(char const* buf, int len)
 
 bool pbcc_split_array(char* buf)
 {
-    bool escaped       = false;
-    bool in_string     = false;
-    int  bracket_level = 0;
-
-    for (; *buf != '\0'; ++buf) {
-        if (escaped) { escaped = false; }
-        else if ('"' == *buf) {
-            in_string = !in_string;
+    char const* const end = buf + strlen(buf);
+    size_t            sep[PBCC_SPLIT_ARRAY_CHUNK];
+    bool              complete;
+
+    /* Separators are found a chunk at a time, the next chunk from
+       after the last separator of the previous one */
+    for (;;) {
+        size_t const n = pbjson_find_array_separators(
+            buf, end, sep, PBCC_SPLIT_ARRAY_CHUNK, &complete);
+        size_t i;
+        for (i = 0; i < n; ++i) {
+            buf[sep[i]] = '\0';
+        }
+        if (n < PBCC_SPLIT_ARRAY_CHUNK) { break; }
+        buf += sep[n - 1] + 1;
+    }
+
+    return complete;
+}
+
+
+/** Returns the (HTTP like) status code in @p value, 0 if it's not
+    an integer number, in the same form "status" is compared to.
+ */
+static int status_code(struct pbjson_elem const* value)
+{
+    char const* s;
+    int         code = 0;
+
+    if ((value->start == value->end) || ('0' == *value->start)) { return 0; }
+    for (s = value->start; s < value->end; ++s) {
+        if ((*s < '0') || (*s > '9') || (code > 99999)) { return 0; }
+        code = code * 10 + (*s - '0');
+    }
+
+    return code;
+}
+
+
+struct pbcc_response_class pbcc_classify_response(struct pbjson_elem const* el)
+{
+    struct pbcc_response_class rslt;
+    struct pbjson_elem         key;
+    struct pbjson_elem         value;
+    char const*                cursor = NULL;
+    bool                       first;
+    bool                       status = false;
+    char const*                s;
+
+    memset(&rslt, 0, sizeof rslt);
+    s = pbjson_skip_whitespace(el->start, el->end);
+    if (s == el->end) { return rslt; }
+    if ('[' == *s) {
+        rslt.shape = pbrsArray;
+        return rslt;
+    }
+    if (*s != '{') { return rslt; }
+
+    rslt.shape = pbrsObject;
+    for (first = true;
+         jonmpOK == pbjson_get_next_key_value(el, &cursor, &key, &value);
+         first = false) {
+        size_t const len = key.end - key.start;
+        if (first && (1 == len) && ('t' == *key.start)) {
+            rslt.shape = pbrsEnvelope;
+            break;
         }
-        else if (in_string) {
-            escaped = ('\\' == *buf);
+        if ((6 == len) && (0 == memcmp(key.start, "status", 6))) {
+            if (!status) { rslt.status = status_code(&value); }
+            status = true;
         }
-        else {
-            switch (*buf) {
-            case '[':
-            case '{':
-                bracket_level++;
-                break;
-            case ']':
-            case '}':
-                bracket_level--;
-                break;
-            /* if at root, split! */
-            case ',':
-                if (bracket_level == 0) { *buf = '\0'; }
-                break;
-            default:
-                break;
-            }
+        else if ((5 == len) && (0 == memcmp(key.start, "error", 5))) {
+            if (NULL == rslt.error.start) { rslt.error = value; }
+        }
+        else if ((7 == len) && (0 == memcmp(key.start, "message", 7))) {
+            if (NULL == rslt.message.start) { rslt.message = value; }
         }
     }
 
-    return !(escaped || in_string || (bracket_level > 0));
+    return rslt;
 }
 
 
@@ -328,7 +422,7 @@ enum pubnub_res pbcc_parse_publish_response(struct pbcc_context* p)
 
     el.start = reply;
     el.end   = reply + replylen;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    if (403 == pbcc_classify_response(&el).status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Publish access denied:\n  - response: %.*s",
@@ -360,16 +454,18 @@ enum pubnub_res pbcc_parse_publish_response(struct pbcc_context* p)
 
 enum pubnub_res pbcc_parse_subscribe_response(struct pbcc_context* p)
 {
-    struct pbjson_elem el;
-    int                i;
-    int                previous_i;
-    unsigned           time_token_length;
-    char*              reply    = p->http_reply;
-    int                replylen = p->http_buf_len;
+    struct pbjson_elem         el;
+    struct pbcc_response_class rclass;
+    int                        i;
+    int                        previous_i;
+    unsigned                   time_token_length;
+    char*                      reply    = p->http_reply;
+    int                        replylen = p->http_buf_len;
     if (replylen < 2) { return PNR_FORMAT_ERROR; }
     el.start = reply;
     el.end   = reply + replylen;
-    if (pbjson_value_for_field_found(&el, "status", "403")) {
+    rclass   = pbcc_classify_response(&el);
+    if (403 == rclass.status) {
         PBCC_LOG_ERROR(
             p->logger_manager,
             "Subscribe access denied:\n  - response: %.*s",
@@ -378,12 +474,10 @@ enum pubnub_res pbcc_parse_subscribe_response(struct pbcc_context* p)
         return PNR_ACCESS_DENIED;
     }
 
-    if (pbjson_value_for_field_found(&el, "status", "400")) {
-        char* msgtext = (char*)pbjson_get_status_400_message_value(&el);
-        if (msgtext != NULL && strcmp(
-                                   msgtext,
-                                   "\"Channel group or groups result in empty "
-                                   "subscription set\"") == 0) {
+    if (400 == rclass.status) {
+        if (pbjson_elem_equals_string(&rclass.message,
+                                      "\"Channel group or groups result in "
+                                      "empty subscription set\"")) {
             return PNR_GROUP_EMPTY;
         }
         else {
@@ -22,6 +22,7 @@
 #include "pubnub_config.h"
 #include "pubnub_api_types.h"
 #include "pubnub_generate_uuid.h"
+#include "pubnub_json_parse.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
@@ -42,6 +43,50 @@
 
 #endif // PUBNUB_CRYPTO_API
 
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+/** States of parsing a subscribe V2 response as it is received */
+enum pbcc_subscribe_v2_stream_state {
+    /** Not parsing, the response is received as a whole */
+    pbsv2sIdle,
+    /** In the response object, looking for the message array */
+    pbsv2sEnvelope,
+    /** In the message array, between messages */
+    pbsv2sArray,
+    /** In a message (object) */
+    pbsv2sMessage,
+    /** Past the message array, nothing more to parse */
+    pbsv2sDone
+};
+
+/** Parser of a subscribe V2 response, as it is received */
+struct pbcc_subscribe_v2_stream {
+    enum pbcc_subscribe_v2_stream_state state;
+    /** Offset (in the reply) of the next octet to parse */
+    unsigned scan_ofs;
+    /** Offset of the first octet after the `[` of the message array */
+    unsigned array_ofs;
+    /** Offset of the first octet (after `array_ofs`) that was not
+        given to the user (or is not a separator) */
+    unsigned drop_ofs;
+    /** Offset of the start of the message being parsed */
+    unsigned msg_start;
+    /** Offset of the start of the last key of the response object */
+    unsigned key_ofs;
+    /** Depth of object/array nesting at `scan_ofs` */
+    unsigned level;
+    /** Parsing a string */
+    bool in_string;
+    /** Previous octet was an escape (`\`) in a string */
+    bool escaped;
+    /** Next string (in the response object) is a key */
+    bool expect_key;
+    /** Parsing a key of the response object */
+    bool in_key;
+    /** The value to parse next is that of the "m" key */
+    bool key_is_m;
+};
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
 /** The Pubnub "(C) core" context, contains context data
     that is shared among all Pubnub C clients.
  */
@@ -120,8 +165,12 @@ struct pbcc_context
 
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
     char* http_reply;
+    /** The size of the memory allocated for `http_reply` */
+    size_t http_reply_size;
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
     char* decomp_http_reply;
+    /** The size of the memory allocated for `decomp_http_reply` */
+    size_t decomp_http_reply_size;
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 #else
     /** The contents of a HTTP reply/reponse */
@@ -145,6 +194,11 @@ struct pbcc_context
     */
     unsigned chan_ofs, chan_end;
 
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+    /** Parser of the subscribe V2 response being received */
+    struct pbcc_subscribe_v2_stream v2_stream;
+#endif
+
 #if PUBNUB_USE_RETRY_CONFIGURATION
     /** Pointer to the configuration with failed request handling details. */
     pubnub_retry_configuration_t* retry_configuration;
@@ -490,11 +544,19 @@ void pbcc_init(struct pbcc_context* pbcc,
 void pbcc_deinit(struct pbcc_context* p);
 
 /** Reallocates the reply buffer in the C core context @p p to have
-    @p bytes.
+    (at least) @p bytes. It is grown geometrically, and never shrunk,
+    so that a reply received piece by piece (chunk by chunk) doesn't
+    get reallocated and copied for each piece.
     @return 0: OK, allocated, -1: failed
 */
 int pbcc_realloc_reply_buffer(struct pbcc_context* p, unsigned bytes);
 
+/** Shrinks the reply buffers in the C core context @p p (if larger)
+    to have @p bytes, dropping the data beyond those. Does nothing if
+    reply buffer is not dynamic.
+*/
+void pbcc_trim_reply_buffer(struct pbcc_context* p, size_t bytes);
+
 /** Ensures existence of reply buffer in the C core context @p p
     in special cases when no: 'Content-Length:', nor 'Transfer-Encoding:
    chunked' header line has been received.
@@ -598,6 +660,43 @@ enum pubnub_res pbcc_subscribe_prep(struct pbcc_context* p,
 bool pbcc_split_array(char* buf);
 
 
+/** The shape of the top level of a response */
+enum pbcc_response_shape {
+    /** Neither a JSON array nor a JSON object */
+    pbrsOther,
+    /** A JSON array, like the publish or time response */
+    pbrsArray,
+    /** A JSON object with the "t" (timetoken) key first, like the
+        subscribe V2 response. It is not an error object, so its other
+        keys are not looked at. */
+    pbrsEnvelope,
+    /** Any other JSON object, which may be an error object */
+    pbrsObject
+};
+
+/** The outcome of classifying a response with pbcc_classify_response() */
+struct pbcc_response_class {
+    enum pbcc_response_shape shape;
+    /** The "status" of an object, 0 if it has none, or it's not an
+        (integer) number */
+    int status;
+    /** The value of the "error" key of an object, `start` is NULL if
+        it has none */
+    struct pbjson_elem error;
+    /** The value of the "message" key of an object, `start` is NULL
+        if it has none */
+    struct pbjson_elem message;
+};
+
+/** Classifies the response in @p el, getting the keys of an error
+    object ("status", "error" and "message"), if it is one, all in one
+    pass, so that parsers don't have to look for each of them from the
+    start of the response. Keys are got as pbjson_get_object_value()
+    would get them.
+ */
+struct pbcc_response_class pbcc_classify_response(struct pbjson_elem const* el);
+
+
 enum pubnub_res pbcc_append_url_param(struct pbcc_context* pb,
                                       char const* param_name,
                                       size_t param_name_len,
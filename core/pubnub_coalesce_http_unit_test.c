@@ -0,0 +1,174 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+#include "test/pubnub_test_mocks.h"
+#include "test/pubnub_test_helper.h"
+
+#include "pubnub_internal.h"
+#include "pubnub_version_internal.h"
+#include "pubnub_pubsubapi.h"
+#include "pubnub_coreapi.h"
+#include "pubnub_coreapi_ex.h"
+#include "pubnub_netcore.h"
+#include "pbpal.h"
+
+#include <string.h>
+
+
+/* A less chatty cgreen :) */
+
+#define attest assert_that
+#define equals is_equal_to
+#define streqs is_equal_to_string
+#define returns will_return
+
+
+#if !PUBNUB_COALESCE_HTTP_REQUEST
+#error Build this test with PUBNUB_COALESCE_HTTP_REQUEST=1
+#endif
+
+
+static pubnub_t* pbp;
+
+
+#define USER_AGENT "POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
+#define FIN_HEAD(uagent) "\r\nUser-Agent: " uagent "\r\n" ACCEPT_ENCODING "\r\n"
+#define TIME_URL "/time/0?pnsdk=unit-test-0.1&uuid=test_id"
+#define PUBLISH_POST_URL                                                       \
+    "/publish/pubkey/subkey/0/ch/0?pnsdk=unit-test-0.1&uuid=test_id"
+#define PUBLISH_RESPONSE                                                       \
+    "HTTP/1.1 200\r\nContent-Length: 30\r\n\r\n[1,\"Sent\",\"17000000000000000\"]"
+
+
+/** Expects @p request to be sent, in one piece, and sent right away */
+static void expect_sent_at_once(char const* request)
+{
+    expect(pbpal_send,
+           when(data, is_equal_to_contents_of(request, strlen(request))),
+           when(n, equals(strlen(request))),
+           returns(0));
+    expect(pbpal_send_status, returns(0));
+}
+
+
+/** Expects the response to be waited for, and the transaction to end
+    with it
+ */
+static void expect_response(char const* response)
+{
+    expect(pbntf_watch_in_events, when(pb, equals(pbp)), returns(0));
+    incoming(response, NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+}
+
+
+Describe(coalesce_http);
+
+
+BeforeEach(coalesce_http)
+{
+    pubnub_setup_mocks(&pbp);
+    pubnub_origin_set(pbp, NULL);
+    pubnub_init(pbp, "pubkey", "subkey");
+    pubnub_set_user_id(pbp, "test_id");
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+}
+
+
+AfterEach(coalesce_http)
+{
+    pubnub_cleanup_mocks(pbp);
+}
+
+
+Ensure(coalesce_http, sends_get_request_at_once)
+{
+    expect_sent_at_once("GET " TIME_URL " HTTP/1.1\r\nHost: " PUBNUB_ORIGIN
+                            FIN_HEAD(USER_AGENT));
+    expect_response("HTTP/1.1 200\r\nContent-Length: 9\r\n\r\n[1643092]");
+    attest(pubnub_time(pbp), equals(PNR_OK));
+    attest(pubnub_get(pbp), streqs("1643092"));
+}
+
+
+Ensure(coalesce_http, sends_post_request_with_its_body_at_once)
+{
+    struct pubnub_publish_options opts = pubnub_publish_defopts();
+
+    opts.method = pubnubSendViaPOST;
+    expect_sent_at_once(
+        "POST " PUBLISH_POST_URL " HTTP/1.1\r\nHost: " PUBNUB_ORIGIN
+        "\r\nContent-Type: application/json\r\nContent-Length: 4" FIN_HEAD(
+            USER_AGENT) "\"hi\"");
+    expect_response(PUBLISH_RESPONSE);
+    attest(pubnub_publish_ex(pbp, "ch", "\"hi\"", opts), equals(PNR_OK));
+}
+
+
+Ensure(coalesce_http, sends_extra_headers_at_once)
+{
+    struct pubnub_publish_options opts = pubnub_publish_defopts();
+
+    pubnub_set_sdk_version_suffix(pbp, "/unit-test-9.9");
+    opts.method = pubnubSendViaPOST;
+    expect_sent_at_once(
+        "POST /publish/pubkey/subkey/0/ch/0"
+        "?pnsdk=unit-test%2Funit-test-9.9&uuid=test_id"
+        " HTTP/1.1\r\nHost: " PUBNUB_ORIGIN
+        "\r\nContent-Type: application/json\r\nContent-Length: 4" FIN_HEAD(
+            "unit-test/unit-test-9.9") "\"hi\"");
+    expect_response(PUBLISH_RESPONSE);
+    attest(pubnub_publish_ex(pbp, "ch", "\"hi\"", opts), equals(PNR_OK));
+}
+
+
+Ensure(coalesce_http, sends_long_body_after_the_head)
+{
+    struct pubnub_publish_options opts = pubnub_publish_defopts();
+    char body[PUBNUB_COALESCE_BODY_MAXLEN + 8];
+    char head[256];
+
+    memset(body, 'x', sizeof body - 1);
+    body[0]               = '"';
+    body[sizeof body - 2] = '"';
+    body[sizeof body - 1] = '\0';
+    snprintf(head,
+             sizeof head,
+             "POST " PUBLISH_POST_URL " HTTP/1.1\r\nHost: " PUBNUB_ORIGIN
+             "\r\nContent-Type: application/json\r\nContent-Length: %u"
+                 FIN_HEAD(USER_AGENT),
+             (unsigned)strlen(body));
+
+    opts.method = pubnubSendViaPOST;
+    expect_sent_at_once(head);
+    expect_sent_at_once(body);
+    expect_response(PUBLISH_RESPONSE);
+    attest(pubnub_publish_ex(pbp, "ch", body, opts), equals(PNR_OK));
+}
+
+
+Ensure(coalesce_http, sends_piece_by_piece_if_it_doesnt_fit_in_the_buffer)
+{
+    /* The URL takes up (almost) all of the HTTP buffer, leaving no
+       room for the rest of the request after it */
+    static char msg[PUBNUB_BUF_MAXLEN - 100];
+
+    memset(msg, '1', sizeof msg - 1);
+    msg[sizeof msg - 1] = '\0';
+
+    expect(pbpal_send_str, when(s, streqs("GET ")), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str,
+           when(s, begins_with_string("/publish/pubkey/subkey/0/ch/0/111")),
+           returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send, when(data, streqs(" HTTP/1.1\r\nHost: ")), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(PUBNUB_ORIGIN)), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(FIN_HEAD(USER_AGENT))), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect_response(PUBLISH_RESPONSE);
+    attest(pubnub_publish(pbp, "ch", msg), equals(PNR_OK));
+}
@@ -0,0 +1,206 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#if PUBNUB_USE_CONNECTION_POOL
+#include "core/pubnub_connection_pool.h"
+#include "core/pbconn_pool.h"
+#else
+#error PUBNUB_USE_CONNECTION_POOL must be defined and set to 1 before compiling this file
+#endif
+
+#include "core/pubnub_assert.h"
+#if PUBNUB_USE_LOGGER
+#include "core/pbcc_logger_manager.h"
+#endif // PUBNUB_USE_LOGGER
+
+#include <string.h>
+
+
+/** Longest origin (host name, with the terminating NUL) for which
+    connections are pooled. Way more than any sane DNS name.
+ */
+#define PBCONN_POOL_ORIGIN_MAX 256
+
+
+/** What a connection is to be usable by a context */
+struct pbconn_pool_key {
+    char     origin[PBCONN_POOL_ORIGIN_MAX];
+    uint16_t port;
+#if PUBNUB_USE_SSL
+    bool useSSL;
+    bool fallbackSSL;
+    bool use_system_certificate_store;
+#endif
+};
+
+struct pbconn_pool_entry {
+    /** Whether there is a connection in this entry */
+    bool occupied;
+    struct pbconn_pool_key         key;
+    struct pbpal_pooled_connection conn;
+#if PUBNUB_ADVANCED_KEEP_ALIVE
+    /** Of the connection, as used for the "max" and "timeout"
+        keep-alive parameters of the contexts that use it */
+    time_t   t_connect;
+    unsigned count;
+#endif
+    /** When was the connection put in the pool, the bigger the later */
+    unsigned long stamp;
+};
+
+
+pubnub_mutex_static_decl_and_init(m_lock);
+static struct pbconn_pool_entry m_pool[PUBNUB_CONNECTION_POOL_SIZE]
+    pubnub_guarded_by(m_lock);
+static unsigned long m_stamp pubnub_guarded_by(m_lock);
+
+
+static bool make_key(pubnub_t const* pb, struct pbconn_pool_key* key)
+{
+    char const* origin = PUBNUB_ORIGIN;
+    size_t      len;
+
+    key->port = INITIAL_PORT_VALUE;
+#if PUBNUB_ORIGIN_SETTABLE
+    if (pb->origin != NULL) { origin = pb->origin; }
+    key->port = pb->port;
+#endif
+#if PUBNUB_PROXY_API
+    if (pb->proxy_type != pbproxyNONE) { return false; }
+#endif
+    len = strlen(origin);
+    if (len >= sizeof key->origin) { return false; }
+    memcpy(key->origin, origin, len + 1);
+#if PUBNUB_USE_SSL
+    key->useSSL                       = pb->options.useSSL;
+    key->fallbackSSL                  = pb->options.fallbackSSL;
+    key->use_system_certificate_store = pb->options.use_system_certificate_store;
+#endif
+
+    return true;
+}
+
+
+static bool key_equal(
+    struct pbconn_pool_key const* a,
+    struct pbconn_pool_key const* b)
+{
+    return (a->port == b->port)
+#if PUBNUB_USE_SSL
+           && (a->useSSL == b->useSSL) && (a->fallbackSSL == b->fallbackSSL)
+           && (a->use_system_certificate_store
+               == b->use_system_certificate_store)
+#endif
+           && (0 == strcmp(a->origin, b->origin));
+}
+
+
+bool pbconn_pool_put(pubnub_t* pb)
+{
+    struct pbconn_pool_key         key;
+    struct pbconn_pool_entry*      entry   = NULL;
+    bool                           evicted = false;
+    struct pbpal_pooled_connection evicted_conn;
+    size_t                         i;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    if (!make_key(pb, &key)) { return false; }
+    if ((pb->unreadlen != 0)
+#if PUBNUB_RECEIVE_READ_AHEAD
+        || (pb->read_ahead_pos != pb->read_ahead_len)
+#endif
+    ) {
+        /* Something left unread on the connection, can't be shared */
+        return false;
+    }
+
+    pubnub_mutex_init_static(m_lock);
+    pubnub_mutex_lock(m_lock);
+    for (i = 0; i < PUBNUB_CONNECTION_POOL_SIZE; ++i) {
+        if (!m_pool[i].occupied) {
+            entry = &m_pool[i];
+            break;
+        }
+        if ((NULL == entry) || (m_pool[i].stamp < entry->stamp)) {
+            entry = &m_pool[i];
+        }
+    }
+    if (entry->occupied) {
+        /* Pool is full, make room by closing the one idle the longest */
+        evicted      = true;
+        evicted_conn = entry->conn;
+    }
+    entry->key = key;
+    pbpal_detach_connection(pb, &entry->conn);
+#if PUBNUB_ADVANCED_KEEP_ALIVE
+    entry->t_connect = pb->keep_alive.t_connect;
+    entry->count     = pb->keep_alive.count;
+#endif
+    entry->stamp    = ++m_stamp;
+    entry->occupied = true;
+    pubnub_mutex_unlock(m_lock);
+
+    if (evicted) { pbpal_close_detached_connection(&evicted_conn); }
+    PUBNUB_LOG_TRACE(
+        pb,
+        "Gave connection to the pool%s.",
+        evicted ? ", closed the oldest one in it" : "");
+
+    return true;
+}
+
+
+bool pbconn_pool_take(pubnub_t* pb)
+{
+    struct pbconn_pool_key    key;
+    struct pbconn_pool_entry* entry = NULL;
+    size_t                    i;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    if (!pb->options.use_http_keep_alive || !make_key(pb, &key)) {
+        return false;
+    }
+
+    pubnub_mutex_init_static(m_lock);
+    pubnub_mutex_lock(m_lock);
+    /* Of the suitable, take the one idle the shortest, it's the most
+       likely to still be alive */
+    for (i = 0; i < PUBNUB_CONNECTION_POOL_SIZE; ++i) {
+        if (m_pool[i].occupied && key_equal(&m_pool[i].key, &key)
+            && ((NULL == entry) || (m_pool[i].stamp > entry->stamp))) {
+            entry = &m_pool[i];
+        }
+    }
+    if (entry != NULL) {
+        pbpal_attach_connection(pb, &entry->conn);
+#if PUBNUB_ADVANCED_KEEP_ALIVE
+        pb->keep_alive.t_connect = entry->t_connect;
+        pb->keep_alive.count     = entry->count;
+#endif
+        entry->occupied = false;
+    }
+    pubnub_mutex_unlock(m_lock);
+
+    if (NULL == entry) { return false; }
+    PUBNUB_LOG_TRACE(pb, "Borrowed connection from the pool.");
+
+    return true;
+}
+
+
+void pubnub_connection_pool_drain(void)
+{
+    size_t i;
+
+    pubnub_mutex_init_static(m_lock);
+    pubnub_mutex_lock(m_lock);
+    for (i = 0; i < PUBNUB_CONNECTION_POOL_SIZE; ++i) {
+        if (m_pool[i].occupied) {
+            pbpal_close_detached_connection(&m_pool[i].conn);
+            m_pool[i].occupied = false;
+        }
+    }
+    pubnub_mutex_unlock(m_lock);
+}
@@ -0,0 +1,46 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_CONNECTION_POOL
+#define INC_PUBNUB_CONNECTION_POOL
+
+#if PUBNUB_USE_CONNECTION_POOL
+
+#include "lib/pb_extern.h"
+
+
+/** @file pubnub_connection_pool.h
+
+    The process-wide pool of (HTTP keep-alive) connections, shared by
+    all the contexts that use HTTP keep-alive.
+
+    When a transaction ends and its connection should be kept alive,
+    instead of keeping it for itself (in "keep-alive idle" state), the
+    context gives it to the pool. When a context starts a transaction,
+    it borrows an idle connection from the pool, to the same origin,
+    port and with the same TLS/SSL settings, if there is one, instead
+    of making a new one. So, a set of contexts that are mostly idle
+    needs far fewer connections (and TLS/SSL handshakes).
+
+    Contexts that use a proxy don't use the pool.
+
+    Connections in the pool are not monitored. A connection that was
+    closed by the server while in the pool is detected by the context
+    that borrows it, which then makes a new one, like with a
+    connection kept alive by a context.
+ */
+
+
+/** Closes all the idle connections in the pool. Connections that are
+    borrowed by contexts at the time are not affected and will be
+    returned to the pool when their transactions end.
+
+    Call this if you know you won't be needing these connections
+    for a while, or before exiting the process.
+ */
+PUBNUB_EXTERN void pubnub_connection_pool_drain(void);
+
+
+#else
+#error To use the connection pool API you must define PUBNUB_USE_CONNECTION_POOL=1
+#endif /* PUBNUB_USE_CONNECTION_POOL */
+
+#endif /* !defined INC_PUBNUB_CONNECTION_POOL */
@@ -0,0 +1,213 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include "pubnub_internal.h"
+#include "pbconn_pool.h"
+#include "pubnub_connection_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* A less chatty cgreen :) */
+
+#define attest assert_that
+#define equals is_equal_to
+#define differs is_not_equal_to
+
+
+/* The connection hand-over of the PAL, with connections being just
+   numbers (of sockets) */
+
+static int    m_closed[PUBNUB_CONNECTION_POOL_SIZE + 1];
+static size_t m_closed_count;
+
+
+bool pb_valid_ctx_ptr(pubnub_t const* pb)
+{
+    return pb != NULL;
+}
+
+
+void pbpal_detach_connection(pubnub_t* pb, struct pbpal_pooled_connection* conn)
+{
+    conn->socket   = pb->pal.socket;
+    conn->tls      = NULL;
+    pb->pal.socket = -1;
+}
+
+
+void pbpal_attach_connection(pubnub_t* pb, struct pbpal_pooled_connection const* conn)
+{
+    attest(pb->pal.socket, equals(-1));
+    pb->pal.socket = conn->socket;
+}
+
+
+void pbpal_close_detached_connection(struct pbpal_pooled_connection* conn)
+{
+    attest(m_closed_count, is_less_than(sizeof m_closed / sizeof m_closed[0]));
+    m_closed[m_closed_count++] = conn->socket;
+    conn->socket               = -1;
+}
+
+
+static pubnub_t* alloc_context(char const* origin, int socket)
+{
+    pubnub_t* rslt = (pubnub_t*)calloc(1, sizeof *rslt);
+
+    rslt->origin                      = origin;
+    rslt->port                        = INITIAL_PORT_VALUE;
+    rslt->options.use_http_keep_alive = true;
+    rslt->pal.socket                  = socket;
+    return rslt;
+}
+
+
+Describe(pubnub_connection_pool);
+
+
+BeforeEach(pubnub_connection_pool)
+{
+    pubnub_connection_pool_drain();
+    m_closed_count = 0;
+}
+
+
+AfterEach(pubnub_connection_pool) {}
+
+
+Ensure(pubnub_connection_pool, lends_what_was_given)
+{
+    pubnub_t* giver    = alloc_context("ps.pndsn.com", 3);
+    pubnub_t* borrower = alloc_context("ps.pndsn.com", -1);
+
+    attest(pbconn_pool_put(giver), is_true);
+    attest(giver->pal.socket, equals(-1));
+    attest(pbconn_pool_take(borrower), is_true);
+    attest(borrower->pal.socket, equals(3));
+
+    borrower->pal.socket = -1;
+    attest(pbconn_pool_take(borrower), is_false);
+    attest(m_closed_count, equals(0));
+
+    free(giver);
+    free(borrower);
+}
+
+
+Ensure(pubnub_connection_pool, lends_only_to_the_same_origin_and_port)
+{
+    pubnub_t* giver = alloc_context("a.pndsn.com", 3);
+    pubnub_t* other = alloc_context("b.pndsn.com", -1);
+    pubnub_t* same  = alloc_context("a.pndsn.com", -1);
+
+    attest(pbconn_pool_put(giver), is_true);
+    attest(pbconn_pool_take(other), is_false);
+    same->port = 8080;
+    attest(pbconn_pool_take(same), is_false);
+    same->port = INITIAL_PORT_VALUE;
+    attest(pbconn_pool_take(same), is_true);
+    attest(same->pal.socket, equals(3));
+
+    free(giver);
+    free(other);
+    free(same);
+}
+
+
+Ensure(pubnub_connection_pool, lends_the_latest_given_first)
+{
+    pubnub_t* pb = alloc_context("ps.pndsn.com", 3);
+
+    attest(pbconn_pool_put(pb), is_true);
+    pb->pal.socket = 4;
+    attest(pbconn_pool_put(pb), is_true);
+
+    attest(pbconn_pool_take(pb), is_true);
+    attest(pb->pal.socket, equals(4));
+    pb->pal.socket = -1;
+    attest(pbconn_pool_take(pb), is_true);
+    attest(pb->pal.socket, equals(3));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_connection_pool, doesnt_lend_without_keep_alive)
+{
+    pubnub_t* giver    = alloc_context("ps.pndsn.com", 3);
+    pubnub_t* borrower = alloc_context("ps.pndsn.com", -1);
+
+    attest(pbconn_pool_put(giver), is_true);
+    borrower->options.use_http_keep_alive = false;
+    attest(pbconn_pool_take(borrower), is_false);
+    attest(borrower->pal.socket, equals(-1));
+
+    free(giver);
+    free(borrower);
+}
+
+
+Ensure(pubnub_connection_pool, refuses_connection_with_unread_data)
+{
+    pubnub_t* pb = alloc_context("ps.pndsn.com", 3);
+
+    pb->unreadlen = 1;
+    attest(pbconn_pool_put(pb), is_false);
+    attest(pb->pal.socket, equals(3));
+    pb->unreadlen = 0;
+
+#if PUBNUB_RECEIVE_READ_AHEAD
+    /* Leftover of the response (or start of another) received ahead */
+    pb->read_ahead_pos = 10;
+    pb->read_ahead_len = 12;
+    attest(pbconn_pool_put(pb), is_false);
+    attest(pb->pal.socket, equals(3));
+    pb->read_ahead_pos = 12;
+#endif
+    attest(pbconn_pool_put(pb), is_true);
+    attest(pb->pal.socket, equals(-1));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_connection_pool, closes_the_oldest_when_full)
+{
+    pubnub_t* pb = alloc_context("ps.pndsn.com", -1);
+    int       i;
+
+    for (i = 0; i < PUBNUB_CONNECTION_POOL_SIZE; ++i) {
+        pb->pal.socket = 100 + i;
+        attest(pbconn_pool_put(pb), is_true);
+    }
+    attest(m_closed_count, equals(0));
+
+    pb->pal.socket = 99;
+    attest(pbconn_pool_put(pb), is_true);
+    attest(m_closed_count, equals(1));
+    attest(m_closed[0], equals(100));
+
+    attest(pbconn_pool_take(pb), is_true);
+    attest(pb->pal.socket, equals(99));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_connection_pool, drain_closes_all_idle)
+{
+    pubnub_t* pb = alloc_context("ps.pndsn.com", 3);
+
+    attest(pbconn_pool_put(pb), is_true);
+    pb->pal.socket = 4;
+    attest(pbconn_pool_put(pb), is_true);
+
+    pubnub_connection_pool_drain();
+    attest(m_closed_count, equals(2));
+    attest(pbconn_pool_take(pb), is_false);
+
+    free(pb);
+}
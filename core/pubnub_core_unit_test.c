@@ -286,6 +286,136 @@ Ensure(/*pbjson_parse, */ gibberish_json)
            is_true);
 }
 
+Ensure(/*pbjson_parse, */ get_next_key_value)
+{
+    char const*        json   = "{\"a\": 1, \"b\\\"\":{\"c\":[2]} ,\"a\":\"x\"}";
+    struct pbjson_elem elem   = { json, json + strlen(json) };
+    char const*        cursor = NULL;
+    struct pbjson_elem key;
+    struct pbjson_elem value;
+
+    attest(pbjson_get_next_key_value(&elem, &cursor, &key, &value),
+           equals(jonmpOK));
+    attest(pbjson_elem_equals_string(&key, "a"), is_true);
+    attest(pbjson_elem_equals_string(&value, "1"), is_true);
+    attest(pbjson_get_next_key_value(&elem, &cursor, &key, &value),
+           equals(jonmpOK));
+    attest(pbjson_elem_equals_string(&key, "b\\\""), is_true);
+    attest(pbjson_elem_equals_string(&value, "{\"c\":[2]}"), is_true);
+    attest(pbjson_get_next_key_value(&elem, &cursor, &key, &value),
+           equals(jonmpOK));
+    attest(pbjson_elem_equals_string(&key, "a"), is_true);
+    attest(pbjson_elem_equals_string(&value, "\"x\""), is_true);
+    attest(pbjson_get_next_key_value(&elem, &cursor, &key, &value),
+           equals(jonmpKeyNotFound));
+
+    cursor    = NULL;
+    elem.end -= 12;
+    attest(pbjson_get_next_key_value(&elem, &cursor, &key, &value),
+           equals(jonmpOK));
+    attest(pbjson_get_next_key_value(&elem, &cursor, &key, &value),
+           equals(jonmpValueIncomplete));
+}
+
+Ensure(/*pbcc, */ classify_response)
+{
+    char const* error = " {\"message\":\"Forbidden\",\"payload\":{\"c\":[]},"
+                        "\"error\":true,\"service\":\"Access Manager\","
+                        "\"status\":403}";
+    char const* envelope =
+        "{\"t\":{\"t\":\"1\",\"r\":1},\"m\":[],\"status\":403}";
+    char const*                array  = "[1,\"Sent\",\"15\"]";
+    struct pbjson_elem         elem   = { error, error + strlen(error) };
+    struct pbcc_response_class rclass = pbcc_classify_response(&elem);
+
+    attest(rclass.shape, equals(pbrsObject));
+    attest(rclass.status, equals(403));
+    attest(pbjson_elem_equals_string(&rclass.error, "true"), is_true);
+    attest(pbjson_elem_equals_string(&rclass.message, "\"Forbidden\""),
+           is_true);
+
+    elem.start = envelope;
+    elem.end   = envelope + strlen(envelope);
+    rclass     = pbcc_classify_response(&elem);
+    attest(rclass.shape, equals(pbrsEnvelope));
+    attest(rclass.status, equals(0));
+
+    elem.start = array;
+    elem.end   = array + strlen(array);
+    rclass     = pbcc_classify_response(&elem);
+    attest(rclass.shape, equals(pbrsArray));
+    attest(rclass.error.start, equals(NULL));
+    attest(rclass.message.start, equals(NULL));
+}
+
+Ensure(/*pbjson_parse, */ long_json)
+{
+    char        json[400];
+    char const* end;
+    size_t      i;
+
+    /* Escapes and brackets in strings, at and around the (64 byte)
+       block boundaries */
+    strcpy(json, "{\"a\":\"");
+    for (i = strlen(json); i < 62; ++i) {
+        json[i] = 'x';
+    }
+    strcpy(json + i,
+           "\\\"}\\\\\", \"b\":[[1,2],{\"c\":\"]}\\\\\"}, \"d\":[");
+    for (i = strlen(json); i < 250; ++i) {
+        json[i] = ' ';
+    }
+    strcpy(json + i, "\"\\\\\"]]}");
+    end = json + strlen(json);
+
+    attest(pbjson_find_end_complex(json, end), equals(end - 1));
+    attest(pbjson_find_end_string(json + 6, end), equals(json + 67));
+    attest(pbjson_skip_whitespace(json + 130, end), equals(json + 250));
+    attest(pbjson_find_end_element(json + 5, end), equals(json + 67));
+
+    json[200] = '\0';
+    attest(pbjson_find_end_complex(json, end), equals(json + 200));
+    json[200] = ' ';
+    attest(pbjson_find_end_complex(json, end - 1), equals(end - 1));
+}
+
+
+Ensure(/*pbjson_parse, */ array_separators)
+{
+    char        json[200];
+    char const* end;
+    size_t      sep[8];
+    bool        complete;
+    size_t      i;
+
+    /* Commas in strings and in nested complexes, then separators
+       around the (64 byte) block boundary */
+    strcpy(json, "\"a,\\\",\",[1,{\"c\":[\",\"]}],");
+    for (i = strlen(json); i < 100; ++i) {
+        json[i] = 'x';
+    }
+    json[63] = json[64] = ',';
+    strcpy(json + i, "\"]\\\\\"");
+    end = json + strlen(json);
+
+    attest(pbjson_find_array_separators(json, end, sep, 2, &complete),
+           equals(2));
+    attest(sep[0], equals(7));
+    attest(sep[1], equals(23));
+    attest(pbjson_find_array_separators(json, end, sep, 8, &complete),
+           equals(4));
+    attest(sep[2], equals(63));
+    attest(sep[3], equals(64));
+    attest(complete, is_true);
+
+    attest(pbjson_find_array_separators(json, json + 102, sep, 8, &complete),
+           equals(4));
+    attest(complete, is_false);
+    attest(pbjson_find_array_separators(json, json + 20, sep, 8, &complete),
+           equals(1));
+    attest(complete, is_false);
+}
+
 
 Describe(single_context_pubnub);
 
@@ -139,19 +139,7 @@ static int memory_encode(
     buffer.ptr[buffer.size] = '\0';
 #endif
 
-    int max_size = base64_max_size(buffer.size);
-    if (*n + 1 < (size_t)max_size) { return -1; }
-    char* base64_output = (char*)malloc(max_size);
-    if (base64encode(base64_output, max_size, buffer.ptr, buffer.size) != 0) {
-        free(base64_output);
-        return -1;
-    }
-    int result = snprintf(base64_str, *n, "%s", base64_output);
-    *n         = (size_t)strlen(base64_str);
-
-    free(base64_output);
-
-    return result >= 0 ? 0 : -1;
+    return pbbase64_encode_std(buffer, base64_str, n);
 }
 
 int pubnub_encrypt(
@@ -605,22 +593,13 @@ int base64encode(
     const void* b64_encode_this,
     int         encode_this_many_bytes)
 {
-    size_t buf_size =
-        4 * ((encode_this_many_bytes + 2) / 3) + 1; // +1 for tailing 0
-    unsigned char* buf = (unsigned char*)calloc(buf_size, 1);
-    if (!buf) { return -1; }
-
-    size_t size = EVP_EncodeBlock(
-        buf, (const unsigned char*)b64_encode_this, encode_this_many_bytes);
-    // size does not include tailing 0
-    // https://www.openssl.org/docs/man3.0/man3/EVP_EncodeBlock.html
-    if (size + 1 > (size_t)max_size) {
-        free(buf);
-        return -1;
-    }
-    memcpy(result, buf, size + 1);
-    free(buf);
-    return 0;
+    pubnub_bymebl_t data;
+    size_t          n = (size_t)max_size;
+
+    data.ptr  = (uint8_t*)b64_encode_this;
+    data.size = (size_t)encode_this_many_bytes;
+
+    return pbbase64_encode_std(data, result, &n);
 }
 
 char* pn_pam_hmac_sha256_sign(char const* key, char const* message)
@@ -10,12 +10,19 @@
 #include "pbcc_logger_manager.h"
 #endif // PUBNUB_USE_LOGGER
 
+/** Freeing a context that is being cancelled is tried again after
+    this many milliseconds, doubling each time (to not wake up every
+    millisecond for a cancellation that takes a while), up to
+    #PUBNUB_FREE_POLL_INTERVAL_MAX_MS.
+ */
 #define PUBNUB_FREE_POLL_INTERVAL_MS 1
+#define PUBNUB_FREE_POLL_INTERVAL_MAX_MS 32
 
 
 int pubnub_free_with_timeout(pubnub_t* pbp, unsigned millisec)
 {
-    const pbmsref_t t0 = pbms_start();
+    const pbmsref_t t0       = pbms_start();
+    pbms_t          interval = PUBNUB_FREE_POLL_INTERVAL_MS;
 
     PUBNUB_ASSERT_OPT(pbp != NULL);
 
@@ -26,7 +33,13 @@ int pubnub_free_with_timeout(pubnub_t* pbp, unsigned millisec)
                 pbp, "Failed to free the context in %u milliseconds", millisec);
             return -1;
         }
-        pb_sleep_ms(PUBNUB_FREE_POLL_INTERVAL_MS);
+        if (interval > (pbms_t)millisec - elapsed + 1) {
+            interval = (pbms_t)millisec - elapsed + 1;
+        }
+        pb_sleep_ms(interval);
+        if (interval < PUBNUB_FREE_POLL_INTERVAL_MAX_MS) {
+            interval *= 2;
+        }
     }
     PUBNUB_LOG_TRACE(
         pbp,
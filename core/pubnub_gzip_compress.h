@@ -0,0 +1,65 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_GZIP_COMPRESS
+#define INC_PUBNUB_GZIP_COMPRESS
+
+#if PUBNUB_USE_GZIP_COMPRESSION
+
+#include "core/pubnub_api_types.h"
+#include "lib/pb_extern.h"
+
+#include <stddef.h>
+
+
+/** @file pubnub_gzip_compress.h
+
+    Tuning of the gzip compression of messages published with
+    #pubnubSendViaPOSTwithGZIP. A message is sent compressed only if
+    that makes it shorter by at least 10%, otherwise it's sent as is.
+ */
+
+
+/** Compression strategies, like in zlib */
+enum pubnub_gzip_strategy {
+    /** Best for general (JSON) data. This is the default. */
+    pbgzsDefault,
+    /** Ignores short matches, for data with many small values */
+    pbgzsFiltered,
+    /** No string matching at all, just Huffman coding. Fastest. */
+    pbgzsHuffmanOnly,
+    /** Only runs of the same octet are matched */
+    pbgzsRLE,
+    /** Uses only the fixed Huffman codes */
+    pbgzsFixed
+};
+
+/** Sets the gzip compression @p level and @p strategy of the context
+    @p pb. Level is like in zlib: 1 is the fastest, 9 compresses
+    best, while 10 is "even better", but may be quite slow. Level 0
+    turns compression off, that is, messages are sent as is.
+
+    Default is #PUBNUB_GZIP_COMPRESSION_LEVEL and #pbgzsDefault.
+
+    @param pb The context to set compression for
+    @param level Compression level, 0 - 10
+    @param strategy Compression strategy
+ */
+PUBNUB_EXTERN void pubnub_set_gzip_compression(
+    pubnub_t*                 pb,
+    int                       level,
+    enum pubnub_gzip_strategy strategy);
+
+/** Sets the minimal length of a message that the context @p pb will
+    try to compress. Shorter messages are sent as is, without any
+    compression work done.
+
+    Default is #PUBNUB_GZIP_MIN_MESSAGE_SIZE.
+
+    @param pb The context to set minimal length for
+    @param min_size Minimal length of a message to compress, in octets
+ */
+PUBNUB_EXTERN void pubnub_set_gzip_min_size(pubnub_t* pb, size_t min_size);
+
+
+#endif /* PUBNUB_USE_GZIP_COMPRESSION */
+
+#endif /* !defined INC_PUBNUB_GZIP_COMPRESS */
@@ -29,6 +29,107 @@
 #define PUBNUB_CHANGE_DNS_SERVERS 0
 #endif
 
+#if !defined(PUBNUB_USE_EPOLL)
+#define PUBNUB_USE_EPOLL 0
+#endif
+
+#if !defined(PUBNUB_EPOLL_EDGE_TRIGGERED)
+#define PUBNUB_EPOLL_EDGE_TRIGGERED 0
+#endif
+
+#if !defined(PUBNUB_USE_IO_URING)
+#define PUBNUB_USE_IO_URING 0
+#endif
+
+#if PUBNUB_USE_EPOLL && PUBNUB_USE_IO_URING
+#error You can use only one of PUBNUB_USE_EPOLL and PUBNUB_USE_IO_URING
+#endif
+
+#if !defined(PUBNUB_COALESCE_HTTP_REQUEST)
+#define PUBNUB_COALESCE_HTTP_REQUEST 0
+#endif
+
+#if PUBNUB_COALESCE_HTTP_REQUEST && !defined(PUBNUB_COALESCE_BODY_MAXLEN)
+#define PUBNUB_COALESCE_BODY_MAXLEN 4096
+#endif
+
+#if PUBNUB_DYNAMIC_REPLY_BUFFER && !defined(PUBNUB_REPLY_BUFFER_KEEP_MAX)
+#define PUBNUB_REPLY_BUFFER_KEEP_MAX 16384
+#endif
+
+#if !defined(PUBNUB_RECEIVE_READ_AHEAD)
+#define PUBNUB_RECEIVE_READ_AHEAD 0
+#endif
+
+#if PUBNUB_RECEIVE_READ_AHEAD
+#if !defined(PUBNUB_READ_AHEAD_BUF_SIZE)
+#define PUBNUB_READ_AHEAD_BUF_SIZE 16384
+#endif
+#if (PUBNUB_READ_AHEAD_BUF_SIZE < 16) || (PUBNUB_READ_AHEAD_BUF_SIZE > 65535)
+#error PUBNUB_READ_AHEAD_BUF_SIZE must be between 16 and 65535
+#endif
+#endif
+
+#if !defined(PUBNUB_SYNC_WAIT_FOR_SOCKET)
+#define PUBNUB_SYNC_WAIT_FOR_SOCKET 0
+#endif
+
+#if !defined(PUBNUB_USE_CONNECTION_POOL)
+#define PUBNUB_USE_CONNECTION_POOL 0
+#endif
+
+#if PUBNUB_USE_CONNECTION_POOL && !defined(PUBNUB_CONNECTION_POOL_SIZE)
+#define PUBNUB_CONNECTION_POOL_SIZE 16
+#endif
+
+#if !defined(PUBNUB_USE_PIPELINING)
+#define PUBNUB_USE_PIPELINING 0
+#endif
+
+#if PUBNUB_USE_PIPELINING && !defined(PUBNUB_CALLBACK_API)
+#error PUBNUB_USE_PIPELINING can be used only with the callback interface
+#endif
+
+#if PUBNUB_USE_PIPELINING && !defined(PUBNUB_PIPELINE_DEPTH)
+#define PUBNUB_PIPELINE_DEPTH 8
+#endif
+
+#if !defined(PUBNUB_USE_PUBLISH_QUEUE)
+#define PUBNUB_USE_PUBLISH_QUEUE 0
+#endif
+
+#if PUBNUB_USE_PUBLISH_QUEUE && !defined(PUBNUB_CALLBACK_API)
+#error PUBNUB_USE_PUBLISH_QUEUE can be used only with the callback interface
+#endif
+
+#if PUBNUB_USE_PUBLISH_QUEUE && !defined(PUBNUB_PUBLISH_QUEUE_SIZE)
+#define PUBNUB_PUBLISH_QUEUE_SIZE 32
+#endif
+
+#if PUBNUB_USE_PUBLISH_QUEUE
+#include "core/pubnub_publish_queue.h"
+#endif
+
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET && !defined(_WIN32)
+#include "lib/sockets/pbpal_ntf_callback_wakeup.h"
+#endif
+
+#if !defined(PUBNUB_USE_TIMER_WHEEL)
+#define PUBNUB_USE_TIMER_WHEEL 0
+#endif
+
+#if !defined(PUBNUB_CALLBACK_THREAD_COUNT)
+#define PUBNUB_CALLBACK_THREAD_COUNT 1
+#endif
+
+#if !defined(PUBNUB_CALLBACK_THREAD_AFFINITY)
+#define PUBNUB_CALLBACK_THREAD_AFFINITY 0
+#endif
+
+#if !defined(PUBNUB_CALLBACK_THREAD_NAME)
+#define PUBNUB_CALLBACK_THREAD_NAME "pubnub-cb"
+#endif
+
 #define PUBNUB_ADNS_RETRY_AFTER_CLOSE                                          \
     (PUBNUB_CHANGE_DNS_SERVERS || PUBNUB_USE_MULTIPLE_ADDRESSES)
 
@@ -40,6 +141,18 @@
 #define PUBNUB_USE_SUBSCRIBE_V2 0
 #endif
 
+#if !defined(PUBNUB_SUBSCRIBE_V2_STREAMING)
+#define PUBNUB_SUBSCRIBE_V2_STREAMING 0
+#endif
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING && !PUBNUB_USE_SUBSCRIBE_V2
+#error PUBNUB_SUBSCRIBE_V2_STREAMING can be used only with PUBNUB_USE_SUBSCRIBE_V2
+#endif
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+#include "core/pubnub_subscribe_v2.h"
+#endif
+
 #if !defined(PUBNUB_USE_ADVANCED_HISTORY)
 #define PUBNUB_USE_ADVANCED_HISTORY 0
 #endif
@@ -94,12 +207,28 @@
 #include "core/pbgzip_compress.h"
 #endif
 
+#if !defined(PUBNUB_GZIP_COMPRESSION_LEVEL)
+#define PUBNUB_GZIP_COMPRESSION_LEVEL 6
+#endif
+
+#if !defined(PUBNUB_GZIP_MIN_MESSAGE_SIZE)
+#define PUBNUB_GZIP_MIN_MESSAGE_SIZE 0
+#endif
+
+#if !defined(PUBNUB_RECEIVE_GZIP_STREAMING)
+#define PUBNUB_RECEIVE_GZIP_STREAMING 0
+#endif
+
 #if !defined PUBNUB_RECEIVE_GZIP_RESPONSE
 #define PUBNUB_RECEIVE_GZIP_RESPONSE 0
 #elif PUBNUB_RECEIVE_GZIP_RESPONSE
 #include "core/pbgzip_decompress.h"
 #endif
 
+#if PUBNUB_RECEIVE_GZIP_STREAMING && !PUBNUB_RECEIVE_GZIP_RESPONSE
+#error PUBNUB_RECEIVE_GZIP_STREAMING can be used only with PUBNUB_RECEIVE_GZIP_RESPONSE
+#endif
+
 #include <stdint.h>
 #if PUBNUB_ADVANCED_KEEP_ALIVE
 #include <time.h>
@@ -385,6 +514,93 @@ struct pubnub_multi_addresses {
     +----------------------------------------+
 
 */
+#if PUBNUB_USE_PIPELINING
+/** A request queued for pipelining */
+struct pbpipeline_request {
+    enum pubnub_trans trans;
+    /** Channel and message, in one allocated block, NULL for
+        transactions without them */
+    char*       channel;
+    char const* message;
+    /** Sent on a connection that was lost before it was answered, so
+        it fails when it's its turn (it's not idempotent) */
+    bool lost;
+};
+
+/** Requests to pipeline on the connection of a context, in a ring.
+    The first `sent` of them were sent on the connection - the first
+    one is of the current transaction, if `active`. The rest are yet
+    to be sent.
+ */
+struct pbpipeline {
+    struct pbpipeline_request ring[PUBNUB_PIPELINE_DEPTH];
+    unsigned                  head;
+    unsigned                  count;
+    unsigned                  sent;
+    /** Number of responses read on the connection, since the current
+        transaction started */
+    unsigned answered;
+    /** Whether the current transaction is of the first request */
+    bool active;
+    /** Don't pipeline requests after the current one. Set when it's
+        sent again, on a new connection, because the previous one was
+        closed with requests unanswered (RFC 7230 6.3.2). */
+    bool fallback;
+    /** The FSM should go on (read the next response or make a new
+        connection) */
+    bool resume;
+    /** The outcome of a transaction that was answered is to be
+        reported before the FSM goes on */
+    bool to_report;
+    enum pubnub_trans report_trans;
+    enum pubnub_res   report_rslt;
+};
+#endif /* PUBNUB_USE_PIPELINING */
+
+#if PUBNUB_USE_PUBLISH_QUEUE
+/** A queued publish */
+struct pbpublish_queue_entry {
+    pubnub_publish_token_t token;
+    /** Channel, and the message, if it was copied, in one allocated
+        block */
+    char*       channel;
+    char const* message;
+    /** The message, if it was adopted, NULL otherwise */
+    char* adopted;
+};
+
+/** Publishes queued on a context, in a ring. The first one is of the
+    current transaction, if `active`.
+ */
+struct pbpublish_queue {
+    struct pbpublish_queue_entry       ring[PUBNUB_PUBLISH_QUEUE_SIZE];
+    unsigned                           head;
+    unsigned                           count;
+    enum pubnub_publish_queue_overflow overflow;
+    /** Token given to the publish queued last */
+    pubnub_publish_token_t last_token;
+    /** Token of the publish being reported in the callback, 0 if
+        none */
+    pubnub_publish_token_t reported;
+    /** Whether the current transaction is of the first publish */
+    bool active;
+    /** Whether the callback of the context is being called */
+    bool in_callback;
+    /** The current transaction was cancelled, drop the queue */
+    bool cancelled;
+#if PUBNUB_THREADSAFE
+    /** Broadcast (on the monitor of the context) when a publish is
+        taken out of the queue, to those waiting for room in it, and
+        when one of them stops waiting on shutdown */
+    pbpal_cond_t room;
+    /** Number of those waiting for room in the queue */
+    unsigned waiters;
+    /** The queue is being freed, those waiting for room give up */
+    bool shutdown;
+#endif
+};
+#endif /* PUBNUB_USE_PUBLISH_QUEUE */
+
 struct pubnub_ {
     struct pbcc_context core;
 
@@ -405,6 +621,22 @@ struct pubnub_ {
     /** Number of bytes left (empty) in the read buffer */
     uint16_t left;
 
+#if PUBNUB_RECEIVE_READ_AHEAD
+    /** Data received from the connection, but not moved to the read
+        buffer yet - it may already be the start of the next response
+        (if pipelining or keeping the connection alive). Lines and
+        chunks are taken from here, so that one receive can serve all
+        the lines and chunks (and responses) that arrived together.
+     */
+    uint8_t read_ahead[PUBNUB_READ_AHEAD_BUF_SIZE];
+
+    /** Position of the first octet in `read_ahead` not taken yet */
+    uint16_t read_ahead_pos;
+
+    /** Number of octets in `read_ahead` (taken or not) */
+    uint16_t read_ahead_len;
+#endif
+
     /** The state of the socket. */
     enum PBSocketState sock_state;
 
@@ -455,6 +687,39 @@ struct pubnub_ {
     enum pubnub_data_compressionType data_compressed;
 #endif
 
+#if PUBNUB_USE_GZIP_COMPRESSION
+    /** Settings and reusable state of gzip compression (of messages) */
+    struct pbgzip_compressor gzip_compressor;
+#endif
+
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+    /** Inflating of the (gzip) response being received */
+    struct pbgzip_inflate gzip_inflate;
+#endif
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+    /** Callback to give the subscribe V2 messages to, as they are
+        received. If NULL, messages are not streamed. */
+    pubnub_subscribe_v2_message_callback_t v2_message_cb;
+    /** User data to pass to `v2_message_cb` */
+    void* v2_message_user_data;
+    /** The messages given to `v2_message_cb` from the responses to
+        the subscribe V2 that didn't succeed (yet), so that they are
+        not given again when it's retried.
+      */
+    struct pbsubscribe_v2_given {
+        /** Hash of the channels and channel groups subscribed to */
+        uint32_t subscription;
+        /** The timetoken subscribed with */
+        char timetoken[20];
+        /** Number of messages given */
+        unsigned count;
+        /** Number of messages of the response being received that
+            were handled (given or skipped) so far */
+        unsigned index;
+    } v2_given;
+#endif
+
 #if PUBNUB_USE_SSL
     /** Certificate store file */
     char const* ssl_CAfile;
@@ -473,6 +738,28 @@ struct pubnub_ {
 #endif
     /** Whether sync `await` should stop (cancel) or not. */
     bool should_stop_await;
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    /** How sync `await` waits for the socket, between runs of the
+        transaction FSM.
+      */
+    struct pbntf_sync_wait {
+        /** Wait for "in" events (otherwise for "out" events) */
+        bool in;
+        /** The FSM has more to do before it needs to wait */
+        bool requeued;
+#if PUBNUB_BLOCKING_IO_SETTABLE
+        /** The blocking I/O setting, saved while in `await`, which
+            uses non-blocking I/O */
+        bool use_blocking_io;
+#endif
+#if !defined(_WIN32)
+        /** Signalled to interrupt the wait. Created on first wait
+            (`read_fd` is -1 before that), guarded by `cancel_monitor`.
+          */
+        struct pbpal_ntf_callback_wakeup wakeup;
+#endif
+    } sync_wait;
+#endif
 #endif
 
 #if PUBNUB_TIMERS_API
@@ -486,6 +773,12 @@ struct pubnub_ {
     struct pubnub_* previous;
     struct pubnub_* next;
     int             timeout_left_ms;
+    /** Slot of the timer wheel this context is linked in (NULL if
+        not in a timer wheel) */
+    struct pubnub_** timer_slot;
+    /** Time of the timer wheel at which the timer of this context
+        expires */
+    unsigned long timer_expiry;
 #endif
 
 #endif /* PUBNUB_TIMERS_API */
@@ -494,6 +787,44 @@ struct pubnub_ {
     pubnub_callback_t cb;
     void*             user_data;
 
+#if PUBNUB_USE_PIPELINING
+    /** Requests to pipeline on the connection of this context */
+    struct pbpipeline pipeline;
+#endif
+
+#if PUBNUB_USE_PUBLISH_QUEUE
+    /** Publishes queued on this context */
+    struct pbpublish_queue publish_queue;
+#endif
+
+    /** Next context in the callback processing queue */
+    struct pubnub_* queue_next;
+    /** State of this context in the callback processing queue (one of
+        `enum pbpal_ntf_callback_queue_state`), changed atomically */
+    volatile long queue_state;
+
+#if PUBNUB_USE_EPOLL
+    /** Registration of this context in the epoll poller - the socket
+        registered and the events watched for (0 if not registered).
+        Kept here so that the poller never has to search for a context.
+      */
+    struct pbpal_epoll_registration {
+        int      socket;
+        uint32_t events;
+    } epoll;
+#endif
+#if PUBNUB_USE_IO_URING
+    /** Registration of this context in the io_uring poller - the
+        socket registered, the events watched for (0 if not
+        registered) and the poller's slot of this context.
+      */
+    struct pbpal_uring_registration {
+        int      socket;
+        uint32_t events;
+        uint32_t slot;
+    } uring;
+#endif
+
     struct dns_queries_tracking dns_queries;
 #if PUBNUB_CHANGE_DNS_SERVERS
     struct pbdns_servers_check dns_check;
@@ -664,6 +995,20 @@ void pbntf_start_wait_connect_timer(pubnub_t* pb);
 /** Removes timer running on the context @p p and starts the one for 'transaction' */
 void pbntf_start_transaction_timer(pubnub_t* pb);
 
+#if PUBNUB_USE_RETRY_CONFIGURATION && defined(PUBNUB_CALLBACK_API)
+/** Removes timer running on the context @p pb and starts the one for
+    waiting @p delay_ms before retrying a failed request. On expiry,
+    pbcc_request_retry_timer_expired() is called, instead of stopping
+    the transaction. Callback interface only.
+ */
+void pbntf_start_wait_retry_timer(pubnub_t* pb, int delay_ms);
+
+/** Stops the timer started with pbntf_start_wait_retry_timer(), if
+    it's still running. Callback interface only.
+ */
+void pbntf_stop_wait_retry_timer(pubnub_t* pb);
+#endif
+
 void pbntf_lost_socket(pubnub_t* pb);
 
 int pbntf_enqueue_for_processing(pubnub_t* pb);
@@ -673,6 +1018,40 @@ int pbntf_requeue_for_processing(pubnub_t* pb);
 int pbntf_watch_in_events(pubnub_t* pb);
 int pbntf_watch_out_events(pubnub_t* pb);
 
+#if PUBNUB_USE_IO_URING
+/** Returned by the functions below if the context can't do completion
+    based I/O (it's not registered in the poller, or not with the
+    socket it uses now). Then it should do its own send()/recv().
+ */
+#define PBNTF_URING_NO_IO -2
+
+/** Gives, in @p buf, the poller's buffer to put the data to send for
+    @p pb in, if the previous send is done. Context is requeued when
+    it is, if this failed with EAGAIN.
+    @return The size of the buffer, -1 on error (`errno` set), or
+    #PBNTF_URING_NO_IO
+ */
+int pbntf_uring_send_buffer(pubnub_t* pb, uint8_t** buf);
+
+/** Sends the first @p n octets of the buffer got from
+    pbntf_uring_send_buffer()
+ */
+void pbntf_uring_send(pubnub_t* pb, size_t n);
+
+/** Gives, in @p buf, the data the poller received for @p pb. If there
+    is none, starts receiving (at most @p max octets). Context is
+    requeued when it's received.
+    @return The number of octets received, 0 on end of connection, -1
+    on error (`errno` set, EAGAIN if receiving), or #PBNTF_URING_NO_IO
+ */
+int pbntf_uring_recv_buffer(pubnub_t* pb, uint8_t const** buf, size_t max);
+
+/** Marks the first @p n octets of the data got from
+    pbntf_uring_recv_buffer() as consumed
+ */
+void pbntf_uring_recv_consume(pubnub_t* pb, size_t n);
+#endif /* PUBNUB_USE_IO_URING */
+
 
 /** Returns a string representation of the @p state enum value.
     Used for debugging / logging.
@@ -5,8 +5,435 @@
 #include <stdio.h>
 #include <string.h>
 
+#if !defined(PBJSON_NO_SIMD)
+#if (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))          \
+    && (defined(__GNUC__) || defined(__clang__))
+#define PBJSON_X86 1
+#define PBJSON_AVX2_TARGET __attribute__((target("avx2")))
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(_M_X64) && defined(_MSC_VER)
+#define PBJSON_X86 1
+#define PBJSON_AVX2_TARGET
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define PBJSON_NEON 1
+#include <arm_neon.h>
+#endif
+#endif /* !defined(PBJSON_NO_SIMD) */
+
+#if !defined(PBJSON_X86)
+#define PBJSON_X86 0
+#endif
+#if !defined(PBJSON_NEON)
+#define PBJSON_NEON 0
+#endif
+#define PBJSON_SIMD (PBJSON_X86 || PBJSON_NEON)
+
+
+#if PBJSON_SIMD
+#include <stdint.h>
+
+/** Number of characters that are classified at once */
+#define PBJSON_BLOCK 64
+
+/** Whitespace runs up to this long are skipped one character at a
+    time, only longer ones are worth classifying blocks.
+ */
+#define PBJSON_WHITESPACE_RUN 16
+
+/** Masks of the characters of interest in a block, bit `i` being for
+    the character at offset `i`.
+ */
+struct pbjson_block {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t nul;
+    /** Any of `{`, `}`, `[`, `]` */
+    uint64_t bracket;
+};
+
+
+#if defined(_MSC_VER)
+static unsigned lowest_bit(uint64_t mask)
+{
+    unsigned long i;
+    _BitScanForward64(&i, mask);
+    return (unsigned)i;
+}
+#else
+#define lowest_bit(mask) ((unsigned)__builtin_ctzll(mask))
+#endif
 
-char const* pbjson_skip_whitespace(char const* start, char const* end)
+
+/** Bit `i` of the result is the XOR of bits `0..i` of @p mask. For
+    (unescaped) quotes, that is the mask of the inside of strings.
+ */
+static uint64_t prefix_xor(uint64_t mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+
+/** Returns the mask of characters (of a string) escaped by those
+    backslashes in @p backslash that are not escaped themselves.
+    On input, @p carry is
+    whether the first character is escaped (by the last one of the
+    previous block), on output, whether the first one of the next
+    block is.
+ */
+static uint64_t escaped_chars(uint64_t backslash, uint64_t* carry)
+{
+    uint64_t escaped = *carry;
+
+    *carry = 0;
+    while (backslash != 0) {
+        uint64_t const bit = backslash & (0 - backslash);
+        backslash ^= bit;
+        if (0 == (escaped & bit)) {
+            escaped |= bit << 1;
+            *carry = bit >> 63;
+        }
+    }
+    return escaped;
+}
+
+
+/** Returns the mask of the characters of block @p b that are in
+    strings (opening quotes included, closing ones not). On input,
+    @p in_string and @p in_escape are the state at the start of the
+    block, on output, at its end (the start of the next one).
+ */
+static uint64_t strings_mask(struct pbjson_block const* b,
+                             bool*                      in_string,
+                             bool*                      in_escape)
+{
+    uint64_t toggles = 0;
+    uint64_t strings;
+
+    if ((0 == b->backslash) && !*in_escape) { toggles = b->quote; }
+    else {
+        /* Escapes are rare, so following them is not optimized */
+        uint64_t escaped = *in_escape;
+        uint64_t special = b->quote | b->backslash;
+        bool     quoted  = *in_string;
+        *in_escape       = false;
+        while (special != 0) {
+            uint64_t const bit = special & (0 - special);
+            special ^= bit;
+            if (escaped & bit) { continue; }
+            if (b->quote & bit) {
+                toggles |= bit;
+                quoted = !quoted;
+            }
+            else if (quoted) {
+                escaped |= bit << 1;
+                *in_escape = (bit >> 63) != 0;
+            }
+        }
+    }
+    strings    = prefix_xor(toggles) ^ (*in_string ? ~(uint64_t)0 : 0);
+    *in_string = (strings >> 63) != 0;
+
+    return strings;
+}
+
+
+#if PBJSON_X86
+#if defined(_MSC_VER)
+static volatile long m_has_avx2 = -1;
+#define load_has_avx2() m_has_avx2
+#define store_has_avx2(v) (m_has_avx2 = (v))
+#else
+static int m_has_avx2 = -1;
+#define load_has_avx2() __atomic_load_n(&m_has_avx2, __ATOMIC_RELAXED)
+#define store_has_avx2(v) __atomic_store_n(&m_has_avx2, (v), __ATOMIC_RELAXED)
+#endif
+
+/* SSE2 is there on every x86-64 CPU (and the 32 bit build requires
+   it), AVX2 is checked for once (-1: not yet), racing threads would
+   store the same value.
+ */
+static int has_avx2(void)
+{
+    int has = load_has_avx2();
+    if (has < 0) {
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        has = 0;
+        if (regs[0] >= 7) {
+            __cpuid(regs, 1);
+            if (((regs[2] >> 27) & 1) && ((regs[2] >> 28) & 1)
+                && ((_xgetbv(0) & 6) == 6)) {
+                __cpuidex(regs, 7, 0);
+                has = (regs[1] >> 5) & 1;
+            }
+        }
+#else
+        unsigned eax, ebx, ecx, edx;
+        has = 0;
+        if ((__get_cpuid_max(0, NULL) >= 7)
+            && __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_OSXSAVE)
+            && (ecx & bit_AVX)) {
+            unsigned xcr0, xcr0_high;
+            __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            has = ((ebx & bit_AVX2) != 0) && ((xcr0 & 6) == 6);
+        }
+#endif
+        store_has_avx2(has);
+    }
+    return has;
+}
+
+
+#define movemask16(v) ((uint64_t)(unsigned)_mm_movemask_epi8(v))
+#define movemask32(v) ((uint64_t)(uint32_t)_mm256_movemask_epi8(v))
+
+static void classify_sse2(char const* p, struct pbjson_block* b)
+{
+    __m128i const quote     = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const zero      = _mm_setzero_si128();
+    __m128i const lower     = _mm_set1_epi8(0x20);
+    __m128i const open      = _mm_set1_epi8('{');
+    __m128i const close     = _mm_set1_epi8('}');
+    unsigned      i;
+
+    memset(b, 0, sizeof *b);
+    for (i = 0; i < PBJSON_BLOCK; i += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(p + i));
+        /* `[` and `]` differ from `{` and `}` only in this bit */
+        __m128i const l = _mm_or_si128(v, lower);
+        b->quote |= movemask16(_mm_cmpeq_epi8(v, quote)) << i;
+        b->backslash |= movemask16(_mm_cmpeq_epi8(v, backslash)) << i;
+        b->nul |= movemask16(_mm_cmpeq_epi8(v, zero)) << i;
+        b->bracket |= movemask16(_mm_or_si128(_mm_cmpeq_epi8(l, open),
+                                              _mm_cmpeq_epi8(l, close)))
+                      << i;
+    }
+}
+
+
+static uint64_t whitespace_sse2(char const* p)
+{
+    __m128i const space = _mm_set1_epi8(' ');
+    __m128i const tab   = _mm_set1_epi8('\t');
+    __m128i const cr    = _mm_set1_epi8('\r');
+    __m128i const lf    = _mm_set1_epi8('\n');
+    uint64_t      rslt  = 0;
+    unsigned      i;
+
+    for (i = 0; i < PBJSON_BLOCK; i += 16) {
+        __m128i const v = _mm_loadu_si128((__m128i const*)(p + i));
+        rslt |= movemask16(
+                    _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space),
+                                              _mm_cmpeq_epi8(v, tab)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, cr),
+                                              _mm_cmpeq_epi8(v, lf))))
+                << i;
+    }
+    return rslt;
+}
+
+
+static PBJSON_AVX2_TARGET void classify_avx2(char const*          p,
+                                             struct pbjson_block* b)
+{
+    __m256i const quote     = _mm256_set1_epi8('"');
+    __m256i const backslash = _mm256_set1_epi8('\\');
+    __m256i const zero      = _mm256_setzero_si256();
+    __m256i const lower     = _mm256_set1_epi8(0x20);
+    __m256i const open      = _mm256_set1_epi8('{');
+    __m256i const close     = _mm256_set1_epi8('}');
+    __m256i const lo        = _mm256_loadu_si256((__m256i const*)p);
+    __m256i const hi        = _mm256_loadu_si256((__m256i const*)(p + 32));
+    __m256i const l_lo      = _mm256_or_si256(lo, lower);
+    __m256i const l_hi      = _mm256_or_si256(hi, lower);
+
+    b->quote = movemask32(_mm256_cmpeq_epi8(lo, quote))
+               | (movemask32(_mm256_cmpeq_epi8(hi, quote)) << 32);
+    b->backslash = movemask32(_mm256_cmpeq_epi8(lo, backslash))
+                   | (movemask32(_mm256_cmpeq_epi8(hi, backslash)) << 32);
+    b->nul = movemask32(_mm256_cmpeq_epi8(lo, zero))
+             | (movemask32(_mm256_cmpeq_epi8(hi, zero)) << 32);
+    b->bracket = movemask32(_mm256_or_si256(_mm256_cmpeq_epi8(l_lo, open),
+                                            _mm256_cmpeq_epi8(l_lo, close)))
+                 | (movemask32(_mm256_or_si256(_mm256_cmpeq_epi8(l_hi, open),
+                                               _mm256_cmpeq_epi8(l_hi, close)))
+                    << 32);
+}
+
+
+static PBJSON_AVX2_TARGET uint64_t whitespace_avx2(char const* p)
+{
+    __m256i const space = _mm256_set1_epi8(' ');
+    __m256i const tab   = _mm256_set1_epi8('\t');
+    __m256i const cr    = _mm256_set1_epi8('\r');
+    __m256i const lf    = _mm256_set1_epi8('\n');
+    __m256i const lo    = _mm256_loadu_si256((__m256i const*)p);
+    __m256i const hi    = _mm256_loadu_si256((__m256i const*)(p + 32));
+
+    return movemask32(
+               _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lo, space),
+                                               _mm256_cmpeq_epi8(lo, tab)),
+                               _mm256_or_si256(_mm256_cmpeq_epi8(lo, cr),
+                                               _mm256_cmpeq_epi8(lo, lf))))
+           | (movemask32(_mm256_or_si256(
+                  _mm256_or_si256(_mm256_cmpeq_epi8(hi, space),
+                                  _mm256_cmpeq_epi8(hi, tab)),
+                  _mm256_or_si256(_mm256_cmpeq_epi8(hi, cr),
+                                  _mm256_cmpeq_epi8(hi, lf))))
+              << 32);
+}
+
+
+static void classify(char const* p, struct pbjson_block* b)
+{
+    if (has_avx2()) { classify_avx2(p, b); }
+    else {
+        classify_sse2(p, b);
+    }
+}
+
+
+static uint64_t whitespace(char const* p)
+{
+    return has_avx2() ? whitespace_avx2(p) : whitespace_sse2(p);
+}
+
+
+static uint64_t char_mask_sse2(char const* p, char c)
+{
+    __m128i const v    = _mm_set1_epi8(c);
+    uint64_t      rslt = 0;
+    unsigned      i;
+
+    for (i = 0; i < PBJSON_BLOCK; i += 16) {
+        rslt |= movemask16(_mm_cmpeq_epi8(
+                    _mm_loadu_si128((__m128i const*)(p + i)), v))
+                << i;
+    }
+    return rslt;
+}
+
+
+static PBJSON_AVX2_TARGET uint64_t char_mask_avx2(char const* p, char c)
+{
+    __m256i const v = _mm256_set1_epi8(c);
+
+    return movemask32(_mm256_cmpeq_epi8(
+               _mm256_loadu_si256((__m256i const*)p), v))
+           | (movemask32(_mm256_cmpeq_epi8(
+                  _mm256_loadu_si256((__m256i const*)(p + 32)), v))
+              << 32);
+}
+
+
+/** Returns the mask of the characters of the block at @p p that are
+    @p c */
+static uint64_t char_mask(char const* p, char c)
+{
+    return has_avx2() ? char_mask_avx2(p, c) : char_mask_sse2(p, c);
+}
+
+#elif PBJSON_NEON
+
+/* There's no "move mask" on ARM, this is the usual replacement:
+   leave one (distinct) bit per byte and add them up pairwise.
+ */
+static uint64_t to_mask(uint8x16_t m0,
+                        uint8x16_t m1,
+                        uint8x16_t m2,
+                        uint8x16_t m3)
+{
+    static uint8_t const bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                      1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t const     bit      = vld1q_u8(bits);
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(m0, bit), vandq_u8(m1, bit));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(m2, bit), vandq_u8(m3, bit));
+
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+
+static uint8x16_t either(uint8x16_t v, uint8_t c1, uint8_t c2)
+{
+    return vorrq_u8(vceqq_u8(v, vdupq_n_u8(c1)), vceqq_u8(v, vdupq_n_u8(c2)));
+}
+
+
+static void classify(char const* p, struct pbjson_block* b)
+{
+    uint8x16_t const quote     = vdupq_n_u8('"');
+    uint8x16_t const backslash = vdupq_n_u8('\\');
+    uint8x16_t       v[4];
+    uint8x16_t       l[4];
+    unsigned         i;
+
+    for (i = 0; i < 4; ++i) {
+        v[i] = vld1q_u8((uint8_t const*)p + 16 * i);
+        /* `[` and `]` differ from `{` and `}` only in this bit */
+        l[i] = vorrq_u8(v[i], vdupq_n_u8(0x20));
+    }
+    b->quote = to_mask(vceqq_u8(v[0], quote),
+                       vceqq_u8(v[1], quote),
+                       vceqq_u8(v[2], quote),
+                       vceqq_u8(v[3], quote));
+    b->backslash = to_mask(vceqq_u8(v[0], backslash),
+                           vceqq_u8(v[1], backslash),
+                           vceqq_u8(v[2], backslash),
+                           vceqq_u8(v[3], backslash));
+    b->nul = to_mask(vceqzq_u8(v[0]),
+                     vceqzq_u8(v[1]),
+                     vceqzq_u8(v[2]),
+                     vceqzq_u8(v[3]));
+    b->bracket = to_mask(either(l[0], '{', '}'),
+                         either(l[1], '{', '}'),
+                         either(l[2], '{', '}'),
+                         either(l[3], '{', '}'));
+}
+
+
+static uint64_t whitespace(char const* p)
+{
+    uint8x16_t m[4];
+    unsigned   i;
+
+    for (i = 0; i < 4; ++i) {
+        uint8x16_t const v = vld1q_u8((uint8_t const*)p + 16 * i);
+        m[i] = vorrq_u8(either(v, ' ', '\t'), either(v, '\r', '\n'));
+    }
+    return to_mask(m[0], m[1], m[2], m[3]);
+}
+
+
+static uint64_t char_mask(char const* p, char c)
+{
+    uint8_t const* const q = (uint8_t const*)p;
+    uint8x16_t const     v = vdupq_n_u8((uint8_t)c);
+
+    return to_mask(vceqq_u8(vld1q_u8(q), v),
+                   vceqq_u8(vld1q_u8(q + 16), v),
+                   vceqq_u8(vld1q_u8(q + 32), v),
+                   vceqq_u8(vld1q_u8(q + 48), v));
+}
+
+#endif /* PBJSON_X86 */
+#endif /* PBJSON_SIMD */
+
+
+static char const* skip_whitespace(char const* start, char const* end)
 {
     for (; start < end; ++start) {
         switch (*start) {
@@ -23,10 +450,41 @@ char const* pbjson_skip_whitespace(char const* start, char const* end)
 }
 
 
+char const* pbjson_skip_whitespace(char const* start, char const* end)
+{
+#if PBJSON_SIMD
+    /* Mostly, there's no whitespace, or very little of it */
+    if (end - start >= PBJSON_WHITESPACE_RUN + PBJSON_BLOCK) {
+        char const* s = skip_whitespace(start, start + PBJSON_WHITESPACE_RUN);
+        if (s < start + PBJSON_WHITESPACE_RUN) { return s; }
+        for (; end - s >= PBJSON_BLOCK; s += PBJSON_BLOCK) {
+            uint64_t const other = ~whitespace(s);
+            if (other != 0) { return s + lowest_bit(other); }
+        }
+        start = s;
+    }
+#endif
+    return skip_whitespace(start, end);
+}
+
+
 char const* pbjson_find_end_string(char const* start, char const* end)
 {
     bool in_escape = false;
 
+#if PBJSON_SIMD
+    for (; end - start >= PBJSON_BLOCK; start += PBJSON_BLOCK) {
+        struct pbjson_block b;
+        uint64_t            carry = in_escape;
+        uint64_t            stop;
+
+        classify(start, &b);
+        stop = (b.quote & ~escaped_chars(b.backslash, &carry)) | b.nul;
+        if (stop != 0) { return start + lowest_bit(stop); }
+        in_escape = (carry != 0);
+    }
+#endif
+
     for (; start < end; ++start) {
         switch (*start) {
         case '\\':
@@ -74,9 +532,45 @@ char const* pbjson_find_end_complex(char const* start, char const* end)
     bool        in_string = false, in_escape = false;
     int         bracket_level = 0, brace_level = 0;
     char        c;
-    char const* s;
-
-    for (s = start, c = *s; (c != '\0') && (s < end); ++s, c = *s) {
+    char const* s = start;
+
+#if PBJSON_SIMD
+    /* Brackets are looked at one by one, but only those that are not
+       in strings, which are found for the whole block at once.
+     */
+    for (; end - s >= PBJSON_BLOCK; s += PBJSON_BLOCK) {
+        struct pbjson_block b;
+        uint64_t            strings;
+        uint64_t            structural;
+
+        classify(s, &b);
+        strings = strings_mask(&b, &in_string, &in_escape);
+        structural = b.bracket & ~strings;
+        if (b.nul != 0) {
+            structural &= (b.nul & (0 - b.nul)) - 1;
+        }
+        while (structural != 0) {
+            char const* const p = s + lowest_bit(structural);
+            structural &= structural - 1;
+            switch (*p) {
+            case '{':
+                ++brace_level;
+                break;
+            case '}':
+                if ((--brace_level == 0) && (0 == bracket_level)) { return p; }
+                break;
+            case '[':
+                ++bracket_level;
+                break;
+            default:
+                if ((--bracket_level == 0) && (0 == brace_level)) { return p; }
+                break;
+            }
+        }
+        if (b.nul != 0) { return s + lowest_bit(b.nul); }
+    }
+#endif
+    for (c = *s; (c != '\0') && (s < end); ++s, c = *s) {
         if (!in_string) {
             switch (c) {
             case '{':
@@ -120,6 +614,99 @@ char const* pbjson_find_end_complex(char const* start, char const* end)
 }
 
 
+size_t pbjson_find_array_separators(char const* start,
+                                    char const* end,
+                                    size_t*     sep,
+                                    size_t      n,
+                                    bool*       complete)
+{
+    bool        in_string = false, in_escape = false;
+    int         level = 0;
+    size_t      count = 0;
+    char const* s     = start;
+
+    PUBNUB_ASSERT_OPT(n > 0);
+#if PBJSON_SIMD
+    /* Like in pbjson_find_end_complex(), but commas are looked at, too */
+    for (; end - s >= PBJSON_BLOCK; s += PBJSON_BLOCK) {
+        struct pbjson_block b;
+        uint64_t            strings;
+        uint64_t            structural;
+
+        classify(s, &b);
+        strings    = strings_mask(&b, &in_string, &in_escape);
+        structural = (b.bracket | char_mask(s, ',')) & ~strings;
+        if (b.nul != 0) {
+            structural &= (b.nul & (0 - b.nul)) - 1;
+        }
+        while (structural != 0) {
+            unsigned const i = lowest_bit(structural);
+            structural &= structural - 1;
+            switch (s[i]) {
+            case '[':
+            case '{':
+                ++level;
+                break;
+            case ']':
+            case '}':
+                --level;
+                break;
+            default:
+                if (0 == level) {
+                    sep[count] = s + i - start;
+                    if (++count == n) {
+                        *complete = true;
+                        return count;
+                    }
+                }
+                break;
+            }
+        }
+        if (b.nul != 0) {
+            *complete = (0 == ((strings >> lowest_bit(b.nul)) & 1))
+                        && (level <= 0);
+            return count;
+        }
+    }
+#endif
+    for (; (s < end) && (*s != '\0'); ++s) {
+        if (in_escape) { in_escape = false; }
+        else if ('"' == *s) {
+            in_string = !in_string;
+        }
+        else if (in_string) {
+            in_escape = ('\\' == *s);
+        }
+        else {
+            switch (*s) {
+            case '[':
+            case '{':
+                ++level;
+                break;
+            case ']':
+            case '}':
+                --level;
+                break;
+            case ',':
+                if (0 == level) {
+                    sep[count] = s - start;
+                    if (++count == n) {
+                        *complete = true;
+                        return count;
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    *complete = !(in_escape || in_string || (level > 0));
+
+    return count;
+}
+
+
 char const* pbjson_find_end_element(char const* start, char const* end)
 {
     switch (*start) {
@@ -134,47 +721,75 @@ char const* pbjson_find_end_element(char const* start, char const* end)
 }
 
 
+enum pbjson_object_name_parse_result
+pbjson_get_next_key_value(struct pbjson_elem const* p,
+                          char const**              cursor,
+                          struct pbjson_elem*       key,
+                          struct pbjson_elem*       value)
+{
+    char const* s = *cursor;
+    char const* end;
+
+    if (NULL == s) {
+        s = pbjson_skip_whitespace(p->start, p->end);
+        if (*s != '{') { return jonmpNoStartCurly; }
+    }
+    else {
+        s = pbjson_skip_whitespace(s, p->end);
+        if (*s != ',') {
+            if (*s == '}') {
+                return (s < p->end) ? jonmpKeyNotFound : jonmpObjectIncomplete;
+            }
+            return jonmpMissingValueSeparator;
+        }
+    }
+    if (s >= p->end) { return jonmpObjectIncomplete; }
+    s = pbjson_skip_whitespace(s + 1, p->end);
+    if (s == p->end) { return jonmpKeyMissing; }
+    if (*s != '"') { return jonmpKeyNotString; }
+    end = pbjson_find_end_string(s + 1, p->end);
+    if (end == p->end) { return jonmpStringNotTerminated; }
+    if (*end != '"') { return jonmpStringNotTerminated; }
+    key->start = s + 1;
+    key->end   = end;
+    s          = pbjson_skip_whitespace(end + 1, p->end);
+    if (s == p->end) { return jonmpMissingColon; }
+    if (*s != ':') { return jonmpMissingColon; }
+    s   = pbjson_skip_whitespace(s + 1, p->end);
+    end = pbjson_find_end_element(s, p->end);
+    if (end == p->end) { return jonmpValueIncomplete; }
+    if ('\0' == *end) { return jonmpValueIncomplete; }
+    value->start = s;
+    value->end   = end + 1;
+    *cursor      = end + 1;
+
+    return jonmpOK;
+}
+
+
 enum pbjson_object_name_parse_result pbjson_get_object_value(
     struct pbjson_elem const* p,
     char const*               name,
     struct pbjson_elem*       parsed)
 {
-    char const* s        = pbjson_skip_whitespace(p->start, p->end);
-    unsigned    name_len = strlen(name);
-    char const* end;
+    size_t const                         name_len = strlen(name);
+    char const*                          cursor   = NULL;
+    struct pbjson_elem                   key;
+    struct pbjson_elem                   value;
+    enum pbjson_object_name_parse_result rslt;
 
     if (0 == name_len) { return jonmpInvalidKeyName; }
-    if (*s != '{') { return jonmpNoStartCurly; }
-    while (s < p->end) {
-        bool found = false;
-        s          = pbjson_skip_whitespace(s + 1, p->end);
-        if (s == p->end) { return jonmpKeyMissing; }
-        if (*s != '"') { return jonmpKeyNotString; }
-        end = pbjson_find_end_string(s + 1, p->end);
-        if (end == p->end) { return jonmpStringNotTerminated; }
-        if (*end != '"') { return jonmpStringNotTerminated; }
-        found =
-            (end - s - 1 == name_len) && (0 == memcmp(s + 1, name, name_len));
-        s = pbjson_skip_whitespace(end + 1, p->end);
-        if (s == p->end) { return jonmpMissingColon; }
-        if (*s != ':') { return jonmpMissingColon; }
-        s   = pbjson_skip_whitespace(s + 1, p->end);
-        end = pbjson_find_end_element(s, p->end);
-        if (end == p->end) { return jonmpValueIncomplete; }
-        if ('\0' == *end) { return jonmpValueIncomplete; }
-        if (found) {
-            parsed->start = s;
-            parsed->end   = end + 1;
+    for (;;) {
+        rslt = pbjson_get_next_key_value(p, &cursor, &key, &value);
+        if (rslt != jonmpOK) { break; }
+        if (((size_t)(key.end - key.start) == name_len)
+            && (0 == memcmp(key.start, name, name_len))) {
+            *parsed = value;
             return jonmpOK;
         }
-        s = pbjson_skip_whitespace(end + 1, p->end);
-        if (*s != ',') {
-            if (*s == '}') { break; }
-            return jonmpMissingValueSeparator;
-        }
     }
 
-    return (s < p->end) ? jonmpKeyNotFound : jonmpObjectIncomplete;
+    return rslt;
 }
 
 
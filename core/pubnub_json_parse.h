@@ -13,6 +13,11 @@
     generic, the user can use them, too, though their availability and
     interface are not guaranteed to survive Pubnub client version
     changes.
+
+    Long strings, complexes and runs of whitespace are scanned with
+    vector instructions (SSE2 or AVX2 on x86, whichever the CPU has,
+    NEON on ARM64), unless PBJSON_NO_SIMD is defined. Results are the
+    same as without them, for invalid JSON, too.
  */
 
 /** A representation of a JSON element. */
@@ -115,6 +120,27 @@ char const* pbjson_find_end_primitive(char const* start, char const* end);
 char const* pbjson_find_end_complex(char const* start, char const* end);
 
 
+/** Finds the commas that separate the elements of a JSON array,
+    whose contents (without the brackets) are from @p start until
+    @p end or the first NUL. Commas in strings and in nested arrays
+    or objects are not separators. The contents are not changed.
+
+    @param sep Array to put the offsets (from @p start) of the
+    separators to
+    @param n The number of elements of @p sep, has to be positive
+    @param complete Set to whether the contents are complete (no
+    string, array or object is left unterminated), if scanned to
+    the end
+    @return The number of separators found. If it is @p n, scanning
+    stopped at the last of them, there may be more after it.
+ */
+size_t pbjson_find_array_separators(char const* start,
+                                    char const* end,
+                                    size_t*     sep,
+                                    size_t      n,
+                                    bool*       complete);
+
+
 /** Finds the end of the JSON element starting from @p start, until
     @p end.  Interprets element as JSON does (primitive, object or array) -
     that should be compatible with a lot of other specifications.
@@ -129,6 +155,23 @@ char const* pbjson_find_end_complex(char const* start, char const* end);
 char const* pbjson_find_end_element(char const* start, char const* end);
 
 
+/** Gets the next key-value pair of the JSON object from @p p, for
+    going over all of them in one pass. @p cursor is where the
+    previous pair ended, it should be NULL on the first call.
+
+    On success, puts the key (without the quotes) to @p key and the
+    value to @p value, updates @p cursor and returns jonmpOK. After
+    the last pair, returns jonmpKeyNotFound. On failure, returns the
+    error code, as pbjson_get_object_value() would for a key that is
+    not before the error.
+*/
+enum pbjson_object_name_parse_result
+pbjson_get_next_key_value(struct pbjson_elem const* p,
+                          char const**              cursor,
+                          struct pbjson_elem*       key,
+                          struct pbjson_elem*       value);
+
+
 /** Gets the value from a JSON object from @p p, with the key @p name
     and puts it to @p parsed o success, returning jonmpOK. On failure,
     returns the error code and the effects on @p parsed are not
@@ -15,12 +15,21 @@
 #include "pubnub_ntf_enforcement.h"
 #endif
 #include "core/pbpal.h"
+#if PUBNUB_USE_CONNECTION_POOL
+#include "core/pbconn_pool.h"
+#endif
+#if PUBNUB_USE_PIPELINING
+#include "core/pbpipeline.h"
+#endif
 #include "core/pubnub_version.h"
 #include "core/pubnub_version_internal.h"
 #include "core/pubnub_helper.h"
 #if PUBNUB_USE_SUBSCRIBE_V2
 #include "core/pbcc_subscribe_v2.h"
 #endif
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+#include "core/pbsubscribe_v2_stream.h"
+#endif
 #if PUBNUB_USE_ADVANCED_HISTORY
 #include "core/pbcc_advanced_history.h"
 #endif
@@ -101,6 +110,27 @@
 #define possible_gzip_response(pb)
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+/* Streamed response body is received in the reply buffer piece by
+   piece, not allocated for all of it up front */
+#define stream_v2_wanted(pb) pbsubscribe_v2_stream_wanted(pb)
+#define stream_v2_streaming(pb) pbsubscribe_v2_streaming(pb)
+#else
+#define stream_v2_wanted(pb) false
+#define stream_v2_streaming(pb) false
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+/* Compressed response body is inflated into the reply buffer as it
+   is received, piece by piece */
+#define inflating(pb) pbgzip_inflating(pb)
+#define inflate_body(pb, len)                                                  \
+    pbgzip_inflate((pb), (uint8_t const*)(pb)->core.http_buf, (len))
+#else
+#define inflating(pb) false
+#define inflate_body(pb, len) PNR_INTERNAL_ERROR
+#endif /* PUBNUB_RECEIVE_GZIP_STREAMING */
+
 bool HTTP_request_has_body(const struct pubnub_* pb)
 {
     switch (pb->method) {
@@ -320,24 +350,164 @@ static void log_http_response(struct pubnub_* pb, char const* location)
 }
 #endif /* PUBNUB_LOG_ENABLED(DEBUG) */
 
-static int send_fin_head(struct pubnub_* pb)
+/** Puts the last lines of the HTTP request head of @p pb to @p s, of
+    size @p n. Returns the length of the lines, which is >= @p n if
+    they don't fit.
+ */
+static int fin_head(struct pubnub_* pb, char* s, size_t n)
 {
-    char s[200];
     /* Use context-specific identification when runtime suffix is set;
        otherwise preserve default (pubnub_uagent). */
     char const* uagent = (pb->core.sdk_version_suffix != NULL)
                              ? pbcc_uname(&pb->core)
                              : pubnub_uagent();
-    snprintf(
-        s,
-        sizeof s,
-        "\r\nUser-Agent: %s%s",
-        uagent,
-        "\r\n" ACCEPT_ENCODING "\r\n");
+    return snprintf(
+        s, n, "\r\nUser-Agent: %s%s", uagent, "\r\n" ACCEPT_ENCODING "\r\n");
+}
+
+
+static char const* request_body(struct pubnub_* pb, size_t* len)
+{
+    char const* message = pb->core.message_to_send;
+#if PUBNUB_USE_GZIP_COMPRESSION
+    *len = (pb->core.gzip_msg_len != 0) ? pb->core.gzip_msg_len : strlen(message);
+#else
+    *len = strlen(message);
+#endif
+    return message;
+}
+
+
+/** Returns where the HTTP request of @p pb is serialized to - in the
+    HTTP buffer, right after the URL (path) in it, or after the body,
+    if it's there, too (both are kept intact, as the request may have
+    to be sent again, on a new connection).
+ */
+static char* serialized_request(struct pubnub_* pb)
+{
+    char* rslt = pb->core.http_buf + pb->core.http_buf_len + 1;
+    if (HTTP_request_has_body(pb) && (pb->core.message_to_send == rslt)) {
+        rslt += strlen(rslt) + 1;
+    }
+    return rslt;
+}
+
+
+/** Starts sending @p s, a piece of the HTTP request of @p pb that
+    was put together on the stack. The PAL keeps sending from where
+    it's told to until it's all sent, so, if there's room, @p s is
+    copied to serialized_request() first.
+ */
+static int send_piece(struct pubnub_* pb, char const* s)
+{
+    char* const  at  = serialized_request(pb);
+    size_t const len = strlen(s);
+
+    if (at + len < pb->core.http_buf + sizeof pb->core.http_buf) {
+        memcpy(at, s, len + 1);
+        s = at;
+    }
     return pbpal_send_str(pb, s);
 }
 
 
+static int send_fin_head(struct pubnub_* pb)
+{
+    char s[200];
+    fin_head(pb, s, sizeof s);
+    return send_piece(pb, s);
+}
+
+
+#if PUBNUB_COALESCE_HTTP_REQUEST
+
+/** Serializes the HTTP request of @p pb - the request line, headers
+    and the body, if it's not too long - to the HTTP buffer, at
+    serialized_request().
+
+    @param with_body Set to whether the body was serialized, too
+    @return Length of the serialized request, 0 if it doesn't fit
+    in the buffer (so has to be sent piece by piece)
+ */
+static size_t serialize_request(struct pubnub_* pb, bool* with_body)
+{
+    char const* verb   = get_method_verb_string(pb);
+    char const* origin = PUBNUB_ORIGIN_SETTABLE ? pb->origin : PUBNUB_ORIGIN;
+    char*       start  = serialized_request(pb);
+    char* const end    = pb->core.http_buf + sizeof pb->core.http_buf;
+    char*       p      = start;
+    size_t      len;
+    int         n;
+
+#define PUT(s, l)                                                              \
+    if ((size_t)(end - p) <= (l)) { return 0; }                                \
+    memcpy(p, (s), (l));                                                       \
+    p += (l)
+
+    len = strlen(verb);
+    PUT(verb, len);
+    PUT(pb->core.http_buf, pb->core.http_buf_len);
+    PUT(" HTTP/1.1\r\nHost: ", sizeof " HTTP/1.1\r\nHost: " - 1);
+    len = strlen(origin);
+    PUT(origin, len);
+    if (HTTP_request_has_body(pb)) {
+        char hedr[128] = "\r\n";
+        pbcc_via_post_headers(&(pb->core), hedr + 2, sizeof hedr - 2);
+        len = strlen(hedr);
+        PUT(hedr, len);
+    }
+    n = fin_head(pb, p, end - p);
+    if ((n < 0) || (n >= end - p)) { return 0; }
+    p += n;
+
+    *with_body = false;
+    if (HTTP_request_has_body(pb)) {
+        char const* body = request_body(pb, &len);
+        if ((len <= PUBNUB_COALESCE_BODY_MAXLEN) && ((size_t)(end - p) > len)) {
+            memcpy(p, body, len);
+            p += len;
+            *with_body = true;
+        }
+    }
+#undef PUT
+
+    return p - start;
+}
+#endif /* PUBNUB_COALESCE_HTTP_REQUEST */
+
+
+/** Starts sending the HTTP request of @p pb. If possible, the whole
+    request is sent at once, otherwise (like when using a proxy), it
+    is sent piece by piece, starting with the method.
+ */
+static int send_request(struct pubnub_* pb)
+{
+#if PUBNUB_COALESCE_HTTP_REQUEST
+    bool   with_body = false;
+    size_t len = 0;
+
+#if PUBNUB_PROXY_API
+    if (pbproxyNONE == pb->proxy_type)
+#endif
+    {
+        len = serialize_request(pb, &with_body);
+    }
+    if (len > 0) {
+        PUBNUB_LOG_TRACE(
+            pb,
+            "Sending HTTP request at once: %lu bytes%s",
+            (unsigned long)len,
+            with_body ? ", body included" : "");
+        /* If the body was not included, it's to be sent after the head */
+        pb->state = with_body ? PBS_TX_BODY : PBS_TX_FIN_HEAD;
+        return pbpal_send(pb, serialized_request(pb), len);
+    }
+#endif /* PUBNUB_COALESCE_HTTP_REQUEST */
+    pb->state = PBS_TX_GET;
+    return pbpal_send_str(pb, get_method_verb_string(pb));
+}
+
+
 #define SEND_FIN_HEAD(pb)                                                      \
     if (0 > send_fin_head(pb)) {                                               \
         outcome_detected(pb, PNR_IO_ERROR);                                    \
@@ -472,6 +642,21 @@ static enum pubnub_state close_kept_alive_connection(struct pubnub_* pb)
 
 static void outcome_detected(struct pubnub_* pb, enum pubnub_res rslt)
 {
+#if PUBNUB_USE_PIPELINING
+    switch (rslt) {
+    case PNR_IO_ERROR:
+    case PNR_CONNECTION_TIMEOUT:
+    case PNR_TIMEOUT:
+        /* Connection lost, with pipelined requests unanswered */
+        if (pbpipeline_connection_lost(pb)) {
+            pb->state = close_kept_alive_connection(pb);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+#endif
     pb->core.last_result = rslt;
 
 #if PUBNUB_LOG_ENABLED(ERROR)
@@ -536,13 +721,34 @@ static void outcome_detected(struct pubnub_* pb, enum pubnub_res rslt)
 #endif /* PUBNUB_LOG_ENABLED(ERROR) */
 
     if (should_keep_alive(pb, rslt)) {
+#if PUBNUB_USE_PIPELINING
+        if (pbpipeline_next_response(pb)) {
+            /* More pipelined responses to read on this connection */
+#if PUBNUB_USE_LOGGER
+            pb->core.last_request_url[0] = '\0';
+#endif
+            return;
+        }
+#endif
         /* We don't monitor the connection while in "keep-alive idle".
            This is easy on the CPU and we don't really care much, as
            we don't have a way to report to the user that the
            connection was lost.
          */
         pbntf_lost_socket(pb);
-        pbntf_trans_outcome(pb, PBS_KEEP_ALIVE_IDLE);
+#if PUBNUB_USE_CONNECTION_POOL
+        /* The connection is shared, so we'll borrow one (maybe this
+           same one) when the next transaction starts.
+         */
+        if (pbconn_pool_put(pb)) {
+            pb->flags.started_while_kept_alive = false;
+            pbntf_trans_outcome(pb, PBS_IDLE);
+        }
+        else
+#endif
+        {
+            pbntf_trans_outcome(pb, PBS_KEEP_ALIVE_IDLE);
+        }
 #if PUBNUB_NEED_RETRY_AFTER_CLOSE
         pb->flags.retry_after_close = false;
 #endif
@@ -751,12 +957,50 @@ static enum pubnub_res finish(struct pubnub_* pb)
     if ((PNR_OK == pbres) && ((pb->http_code / 100) != 2)) {
         pbres = PNR_HTTP_ERROR;
     }
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+    if (PNR_OK == pbres) { pbsubscribe_v2_stream_rest(pb); }
+#endif
 
     outcome_detected(pb, pbres);
     return pbres;
 }
 
 
+/** Appends the @p len octets of the response body just received in
+    the HTTP buffer of @p pb to its reply buffer - inflating them if
+    the body is compressed and streaming them if they should be.
+    @retval 0 OK
+    @retval -1 Failed, outcome of the transaction was detected
+ */
+static int append_body(struct pubnub_* pb, size_t len)
+{
+    if (inflating(pb)) {
+        enum pubnub_res const rslt = inflate_body(pb, len);
+        if (rslt != PNR_OK) {
+            outcome_detected(pb, rslt);
+            return -1;
+        }
+    }
+    else {
+        /* A streamed body may stop being streamed at any point, so
+           don't rely on the buffer being allocated for the whole body */
+        if (0 != pbcc_realloc_reply_buffer(
+                &pb->core, pb->core.http_buf_len + len)) {
+            outcome_detected(pb, PNR_REPLY_TOO_BIG);
+            return -1;
+        }
+        memcpy(
+            pb->core.http_reply + pb->core.http_buf_len, pb->core.http_buf, len);
+        pb->core.http_buf_len += len;
+    }
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+    if (pbsubscribe_v2_streaming(pb)) { pbsubscribe_v2_stream_feed(pb); }
+#endif
+
+    return 0;
+}
+
+
 char const* pbcc_state_2_string(enum pubnub_state e)
 {
     switch (e) {
@@ -889,6 +1133,16 @@ next_state:
         break;
     case PBS_IDLE:
         initialize_fields_in_state_IDLE(pb);
+#if PUBNUB_DYNAMIC_REPLY_BUFFER
+        pbcc_trim_reply_buffer(&pb->core, PUBNUB_REPLY_BUFFER_KEEP_MAX);
+#endif
+#if PUBNUB_USE_CONNECTION_POOL
+        if (pbconn_pool_take(pb)) {
+            pb->flags.should_close = false;
+            pb->state              = PBS_KEEP_ALIVE_IDLE;
+            goto next_state;
+        }
+#endif
         pb->state = PBS_READY;
         switch (pbntf_enqueue_for_processing(pb)) {
         case -1:
@@ -1110,12 +1364,11 @@ next_state:
         if (pubnub_logger_should_log(pb, PUBNUB_LOG_LEVEL_DEBUG))
             log_http_request(pb, PUBNUB_LOG_LOCATION, false, false, NULL);
 #endif /* PUBNUB_LOG_ENABLED(DEBUG) */
-        i = pbpal_send_str(pb, get_method_verb_string(pb));
+        i = send_request(pb);
         if (i < 0) {
             outcome_detected(pb, PNR_IO_ERROR);
             break;
         }
-        pb->state = PBS_TX_GET;
         goto next_state;
 #if PUBNUB_USE_SSL
     case PBS_WAIT_TLS_CONNECT: {
@@ -1126,12 +1379,11 @@ next_state:
             if (pubnub_logger_should_log(pb, PUBNUB_LOG_LEVEL_DEBUG))
                 log_http_request(pb, PUBNUB_LOG_LOCATION, false, false, NULL);
 #endif /* PUBNUB_LOG_ENABLED(DEBUG) */
-            i = pbpal_send_str(pb, get_method_verb_string(pb));
+            i = send_request(pb);
             if (i < 0) {
                 outcome_detected(pb, PNR_IO_ERROR);
                 break;
             }
-            pb->state = PBS_TX_GET;
             goto next_state;
         case pbtlsStarted:
         case pbtlsStartedWaitRead:
@@ -1341,7 +1593,7 @@ next_state:
                              pb, hedr + 2, sizeof hedr - 2)) {
                     PUBNUB_LOG_TRACE(pb, "Sending HTTP proxy header: %s", hedr);
                     pb->state = PBS_TX_EXTRA_HEADERS;
-                    if (-1 == pbpal_send_str(pb, hedr)) {
+                    if (-1 == send_piece(pb, hedr)) {
                         outcome_detected(pb, PNR_IO_ERROR);
                         break;
                     }
@@ -1360,7 +1612,7 @@ next_state:
                 PUBNUB_LOG_TRACE(
                     pb, "Sending HTTP body via POST/PATCH headers: %s", hedr);
                 pb->state = PBS_TX_EXTRA_HEADERS;
-                if (-1 == pbpal_send_str(pb, hedr)) {
+                if (-1 == send_piece(pb, hedr)) {
                     outcome_detected(pb, PNR_IO_ERROR);
                     break;
                 }
@@ -1390,21 +1642,29 @@ next_state:
                     (pbproxyNONE == pb->proxy_type))
 #endif
             ) {
-                const char* message = pb->core.message_to_send;
-#if PUBNUB_USE_GZIP_COMPRESSION
-                size_t len = (pb->core.gzip_msg_len != 0)
-                                 ? pb->core.gzip_msg_len
-                                 : strlen(message);
-#else
-                size_t len = strlen(message);
-#endif
-                pb->state = PBS_TX_BODY;
+                size_t      len;
+                const char* message = request_body(pb, &len);
+                pb->state           = PBS_TX_BODY;
                 if (-1 == pbpal_send(pb, message, len)) {
                     outcome_detected(pb, PNR_IO_ERROR);
                     break;
                 }
             }
             else {
+#if PUBNUB_USE_PIPELINING
+                if (pbpipeline_prepare_next_request(pb)) {
+#if PUBNUB_LOG_ENABLED(DEBUG)
+                    if (pubnub_logger_should_log(pb, PUBNUB_LOG_LEVEL_DEBUG))
+                        log_http_request(
+                            pb, PUBNUB_LOG_LOCATION, false, false, NULL);
+#endif
+                    if (-1 == send_request(pb)) {
+                        outcome_detected(pb, PNR_IO_ERROR);
+                        break;
+                    }
+                    goto next_state;
+                }
+#endif
                 pbpal_start_read_line(pb);
                 pb->state = PBS_RX_HTTP_VER;
                 pbntf_watch_in_events(pb);
@@ -1445,7 +1705,10 @@ next_state:
             pb->http_header_retry_after = 0;
 #endif // #if PUBNUB_USE_RETRY_CONFIGURATION
             pb->http_chunked = false;
-            pb->state        = PBS_RX_HEADERS;
+#if PUBNUB_RECEIVE_GZIP_RESPONSE
+            pb->data_compressed = compressionNONE;
+#endif
+            pb->state = PBS_RX_HEADERS;
             goto next_state;
         case PNR_CONNECTION_TIMEOUT:
         case PNR_IO_ERROR:
@@ -1524,6 +1787,15 @@ next_state:
 #endif
             if (read_len <= 2) {
                 pb->core.http_buf_len = 0;
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+                pbgzip_inflate_start(pb);
+#endif
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+                if (0 != pbsubscribe_v2_stream_start(pb)) {
+                    outcome_detected(pb, PNR_REPLY_TOO_BIG);
+                    break;
+                }
+#endif
                 if (!pb->http_chunked) {
                     if (0 == pb->core.http_content_len) {
 #if PUBNUB_PROXY_API
@@ -1570,7 +1842,8 @@ next_state:
                 pb_strncasecmp(
                     pb->core.http_buf, h_length, sizeof h_length - 1) == 0) {
                 size_t len = atoi(pb->core.http_buf + sizeof h_length - 1);
-                if (0 != pbcc_realloc_reply_buffer(&pb->core, len)) {
+                if (!stream_v2_wanted(pb)
+                    && (0 != pbcc_realloc_reply_buffer(&pb->core, len))) {
                     outcome_detected(pb, PNR_REPLY_TOO_BIG);
                     break;
                 }
@@ -1631,15 +1904,15 @@ next_state:
         case PNR_IN_PROGRESS:
             break;
         case PNR_OK: {
-            unsigned len = pbpal_read_len(pb);
-            PUBNUB_ASSERT_OPT(
-                pb->core.http_buf_len + len <= pb->core.http_content_len);
-            memcpy(
-                pb->core.http_reply + pb->core.http_buf_len,
-                pb->core.http_buf,
-                len);
-            pb->core.http_buf_len += len;
-            pb->state = PBS_RX_BODY;
+            unsigned     len  = pbpal_read_len(pb);
+            size_t const left =
+                pb->core.http_content_len - pb->core.http_buf_len;
+            PUBNUB_ASSERT_OPT(len <= left);
+            if (0 != append_body(pb, len)) { break; }
+            /* What's in the reply buffer may not be what was received
+               (inflated, or dropped after being streamed) */
+            pb->core.http_content_len = pb->core.http_buf_len + left - len;
+            pb->state                 = PBS_RX_BODY;
             goto next_state;
         }
         default:
@@ -1665,8 +1938,9 @@ next_state:
 #endif
             }
             else if (
-                0 != pbcc_realloc_reply_buffer(
-                         &pb->core, pb->core.http_buf_len + chunk_length)) {
+                !stream_v2_streaming(pb) && !inflating(pb)
+                && (0 != pbcc_realloc_reply_buffer(
+                         &pb->core, pb->core.http_buf_len + chunk_length))) {
                 outcome_detected(pb, PNR_REPLY_TOO_BIG);
             }
             else {
@@ -1705,11 +1979,7 @@ next_state:
                 unsigned to_copy =
                     pb->core.http_content_len - CHUNK_TRAIL_LENGTH;
                 if (len < to_copy) { to_copy = len; }
-                memcpy(
-                    pb->core.http_reply + pb->core.http_buf_len,
-                    pb->core.http_buf,
-                    to_copy);
-                pb->core.http_buf_len += to_copy;
+                if (0 != append_body(pb, to_copy)) { break; }
             }
             pb->core.http_content_len -= len;
             pb->state = PBS_RX_BODY_CHUNK;
@@ -1760,6 +2030,9 @@ next_state:
         pb->proxy_saved_path_len     = 0;
         pb->proxy_authorization_sent = false;
         pb->auth_msg_count           = 0;
+#endif
+#if PUBNUB_DYNAMIC_REPLY_BUFFER
+        pbcc_trim_reply_buffer(&pb->core, PUBNUB_REPLY_BUFFER_KEEP_MAX);
 #endif
         pb->state                          = PBS_KEEP_ALIVE_READY;
         pb->flags.started_while_kept_alive = true;
@@ -1789,8 +2062,7 @@ next_state:
         if (pubnub_logger_should_log(pb, PUBNUB_LOG_LEVEL_DEBUG))
             log_http_request(pb, PUBNUB_LOG_LOCATION, false, false, NULL);
 #endif
-        pb->state = PBS_TX_GET;
-        i         = pbpal_send_str(pb, get_method_verb_string(pb));
+        i = send_request(pb);
         if (i < 0) { pb->state = close_kept_alive_connection(pb); }
         goto next_state;
     case PBS_KEEP_ALIVE_WAIT_CLOSE:
@@ -1816,6 +2088,9 @@ next_state:
     }
 #if PUBNUB_ADNS_RETRY_AFTER_CLOSE
     if (PBS_RETRY == pb->state) { goto next_state; }
+#endif
+#if PUBNUB_USE_PIPELINING
+    if (pbpipeline_should_resume(pb)) { goto next_state; }
 #endif
     return 0;
 }
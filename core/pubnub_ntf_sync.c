@@ -12,6 +12,7 @@
 
 #include "pubnub_internal.h"
 #include "pbpal.h"
+#include "pbpal_ntf_sync_wait.h"
 #include "pubnub_assert.h"
 #if PUBNUB_USE_LOGGER
 #include "pbcc_logger_manager.h"
@@ -45,6 +46,11 @@ MAYBE_INLINE int pbntf_got_socket_sync(pubnub_t* pb)
 {
 #if PUBNUB_BLOCKING_IO_SETTABLE
     pbpal_set_blocking_io(pb);
+#endif
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    /* Like in the callback interface, a new socket is first waited
+       to be writable (connected) */
+    pb->sync_wait.in = false;
 #endif
     return +1;
 }
@@ -118,7 +124,11 @@ MAYBE_INLINE int pbntf_enqueue_for_processing_sync(pubnub_t* pb)
 
 MAYBE_INLINE int pbntf_requeue_for_processing_sync(pubnub_t* pb)
 {
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pb->sync_wait.requeued = true;
+#else
     PUBNUB_UNUSED(pb);
+#endif
 
     return 0;
 }
@@ -126,14 +136,22 @@ MAYBE_INLINE int pbntf_requeue_for_processing_sync(pubnub_t* pb)
 
 MAYBE_INLINE int pbntf_watch_out_events_sync(pubnub_t* pbp)
 {
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pbp->sync_wait.in = false;
+#else
     PUBNUB_UNUSED(pbp);
+#endif
     return 0;
 }
 
 
 MAYBE_INLINE int pbntf_watch_in_events_sync(pubnub_t* pbp)
 {
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pbp->sync_wait.in = true;
+#else
     PUBNUB_UNUSED(pbp);
+#endif
     return 0;
 }
 
@@ -264,6 +282,9 @@ enum pubnub_res pubnub_await(pubnub_t* pb)
 
     pb->should_stop_await = false;
     t0                    = pbms_start();
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pbpal_ntf_sync_wait_start(pb);
+#endif
     while (!pbnc_can_start_transaction(pb)) {
         // Checking whether await cycle should be stopped or not.
         pubnub_mutex_lock(pb->cancel_monitor);
@@ -271,6 +292,9 @@ enum pubnub_res pubnub_await(pubnub_t* pb)
             // Need to reset cancellation flag.
             pb->should_stop_await = false;
             pubnub_mutex_unlock(pb->cancel_monitor);
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+            pbpal_ntf_sync_wait_stop(pb);
+#endif
             pubnub_mutex_unlock(pb->monitor);
             // This is not real result because actual cancellation result is
             // returned by `pubnub_cancel()` function.
@@ -280,6 +304,9 @@ enum pubnub_res pubnub_await(pubnub_t* pb)
 
         pbms_t delta;
 
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+        pb->sync_wait.requeued = false;
+#endif
         pbnc_fsm(pb);
 
         delta = pbms_elapsed(t0);
@@ -293,7 +320,16 @@ enum pubnub_res pubnub_await(pubnub_t* pb)
                 break;
             }
         }
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+        else if (!pb->sync_wait.requeued && !pbnc_can_start_transaction(pb)) {
+            /* Nothing to do until the socket is ready */
+            pbpal_ntf_sync_wait(pb, pb->transaction_timeout_ms - (int)delta + 1);
+        }
+#endif
     }
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pbpal_ntf_sync_wait_stop(pb);
+#endif
     result = pb->core.last_result;
     if (result != PNR_OK) { pbnc_tr_cxt_state_reset_sync(pb); }
     pubnub_mutex_unlock(pb->monitor);
@@ -0,0 +1,404 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#if PUBNUB_USE_PIPELINING
+#include "core/pubnub_pipelining.h"
+#include "core/pbpipeline.h"
+#else
+#error PUBNUB_USE_PIPELINING must be defined and set to 1 before compiling this file
+#endif
+
+#include "core/pubnub_ccore.h"
+#include "core/pubnub_ccore_pubsub.h"
+#include "core/pubnub_netcore.h"
+#include "core/pubnub_helper.h"
+#include "core/pubnub_assert.h"
+#include "core/pbpal.h"
+#if PUBNUB_USE_LOGGER
+#include "core/pbcc_logger_manager.h"
+#endif // PUBNUB_USE_LOGGER
+
+#include <stdlib.h>
+#include <string.h>
+
+
+static struct pbpipeline_request* request_at(pubnub_t* pb, unsigned i)
+{
+    return &pb->pipeline.ring[(pb->pipeline.head + i) % PUBNUB_PIPELINE_DEPTH];
+}
+
+
+static void pop_head(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+
+    PUBNUB_ASSERT_OPT(p->count > 0);
+    free(p->ring[p->head].channel);
+    p->ring[p->head].channel = NULL;
+    p->head                  = (p->head + 1) % PUBNUB_PIPELINE_DEPTH;
+    --p->count;
+}
+
+
+/** Returns whether a request for @p trans can be sent again, without
+    changing the outcome, if its response was lost. Publish and signal
+    may have been done, so doing them again could duplicate them.
+ */
+static bool idempotent(enum pubnub_trans trans)
+{
+    return PBTT_TIME == trans;
+}
+
+
+/** Prepares the HTTP request of @p req in the HTTP buffer of @p pb */
+static enum pubnub_res prepare(pubnub_t* pb, struct pbpipeline_request const* req)
+{
+    switch (req->trans) {
+    case PBTT_PUBLISH:
+        return pbcc_publish_prep(
+            &pb->core,
+            req->channel,
+            req->message,
+            NULL,
+            true,
+            false,
+            NULL,
+            SIZE_MAX,
+            pubnubSendViaGET);
+    case PBTT_SIGNAL:
+        return pbcc_signal_prep(&pb->core, req->channel, req->message, NULL);
+    case PBTT_TIME:
+        /* Outcome of a pipelined transaction is to be read in the
+           callback, so what is left unread now will never be */
+        pb->core.msg_ofs = pb->core.msg_end;
+        return pbcc_time_prep(&pb->core);
+    default:
+        return PNR_INTERNAL_ERROR;
+    }
+}
+
+
+static void report(pubnub_t* pb, enum pubnub_trans trans, enum pubnub_res rslt)
+{
+    if (pb->cb != NULL) {
+#if PUBNUB_USE_PUBLISH_QUEUE
+        bool const in_callback        = pb->publish_queue.in_callback;
+        pb->publish_queue.in_callback = true;
+#endif
+        PUBNUB_LOG_TRACE(
+            pb,
+            "Call callback for %d pipelined transaction outcome: %s",
+            trans,
+            pubnub_res_2_string(rslt));
+        pb->cb(pb, trans, rslt, pb->user_data);
+#if PUBNUB_USE_PUBLISH_QUEUE
+        pb->publish_queue.in_callback = in_callback;
+#endif
+    }
+}
+
+
+/** Starts the transaction for the request at the head of the queue
+    of @p pb.
+
+    @retval PNR_STARTED Started (and maybe already finished)
+    @retval other Failed to prepare the request, not started
+ */
+static enum pubnub_res start_head(pubnub_t* pb)
+{
+    struct pbpipeline*               p   = &pb->pipeline;
+    struct pbpipeline_request const* req = request_at(pb, 0);
+    enum pubnub_res                  rslt;
+
+    if (req->lost) { return PNR_IO_ERROR; }
+    rslt = prepare(pb, req);
+    if (rslt != PNR_STARTED) { return rslt; }
+    pb->trans            = p->ring[p->head].trans;
+    pb->core.last_result = PNR_STARTED;
+    p->active            = true;
+    p->sent              = 1;
+    p->answered          = 0;
+    pbnc_fsm(pb);
+
+    return PNR_STARTED;
+}
+
+
+static enum pubnub_res enqueue(
+    pubnub_t*         pb,
+    enum pubnub_trans trans,
+    char const*       channel,
+    char const*       message)
+{
+    struct pbpipeline*         p = &pb->pipeline;
+    struct pbpipeline_request* req;
+    enum pubnub_res            rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+#if defined(PUBNUB_NTF_RUNTIME_SELECTION)
+    if (PNA_CALLBACK != pb->api_policy) {
+        pubnub_mutex_unlock(pb->monitor);
+        return PNR_INTERNAL_ERROR;
+    }
+#endif
+    if (PUBNUB_PIPELINE_DEPTH == p->count) {
+        PUBNUB_LOG_WARNING(pb, "Pipeline is full, can't queue request");
+        pubnub_mutex_unlock(pb->monitor);
+        return PNR_IN_PROGRESS;
+    }
+    req          = request_at(pb, p->count);
+    req->trans   = trans;
+    req->channel = NULL;
+    req->message = NULL;
+    req->lost    = false;
+    if (channel != NULL) {
+        size_t const channel_len = strlen(channel) + 1;
+        size_t const message_len = strlen(message) + 1;
+        req->channel = (char*)malloc(channel_len + message_len);
+        if (NULL == req->channel) {
+            pubnub_mutex_unlock(pb->monitor);
+            return PNR_OUT_OF_MEMORY;
+        }
+        memcpy(req->channel, channel, channel_len);
+        memcpy(req->channel + channel_len, message, message_len);
+        req->message = req->channel + channel_len;
+    }
+    ++p->count;
+    PUBNUB_LOG_DEBUG(
+        pb, "Queued %d transaction to pipeline, %u queued", trans, p->count);
+
+    rslt = PNR_STARTED;
+    if ((1 == p->count) && pbnc_can_start_transaction(pb)) {
+        rslt = start_head(pb);
+        if (rslt != PNR_STARTED) { pop_head(pb); }
+        else {
+            rslt = pb->core.last_result;
+        }
+    }
+    /* Otherwise, it will be started when the transaction(s) before it
+       are done */
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+enum pubnub_res pubnub_pipeline_publish(
+    pubnub_t*   pb,
+    const char* channel,
+    const char* message)
+{
+    PUBNUB_ASSERT_OPT(channel != NULL);
+    PUBNUB_ASSERT_OPT(message != NULL);
+    return enqueue(pb, PBTT_PUBLISH, channel, message);
+}
+
+
+enum pubnub_res pubnub_pipeline_signal(
+    pubnub_t*   pb,
+    const char* channel,
+    const char* message)
+{
+    PUBNUB_ASSERT_OPT(channel != NULL);
+    PUBNUB_ASSERT_OPT(message != NULL);
+    return enqueue(pb, PBTT_SIGNAL, channel, message);
+}
+
+
+enum pubnub_res pubnub_pipeline_time(pubnub_t* pb)
+{
+    return enqueue(pb, PBTT_TIME, NULL, NULL);
+}
+
+
+unsigned pubnub_pipeline_pending(pubnub_t* pb)
+{
+    unsigned rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    rslt = pb->pipeline.count;
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+bool pbpipeline_active(pubnub_t const* pb)
+{
+    return pb->pipeline.active;
+}
+
+
+bool pbpipeline_prepare_next_request(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+
+    if (!p->active || p->fallback || (p->sent >= p->count)
+        || !pb->options.use_http_keep_alive) {
+        return false;
+    }
+#if PUBNUB_PROXY_API
+    if (pb->proxy_type != pbproxyNONE) { return false; }
+#endif
+    if (request_at(pb, p->sent)->lost) {
+        /* It fails when it's its turn, nothing to send */
+        return false;
+    }
+    if (prepare(pb, request_at(pb, p->sent)) != PNR_STARTED) {
+        /* It will fail again, and be reported, when it's its turn */
+        p->fallback = true;
+        return false;
+    }
+    ++p->sent;
+    /* The HTTP buffer doesn't hold the request of the current
+       transaction anymore, so it can't just be sent again if the
+       connection was closed while it was kept alive.
+     */
+    pb->flags.started_while_kept_alive = false;
+    PUBNUB_LOG_TRACE(pb, "Pipelining request #%u on the connection", p->sent);
+
+    return true;
+}
+
+
+bool pbpipeline_next_response(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+    enum pubnub_trans  trans;
+    enum pubnub_res    rslt;
+
+    if (!p->active || (p->sent < 2)) { return false; }
+
+    trans = pb->trans;
+    rslt  = pb->core.last_result;
+    pop_head(pb);
+    --p->sent;
+    ++p->answered;
+
+    pb->flags.started_while_kept_alive = false;
+#if PUBNUB_USE_LOGGER
+    pb->core.last_response_headers[0]  = '\0';
+    pb->core.last_response_headers_len = 0;
+#endif
+    pbntf_start_transaction_timer(pb);
+    pbpal_start_read_line(pb);
+    pb->state = PBS_RX_HTTP_VER;
+
+    /* We're deep in the FSM, so the callback is called when it's done
+       with this response, before it starts reading the next one (see
+       pbpipeline_should_resume()).
+     */
+    p->to_report    = true;
+    p->report_trans = trans;
+    p->report_rslt  = rslt;
+    p->resume       = true;
+
+    return true;
+}
+
+
+bool pbpipeline_connection_lost(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+    unsigned           i;
+
+    if (!p->active || ((p->sent < 2) && (0 == p->answered))) { return false; }
+    /* Those that are not idempotent may have been done, even if their
+       response was lost, so they're not sent again, but fail */
+    for (i = 1; i < p->sent; ++i) {
+        struct pbpipeline_request* req = request_at(pb, i);
+        if (!idempotent(req->trans)) { req->lost = true; }
+    }
+    if (!idempotent(pb->trans)) {
+        PUBNUB_LOG_DEBUG(
+            pb,
+            "Connection lost with %u pipelined request(s) unanswered, "
+            "failing those that are not idempotent",
+            p->sent);
+        return false;
+    }
+    if (prepare(pb, request_at(pb, 0)) != PNR_STARTED) { return false; }
+    PUBNUB_LOG_DEBUG(
+        pb,
+        "Connection lost with %u pipelined request(s) unanswered, "
+        "sending them one at a time",
+        p->sent);
+    p->sent     = 1;
+    p->answered = 0;
+    p->fallback = true;
+    p->resume   = true;
+
+    return true;
+}
+
+
+void pbpipeline_trans_ended(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+
+    if ((PNR_CANCELLED == pb->core.last_result) && (p->count > 0)) {
+        PUBNUB_LOG_DEBUG(
+            pb, "Dropping %u pipelined request(s) on cancel", p->count);
+        pbpipeline_free(pb);
+    }
+    else if (p->active) {
+        pop_head(pb);
+        p->active = false;
+    }
+    /* If requests were left unanswered, the next one will be sent on
+       a new connection, so it should be sent alone.
+     */
+    p->fallback = (p->sent > 1) && (p->count > 0);
+    p->sent     = 0;
+    p->answered = 0;
+}
+
+
+void pbpipeline_dispatch(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+
+    while (!p->active && (p->count > 0) && pbnc_can_start_transaction(pb)) {
+        enum pubnub_trans const trans = p->ring[p->head].trans;
+        enum pubnub_res const   rslt  = start_head(pb);
+        if (rslt != PNR_STARTED) {
+            pop_head(pb);
+            pb->core.last_result = rslt;
+            report(pb, trans, rslt);
+        }
+    }
+}
+
+
+bool pbpipeline_should_resume(pubnub_t* pb)
+{
+    struct pbpipeline* p = &pb->pipeline;
+
+    if (!p->resume) { return false; }
+    p->resume = false;
+    if (p->to_report) {
+        p->to_report = false;
+        /* The user may get the outcome of the transaction in the
+           callback, for which `trans` should be the one that was
+           answered */
+        report(pb, p->report_trans, p->report_rslt);
+        /* Unless the callback cancelled the transaction */
+        if (PBS_RX_HTTP_VER != pb->state) { return false; }
+        pb->trans            = p->ring[p->head].trans;
+        pb->core.last_result = PNR_STARTED;
+    }
+    return true;
+}
+
+
+void pbpipeline_free(pubnub_t* pb)
+{
+    while (pb->pipeline.count > 0) {
+        pop_head(pb);
+    }
+    pb->pipeline.active = false;
+}
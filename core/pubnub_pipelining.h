@@ -0,0 +1,100 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_PIPELINING
+#define INC_PUBNUB_PIPELINING
+
+#if PUBNUB_USE_PIPELINING
+
+#include "core/pubnub_api_types.h"
+#include "lib/pb_extern.h"
+
+
+/** @file pubnub_pipelining.h
+
+    HTTP/1.1 request pipelining on the (keep-alive) connection of a
+    context. Instead of waiting for the response to a request before
+    sending the next one, a context can send several requests, one
+    after another, and then read their responses, in the same order.
+    This saves a network round-trip per request, which makes a big
+    difference when sending a lot of small requests (like a burst of
+    publishes) over a link with high latency.
+
+    Requests to pipeline are queued on the context (at most
+    #PUBNUB_PIPELINE_DEPTH of them). Each of them is a transaction of
+    its own: when its response is read, the callback of the context
+    is called, with the type of the transaction and its outcome, as
+    usual. Callbacks are called in the order the requests were
+    queued. In the callback, the outcome of the transaction is read
+    in the usual way (like with pubnub_last_publish_result()), but it
+    has to be done in the callback, as the next response will be read
+    right after it returns.
+
+    Only requests that are sent with HTTP GET are pipelined, so
+    publish is always done via GET. Requests are pipelined only if
+    the context uses HTTP keep-alive and doesn't use a proxy, otherwise
+    they are sent one at a time (after the previous one is done).
+
+    If the connection is closed by the server before all the
+    pipelined requests were answered, the idempotent ones that weren't
+    (time) are sent again, one at a time, on a new connection (as RFC
+    7230 6.3.2 requires), until the queue is empty. The others
+    (publish, signal) may have been done, so they are not sent again,
+    but fail (with #PNR_IO_ERROR, unless it's the current one, which
+    fails the way the connection was lost).
+
+    Cancelling (pubnub_cancel()) the current transaction of a context
+    drops all the requests queued on it, too. Pipelined transactions
+    are not retried per the retry configuration of the context.
+
+    This is available only with the callback interface. Queued
+    requests are started when the context is idle, after the callback
+    for the previous transaction returns. So, a transaction started
+    with the "regular" API (like pubnub_publish()) from the callback
+    is done before the queued requests - which is why one should not
+    subscribe in a loop on a context used for pipelining.
+ */
+
+
+/** Queues a publish of @p message on @p channel on the context @p pb,
+    to be pipelined. Parameters are the same as for pubnub_publish()
+    and are copied, so they don't have to be kept.
+
+    @return #PNR_STARTED if queued, #PNR_IN_PROGRESS if the queue
+    is full, #PNR_OUT_OF_MEMORY if out of memory
+ */
+PUBNUB_EXTERN enum pubnub_res pubnub_pipeline_publish(
+    pubnub_t*   pb,
+    const char* channel,
+    const char* message);
+
+/** Queues a signal of @p message on @p channel on the context @p pb,
+    to be pipelined. Parameters are the same as for pubnub_signal()
+    and are copied, so they don't have to be kept.
+
+    @return #PNR_STARTED if queued, #PNR_IN_PROGRESS if the queue
+    is full, #PNR_OUT_OF_MEMORY if out of memory
+ */
+PUBNUB_EXTERN enum pubnub_res pubnub_pipeline_signal(
+    pubnub_t*   pb,
+    const char* channel,
+    const char* message);
+
+/** Queues a "get time" request on the context @p pb, to be
+    pipelined. Same as pubnub_time(), otherwise.
+
+    @return #PNR_STARTED if queued, #PNR_IN_PROGRESS if the queue
+    is full
+ */
+PUBNUB_EXTERN enum pubnub_res pubnub_pipeline_time(pubnub_t* pb);
+
+/** Returns the number of requests queued on the context @p pb, that
+    are not done yet, including the one of the current transaction,
+    if it is pipelined.
+ */
+PUBNUB_EXTERN unsigned pubnub_pipeline_pending(pubnub_t* pb);
+
+
+#else
+#error To use the pipelining API you must define PUBNUB_USE_PIPELINING=1
+#endif /* PUBNUB_USE_PIPELINING */
+
+#endif /* !defined INC_PUBNUB_PIPELINING */
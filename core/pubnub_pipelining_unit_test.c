@@ -0,0 +1,429 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+#include "test/pubnub_test_mocks.h"
+#include "test/pubnub_test_helper.h"
+
+#include "pubnub_internal.h"
+#include "pubnub_version_internal.h"
+#include "pubnub_pubsubapi.h"
+#include "pubnub_pipelining.h"
+#include "pubnub_netcore.h"
+#include "pubnub_alloc.h"
+#include "pbpal.h"
+
+#include <string.h>
+
+
+/* A less chatty cgreen :) */
+
+#define attest assert_that
+#define equals is_equal_to
+#define streqs is_equal_to_string
+#define returns will_return
+
+
+/** Maximum number of outcomes a test goes through */
+#define MAX_REPORTED 8
+
+/** An outcome of a (pipelined) transaction, as reported in the
+    callback */
+struct outcome {
+    enum pubnub_trans trans;
+    enum pubnub_res   rslt;
+    /** Time token, for the time transaction */
+    char timetoken[20];
+};
+
+static pubnub_t* pbp;
+
+static struct outcome m_reported[MAX_REPORTED];
+static size_t         m_reported_count;
+
+/** Whether the callback cancels the transaction */
+static bool m_cancel_in_callback;
+
+
+static void callback(pubnub_t*         pb,
+                     enum pubnub_trans trans,
+                     enum pubnub_res   rslt,
+                     void*             user_data)
+{
+    struct outcome* out;
+
+    attest(m_reported_count, is_less_than(MAX_REPORTED));
+    out        = &m_reported[m_reported_count++];
+    out->trans = trans;
+    out->rslt  = rslt;
+    out->timetoken[0] = '\0';
+    if ((PBTT_TIME == trans) && (PNR_OK == rslt)) {
+        char const* tt = pubnub_get(pb);
+        attest(tt, is_not_null);
+        if (tt != NULL) {
+            strncpy(out->timetoken, tt, sizeof out->timetoken - 1);
+            out->timetoken[sizeof out->timetoken - 1] = '\0';
+        }
+    }
+    if (m_cancel_in_callback) {
+        m_cancel_in_callback = false;
+        expect(pbntf_requeue_for_processing, when(pb, equals(pbp)));
+        attest(pubnub_cancel(pb), equals(PN_CANCEL_STARTED));
+    }
+}
+
+
+/** Expects the request for @p url to be sent, with nothing after it -
+    either another request is pipelined, or the response is waited for
+ */
+static void expect_request(char const* url)
+{
+    expect(pbpal_send_str, when(s, streqs("GET ")), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(url)), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send, when(data, streqs(" HTTP/1.1\r\nHost: ")), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(PUBNUB_ORIGIN)), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str,
+           when(s,
+                streqs("\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
+                       "\r\n" ACCEPT_ENCODING "\r\n")),
+           returns(0));
+    expect(pbpal_send_status, returns(0));
+}
+
+
+static void expect_response_wait(void)
+{
+    expect(pbntf_watch_in_events, when(pb, equals(pbp)), returns(0));
+}
+
+
+/** Expects a new connection to be made, which is waited for */
+static void expect_connection_wait(void)
+{
+    expect(pbntf_enqueue_for_processing, when(pb, equals(pbp)), returns(0));
+    expect(pbpal_resolv_and_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_wouldblock));
+    expect(pbntf_got_socket, when(pb, equals(pbp)), returns(+1));
+}
+
+
+/** Expects the end of the transaction, leaving the connection alive */
+static void expect_kept_alive_outcome(void)
+{
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+}
+
+
+#define TIME_URL "/time/0?pnsdk=unit-test-0.1&uuid=test_id"
+#define PUBLISH_URL(msg)                                                       \
+    "/publish/pubkey/subkey/0/ch/0/" msg "?pnsdk=unit-test-0.1&uuid=test_id"
+#define TIME_RESPONSE(tt)                                                      \
+    "HTTP/1.1 200\r\nContent-Length: 19\r\n\r\n[" tt "]"
+#define PUBLISH_RESPONSE                                                       \
+    "HTTP/1.1 200\r\nContent-Length: 30\r\n\r\n[1,\"Sent\",\"17000000000000000\"]"
+
+
+Describe(pipelining);
+
+
+BeforeEach(pipelining)
+{
+    pubnub_setup_mocks(&pbp);
+    pubnub_init(pbp, "pubkey", "subkey");
+    pubnub_set_user_id(pbp, "test_id");
+    pbp->cb          = callback;
+    pbp->user_data   = NULL;
+    m_reported_count = 0;
+    m_cancel_in_callback = false;
+}
+
+
+AfterEach(pipelining)
+{
+    bool const state_not_idle = (pbp->state != PBS_IDLE);
+
+    /* pubnub_free() - callback environment behaviour */
+    if (state_not_idle) {
+        expect(pbntf_requeue_for_processing, when(pb, equals(pbp)));
+        expect(pbpal_close, when(pb, equals(pbp)), returns(0));
+        expect(pbpal_closed, when(pb, equals(pbp)), returns(true));
+        expect(pbpal_forget, when(pb, equals(pbp)));
+        expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    }
+    expect(pbntf_requeue_for_processing, when(pb, equals(pbp)));
+    if (state_not_idle) {
+        attest(pubnub_free(pbp), equals(-1));
+        attest(pbnc_fsm(pbp), equals(0));
+    }
+    attest(pubnub_free(pbp), equals(0));
+    expect(pbpal_free, when(pb, equals(pbp)));
+    pballoc_free_at_last(pbp);
+}
+
+
+Ensure(pipelining, sends_queued_requests_on_one_connection)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_publish(pbp, "ch", "1"), equals(PNR_STARTED));
+    attest(pubnub_pipeline_pending(pbp), equals(2));
+
+    /* Both requests go out before any response is read */
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_request(PUBLISH_URL("1"));
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+    attest(m_reported_count, equals(0));
+    attest(pubnub_pipeline_pending(pbp), equals(2));
+    attest(pbp->trans, equals(PBTT_TIME));
+}
+
+
+Ensure(pipelining, reports_responses_in_the_order_of_requests)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_publish(pbp, "ch", "1"), equals(PNR_STARTED));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_request(PUBLISH_URL("1"));
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* Response for the head arrives: it's reported as a transaction
+       of its own, and the next response is read on the same
+       connection. */
+    incoming(TIME_RESPONSE("17000000000000001"), NULL);
+    incoming(PUBLISH_RESPONSE, NULL);
+    expect_kept_alive_outcome();
+    attest(pbnc_fsm(pbp), equals(0));
+
+    attest(m_reported_count, equals(2));
+    attest(m_reported[0].trans, equals(PBTT_TIME));
+    attest(m_reported[0].rslt, equals(PNR_OK));
+    attest(m_reported[0].timetoken, streqs("17000000000000001"));
+    attest(m_reported[1].trans, equals(PBTT_PUBLISH));
+    attest(m_reported[1].rslt, equals(PNR_OK));
+    attest(pubnub_pipeline_pending(pbp), equals(0));
+    attest(pbp->core.last_result, equals(PNR_OK));
+}
+
+
+Ensure(pipelining, keeps_reading_when_only_head_response_arrived)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_request(TIME_URL);
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* Only the first response (so far)... */
+    incoming(TIME_RESPONSE("17000000000000001"), NULL);
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+    attest(m_reported_count, equals(1));
+    attest(m_reported[0].timetoken, streqs("17000000000000001"));
+    attest(pubnub_pipeline_pending(pbp), equals(1));
+    attest(pbp->core.last_result, equals(PNR_STARTED));
+
+    /* ... then the second */
+    incoming(TIME_RESPONSE("17000000000000002"), NULL);
+    expect_kept_alive_outcome();
+    attest(pbnc_fsm(pbp), equals(0));
+    attest(m_reported_count, equals(2));
+    attest(m_reported[1].trans, equals(PBTT_TIME));
+    attest(m_reported[1].timetoken, streqs("17000000000000002"));
+    attest(pubnub_pipeline_pending(pbp), equals(0));
+}
+
+
+Ensure(pipelining, resends_unanswered_requests_when_connection_drops)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_request(TIME_URL);
+    expect_request(TIME_URL);
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* First one is answered, then the server closes the connection.
+       The second is sent again, alone, on a new connection. */
+    incoming(TIME_RESPONSE("17000000000000001"), NULL);
+    expect(pbpal_close, when(pb, equals(pbp)), returns(0));
+    expect(pbpal_forget, when(pb, equals(pbp)));
+    expect_connection_wait();
+    attest(pbnc_fsm(pbp), equals(0));
+    attest(m_reported_count, equals(1));
+    attest(pubnub_pipeline_pending(pbp), equals(2));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* Once it's answered, the third goes on the same connection */
+    incoming(TIME_RESPONSE("17000000000000002"), NULL);
+    incoming(TIME_RESPONSE("17000000000000003"), NULL);
+    expect_kept_alive_outcome();
+    expect(pbntf_enqueue_for_processing, when(pb, equals(pbp)), returns(0));
+    expect(pbntf_got_socket, when(pb, equals(pbp)), returns(0));
+    expect_request(TIME_URL);
+    expect_response_wait();
+    expect_kept_alive_outcome();
+    attest(pbnc_fsm(pbp), equals(0));
+
+    attest(m_reported_count, equals(3));
+    attest(m_reported[0].rslt, equals(PNR_OK));
+    attest(m_reported[1].rslt, equals(PNR_OK));
+    attest(m_reported[1].timetoken, streqs("17000000000000002"));
+    attest(m_reported[2].rslt, equals(PNR_OK));
+    attest(m_reported[2].timetoken, streqs("17000000000000003"));
+    attest(pubnub_pipeline_pending(pbp), equals(0));
+}
+
+
+Ensure(pipelining, fails_unanswered_publishes_when_connection_drops)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_publish(pbp, "ch", "1"), equals(PNR_STARTED));
+    attest(pubnub_pipeline_publish(pbp, "ch", "2"), equals(PNR_STARTED));
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_publish(pbp, "ch", "3"), equals(PNR_STARTED));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(PUBLISH_URL("1"));
+    expect_request(PUBLISH_URL("2"));
+    expect_request(TIME_URL);
+    expect_request(PUBLISH_URL("3"));
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* First one is answered, then the server closes the connection.
+       The publishes that were sent may have been done, so they are
+       not sent again, but fail - the time is sent again. */
+    incoming(PUBLISH_RESPONSE, NULL);
+    expect(pbpal_close, when(pb, equals(pbp)), returns(0));
+    expect(pbpal_forget, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    expect_connection_wait();
+    attest(pbnc_fsm(pbp), equals(0));
+    attest(m_reported_count, equals(2));
+    attest(m_reported[0].trans, equals(PBTT_PUBLISH));
+    attest(m_reported[0].rslt, equals(PNR_OK));
+    attest(m_reported[1].trans, equals(PBTT_PUBLISH));
+    /* (the head fails the way the connection was lost) */
+    attest(m_reported[1].rslt, equals(PNR_TIMEOUT));
+    attest(pubnub_pipeline_pending(pbp), equals(2));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* The time is answered, then the last publish fails, unsent */
+    incoming(TIME_RESPONSE("17000000000000001"), NULL);
+    expect_kept_alive_outcome();
+    attest(pbnc_fsm(pbp), equals(0));
+
+    attest(m_reported_count, equals(4));
+    attest(m_reported[2].trans, equals(PBTT_TIME));
+    attest(m_reported[2].rslt, equals(PNR_OK));
+    attest(m_reported[2].timetoken, streqs("17000000000000001"));
+    attest(m_reported[3].trans, equals(PBTT_PUBLISH));
+    attest(m_reported[3].rslt, equals(PNR_IO_ERROR));
+    attest(pubnub_pipeline_pending(pbp), equals(0));
+}
+
+
+Ensure(pipelining, drops_the_queue_on_cancel)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+
+    expect(pbntf_requeue_for_processing, when(pb, equals(pbp)));
+    attest(pubnub_cancel(pbp), equals(PN_CANCEL_STARTED));
+    expect(pbpal_close, when(pb, equals(pbp)), returns(0));
+    expect(pbpal_closed, when(pb, equals(pbp)), returns(true));
+    expect(pbpal_forget, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pbnc_fsm(pbp), equals(0));
+
+    attest(m_reported_count, equals(1));
+    attest(m_reported[0].rslt, equals(PNR_CANCELLED));
+    attest(pubnub_pipeline_pending(pbp), equals(0));
+}
+
+
+Ensure(pipelining, stops_when_callback_cancels_after_a_response)
+{
+    expect_connection_wait();
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+    attest(pubnub_pipeline_time(pbp), equals(PNR_STARTED));
+
+    expect(pbpal_check_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_connect_success));
+    expect_request(TIME_URL);
+    expect_request(TIME_URL);
+    expect_response_wait();
+    incoming("", NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+
+    /* The callback for the first response is called after the FSM is
+       done with it, so cancelling from it doesn't read the next one */
+    m_cancel_in_callback = true;
+    incoming(TIME_RESPONSE("17000000000000001"), NULL);
+    incoming(TIME_RESPONSE("17000000000000002"), NULL);
+    attest(pbnc_fsm(pbp), equals(0));
+    attest(m_reported_count, equals(1));
+    attest(m_reported[0].timetoken, streqs("17000000000000001"));
+
+    expect(pbpal_close, when(pb, equals(pbp)), returns(0));
+    expect(pbpal_closed, when(pb, equals(pbp)), returns(true));
+    expect(pbpal_forget, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pbnc_fsm(pbp), equals(0));
+
+    attest(m_reported_count, equals(2));
+    attest(m_reported[1].trans, equals(PBTT_TIME));
+    attest(m_reported[1].rslt, equals(PNR_CANCELLED));
+    attest(pubnub_pipeline_pending(pbp), equals(0));
+}
@@ -0,0 +1,368 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#if PUBNUB_USE_PUBLISH_QUEUE
+#include "core/pubnub_publish_queue.h"
+#include "core/pbpublish_queue.h"
+#else
+#error PUBNUB_USE_PUBLISH_QUEUE must be defined and set to 1 before compiling this file
+#endif
+
+#include "core/pubnub_pubsubapi.h"
+#include "core/pubnub_netcore.h"
+#include "core/pubnub_helper.h"
+#include "core/pubnub_assert.h"
+#if PUBNUB_USE_LOGGER
+#include "core/pbcc_logger_manager.h"
+#endif // PUBNUB_USE_LOGGER
+
+#include <stdlib.h>
+#include <string.h>
+
+
+static struct pbpublish_queue_entry* entry_at(pubnub_t* pb, unsigned i)
+{
+    return &pb->publish_queue
+                .ring[(pb->publish_queue.head + i) % PUBNUB_PUBLISH_QUEUE_SIZE];
+}
+
+
+static void free_entry(struct pbpublish_queue_entry* entry)
+{
+    free(entry->channel);
+    free(entry->adopted);
+    entry->channel = NULL;
+    entry->adopted = NULL;
+}
+
+
+static void pop_head(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    PUBNUB_ASSERT_OPT(q->count > 0);
+    free_entry(&q->ring[q->head]);
+    q->head = (q->head + 1) % PUBNUB_PUBLISH_QUEUE_SIZE;
+    --q->count;
+#if PUBNUB_THREADSAFE
+    pbpal_cond_broadcast(q->room);
+#endif
+}
+
+
+/** Reports the outcome @p rslt of the queued publish with the
+    @p token, that didn't make it to a transaction of its own */
+static void report(pubnub_t* pb, pubnub_publish_token_t token, enum pubnub_res rslt)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    if (pb->cb != NULL) {
+        pubnub_publish_token_t const reported    = q->reported;
+        bool const                   in_callback = q->in_callback;
+        PUBNUB_LOG_TRACE(
+            pb,
+            "Call callback for queued publish #%lu outcome: %s",
+            token,
+            pubnub_res_2_string(rslt));
+        q->reported    = token;
+        q->in_callback = true;
+        pb->cb(pb, PBTT_PUBLISH, rslt, pb->user_data);
+        q->reported    = reported;
+        q->in_callback = in_callback;
+    }
+}
+
+
+/** Starts queued publishes, while @p pb can start a transaction */
+static void start_queued(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    while (!q->active && !q->cancelled && (q->count > 0)
+           && pbnc_can_start_transaction(pb)) {
+        struct pbpublish_queue_entry* entry = &q->ring[q->head];
+        pubnub_publish_token_t const  token = entry->token;
+        enum pubnub_res               rslt;
+
+        PUBNUB_LOG_DEBUG(pb, "Starting queued publish #%lu", token);
+        q->active = true;
+        rslt      = pubnub_publish(pb, entry->channel, entry->message);
+        /* If it was done right away, it was already popped (and
+           reported) when the transaction ended */
+        if ((rslt != PNR_STARTED) && q->active && (q->count > 0)
+            && (q->ring[q->head].token == token)) {
+            q->active            = false;
+            pb->core.last_result = rslt;
+            pop_head(pb);
+            report(pb, token, rslt);
+        }
+    }
+}
+
+
+/** Makes room in the (full) queue of @p pb, per its overflow policy.
+    @retval true There is room
+    @retval false No room, new publish should not be queued
+ */
+static bool make_room(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    switch (q->overflow) {
+    case pbpqoDropOldest: {
+        /* Oldest that was not started, to be dropped from the ring,
+           moving the ones before it towards the tail */
+        unsigned               i = q->active ? 1 : 0;
+        pubnub_publish_token_t token;
+        if (i >= q->count) { return false; }
+        token = entry_at(pb, i)->token;
+        free_entry(entry_at(pb, i));
+        while (i > 0) {
+            *entry_at(pb, i) = *entry_at(pb, i - 1);
+            --i;
+        }
+        entry_at(pb, 0)->channel = NULL;
+        entry_at(pb, 0)->adopted = NULL;
+        q->head                  = (q->head + 1) % PUBNUB_PUBLISH_QUEUE_SIZE;
+        --q->count;
+        PUBNUB_LOG_DEBUG(pb, "Publish queue full, dropped publish #%lu", token);
+        report(pb, token, PNR_CANCELLED);
+        return true;
+    }
+    case pbpqoBlock:
+#if PUBNUB_THREADSAFE
+        if (q->in_callback) {
+            /* The monitor is held by the callback, so the caller is
+               the callback, nothing will ever be taken out */
+            PUBNUB_LOG_WARNING(
+                pb, "Publish queue full, can't block on it in the callback");
+            return false;
+        }
+        /* Only from a callback could the monitor be held (locked) more
+           than once, so waiting releases it, for the transaction in
+           progress to end and take its publish out of the queue. The
+           caller checks again, maybe with a different policy.
+         */
+        ++q->waiters;
+        pbpal_cond_wait(q->room, pb->monitor);
+        --q->waiters;
+        if (q->shutdown) {
+            /* pbpublish_queue_free() waits for all of us to leave */
+            pbpal_cond_broadcast(q->room);
+            return false;
+        }
+        return true;
+#else
+        PUBNUB_LOG_WARNING(
+            pb, "Publish queue full, can't block on it without threads");
+        return false;
+#endif
+    case pbpqoFail:
+    default:
+        PUBNUB_LOG_WARNING(pb, "Publish queue full, can't queue publish");
+        return false;
+    }
+}
+
+
+static enum pubnub_res enqueue(
+    pubnub_t*               pb,
+    const char*             channel,
+    const char*             message,
+    char*                   adopted,
+    pubnub_publish_token_t* token)
+{
+    struct pbpublish_queue*       q = &pb->publish_queue;
+    struct pbpublish_queue_entry* entry;
+    size_t const                  channel_len = strlen(channel) + 1;
+    size_t const message_len = (NULL == adopted) ? strlen(message) + 1 : 0;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+#if defined(PUBNUB_NTF_RUNTIME_SELECTION)
+    if (PNA_CALLBACK != pb->api_policy) {
+        pubnub_mutex_unlock(pb->monitor);
+        free(adopted);
+        return PNR_INTERNAL_ERROR;
+    }
+#endif
+    /* Callback of a dropped publish may have queued some more, or
+       others may have taken the room made while waiting for it */
+    while (PUBNUB_PUBLISH_QUEUE_SIZE == q->count) {
+        if (!make_room(pb)) {
+            pubnub_mutex_unlock(pb->monitor);
+            free(adopted);
+#if PUBNUB_THREADSAFE
+            if (q->shutdown) { return PNR_CANCELLED; }
+#endif
+            return PNR_IN_PROGRESS;
+        }
+    }
+    entry          = entry_at(pb, q->count);
+    entry->channel = (char*)malloc(channel_len + message_len);
+    if (NULL == entry->channel) {
+        pubnub_mutex_unlock(pb->monitor);
+        free(adopted);
+        return PNR_OUT_OF_MEMORY;
+    }
+    memcpy(entry->channel, channel, channel_len);
+    if (NULL == adopted) {
+        memcpy(entry->channel + channel_len, message, message_len);
+        entry->message = entry->channel + channel_len;
+    }
+    else {
+        entry->message = adopted;
+    }
+    entry->adopted = adopted;
+    if (0 == ++q->last_token) { ++q->last_token; }
+    entry->token = q->last_token;
+    if (token != NULL) { *token = entry->token; }
+    ++q->count;
+    PUBNUB_LOG_DEBUG(
+        pb, "Queued publish #%lu, %u queued", entry->token, q->count);
+
+    start_queued(pb);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return PNR_STARTED;
+}
+
+
+void pubnub_publish_queue_set_overflow(
+    pubnub_t*                          pb,
+    enum pubnub_publish_queue_overflow policy)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    pb->publish_queue.overflow = policy;
+    pubnub_mutex_unlock(pb->monitor);
+}
+
+
+enum pubnub_res pubnub_publish_enqueue(
+    pubnub_t*               pb,
+    const char*             channel,
+    const char*             message,
+    pubnub_publish_token_t* token)
+{
+    PUBNUB_ASSERT_OPT(channel != NULL);
+    PUBNUB_ASSERT_OPT(message != NULL);
+    return enqueue(pb, channel, message, NULL, token);
+}
+
+
+enum pubnub_res pubnub_publish_enqueue_adopt(
+    pubnub_t*               pb,
+    const char*             channel,
+    char*                   message,
+    pubnub_publish_token_t* token)
+{
+    PUBNUB_ASSERT_OPT(channel != NULL);
+    PUBNUB_ASSERT_OPT(message != NULL);
+    return enqueue(pb, channel, message, message, token);
+}
+
+
+pubnub_publish_token_t pubnub_publish_queue_token(pubnub_t* pb)
+{
+    pubnub_publish_token_t rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    rslt = pb->publish_queue.reported;
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+unsigned pubnub_publish_queue_pending(pubnub_t* pb)
+{
+    unsigned rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    rslt = pb->publish_queue.count;
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+void pbpublish_queue_init(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    memset(q, 0, sizeof *q);
+    q->overflow = pbpqoFail;
+#if PUBNUB_THREADSAFE
+    pbpal_cond_init(q->room);
+#endif
+}
+
+
+void pbpublish_queue_trans_ended(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    q->in_callback = true;
+    q->reported    = 0;
+    if (q->active) {
+        q->reported  = q->ring[q->head].token;
+        q->cancelled = (PNR_CANCELLED == pb->core.last_result);
+        q->active    = false;
+        pop_head(pb);
+    }
+}
+
+
+void pbpublish_queue_dispatch(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+    q->in_callback = false;
+    q->reported    = 0;
+    if (q->cancelled) {
+        /* Those queued from the callbacks of the dropped ones are not
+           dropped, they are queued after the cancel */
+        pubnub_publish_token_t const last = q->last_token;
+        if (q->count > 0) {
+            PUBNUB_LOG_DEBUG(
+                pb, "Dropping %u queued publish(es) on cancel", q->count);
+        }
+        while ((q->count > 0) && (q->ring[q->head].token <= last)) {
+            pubnub_publish_token_t const token = q->ring[q->head].token;
+            pop_head(pb);
+            report(pb, token, PNR_CANCELLED);
+        }
+        q->cancelled = false;
+    }
+    start_queued(pb);
+}
+
+
+void pbpublish_queue_free(pubnub_t* pb)
+{
+    struct pbpublish_queue* q = &pb->publish_queue;
+
+#if PUBNUB_THREADSAFE
+    /* The condition can't be destroyed while someone is waiting on
+       it, so wake them up, to give up, and wait until they do */
+    q->shutdown = true;
+    pbpal_cond_broadcast(q->room);
+    while (q->waiters > 0) {
+        pbpal_cond_wait(q->room, pb->monitor);
+    }
+#endif
+    while (q->count > 0) {
+        pop_head(pb);
+    }
+    q->active = false;
+#if PUBNUB_THREADSAFE
+    pbpal_cond_destroy(q->room);
+#endif
+}
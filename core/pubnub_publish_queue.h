@@ -0,0 +1,115 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_PUBLISH_QUEUE
+#define INC_PUBNUB_PUBLISH_QUEUE
+
+#if PUBNUB_USE_PUBLISH_QUEUE
+
+#include "core/pubnub_api_types.h"
+#include "lib/pb_extern.h"
+
+
+/** @file pubnub_publish_queue.h
+
+    A bounded queue of publishes on a context. While a context is
+    busy, pubnub_publish() fails with #PNR_IN_PROGRESS, so one has to
+    wait for the outcome of a publish before starting the next one.
+    Instead, publishes can be queued on the context, which will start
+    them one after another, as soon as the previous transaction is
+    done, on the same (kept alive) connection, without a trip
+    through the user code between them.
+
+    Each queued publish gets a token (unique on the context). Its
+    outcome is reported through the callback of the context, as a
+    #PBTT_PUBLISH transaction, in which the token is available via
+    pubnub_publish_queue_token(). Publishes are started (and
+    reported) in the order they were queued.
+
+    When the queue is full (#PUBNUB_PUBLISH_QUEUE_SIZE publishes in
+    it), what happens depends on the overflow policy of the context
+    (see pubnub_publish_queue_set_overflow()).
+
+    Cancelling (pubnub_cancel()) a queued publish drops the rest of
+    the queue, too - each of the dropped publishes is reported with
+    #PNR_CANCELLED.
+
+    This is available only with the callback interface.
+ */
+
+
+/** Identifies a queued publish on its context. Never 0. */
+typedef unsigned long pubnub_publish_token_t;
+
+/** What to do when a publish is queued on a context whose queue is
+    full */
+enum pubnub_publish_queue_overflow {
+    /** Don't queue the new publish (return #PNR_IN_PROGRESS). This is
+        the default. */
+    pbpqoFail,
+    /** Drop the oldest publish that was not started yet and queue
+        the new one. The dropped one is reported with #PNR_CANCELLED,
+        from pubnub_publish_enqueue(), that is, on the thread that
+        called it. */
+    pbpqoDropOldest,
+    /** Wait until there is room in the queue. If called from the
+        callback of the context, acts as #pbpqoFail, as the room
+        would never be made. Don't use from a callback of some other
+        context, either, as it may be processed on the same thread.
+     */
+    pbpqoBlock
+};
+
+
+/** Sets the overflow policy of the publish queue of the context @p pb
+    to @p policy.
+ */
+PUBNUB_EXTERN void pubnub_publish_queue_set_overflow(
+    pubnub_t*                          pb,
+    enum pubnub_publish_queue_overflow policy);
+
+/** Queues a publish of @p message on @p channel on the context @p pb.
+    Parameters are the same as for pubnub_publish() and are copied,
+    so they don't have to be kept.
+
+    @param token If not NULL, the token of the queued publish is put
+    here, to match with the one reported in the callback
+
+    @return #PNR_STARTED if queued, #PNR_IN_PROGRESS if the queue is
+    full (and it's not to be blocked on), #PNR_CANCELLED if the context
+    was freed while blocked on the full queue, #PNR_OUT_OF_MEMORY if
+    out of memory
+ */
+PUBNUB_EXTERN enum pubnub_res pubnub_publish_enqueue(
+    pubnub_t*               pb,
+    const char*             channel,
+    const char*             message,
+    pubnub_publish_token_t* token);
+
+/** Same as pubnub_publish_enqueue(), but @p message is not copied.
+    Instead, it is adopted by the queue, which will free() it when
+    done with it - so, it has to be allocated with malloc(). It is
+    adopted even if it is not queued (and freed right away).
+ */
+PUBNUB_EXTERN enum pubnub_res pubnub_publish_enqueue_adopt(
+    pubnub_t*               pb,
+    const char*             channel,
+    char*                   message,
+    pubnub_publish_token_t* token);
+
+/** Returns the token of the queued publish whose outcome is being
+    reported in the callback of the context @p pb. Returns 0 if the
+    transaction being reported is not a queued publish, or if not
+    called from the callback.
+ */
+PUBNUB_EXTERN pubnub_publish_token_t pubnub_publish_queue_token(pubnub_t* pb);
+
+/** Returns the number of publishes queued on the context @p pb, that
+    are not done yet, including the one in progress, if any.
+ */
+PUBNUB_EXTERN unsigned pubnub_publish_queue_pending(pubnub_t* pb);
+
+
+#else
+#error To use the publish queue API you must define PUBNUB_USE_PUBLISH_QUEUE=1
+#endif /* PUBNUB_USE_PUBLISH_QUEUE */
+
+#endif /* !defined INC_PUBNUB_PUBLISH_QUEUE */
@@ -0,0 +1,365 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include "pubnub_internal.h"
+#include "pubnub_publish_queue.h"
+#include "pbpublish_queue.h"
+#include "pubnub_netcore.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/* A less chatty cgreen :) */
+
+#define attest assert_that
+#define equals is_equal_to
+#define differs is_not_equal_to
+
+
+/** Maximum number of publishes (or outcomes) a test goes through */
+#define MAX_RECORDED 16
+
+/** An outcome of a (queued) publish, as reported in the callback */
+struct outcome {
+    pubnub_publish_token_t token;
+    enum pubnub_res        rslt;
+};
+
+static pubnub_t* m_pb;
+
+/** Whether a transaction is in progress on the context */
+static bool m_busy;
+
+/** What pubnub_publish() returns, without starting a transaction,
+    if not #PNR_STARTED */
+static enum pubnub_res m_publish_rslt;
+
+static char   m_published[MAX_RECORDED][32];
+static size_t m_published_count;
+
+static struct outcome m_reported[MAX_RECORDED];
+static size_t         m_reported_count;
+
+/** Messages to queue from the callback, if any */
+static char const*     m_queue_in_callback[2];
+static enum pubnub_res m_queued_in_callback[2];
+
+
+/* The context and the publish transaction, as the queue sees them */
+
+bool pb_valid_ctx_ptr(pubnub_t const* pb)
+{
+    return pb == m_pb;
+}
+
+
+bool pbnc_can_start_transaction(struct pubnub_ const* pb)
+{
+    return !m_busy;
+}
+
+
+enum pubnub_res pubnub_publish(pubnub_t* pb, const char* channel, const char* message)
+{
+    attest(m_busy, is_false);
+    attest(m_published_count, is_less_than(MAX_RECORDED));
+    snprintf(m_published[m_published_count++],
+             sizeof m_published[0],
+             "%s:%s",
+             channel,
+             message);
+    if (m_publish_rslt != PNR_STARTED) { return m_publish_rslt; }
+    m_busy = true;
+    return PNR_STARTED;
+}
+
+
+static void callback(pubnub_t*         pb,
+                     enum pubnub_trans trans,
+                     enum pubnub_res   rslt,
+                     void*             user_data)
+{
+    size_t i;
+
+    attest(trans, equals(PBTT_PUBLISH));
+    attest(m_reported_count, is_less_than(MAX_RECORDED));
+    m_reported[m_reported_count].token  = pubnub_publish_queue_token(pb);
+    m_reported[m_reported_count++].rslt = rslt;
+    for (i = 0; i < 2; ++i) {
+        if (m_queue_in_callback[i] != NULL) {
+            m_queued_in_callback[i] = pubnub_publish_enqueue(
+                pb, "ch", m_queue_in_callback[i], NULL);
+            m_queue_in_callback[i] = NULL;
+        }
+    }
+}
+
+
+/** Ends the transaction in progress with @p rslt, the way the
+    callback interface does it
+ */
+static void end_transaction(enum pubnub_res rslt)
+{
+    pubnub_mutex_lock(m_pb->monitor);
+    attest(m_busy, is_true);
+    m_busy                 = false;
+    m_pb->core.last_result = rslt;
+    pbpublish_queue_trans_ended(m_pb);
+    m_pb->cb(m_pb, PBTT_PUBLISH, rslt, m_pb->user_data);
+    pbpublish_queue_dispatch(m_pb);
+    pubnub_mutex_unlock(m_pb->monitor);
+}
+
+
+static void enqueue_n(unsigned n)
+{
+    unsigned i;
+
+    for (i = 0; i < n; ++i) {
+        char msg[16];
+        snprintf(msg, sizeof msg, "%u", i + 1);
+        attest(pubnub_publish_enqueue(m_pb, "ch", msg, NULL),
+               equals(PNR_STARTED));
+    }
+}
+
+
+static void sleep_ms(long ms)
+{
+    struct timespec ts = { 0, ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+
+/** Data of a thread that queues a publish, which may block */
+struct enqueuer {
+    pthread_t       thread;
+    enum pubnub_res rslt;
+    bool            done;
+};
+
+
+static void* enqueuer_thread(void* arg)
+{
+    struct enqueuer* e    = (struct enqueuer*)arg;
+    enum pubnub_res  rslt = pubnub_publish_enqueue(m_pb, "ch", "late", NULL);
+
+    pubnub_mutex_lock(m_pb->monitor);
+    e->rslt = rslt;
+    e->done = true;
+    pubnub_mutex_unlock(m_pb->monitor);
+
+    return NULL;
+}
+
+
+static bool enqueuer_done(struct enqueuer* e)
+{
+    bool rslt;
+
+    pubnub_mutex_lock(m_pb->monitor);
+    rslt = e->done;
+    pubnub_mutex_unlock(m_pb->monitor);
+
+    return rslt;
+}
+
+
+Describe(pubnub_publish_queue);
+
+
+BeforeEach(pubnub_publish_queue)
+{
+    m_pb = (pubnub_t*)calloc(1, sizeof *m_pb);
+    pubnub_mutex_init(m_pb->monitor);
+    pbpublish_queue_init(m_pb);
+    m_pb->cb = callback;
+
+    m_busy                 = false;
+    m_publish_rslt         = PNR_STARTED;
+    m_published_count      = 0;
+    m_reported_count       = 0;
+    m_queue_in_callback[0] = m_queue_in_callback[1] = NULL;
+}
+
+
+AfterEach(pubnub_publish_queue)
+{
+    pubnub_mutex_lock(m_pb->monitor);
+    pbpublish_queue_free(m_pb);
+    pubnub_mutex_unlock(m_pb->monitor);
+    pubnub_mutex_destroy(m_pb->monitor);
+    free(m_pb);
+    m_pb = NULL;
+}
+
+
+Ensure(pubnub_publish_queue, publishes_one_after_another_in_order)
+{
+    pubnub_publish_token_t token;
+
+    attest(pubnub_publish_enqueue(m_pb, "ch", "first", &token),
+           equals(PNR_STARTED));
+    attest(token, equals(1));
+    enqueue_n(2);
+    attest(pubnub_publish_queue_pending(m_pb), equals(3));
+    attest(m_published_count, equals(1));
+    attest(m_published[0], is_equal_to_string("ch:first"));
+
+    end_transaction(PNR_OK);
+    attest(m_published_count, equals(2));
+    attest(m_published[1], is_equal_to_string("ch:1"));
+    end_transaction(PNR_OK);
+    attest(m_published[2], is_equal_to_string("ch:2"));
+    end_transaction(PNR_OK);
+    attest(m_published_count, equals(3));
+
+    attest(pubnub_publish_queue_pending(m_pb), equals(0));
+    attest(m_reported_count, equals(3));
+    attest(m_reported[0].token, equals(1));
+    attest(m_reported[1].token, equals(2));
+    attest(m_reported[2].token, equals(3));
+    attest(m_reported[2].rslt, equals(PNR_OK));
+    attest(pubnub_publish_queue_token(m_pb), equals(0));
+}
+
+
+Ensure(pubnub_publish_queue, reports_publish_that_fails_to_start)
+{
+    m_publish_rslt = PNR_OUT_OF_MEMORY;
+    attest(pubnub_publish_enqueue(m_pb, "ch", "1", NULL), equals(PNR_STARTED));
+    attest(pubnub_publish_queue_pending(m_pb), equals(0));
+    attest(m_reported_count, equals(1));
+    attest(m_reported[0].token, equals(1));
+    attest(m_reported[0].rslt, equals(PNR_OUT_OF_MEMORY));
+}
+
+
+Ensure(pubnub_publish_queue, fails_when_full_by_default)
+{
+    enqueue_n(PUBNUB_PUBLISH_QUEUE_SIZE);
+    attest(pubnub_publish_enqueue(m_pb, "ch", "x", NULL),
+           equals(PNR_IN_PROGRESS));
+    attest(pubnub_publish_queue_pending(m_pb),
+           equals(PUBNUB_PUBLISH_QUEUE_SIZE));
+    attest(m_reported_count, equals(0));
+
+    end_transaction(PNR_OK);
+    attest(pubnub_publish_enqueue(m_pb, "ch", "x", NULL),
+           equals(PNR_STARTED));
+}
+
+
+Ensure(pubnub_publish_queue, drops_oldest_not_started_when_full)
+{
+    unsigned i;
+
+    pubnub_publish_queue_set_overflow(m_pb, pbpqoDropOldest);
+    enqueue_n(PUBNUB_PUBLISH_QUEUE_SIZE);
+    attest(pubnub_publish_enqueue(m_pb, "ch", "x", NULL),
+           equals(PNR_STARTED));
+    attest(m_reported_count, equals(1));
+    attest(m_reported[0].token, equals(2));
+    attest(m_reported[0].rslt, equals(PNR_CANCELLED));
+    attest(pubnub_publish_queue_pending(m_pb),
+           equals(PUBNUB_PUBLISH_QUEUE_SIZE));
+
+    for (i = 0; i < PUBNUB_PUBLISH_QUEUE_SIZE; ++i) {
+        end_transaction(PNR_OK);
+    }
+    attest(m_published_count, equals(PUBNUB_PUBLISH_QUEUE_SIZE));
+    attest(m_published[1], is_equal_to_string("ch:3"));
+    attest(m_published[PUBNUB_PUBLISH_QUEUE_SIZE - 1],
+           is_equal_to_string("ch:x"));
+    attest(pubnub_publish_queue_pending(m_pb), equals(0));
+}
+
+
+Ensure(pubnub_publish_queue, blocks_until_a_publish_is_done)
+{
+    struct enqueuer e = { 0 };
+
+    pubnub_publish_queue_set_overflow(m_pb, pbpqoBlock);
+    enqueue_n(PUBNUB_PUBLISH_QUEUE_SIZE);
+    attest(pthread_create(&e.thread, NULL, enqueuer_thread, &e), equals(0));
+    sleep_ms(50);
+    attest(enqueuer_done(&e), is_false);
+
+    end_transaction(PNR_OK);
+    attest(pthread_join(e.thread, NULL), equals(0));
+    attest(e.rslt, equals(PNR_STARTED));
+    attest(pubnub_publish_queue_pending(m_pb),
+           equals(PUBNUB_PUBLISH_QUEUE_SIZE));
+}
+
+
+Ensure(pubnub_publish_queue, fails_blocked_publish_when_freed)
+{
+    struct enqueuer e[2] = { { 0 }, { 0 } };
+
+    pubnub_publish_queue_set_overflow(m_pb, pbpqoBlock);
+    enqueue_n(PUBNUB_PUBLISH_QUEUE_SIZE);
+    attest(pthread_create(&e[0].thread, NULL, enqueuer_thread, &e[0]),
+           equals(0));
+    attest(pthread_create(&e[1].thread, NULL, enqueuer_thread, &e[1]),
+           equals(0));
+    sleep_ms(50);
+    attest(enqueuer_done(&e[0]), is_false);
+    attest(enqueuer_done(&e[1]), is_false);
+
+    /* As the context is freed, with its monitor locked */
+    pubnub_mutex_lock(m_pb->monitor);
+    pbpublish_queue_free(m_pb);
+    attest(m_pb->publish_queue.waiters, equals(0));
+    pubnub_mutex_unlock(m_pb->monitor);
+
+    attest(pthread_join(e[0].thread, NULL), equals(0));
+    attest(pthread_join(e[1].thread, NULL), equals(0));
+    attest(e[0].rslt, equals(PNR_CANCELLED));
+    attest(e[1].rslt, equals(PNR_CANCELLED));
+    attest(m_published_count, equals(1));
+
+    /* For the teardown to free */
+    pbpublish_queue_init(m_pb);
+}
+
+
+Ensure(pubnub_publish_queue, doesnt_block_in_the_callback)
+{
+    pubnub_publish_queue_set_overflow(m_pb, pbpqoBlock);
+    enqueue_n(PUBNUB_PUBLISH_QUEUE_SIZE);
+
+    /* First one takes the room made by the publish that is done */
+    m_queue_in_callback[0] = "a";
+    m_queue_in_callback[1] = "b";
+    end_transaction(PNR_OK);
+    attest(m_queued_in_callback[0], equals(PNR_STARTED));
+    attest(m_queued_in_callback[1], equals(PNR_IN_PROGRESS));
+    attest(pubnub_publish_queue_pending(m_pb),
+           equals(PUBNUB_PUBLISH_QUEUE_SIZE));
+}
+
+
+Ensure(pubnub_publish_queue, drops_the_queue_on_cancel)
+{
+    enqueue_n(3);
+
+    end_transaction(PNR_CANCELLED);
+    attest(m_reported_count, equals(3));
+    attest(m_reported[0].token, equals(1));
+    attest(m_reported[1].token, equals(2));
+    attest(m_reported[1].rslt, equals(PNR_CANCELLED));
+    attest(m_reported[2].token, equals(3));
+    attest(m_reported[2].rslt, equals(PNR_CANCELLED));
+    attest(pubnub_publish_queue_pending(m_pb), equals(0));
+    attest(m_published_count, equals(1));
+
+    /* Queueing works again after that */
+    attest(pubnub_publish_enqueue(m_pb, "ch", "a", NULL), equals(PNR_STARTED));
+    attest(m_published_count, equals(2));
+    attest(m_published[1], is_equal_to_string("ch:a"));
+}
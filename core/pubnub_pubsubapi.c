@@ -9,7 +9,14 @@
 #include "core/pubnub_timers.h"
 
 #include "core/pbpal.h"
+#include "core/pbpal_ntf_sync_wait.h"
 #include "pubnub_ntf_enforcement.h"
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+#include "core/pbcc_subscribe_v2.h"
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+#include "core/pbpublish_queue.h"
+#endif
 
 #include <ctype.h>
 #include <string.h>
@@ -32,9 +39,13 @@ pubnub_t* pubnub_init(
         p->wait_connect_timeout_ms = PUBNUB_DEFAULT_WAIT_CONNECT_TIMER;
 #if defined(PUBNUB_CALLBACK_API)
 #if defined(PUBNUB_NTF_RUNTIME_SELECTION)
-        if (PNA_CALLBACK == p->api_policy) { p->previous = p->next = NULL; }
+        if (PNA_CALLBACK == p->api_policy) {
+            p->previous = p->next = NULL;
+            p->timer_slot         = NULL;
+        }
 #else
         p->previous = p->next = NULL;
+        p->timer_slot         = NULL;
 #endif /* PUBNUB_NTF_RUNTIME_SELECTION */
 #endif /* defined(PUBNUB_CALLBACK_API) */
     }
@@ -50,6 +61,14 @@ pubnub_t* pubnub_init(
     p->user_data          = NULL;
     p->flags.sent_queries = 0;
 #endif /* PUBNUB_NTF_RUNTIME_SELECTION */
+    p->queue_next  = NULL;
+    p->queue_state = 0;
+#if PUBNUB_USE_EPOLL
+    p->epoll.events = 0;
+#endif
+#if PUBNUB_USE_IO_URING
+    p->uring.events = 0;
+#endif
 #endif /* defined(PUBNUB_CALLBACK_API) */
     if (PUBNUB_ORIGIN_SETTABLE) {
         p->origin = PUBNUB_ORIGIN;
@@ -93,6 +112,13 @@ pubnub_t* pubnub_init(
     p->options.tcp_keepalive.probes   = 3;
 #if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
     p->should_stop_await = false;
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    p->sync_wait.in       = false;
+    p->sync_wait.requeued = false;
+#if !defined(_WIN32)
+    p->sync_wait.wakeup.read_fd = -1;
+#endif
+#endif
 #endif
 #if PUBNUB_USE_IPV6
     /* IPv4 connectivity type by default. */
@@ -100,6 +126,12 @@ pubnub_t* pubnub_init(
 #endif
     p->flags.started_while_kept_alive = false;
     p->method                         = pubnubSendViaGET;
+#if PUBNUB_USE_PIPELINING
+    memset(&p->pipeline, 0, sizeof p->pipeline);
+#endif
+#if PUBNUB_USE_PUBLISH_QUEUE
+    pbpublish_queue_init(p);
+#endif
 #if PUBNUB_ADVANCED_KEEP_ALIVE
     p->keep_alive.max     = 1000;
     p->keep_alive.timeout = 50;
@@ -131,9 +163,21 @@ pubnub_t* pubnub_init(
     p->realm[0]                 = '\0';
 #endif /* PUBNUB_PROXY_API */
 
+#if PUBNUB_USE_GZIP_COMPRESSION
+    pbgzip_compress_init(p);
+#endif
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
     p->data_compressed = compressionNONE;
 #endif
+#if PUBNUB_RECEIVE_GZIP_STREAMING
+    p->gzip_inflate.active = false;
+#endif
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+    p->v2_message_cb        = NULL;
+    p->v2_message_user_data = NULL;
+    memset(&p->v2_given, 0, sizeof p->v2_given);
+    pbcc_subscribe_v2_stream_stop(&p->core);
+#endif
 #if PUBNUB_CRYPTO_API
     p->core.crypto_module = NULL;
 #endif
@@ -503,6 +547,9 @@ enum pubnub_cancel_res pubnub_cancel(pubnub_t* pb)
 #if !defined(PUBNUB_CALLBACK_API) || defined(PUBNUB_NTF_RUNTIME_SELECTION)
     pubnub_mutex_lock(pb->cancel_monitor);
     pb->should_stop_await = true;
+#if PUBNUB_SYNC_WAIT_FOR_SOCKET
+    pbpal_ntf_sync_wait_interrupt(pb);
+#endif
     pubnub_mutex_unlock(pb->cancel_monitor);
 #endif
 
@@ -793,6 +840,26 @@ void pubnub_dont_use_http_keep_alive(pubnub_t* p)
     p->options.use_http_keep_alive = 0;
 }
 
+int pubnub_trim_reply_buffer(pubnub_t* p)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(p));
+
+    pubnub_mutex_lock(p->monitor);
+    if (!pbnc_can_start_transaction(p)) {
+        pubnub_mutex_unlock(p->monitor);
+        return -1;
+    }
+    PUBNUB_LOG_DEBUG(p, "Trim reply buffer.");
+    p->core.http_buf_len = 0;
+    p->core.msg_ofs = p->core.msg_end = 0;
+    p->core.chan_ofs = p->core.chan_end = 0;
+    pbcc_trim_reply_buffer(&p->core, 0);
+    if (pbcc_ensure_reply_buffer(&p->core)) { p->core.http_reply[0] = '\0'; }
+    pubnub_mutex_unlock(p->monitor);
+
+    return 0;
+}
+
 void pubnub_use_tcp_keep_alive(
     pubnub_t*     pb,
     const uint8_t time,
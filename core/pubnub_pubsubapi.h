@@ -401,6 +401,24 @@ PUBNUB_EXTERN void pubnub_use_http_keep_alive(pubnub_t* p);
 */
 PUBNUB_EXTERN void pubnub_dont_use_http_keep_alive(pubnub_t* p);
 
+/** Frees (most of) the memory of the reply buffer(s) of the context
+    @p p, if it's not in a transaction. Reply buffers are kept from
+    one transaction to the next (up to #PUBNUB_REPLY_BUFFER_KEEP_MAX
+    octets), so this is useful for contexts that will not be used for
+    some time.
+
+    The reply of the last transaction is dropped, so, for example,
+    messages received by subscribe, that were not read, are lost.
+
+    With a static reply buffer, there's nothing to free, but the reply
+    is dropped all the same.
+
+    @param p Pubnub context to trim the reply buffer(s) of
+    @retval 0 trimmed
+    @retval -1 context is in a transaction, nothing done
+*/
+PUBNUB_EXTERN int pubnub_trim_reply_buffer(pubnub_t* p);
+
 /** Enable the use of TCP Keep-Alive ("probes") on the context @p pb .
  *
  * @b Defaults:
@@ -315,7 +315,7 @@ pubnub_retry_configuration_t* pubnub_retry_configuration_alloc_with_options_(
     const int                   maximum_delay,
     const int                   maximum_retry,
     const pubnub_endpoint_t     excluded,
-    const va_list               endpoints)
+    va_list                     endpoints)
 {
     pubnub_retry_configuration_t* configuration =
         malloc(sizeof(pubnub_retry_configuration_t));
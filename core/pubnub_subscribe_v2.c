@@ -10,6 +10,13 @@
 #include "pubnub_ccore_pubsub.h"
 #include "pubnub_netcore.h"
 #include "pubnub_assert.h"
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+#include "pbsubscribe_v2_stream.h"
+#endif
+#if PUBNUB_SUBSCRIBE_V2_STREAMING && PUBNUB_USE_SUBSCRIBE_EVENT_ENGINE
+#include "pbcc_subscribe_event_engine.h"
+#include "pbcc_subscribe_event_engine_effects.h"
+#endif
 
 
 struct pubnub_subscribe_v2_options pubnub_subscribe_v2_defopts(void)
@@ -23,6 +30,41 @@ struct pubnub_subscribe_v2_options pubnub_subscribe_v2_defopts(void)
 }
 
 
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+/** Returns the (FNV-1a) hash of @p s, continuing from @p hash */
+static uint32_t hash_string(uint32_t hash, char const* s)
+{
+    if (NULL == s) { return hash; }
+    for (; *s != '\0'; ++s) {
+        hash = (hash ^ (unsigned char)*s) * 16777619u;
+    }
+    /* So that moving a name from channels to groups changes the hash */
+    return (hash ^ ',') * 16777619u;
+}
+
+
+/** Forgets the messages given to the message callback of @p pb
+    unless the subscribe V2 to @p channel and @p channel_group that is
+    about to start is a retry of the one they were given for.
+ */
+static void prepare_given(pubnub_t*   pb,
+                          char const* channel,
+                          char const* channel_group)
+{
+    struct pbsubscribe_v2_given* given = &pb->v2_given;
+    uint32_t const               subscription =
+        hash_string(hash_string(2166136261u, channel), channel_group);
+
+    if ((given->subscription != subscription)
+        || (strcmp(given->timetoken, pb->core.timetoken) != 0)) {
+        given->subscription = subscription;
+        strcpy(given->timetoken, pb->core.timetoken);
+        given->count = 0;
+    }
+}
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
+
 enum pubnub_res pubnub_subscribe_v2(
     pubnub_t*                          p,
     const char*                        channel,
@@ -70,6 +112,9 @@ enum pubnub_res pubnub_subscribe_v2(
         opts.filter_expr,
         opts.timetoken);
     if (PNR_STARTED == rslt) {
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+        prepare_given(p, channel, opts.channel_group);
+#endif
         p->trans            = PBTT_SUBSCRIBE_V2;
         p->core.last_result = PNR_STARTED;
         pbnc_fsm(p);
@@ -93,4 +138,154 @@ struct pubnub_v2_message pubnub_get_v2(pubnub_t* pb)
     return result;
 }
 
+
+size_t pubnub_get_v2_batch(pubnub_t*                 pb,
+                           struct pubnub_v2_message* msgs,
+                           size_t                    n)
+{
+    size_t result;
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT((msgs != NULL) || (0 == n));
+
+    pubnub_mutex_lock(pb->monitor);
+    result = pbcc_get_msgs_v2(&pb->core, msgs, n);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return result;
+}
+
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+void pubnub_subscribe_v2_set_message_callback(
+    pubnub_t*                              pb,
+    pubnub_subscribe_v2_message_callback_t cb,
+    void*                                  user_data)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    pb->v2_message_cb        = cb;
+    pb->v2_message_user_data = user_data;
+    pubnub_mutex_unlock(pb->monitor);
+}
+
+
+/** Returns whether the messages received by @p pb are taken as soon
+    as they are received, by the message callback or the listeners of
+    the subscribe event engine, rather than via pubnub_get_v2() after
+    the transaction is done.
+ */
+static bool messages_taken_at_once(pubnub_t const* pb)
+{
+#if PUBNUB_USE_SUBSCRIBE_EVENT_ENGINE
+    if (pbcc_subscribe_ee_handles_outcomes(pb->core.subscribe_ee)) {
+        return true;
+    }
+#endif
+    return pb->v2_message_cb != NULL;
+}
+
+
+bool pbsubscribe_v2_stream_wanted(pubnub_t const* pb)
+{
+#if PUBNUB_PROXY_API
+    if ((pbproxyHTTP_CONNECT == pb->proxy_type)
+        && !pb->proxy_tunnel_established) {
+        return false;
+    }
+#endif
+    return (PBTT_SUBSCRIBE_V2 == pb->trans) && messages_taken_at_once(pb)
+           && (2 == pb->http_code / 100);
+}
+
+
+/** Gives the next V2 message of the subscribe V2 response being
+    received by @p pb, as it would be returned by pubnub_get_v2(), to
+    the message callback and the listeners of the subscribe event
+    engine, unless it was given from a response to this subscribe V2
+    before it was retried.
+
+    @retval false No (more) messages
+ */
+static bool give_message(pubnub_t* pb)
+{
+    struct pbsubscribe_v2_given*   given = &pb->v2_given;
+    struct pubnub_v2_message const msg   = pubnub_get_v2(pb);
+
+    if (NULL == msg.payload.ptr) { return false; }
+    if (given->index++ < given->count) {
+        PUBNUB_LOG_DEBUG(
+            pb, "Subscribe V2 message was given before the retry, skipping it");
+        return true;
+    }
+    ++given->count;
+    if (pb->v2_message_cb != NULL) {
+        pb->v2_message_cb(pb, msg, pb->v2_message_user_data);
+    }
+#if PUBNUB_USE_SUBSCRIBE_EVENT_ENGINE
+    if (pbcc_subscribe_ee_handles_outcomes(pb->core.subscribe_ee)) {
+        pbcc_subscribe_ee_emit_message(pb->core.subscribe_ee, msg);
+    }
+#endif
+
+    return true;
+}
+
+
+int pbsubscribe_v2_stream_start(pubnub_t* pb)
+{
+    bool const wanted = pbsubscribe_v2_stream_wanted(pb);
+
+    pb->v2_given.index = 0;
+
+#if PUBNUB_RECEIVE_GZIP_RESPONSE && !PUBNUB_RECEIVE_GZIP_STREAMING
+    if (wanted && (compressionGZIP == pb->data_compressed)) {
+        PUBNUB_LOG_DEBUG(
+            pb, "Compressed subscribe V2 response, receiving it as a whole");
+        pbcc_subscribe_v2_stream_stop(&pb->core);
+        if (pb->http_chunked) { return 0; }
+        return pbcc_realloc_reply_buffer(&pb->core, pb->core.http_content_len);
+    }
+#endif
+    if (wanted) {
+        pbcc_subscribe_v2_stream_start(&pb->core);
+    }
+    else {
+        pbcc_subscribe_v2_stream_stop(&pb->core);
+    }
+
+    return 0;
+}
+
+
+bool pbsubscribe_v2_streaming(pubnub_t const* pb)
+{
+    return pbcc_subscribe_v2_streaming(&pb->core);
+}
+
+
+unsigned pbsubscribe_v2_stream_feed(pubnub_t* pb)
+{
+    while (pbcc_subscribe_v2_stream_next(&pb->core)) {
+        give_message(pb);
+    }
+
+    return pbcc_subscribe_v2_stream_drop(&pb->core);
+}
+
+
+void pbsubscribe_v2_stream_rest(pubnub_t* pb)
+{
+    if ((PBTT_SUBSCRIBE_V2 != pb->trans) || !messages_taken_at_once(pb)) {
+        return;
+    }
+    while (give_message(pb)) {
+        continue;
+    }
+    /* Succeeded, so it won't be retried */
+    pb->v2_given.count        = 0;
+    pb->v2_given.timetoken[0] = '\0';
+}
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
 #endif /* PUBNUB_USE_SUBSCRIBE_V2 */
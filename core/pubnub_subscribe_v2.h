@@ -114,6 +114,85 @@ PUBNUB_EXTERN enum pubnub_res pubnub_subscribe_v2(pubnub_t*
 PUBNUB_EXTERN struct pubnub_v2_message pubnub_get_v2(pubnub_t* pbp);
 
 
+/** Parse and return up to @p n next V2 messages, if any, in @p msgs,
+    with the context locked once, instead of once for each message as
+    with pubnub_get_v2(). Returns the number of messages put in
+    @p msgs, which is less than @p n if there are no more messages.
+
+    Messages are "views" into the response, which are valid until
+    the next transaction is started on the context, so they can be
+    handed to other threads (say, a thread pool) as they are:
+
+        struct pubnub_v2_message msgs[16];
+        size_t n;
+        while ((n = pubnub_get_v2_batch(pbp, msgs, 16)) > 0) {
+            process_in_parallel(msgs, n);
+        }
+ */
+PUBNUB_EXTERN size_t pubnub_get_v2_batch(pubnub_t*                 pbp,
+                                         struct pubnub_v2_message* msgs,
+                                         size_t                    n);
+
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+/** Pointer to a function to be called with each V2 message received
+    in a subscribe V2 response.
+    @param pb The Pubnub context which received the message
+    @param msg The message, valid only during the call
+    @param user_data The pointer provided by the user to
+    pubnub_subscribe_v2_set_message_callback()
+ */
+typedef void (*pubnub_subscribe_v2_message_callback_t)(
+    pubnub_t*                pb,
+    struct pubnub_v2_message msg,
+    void*                    user_data);
+
+
+/** Sets the callback to give the V2 messages of subscribe V2
+    responses to, as soon as each of them is received, instead of
+    after the whole response is received. This way, only the message
+    being received has to be kept in the reply buffer, not the whole
+    response, so much less memory is needed for responses with many
+    messages.
+
+    Subscribe V2 responses are streamed like this when the messages
+    are taken as soon as they are received: with the callback set, or
+    when the subscribe event engine handles the outcomes of the
+    transactions of @p pb. Each message is taken via pubnub_get_v2()
+    and given to the callback and to the listeners of the subscribe
+    event engine (the same way they get the messages of a response
+    that is not streamed), so pubnub_get_v2() will not return any
+    after the transaction is done. If a response is not streamed (say,
+    it's compressed), its messages are given the same way when it's
+    received, before the outcome of the transaction is reported.
+    Otherwise, the response is received as a whole, to get its
+    messages with pubnub_get_v2() after the transaction is done.
+
+    The callback (and the listeners) are called while the response is
+    being received, with @p pb locked. They must not call
+    pubnub_get_v2(), as the message was already taken, nor start or
+    cancel any transaction on @p pb.
+
+    Messages are given before the timetoken of the response is known
+    to be good, so the transaction may fail after some messages were
+    given (say, the connection is lost). Its retry - the next
+    subscribe V2 to the same channels and channel groups, with the
+    same timetoken - receives them again, but they are not given
+    again: as many messages as were given are
+    skipped, as the server responds with the same messages, in the
+    same order, for the same timetoken.
+
+    @param pb The Pubnub context. Can't be NULL.
+    @param cb The callback, NULL for none (the default)
+    @param user_data The pointer to pass to @p cb
+ */
+PUBNUB_EXTERN void pubnub_subscribe_v2_set_message_callback(
+    pubnub_t*                              pb,
+    pubnub_subscribe_v2_message_callback_t cb,
+    void*                                  user_data);
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
+
 #endif /* !defined INC_PUBNUB_SUBSCRIBE_V2 */
 
 #endif /* PUBNUB_USE_SUBSCRIBE_V2 */
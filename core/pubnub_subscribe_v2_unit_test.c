@@ -18,6 +18,7 @@
 #include "pubnub_assert.h"
 #include "pubnub_subscribe_v2_message.h"
 #include "pubnub_subscribe_v2.h"
+#include "pubnub_netcore.h"
 #include "test/pubnub_test_mocks.h"
 
 static pubnub_t* pbp;
@@ -96,6 +97,291 @@ Ensure(subscribe_v2, should_parse_response_correctly) {
     assert_that(msg.message_type, is_equal_to(pbsbPublished));
 }
 
+Ensure(subscribe_v2, should_get_messages_in_batches) {
+    struct pubnub_v2_message msgs[2];
+
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp,
+        "/v2/subscribe/sub_key/my-channel/0?pnsdk=unit-test-0.1&tt=0&uuid=test_id&heartbeat=300");
+    incoming("HTTP/1.1 200\r\nContent-Length: "
+             "215\r\n\r\n{\"t\":{\"t\":\"15628652479932717\",\"r\":4},\"m\":[{\"c\":\"ch1\",\"d\":1,\"p\":{\"t\":\"15628652479933927\",\"r\":4}},{\"c\":\"ch2\",\"d\":{\"n\":[2]},\"p\":{\"t\":\"15628652479933928\",\"r\":4}},{\"c\":\"ch3\",\"d\":\"3\",\"p\":{\"t\":\"15628652479933929\",\"r\":4}}]}",
+             NULL);
+
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+
+    assert_that(pubnub_get_v2_batch(pbp, msgs, 2), is_equal_to(2));
+    assert_char_mem_block(msgs[0].channel, "ch1");
+    assert_char_mem_block(msgs[0].payload, "1");
+    assert_char_mem_block(msgs[1].channel, "ch2");
+    assert_char_mem_block(msgs[1].payload, "{\"n\":[2]}");
+    assert_char_mem_block(msgs[1].tt, "15628652479933928");
+
+    assert_that(pubnub_get_v2_batch(pbp, msgs, 2), is_equal_to(1));
+    assert_char_mem_block(msgs[0].channel, "ch3");
+    assert_char_mem_block(msgs[0].payload, "\"3\"");
+
+    assert_that(pubnub_get_v2_batch(pbp, msgs, 2), is_equal_to(0));
+    assert_that(pubnub_get_v2(pbp).payload.ptr, is_equal_to(NULL));
+}
+
+#if PUBNUB_SUBSCRIBE_V2_STREAMING
+#define MAX_STREAMED 8
+
+/* Payloads of the messages given to the subscribe V2 message callback */
+static char   m_streamed[MAX_STREAMED][64];
+static size_t m_streamed_count;
+
+static void stream_callback(pubnub_t*                pb,
+                            struct pubnub_v2_message msg,
+                            void*                    user_data)
+{
+    size_t size = msg.payload.size;
+
+    assert_that(pb, is_equal_to(pbp));
+    assert_that(user_data, is_equal_to(&m_streamed_count));
+    assert_that(m_streamed_count, is_less_than(MAX_STREAMED));
+    if (size >= sizeof m_streamed[0]) { size = sizeof m_streamed[0] - 1; }
+    memcpy(m_streamed[m_streamed_count], msg.payload.ptr, size);
+    m_streamed[m_streamed_count++][size] = '\0';
+}
+
+static void set_stream_callback(void)
+{
+    m_streamed_count = 0;
+    pubnub_subscribe_v2_set_message_callback(
+        pbp, stream_callback, &m_streamed_count);
+}
+
+/* Queues a 200 response with the @p body, which should be longer
+   than the HTTP buffer, so that it's received in several pieces */
+static void incoming_body(char const* body)
+{
+    char headers[64];
+
+    snprintf(headers,
+             sizeof headers,
+             "HTTP/1.1 200\r\nContent-Length: %zu\r\n\r\n",
+             strlen(body));
+    incoming(headers, NULL);
+    incoming(body, NULL);
+}
+
+/* Queues a 200 response with the @p body, but only the first @p cut
+   octets of it are received before the connection is lost */
+static void incoming_cut_body(char const* body, size_t cut)
+{
+    char  headers[64];
+    char* received = malloc(cut + 1);
+
+    assert_that(received, is_not_null);
+    snprintf(headers,
+             sizeof headers,
+             "HTTP/1.1 200\r\nContent-Length: %zu\r\n\r\n",
+             strlen(body));
+    memcpy(received, body, cut);
+    received[cut] = '\0';
+    incoming(headers, NULL);
+    incoming(received, NULL);
+    free(received);
+}
+
+/* Message objects of the tests' responses, padded to be received in
+   pieces */
+#define STREAM_PAD "\"x\":\"0123456789012345678901234567890123456789012345678901234567890123456789\""
+#define STREAM_MSG(d, tt) "{\"c\":\"ch\"," STREAM_PAD ",\"d\":" d ",\"p\":{\"t\":\"" tt "\",\"r\":4}}"
+#define STREAM_T "\"t\":{\"t\":\"15628652479932717\",\"r\":4}"
+#define STREAM_URL "/v2/subscribe/sub_key/my-channel/0?pnsdk=unit-test-0.1&tt=0&uuid=test_id&heartbeat=300"
+/* The region is known from the first response, even if it failed */
+#define STREAM_RETRY_URL "/v2/subscribe/sub_key/my-channel/0?pnsdk=unit-test-0.1&tt=0&tr=4&uuid=test_id&heartbeat=300"
+
+Ensure(subscribe_v2, streams_messages_as_they_are_received) {
+    set_stream_callback();
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_body("{" STREAM_T ",\"m\":[" STREAM_MSG("1", "15628652479933927") ","
+                  STREAM_MSG("\"two\"", "15628652479933928") ","
+                  STREAM_MSG("[3]", "15628652479933929") "]}");
+
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+
+    assert_that(m_streamed_count, is_equal_to(3));
+    assert_that(m_streamed[0], is_equal_to_string("1"));
+    assert_that(m_streamed[1], is_equal_to_string("\"two\""));
+    assert_that(m_streamed[2], is_equal_to_string("[3]"));
+    assert_that(pubnub_last_time_token(pbp), is_equal_to_string("15628652479932717"));
+    assert_that(pubnub_get_v2(pbp).payload.ptr, is_equal_to(NULL));
+}
+
+Ensure(subscribe_v2, receives_as_a_whole_a_response_that_is_not_an_object) {
+    set_stream_callback();
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_body("[" STREAM_MSG("1", "15628652479933927") ","
+                  STREAM_MSG("2", "15628652479933928") ","
+                  STREAM_MSG("3", "15628652479933929") "]");
+
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_FORMAT_ERROR));
+    assert_that(m_streamed_count, is_equal_to(0));
+}
+
+Ensure(subscribe_v2, receives_as_a_whole_a_response_with_messages_not_in_an_array) {
+    set_stream_callback();
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_body("{" STREAM_T ",\"m\":{\"a\":" STREAM_MSG("1", "15628652479933927")
+                  ",\"b\":" STREAM_MSG("2", "15628652479933928")
+                  ",\"c\":" STREAM_MSG("3", "15628652479933929") "}}");
+
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+    assert_that(m_streamed_count, is_equal_to(0));
+}
+
+Ensure(subscribe_v2, receives_as_a_whole_a_response_with_timetoken_after_messages) {
+    set_stream_callback();
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_body("{\"m\":[" STREAM_MSG("1", "15628652479933927") ","
+                  STREAM_MSG("2", "15628652479933928") ","
+                  STREAM_MSG("3", "15628652479933929") "]," STREAM_T "}");
+
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+    assert_that(m_streamed_count, is_equal_to(3));
+    assert_that(m_streamed[0], is_equal_to_string("1"));
+    assert_that(m_streamed[1], is_equal_to_string("2"));
+    assert_that(m_streamed[2], is_equal_to_string("3"));
+    assert_that(pubnub_last_time_token(pbp), is_equal_to_string("15628652479932717"));
+}
+
+Ensure(subscribe_v2, receives_as_a_whole_the_rest_after_a_message_that_is_not_an_object) {
+    set_stream_callback();
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_body("{" STREAM_T ",\"m\":[" STREAM_MSG("1", "15628652479933927")
+                  ",5," STREAM_MSG("2", "15628652479933928") ","
+                  STREAM_MSG("3", "15628652479933929") "]}");
+
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+    /* The rest can't be parsed beyond what is not a message */
+    assert_that(m_streamed_count, is_equal_to(1));
+    assert_that(m_streamed[0], is_equal_to_string("1"));
+}
+#define STREAM_BODY_4 "{" STREAM_T ",\"m\":[" \
+    STREAM_MSG("1", "15628652479933927") "," \
+    STREAM_MSG("2", "15628652479933928") "," \
+    STREAM_MSG("3", "15628652479933929") "," \
+    STREAM_MSG("4", "15628652479933930") "]}"
+
+/* Starts a subscribe V2 which fails after some, but not all, of the
+   messages of #STREAM_BODY_4 were given, returning how many were */
+static size_t subscribe_and_lose_connection(void)
+{
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_cut_body(STREAM_BODY_4, sizeof STREAM_BODY_4 - 40);
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_STARTED));
+
+    expect(pbpal_close, when(pb, is_equal_to(pbp)), will_return(0));
+    expect(pbpal_forget, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+    assert_that(pbnc_fsm(pbp), is_equal_to(0));
+    assert_that(pbp->core.last_result, is_equal_to(PNR_TIMEOUT));
+    assert_that(m_streamed_count, is_greater_than(0));
+    assert_that(m_streamed_count, is_less_than(4));
+    assert_that(pubnub_last_time_token(pbp), is_equal_to_string("0"));
+
+    return m_streamed_count;
+}
+
+Ensure(subscribe_v2, does_not_give_messages_again_when_retried) {
+    set_stream_callback();
+    subscribe_and_lose_connection();
+
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_RETRY_URL);
+    incoming_body(STREAM_BODY_4);
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+    assert_that(m_streamed_count, is_equal_to(4));
+    assert_that(m_streamed[0], is_equal_to_string("1"));
+    assert_that(m_streamed[1], is_equal_to_string("2"));
+    assert_that(m_streamed[2], is_equal_to_string("3"));
+    assert_that(m_streamed[3], is_equal_to_string("4"));
+}
+
+Ensure(subscribe_v2, gives_messages_again_when_subscribing_to_other_channels) {
+    size_t given;
+
+    set_stream_callback();
+    given = subscribe_and_lose_connection();
+
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp,
+        "/v2/subscribe/sub_key/other-channel/0?pnsdk=unit-test-0.1&tt=0&tr=4&uuid=test_id&heartbeat=300");
+    incoming_body(STREAM_BODY_4);
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+
+    assert_that(pubnub_subscribe_v2(pbp, "other-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+    assert_that(m_streamed_count, is_equal_to(given + 4));
+    assert_that(m_streamed[given], is_equal_to_string("1"));
+}
+
+Ensure(subscribe_v2, gives_messages_again_when_resubscribing_after_success) {
+    set_stream_callback();
+    expect_have_dns_for_pubnub_origin_on_ctx(pbp);
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_URL);
+    incoming_body(STREAM_BODY_4);
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", pubnub_subscribe_v2_defopts()),
+        is_equal_to(PNR_OK));
+
+    /* Explicitly asking for the same timetoken again */
+    struct pubnub_subscribe_v2_options opts = pubnub_subscribe_v2_defopts();
+    strcpy(opts.timetoken, "0");
+    expect(pbntf_enqueue_for_processing, when(pb, is_equal_to(pbp)), will_return(0));
+    expect(pbntf_got_socket, when(pb, is_equal_to(pbp)), will_return(0));
+    expect_outgoing_with_url_on_ctx(pbp, STREAM_RETRY_URL);
+    incoming_body(STREAM_BODY_4);
+    expect(pbntf_lost_socket, when(pb, is_equal_to(pbp)));
+    expect(pbntf_trans_outcome, when(pb, is_equal_to(pbp)));
+    assert_that(pubnub_subscribe_v2(pbp, "my-channel", opts),
+        is_equal_to(PNR_OK));
+
+    assert_that(m_streamed_count, is_equal_to(8));
+    assert_that(m_streamed[4], is_equal_to_string("1"));
+}
+#endif /* PUBNUB_SUBSCRIBE_V2_STREAMING */
+
 #if 0
 int main(int argc, char *argv[]) {
     TestSuite *suite = create_test_suite();
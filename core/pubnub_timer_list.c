@@ -8,6 +8,7 @@
 void pubnub_timer_list_init(pubnub_t* pbp)
 {
     pbp->previous = pbp->next = NULL;
+    pbp->timer_slot           = NULL;
 }
 
 
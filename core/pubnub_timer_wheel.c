@@ -0,0 +1,183 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_timer_wheel.h"
+
+#include "pubnub_internal.h"
+#include "pubnub_assert.h"
+
+#include <string.h>
+
+
+#define L0_MASK (PUBNUB_TIMER_WHEEL_L0_SLOTS - 1)
+#define LN_MASK (PUBNUB_TIMER_WHEEL_LN_SLOTS - 1)
+
+/** Bit position of the slot index of upper level @p n (0-based) */
+#define LN_SHIFT(n) (PUBNUB_TIMER_WHEEL_L0_BITS + (n)*PUBNUB_TIMER_WHEEL_LN_BITS)
+
+/** The whole range of the wheel, in milliseconds */
+#define WHEEL_RANGE_MS (1UL << LN_SHIFT(PUBNUB_TIMER_WHEEL_LN_COUNT))
+
+
+/** Returns the slot in which a timer expiring at @p expiry should be */
+static pubnub_t** slot_for(struct pubnub_timer_wheel* wheel,
+                           unsigned long              expiry)
+{
+    unsigned long const delta = expiry - wheel->now;
+    unsigned            level;
+
+    if (delta < PUBNUB_TIMER_WHEEL_L0_SLOTS) {
+        return &wheel->level0[expiry & L0_MASK];
+    }
+    for (level = 0; level < PUBNUB_TIMER_WHEEL_LN_COUNT - 1; ++level) {
+        if (delta < (1UL << LN_SHIFT(level + 1))) { break; }
+    }
+    return &wheel->levelN[level][(expiry >> LN_SHIFT(level)) & LN_MASK];
+}
+
+
+static void link_to_slot(pubnub_t* pb, pubnub_t** slot)
+{
+    pb->previous = NULL;
+    pb->next     = *slot;
+    if (*slot != NULL) { (*slot)->previous = pb; }
+    *slot          = pb;
+    pb->timer_slot = slot;
+}
+
+
+/** Moves the timers from the current slot of the upper @p level to the
+    lower levels.
+    @return The index of the (now empty) slot that was cascaded
+ */
+static unsigned cascade(struct pubnub_timer_wheel* wheel, unsigned level)
+{
+    unsigned const idx = (wheel->now >> LN_SHIFT(level)) & LN_MASK;
+    pubnub_t*      pb  = wheel->levelN[level][idx];
+
+    wheel->levelN[level][idx] = NULL;
+    while (pb != NULL) {
+        pubnub_t* next = pb->next;
+        link_to_slot(pb, slot_for(wheel, pb->timer_expiry));
+        pb = next;
+    }
+
+    return idx;
+}
+
+
+void pubnub_timer_wheel_init(struct pubnub_timer_wheel* wheel)
+{
+    PUBNUB_ASSERT_OPT(wheel != NULL);
+
+    memset(wheel, 0, sizeof *wheel);
+}
+
+
+void pubnub_timer_wheel_add(struct pubnub_timer_wheel* wheel,
+                            pubnub_t*                  to_add,
+                            int                        timeout_ms)
+{
+    unsigned long timeout = (unsigned long)timeout_ms;
+
+    PUBNUB_ASSERT_OPT(wheel != NULL);
+    PUBNUB_ASSERT_OPT(to_add != NULL);
+    PUBNUB_ASSERT_OPT(timeout_ms > 0);
+
+    pubnub_timer_wheel_remove(wheel, to_add);
+    if (timeout >= WHEEL_RANGE_MS) { timeout = WHEEL_RANGE_MS - 1; }
+    to_add->timer_expiry = wheel->now + timeout;
+    link_to_slot(to_add, slot_for(wheel, to_add->timer_expiry));
+    ++wheel->count;
+}
+
+
+void pubnub_timer_wheel_remove(struct pubnub_timer_wheel* wheel,
+                               pubnub_t*                  to_remove)
+{
+    PUBNUB_ASSERT_OPT(wheel != NULL);
+    PUBNUB_ASSERT_OPT(to_remove != NULL);
+
+    if (NULL == to_remove->timer_slot) { return; }
+    if (to_remove->previous != NULL) {
+        to_remove->previous->next = to_remove->next;
+    }
+    else {
+        *to_remove->timer_slot = to_remove->next;
+    }
+    if (to_remove->next != NULL) {
+        to_remove->next->previous = to_remove->previous;
+    }
+    to_remove->previous = to_remove->next = NULL;
+    to_remove->timer_slot                 = NULL;
+    PUBNUB_ASSERT_OPT(wheel->count > 0);
+    --wheel->count;
+}
+
+
+pubnub_t* pubnub_timer_wheel_as_time_goes_by(struct pubnub_timer_wheel* wheel,
+                                             int time_passed_ms)
+{
+    pubnub_t* expired      = NULL;
+    pubnub_t* expired_tail = NULL;
+
+    PUBNUB_ASSERT_OPT(wheel != NULL);
+    PUBNUB_ASSERT_OPT(time_passed_ms > 0);
+
+    while (time_passed_ms > 0) {
+        unsigned  idx;
+        pubnub_t* pb;
+
+        if (0 == wheel->count) {
+            /* Nothing to cascade or expire, just jump ahead */
+            wheel->now += (unsigned long)time_passed_ms;
+            break;
+        }
+        ++wheel->now;
+        --time_passed_ms;
+        idx = wheel->now & L0_MASK;
+        if (0 == idx) {
+            /* Start of a new round of the first level, bring the
+               timers of the coming round down from upper level(s) */
+            unsigned level;
+            for (level = 0; level < PUBNUB_TIMER_WHEEL_LN_COUNT; ++level) {
+                if (cascade(wheel, level) != 0) { break; }
+            }
+        }
+
+        pb                 = wheel->level0[idx];
+        wheel->level0[idx] = NULL;
+        while (pb != NULL) {
+            pubnub_t* next = pb->next;
+
+            pb->timer_slot = NULL;
+            pb->previous   = expired_tail;
+            pb->next       = NULL;
+            if (NULL == expired_tail) { expired = pb; }
+            else { expired_tail->next = pb; }
+            expired_tail = pb;
+            --wheel->count;
+
+            pb = next;
+        }
+    }
+
+    return expired;
+}
+
+
+int pubnub_timer_wheel_next_expiry(struct pubnub_timer_wheel const* wheel)
+{
+    unsigned i;
+
+    PUBNUB_ASSERT_OPT(wheel != NULL);
+
+    if (0 == wheel->count) { return -1; }
+    /* The first level holds the timers of the next
+       PUBNUB_TIMER_WHEEL_L0_SLOTS - 1 milliseconds */
+    for (i = 1; i < PUBNUB_TIMER_WHEEL_L0_SLOTS; ++i) {
+        if (wheel->level0[(wheel->now + i) & L0_MASK] != NULL) {
+            return (int)i;
+        }
+    }
+    /* Timers of upper levels can't expire before they're cascaded */
+    return (int)(PUBNUB_TIMER_WHEEL_L0_SLOTS - (wheel->now & L0_MASK));
+}
@@ -0,0 +1,103 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_TIMER_WHEEL
+#define	INC_PUBNUB_TIMER_WHEEL
+
+
+#include "pubnub_api_types.h"
+#include "lib/pb_extern.h"
+
+
+/** @file pubnub_timer_wheel.h
+
+    A hierarchical timing wheel of Pubnub contexts/timers, an
+    alternative to the (delta) timer list of pubnub_timer_list.h.
+    Adding, removing and expiring a timer are O(1), regardless of the
+    number of timers, while the list has O(n) insertion.
+
+    The wheel has a resolution of 1 ms. The first level has a slot
+    per millisecond, for timers expiring in less than
+    #PUBNUB_TIMER_WHEEL_L0_SLOTS ms, each next level has
+    #PUBNUB_TIMER_WHEEL_LN_SLOTS slots, each covering the whole range
+    of the previous level. Timers of upper levels are moved
+    ("cascaded") to lower levels as the time goes by. Timeouts longer
+    than the whole range of the wheel (~18.6 hours) are cut to it.
+
+    Like the list, the wheel is intrusive: a context is linked in a
+    slot through its own `previous` and `next` fields, so there is no
+    memory allocation.
+ */
+
+
+#define PUBNUB_TIMER_WHEEL_L0_BITS 8
+#define PUBNUB_TIMER_WHEEL_LN_BITS 6
+/** Number of levels above the first one */
+#define PUBNUB_TIMER_WHEEL_LN_COUNT 3
+
+#define PUBNUB_TIMER_WHEEL_L0_SLOTS (1 << PUBNUB_TIMER_WHEEL_L0_BITS)
+#define PUBNUB_TIMER_WHEEL_LN_SLOTS (1 << PUBNUB_TIMER_WHEEL_LN_BITS)
+
+
+struct pubnub_timer_wheel {
+    /** Current time of the wheel, in milliseconds since it was
+        initialized (wraps around). */
+    unsigned long now;
+    /** Number of timers in the wheel */
+    unsigned      count;
+    /** First level, one slot per millisecond */
+    pubnub_t* level0[PUBNUB_TIMER_WHEEL_L0_SLOTS];
+    /** Upper levels */
+    pubnub_t* levelN[PUBNUB_TIMER_WHEEL_LN_COUNT][PUBNUB_TIMER_WHEEL_LN_SLOTS];
+};
+
+
+/** Initializes the (empty) timer @p wheel.
+    @pre wheel != NULL
+ */
+PUBNUB_EXTERN void pubnub_timer_wheel_init(struct pubnub_timer_wheel* wheel);
+
+/** Adds the Pubnub context @p to_add to the timer @p wheel, to expire
+    after @p timeout_ms milliseconds. If it's already in the @p wheel,
+    it is removed first (i.e. the timer is restarted).
+
+    @pre wheel != NULL
+    @pre to_add != NULL
+    @pre timeout_ms > 0
+ */
+PUBNUB_EXTERN void pubnub_timer_wheel_add(struct pubnub_timer_wheel* wheel,
+                                          pubnub_t*                  to_add,
+                                          int timeout_ms);
+
+/** Removes the Pubnub context @p to_remove from the timer @p wheel.
+    Does nothing if it is not in the wheel.
+
+    @pre wheel != NULL
+    @pre to_remove != NULL
+ */
+PUBNUB_EXTERN void pubnub_timer_wheel_remove(struct pubnub_timer_wheel* wheel,
+                                             pubnub_t* to_remove);
+
+/** Advances the timer @p wheel by @p time_passed_ms milliseconds and
+    dequeues all the timers that have expired in that time, returning
+    them in a list linked through `pubnub_timer_list_next()`.
+
+    @pre wheel != NULL
+    @pre time_passed_ms > 0
+    @return List of expired timers (NULL if none have expired)
+ */
+PUBNUB_EXTERN pubnub_t* pubnub_timer_wheel_as_time_goes_by(
+    struct pubnub_timer_wheel* wheel,
+    int                        time_passed_ms);
+
+/** Returns the number of milliseconds until the next timer in the
+    timer @p wheel (might) expire. If the next timer is in an upper
+    level, this is the time of the next cascade, which is earlier than
+    the timer's expiry, but never later than it.
+
+    @pre wheel != NULL
+    @return Time to next expiry, in ms, or -1 if the wheel is empty
+ */
+PUBNUB_EXTERN int pubnub_timer_wheel_next_expiry(
+    struct pubnub_timer_wheel const* wheel);
+
+
+#endif /* !defined INC_PUBNUB_TIMER_WHEEL */
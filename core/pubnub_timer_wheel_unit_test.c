@@ -0,0 +1,207 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include "pubnub_internal.h"
+#include "pubnub_timer_wheel.h"
+#include "pubnub_timer_list.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* A less chatty cgreen :) */
+
+#define attest assert_that
+#define equals is_equal_to
+#define differs is_not_equal_to
+
+
+static struct pubnub_timer_wheel m_wheel;
+
+
+static pubnub_t* alloc_contexts(size_t n)
+{
+    pubnub_t* rslt = (pubnub_t*)calloc(n, sizeof *rslt);
+    size_t    i;
+
+    for (i = 0; i < n; ++i) {
+        pubnub_timer_list_init(&rslt[i]);
+    }
+    return rslt;
+}
+
+
+static size_t list_length(pubnub_t* list)
+{
+    size_t rslt = 0;
+    for (; list != NULL; list = pubnub_timer_list_next(list)) {
+        ++rslt;
+    }
+    return rslt;
+}
+
+
+Describe(pubnub_timer_wheel);
+
+
+BeforeEach(pubnub_timer_wheel)
+{
+    pubnub_timer_wheel_init(&m_wheel);
+}
+
+
+AfterEach(pubnub_timer_wheel) {}
+
+
+Ensure(pubnub_timer_wheel, expires_exactly_on_time)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    pubnub_timer_wheel_add(&m_wheel, pb, 1000);
+    attest(m_wheel.count, equals(1));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 999), equals(NULL));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 1), equals(pb));
+    attest(m_wheel.count, equals(0));
+    attest(pubnub_timer_list_next(pb), equals(NULL));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_timer_wheel, expires_all_that_are_due)
+{
+    pubnub_t* pb = alloc_contexts(3);
+    pubnub_t* expired;
+
+    pubnub_timer_wheel_add(&m_wheel, &pb[0], 10);
+    pubnub_timer_wheel_add(&m_wheel, &pb[1], 300);
+    pubnub_timer_wheel_add(&m_wheel, &pb[2], 20000);
+
+    expired = pubnub_timer_wheel_as_time_goes_by(&m_wheel, 500);
+    attest(list_length(expired), equals(2));
+    attest(expired, equals(&pb[0]));
+    attest(pubnub_timer_list_next(expired), equals(&pb[1]));
+    attest(m_wheel.count, equals(1));
+
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 19499), equals(NULL));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 1), equals(&pb[2]));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_timer_wheel, removed_timer_does_not_expire)
+{
+    pubnub_t* pb = alloc_contexts(3);
+
+    pubnub_timer_wheel_add(&m_wheel, &pb[0], 100);
+    pubnub_timer_wheel_add(&m_wheel, &pb[1], 100);
+    pubnub_timer_wheel_add(&m_wheel, &pb[2], 100);
+    pubnub_timer_wheel_remove(&m_wheel, &pb[1]);
+    attest(m_wheel.count, equals(2));
+
+    /* Removing again is harmless */
+    pubnub_timer_wheel_remove(&m_wheel, &pb[1]);
+    attest(m_wheel.count, equals(2));
+
+    attest(list_length(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 100)),
+           equals(2));
+    attest(m_wheel.count, equals(0));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_timer_wheel, adding_again_restarts_the_timer)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    pubnub_timer_wheel_add(&m_wheel, pb, 100);
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 50), equals(NULL));
+    pubnub_timer_wheel_add(&m_wheel, pb, 100);
+    attest(m_wheel.count, equals(1));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 99), equals(NULL));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 1), equals(pb));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_timer_wheel, time_passes_while_empty)
+{
+    pubnub_t* pb = alloc_contexts(1);
+
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 123456), equals(NULL));
+    pubnub_timer_wheel_add(&m_wheel, pb, 70000);
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 69999), equals(NULL));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 1), equals(pb));
+
+    free(pb);
+}
+
+
+Ensure(pubnub_timer_wheel, every_timer_expires_in_the_right_step)
+{
+    size_t const n     = 5000;
+    pubnub_t*    pb    = alloc_contexts(n);
+    int*         due   = (int*)calloc(n, sizeof *due);
+    int          now   = 0;
+    size_t       fired = 0;
+    size_t       i;
+
+    srand(7);
+    for (i = 0; i < n; ++i) {
+        /* Spread over all the levels of the wheel */
+        due[i] = 1 + rand() % (1 << (4 + rand() % 18));
+        pubnub_timer_wheel_add(&m_wheel, &pb[i], due[i]);
+    }
+    while (fired < n) {
+        int const step    = 1 + rand() % 200;
+        pubnub_t* expired = pubnub_timer_wheel_as_time_goes_by(&m_wheel, step);
+
+        for (; expired != NULL; expired = pubnub_timer_list_next(expired)) {
+            int const d = due[expired - pb];
+            attest(d > now);
+            attest(d <= now + step);
+            ++fired;
+        }
+        now += step;
+    }
+    attest(m_wheel.count, equals(0));
+
+    free(due);
+    free(pb);
+}
+
+
+Ensure(pubnub_timer_wheel, next_expiry_is_never_late)
+{
+    pubnub_t* pb = alloc_contexts(2);
+
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(-1));
+
+    pubnub_timer_wheel_add(&m_wheel, &pb[0], 100);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(100));
+    pubnub_timer_wheel_add(&m_wheel, &pb[1], 30);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(30));
+    pubnub_timer_wheel_as_time_goes_by(&m_wheel, 30);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(70));
+    pubnub_timer_wheel_as_time_goes_by(&m_wheel, 70);
+
+    /* In an upper level, so, it's the time of the next cascade */
+    pubnub_timer_wheel_add(&m_wheel, &pb[0], 1000);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(156));
+    pubnub_timer_wheel_as_time_goes_by(&m_wheel, 156);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(256));
+    pubnub_timer_wheel_as_time_goes_by(&m_wheel, 256);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(256));
+    pubnub_timer_wheel_as_time_goes_by(&m_wheel, 256);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(256));
+    pubnub_timer_wheel_as_time_goes_by(&m_wheel, 256);
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(76));
+    attest(pubnub_timer_wheel_as_time_goes_by(&m_wheel, 76), equals(&pb[0]));
+    attest(pubnub_timer_wheel_next_expiry(&m_wheel), equals(-1));
+
+    free(pb);
+}
@@ -34,7 +34,9 @@
  * the memory size of the whole pubnub context, but it is also an
  * upper bound on URL-encoded form of published message, so if you
  * need to construct big messages, you may need to raise this.  */
+#if !defined(PUBNUB_BUF_MAXLEN)
 #define PUBNUB_BUF_MAXLEN 256
+#endif
 
 /** Maximum length of the HTTP reply. The other major component of the
  * memory size of the PubNub context, beside #PUBNUB_BUF_MAXLEN.
@@ -151,6 +153,11 @@
 
 #define PUBNUB_MAX_URL_PARAMS 12
 
+#if PUBNUB_USE_PIPELINING && !defined(PUBNUB_PIPELINE_DEPTH)
+/** Maximum number of requests queued on a context for pipelining */
+#define PUBNUB_PIPELINE_DEPTH 4
+#endif
+
 #ifndef PUBNUB_RAND_INIT_VECTOR
 #define PUBNUB_RAND_INIT_VECTOR 1
 #endif
@@ -15,6 +15,9 @@
 #include "pubnub_version_internal.h"
 #include "pubnub_keep_alive.h"
 #include "test/pubnub_test_helper.h"
+#if PUBNUB_USE_PIPELINING
+#include "pbpipeline.h"
+#endif
 
 #include <stddef.h>
 #include <stdio.h>
@@ -70,6 +73,14 @@ void pbntf_trans_outcome(pubnub_t* pb, enum pubnub_state state)
 {
     pb->state = state;
     mock(pb);
+#if PUBNUB_USE_PIPELINING
+    /* As the callback interface does, so that the pipeline goes on */
+    pbpipeline_trans_ended(pb);
+    if (pb->cb != NULL) {
+        pb->cb(pb, pb->trans, pb->core.last_result, pb->user_data);
+    }
+    pbpipeline_dispatch(pb);
+#endif
 }
 
 int pbntf_got_socket(pubnub_t* pb)
@@ -447,6 +458,14 @@ int pbpal_close(pubnub_t* pb)
     return mock(pb);
 }
 
+#if PUBNUB_USE_MULTIPLE_ADDRESSES
+void pbpal_multiple_addresses_reset_counters(
+    struct pubnub_multi_addresses* spare_addresses)
+{
+    PUBNUB_UNUSED(spare_addresses);
+}
+#endif
+
 
 /* The Pubnub version stubs */
 
@@ -5,12 +5,525 @@
 
 #include <string.h>
 
+#if !defined(PBBASE64_NO_SIMD)
+#if (defined(__x86_64__) || defined(__i386__))                                 \
+    && (defined(__GNUC__) || defined(__clang__))
+#define PBBASE64_X86 1
+#define PBBASE64_SSSE3_TARGET __attribute__((target("ssse3")))
+#define PBBASE64_AVX2_TARGET __attribute__((target("avx2")))
+#include <cpuid.h>
+#include <immintrin.h>
+#elif (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER)
+#define PBBASE64_X86 1
+#define PBBASE64_SSSE3_TARGET
+#define PBBASE64_AVX2_TARGET
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PBBASE64_NEON 1
+#include <arm_neon.h>
+#endif
+#endif /* !defined(PBBASE64_NO_SIMD) */
+
+#if !defined(PBBASE64_X86)
+#define PBBASE64_X86 0
+#endif
+#if !defined(PBBASE64_NEON)
+#define PBBASE64_NEON 0
+#endif
 
-int pbbase64_encode(
-    pubnub_bymebl_t                data,
-    char*                          s,
-    size_t*                        n,
-    struct pbbase64_options const* options)
+
+static uint8_t const decode_tab_C[256] = {
+    /*  00  01  02  03  04  05  06  07  08  09  0A  0B  0C  0D  0E  0F */
+    /*0*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*1*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*2*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*3*/ 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 64, 64, 64, 64, 64, 64,
+    /*4*/ 64, 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14,
+    /*5*/ 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 64, 64, 64, 64, 64,
+    /*6*/ 64, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    /*7*/ 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64,
+    /*8*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*9*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*A*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*B*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*C*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*D*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*E*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+    /*F*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64
+};
+
+
+#if PBBASE64_X86
+/* The best variant this CPU can do: -1 not checked yet. Checking is
+   cheap, but not free (CPUID traps in virtual machines), so it's
+   done once. Racing threads would store the same value.
+ */
+#if defined(_MSC_VER)
+static volatile long m_best_variant = -1;
+#define load_best_variant() m_best_variant
+#define store_best_variant(v) (m_best_variant = (v))
+#else
+static int m_best_variant = -1;
+#define load_best_variant()                                                    \
+    __atomic_load_n(&m_best_variant, __ATOMIC_RELAXED)
+#define store_best_variant(v)                                                  \
+    __atomic_store_n(&m_best_variant, (v), __ATOMIC_RELAXED)
+#endif
+
+static enum pbbase64_variant detect_variant(void)
+{
+    bool ssse3;
+    bool avx2 = false;
+#if defined(_MSC_VER)
+    int regs[4];
+    int max_leaf;
+
+    __cpuid(regs, 0);
+    max_leaf = regs[0];
+    __cpuid(regs, 1);
+    ssse3 = (regs[2] >> 9) & 1;
+    /* AVX2 is usable only if the OS saves the YMM registers */
+    if (((regs[2] >> 27) & 1) && ((regs[2] >> 28) & 1) && (max_leaf >= 7)) {
+        __cpuidex(regs, 7, 0);
+        avx2 = ((regs[1] >> 5) & 1) && ((_xgetbv(0) & 6) == 6);
+    }
+#else
+    unsigned eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) { return pbbase64Scalar; }
+    ssse3 = (ecx & bit_SSSE3) != 0;
+    /* AVX2 is usable only if the OS saves the YMM registers */
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)
+        && (__get_cpuid_max(0, NULL) >= 7)) {
+        unsigned xcr0, xcr0_high;
+        __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        avx2 = (ebx & bit_AVX2) && ((xcr0 & 6) == 6);
+    }
+#endif
+    if (avx2) { return pbbase64AVX2; }
+    return ssse3 ? pbbase64SSSE3 : pbbase64Scalar;
+}
+
+
+static enum pbbase64_variant best_variant(void)
+{
+    int best = load_best_variant();
+    if (best < 0) {
+        best = detect_variant();
+        store_best_variant(best);
+    }
+    return (enum pbbase64_variant)best;
+}
+
+
+/* Encodes 12 octets to 16 characters at a time, as described by
+   Wojciech Muła in "Base64 encoding with SIMD instructions".
+   Alphabet has to start with COMMON_BASE64_ABC.
+
+   @return Number of octets encoded (multiple of 3)
+ */
+static PBBASE64_SSSE3_TARGET size_t encode_ssse3(uint8_t const* in,
+                                                 size_t         length,
+                                                 char*          out,
+                                                 char const*    alphabet)
+{
+    size_t        i       = 0;
+    __m128i const shuffle = _mm_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    __m128i const mask_ac = _mm_set1_epi32(0x0FC0FC00);
+    __m128i const mul_ac  = _mm_set1_epi32(0x04000040);
+    __m128i const mask_bd = _mm_set1_epi32(0x003F03F0);
+    __m128i const mul_bd  = _mm_set1_epi32(0x01000010);
+    __m128i const c51     = _mm_set1_epi8(51);
+    __m128i const c25     = _mm_set1_epi8(25);
+    /* What to add to the 6 bit value to get its character */
+    __m128i const offset = _mm_setr_epi8('A',
+                                         'a' - 26,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         '0' - 52,
+                                         (char)(alphabet[62] - 62),
+                                         (char)(alphabet[63] - 63),
+                                         0,
+                                         0);
+
+    /* Loads 16 octets, but uses only 12 */
+    for (; length - i >= 16; i += 12, out += 16) {
+        __m128i v = _mm_loadu_si128((__m128i const*)(in + i));
+        __m128i idx;
+        v = _mm_shuffle_epi8(v, shuffle);
+        v = _mm_or_si128(
+            _mm_mulhi_epu16(_mm_and_si128(v, mask_ac), mul_ac),
+            _mm_mullo_epi16(_mm_and_si128(v, mask_bd), mul_bd));
+        /* 0..25 -> 0, 26..51 -> 1, 52..61 -> 2..11, 62 -> 12, 63 -> 13 */
+        idx = _mm_sub_epi8(_mm_subs_epu8(v, c51), _mm_cmpgt_epi8(v, c25));
+        v   = _mm_add_epi8(v, _mm_shuffle_epi8(offset, idx));
+        _mm_storeu_si128((__m128i*)out, v);
+    }
+    return i;
+}
+
+
+/* Same as encode_ssse3(), but 24 octets to 32 characters at a time */
+static PBBASE64_AVX2_TARGET size_t encode_avx2(uint8_t const* in,
+                                               size_t         length,
+                                               char*          out,
+                                               char const*    alphabet)
+{
+    size_t        i       = 0;
+    __m256i const shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    __m256i const mask_ac = _mm256_set1_epi32(0x0FC0FC00);
+    __m256i const mul_ac  = _mm256_set1_epi32(0x04000040);
+    __m256i const mask_bd = _mm256_set1_epi32(0x003F03F0);
+    __m256i const mul_bd  = _mm256_set1_epi32(0x01000010);
+    __m256i const c51     = _mm256_set1_epi8(51);
+    __m256i const c25     = _mm256_set1_epi8(25);
+    __m256i const offset  = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8('A',
+                      'a' - 26,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      '0' - 52,
+                      (char)(alphabet[62] - 62),
+                      (char)(alphabet[63] - 63),
+                      0,
+                      0));
+
+    /* Loads 12 + 16 octets, to the two lanes, uses 24 */
+    for (; length - i >= 28; i += 24, out += 32) {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i const*)(in + i))),
+            _mm_loadu_si128((__m128i const*)(in + i + 12)),
+            1);
+        __m256i idx;
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_or_si256(
+            _mm256_mulhi_epu16(_mm256_and_si256(v, mask_ac), mul_ac),
+            _mm256_mullo_epi16(_mm256_and_si256(v, mask_bd), mul_bd));
+        idx = _mm256_sub_epi8(_mm256_subs_epu8(v, c51),
+                              _mm256_cmpgt_epi8(v, c25));
+        v   = _mm256_add_epi8(v, _mm256_shuffle_epi8(offset, idx));
+        _mm256_storeu_si256((__m256i*)out, v);
+    }
+    /* The rest is done with SSE, which is slow with dirty AVX state */
+    _mm256_zeroupper();
+    return i + encode_ssse3(in + i, length - i, out, alphabet);
+}
+
+
+/* Decodes 16 characters to 12 octets at a time, as described by
+   Wojciech Muła in "Base64 decoding with SIMD instructions". Stops at
+   the first block that has a character that is not in the (standard,
+   "+/") alphabet, which includes padding.
+
+   @return Number of characters decoded (multiple of 4)
+ */
+static PBBASE64_SSSE3_TARGET size_t decode_ssse3(char const* s,
+                                                 size_t      n,
+                                                 uint8_t*    out,
+                                                 size_t      room)
+{
+    size_t        i = 0;
+    __m128i const lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                         0x1B, 0x1B, 0x1B, 0x1A);
+    __m128i const lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                         0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                         0x10, 0x10, 0x10, 0x10);
+    __m128i const lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i const mask_2f = _mm_set1_epi8(0x2F);
+    __m128i const mul_ab  = _mm_set1_epi32(0x01400140);
+    __m128i const mul_abc = _mm_set1_epi32(0x00011000);
+    __m128i const pack    = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    /* Stores 16 octets, of which only 12 are decoded */
+    for (; (n - i >= 16) && (room >= 16); i += 16, out += 12, room -= 12) {
+        __m128i const str = _mm_loadu_si128((__m128i const*)(s + i));
+        __m128i const hi_nibbles =
+            _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        __m128i const lo_nibbles = _mm_and_si128(str, mask_2f);
+        __m128i const hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        __m128i const lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        __m128i       v;
+        if (_mm_movemask_epi8(
+                _mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128()))
+            != 0) {
+            break;
+        }
+        v = _mm_add_epi8(
+            str,
+            _mm_shuffle_epi8(
+                lut_roll,
+                _mm_add_epi8(_mm_cmpeq_epi8(str, mask_2f), hi_nibbles)));
+        v = _mm_madd_epi16(_mm_maddubs_epi16(v, mul_ab), mul_abc);
+        _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(v, pack));
+    }
+    return i;
+}
+
+
+/* Same as decode_ssse3(), but 32 characters to 24 octets at a time */
+static PBBASE64_AVX2_TARGET size_t decode_avx2(char const* s,
+                                               size_t      n,
+                                               uint8_t*    out,
+                                               size_t      room)
+{
+    size_t        i      = 0;
+    __m256i const lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13,
+        0x1A, 0x1B, 0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    __m256i const lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+        0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    __m256i const lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m256i const mask_2f = _mm256_set1_epi8(0x2F);
+    __m256i const mul_ab  = _mm256_set1_epi32(0x01400140);
+    __m256i const mul_abc = _mm256_set1_epi32(0x00011000);
+    __m256i const pack    = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    __m256i const lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+    /* Stores 32 octets, of which only 24 are decoded */
+    for (; (n - i >= 32) && (room >= 32); i += 32, out += 24, room -= 24) {
+        __m256i const str = _mm256_loadu_si256((__m256i const*)(s + i));
+        __m256i const hi_nibbles =
+            _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i const lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i const hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i const lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        __m256i       v;
+        if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(
+                _mm256_and_si256(lo, hi), _mm256_setzero_si256()))
+            != 0) {
+            break;
+        }
+        v = _mm256_add_epi8(
+            str,
+            _mm256_shuffle_epi8(
+                lut_roll,
+                _mm256_add_epi8(_mm256_cmpeq_epi8(str, mask_2f), hi_nibbles)));
+        v = _mm256_madd_epi16(_mm256_maddubs_epi16(v, mul_ab), mul_abc);
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack), lanes);
+        _mm256_storeu_si256((__m256i*)out, v);
+    }
+    _mm256_zeroupper();
+    return i + decode_ssse3(s + i, n - i, out, room);
+}
+
+#elif PBBASE64_NEON
+
+static enum pbbase64_variant best_variant(void)
+{
+    return pbbase64NEON;
+}
+
+
+/* Encodes 48 octets to 64 characters at a time, with the
+   (de)interleaving loads and stores, looking the characters up
+   in the alphabet.
+
+   @return Number of octets encoded (multiple of 3)
+ */
+static size_t encode_neon(uint8_t const* in,
+                          size_t         length,
+                          char*          out,
+                          char const*    alphabet)
+{
+    size_t           i    = 0;
+    uint8x16_t const mask = vdupq_n_u8(0x3F);
+    uint8x16x4_t     abc;
+
+    abc.val[0] = vld1q_u8((uint8_t const*)alphabet);
+    abc.val[1] = vld1q_u8((uint8_t const*)alphabet + 16);
+    abc.val[2] = vld1q_u8((uint8_t const*)alphabet + 32);
+    abc.val[3] = vld1q_u8((uint8_t const*)alphabet + 48);
+    for (; length - i >= 48; i += 48, out += 64) {
+        uint8x16x3_t const src = vld3q_u8(in + i);
+        uint8x16x4_t       dst;
+        dst.val[0] = vshrq_n_u8(src.val[0], 2);
+        dst.val[1] = vandq_u8(
+            vorrq_u8(vshrq_n_u8(src.val[1], 4), vshlq_n_u8(src.val[0], 4)),
+            mask);
+        dst.val[2] = vandq_u8(
+            vorrq_u8(vshrq_n_u8(src.val[2], 6), vshlq_n_u8(src.val[1], 2)),
+            mask);
+        dst.val[3] = vandq_u8(src.val[2], mask);
+        dst.val[0] = vqtbl4q_u8(abc, dst.val[0]);
+        dst.val[1] = vqtbl4q_u8(abc, dst.val[1]);
+        dst.val[2] = vqtbl4q_u8(abc, dst.val[2]);
+        dst.val[3] = vqtbl4q_u8(abc, dst.val[3]);
+        vst4q_u8((uint8_t*)out, dst);
+    }
+    return i;
+}
+
+
+/* Decodes 64 characters to 48 octets at a time, looking them up in
+   the (first half of the) @p decode_tab. Stops at the first block that
+   has a character that is not in the alphabet, which includes
+   padding.
+
+   @return Number of characters decoded (multiple of 4)
+ */
+static size_t decode_neon(char const*    s,
+                          size_t         n,
+                          uint8_t*       out,
+                          size_t         room,
+                          uint8_t const* decode_tab)
+{
+    size_t           i   = 0;
+    uint8x16_t const x40 = vdupq_n_u8(0x40);
+    uint8x16x4_t     tab_lo;
+    uint8x16x4_t     tab_hi;
+
+    tab_lo.val[0] = vld1q_u8(decode_tab);
+    tab_lo.val[1] = vld1q_u8(decode_tab + 16);
+    tab_lo.val[2] = vld1q_u8(decode_tab + 32);
+    tab_lo.val[3] = vld1q_u8(decode_tab + 48);
+    tab_hi.val[0] = vld1q_u8(decode_tab + 64);
+    tab_hi.val[1] = vld1q_u8(decode_tab + 80);
+    tab_hi.val[2] = vld1q_u8(decode_tab + 96);
+    tab_hi.val[3] = vld1q_u8(decode_tab + 112);
+    for (; (n - i >= 64) && (room >= 48); i += 64, out += 48, room -= 48) {
+        uint8x16x4_t const str = vld4q_u8((uint8_t const*)s + i);
+        uint8x16x4_t       v;
+        uint8x16x3_t       dst;
+        uint8x16_t         bad;
+        unsigned           k;
+        /* Out of range indexes look up 0, so each character is found
+           in (at most) one of the tables */
+        for (k = 0; k < 4; ++k) {
+            v.val[k] = vorrq_u8(vqtbl4q_u8(tab_lo, str.val[k]),
+                                vqtbl4q_u8(tab_hi, veorq_u8(str.val[k], x40)));
+        }
+        /* Invalid characters are 64 in the table, or >= 128 */
+        bad = vorrq_u8(vorrq_u8(v.val[0], v.val[1]),
+                       vorrq_u8(v.val[2], v.val[3]));
+        bad = vorrq_u8(bad,
+                       vshrq_n_u8(vorrq_u8(vorrq_u8(str.val[0], str.val[1]),
+                                           vorrq_u8(str.val[2], str.val[3])),
+                                  1));
+        if (vmaxvq_u8(bad) >= 64) { break; }
+        dst.val[0] =
+            vorrq_u8(vshlq_n_u8(v.val[0], 2), vshrq_n_u8(v.val[1], 4));
+        dst.val[1] =
+            vorrq_u8(vshlq_n_u8(v.val[1], 4), vshrq_n_u8(v.val[2], 2));
+        dst.val[2] = vorrq_u8(vshlq_n_u8(v.val[2], 6), v.val[3]);
+        vst3q_u8(out, dst);
+    }
+    return i;
+}
+
+#else
+
+static enum pbbase64_variant best_variant(void)
+{
+    return pbbase64Scalar;
+}
+
+#endif /* PBBASE64_X86 */
+
+
+/** Encodes as much of @p in as the vector kernels of @p variant can,
+    which requires the alphabet to be a common one.
+    @return Number of octets encoded (multiple of 3)
+ */
+static size_t encode_bulk(enum pbbase64_variant variant,
+                          uint8_t const*        in,
+                          size_t                length,
+                          char*                 out,
+                          char const*           alphabet)
+{
+    if (0
+        != memcmp(alphabet, COMMON_BASE64_ABC, sizeof COMMON_BASE64_ABC - 1)) {
+        return 0;
+    }
+    switch (variant) {
+#if PBBASE64_X86
+    case pbbase64AVX2:
+        /* For short data, setting up is a bigger cost than the rest */
+        if (length >= 64) { return encode_avx2(in, length, out, alphabet); }
+        return encode_ssse3(in, length, out, alphabet);
+    case pbbase64SSSE3:
+        return encode_ssse3(in, length, out, alphabet);
+#elif PBBASE64_NEON
+    case pbbase64NEON:
+        return encode_neon(in, length, out, alphabet);
+#endif
+    default:
+        return 0;
+    }
+}
+
+
+/** Decodes as much of @p s as the vector kernels of @p variant can,
+    which is up to the first invalid character (or padding), writing
+    no more than @p room octets to @p out.
+    @return Number of characters decoded (multiple of 4)
+ */
+static size_t decode_bulk(enum pbbase64_variant variant,
+                          char const*           s,
+                          size_t                n,
+                          uint8_t*              out,
+                          size_t                room,
+                          uint8_t const*        decode_tab,
+                          char const*           alphabet)
+{
+    switch (variant) {
+#if PBBASE64_X86
+    case pbbase64AVX2:
+        if ((alphabet[62] != '+') || (alphabet[63] != '/')) { return 0; }
+        if (n >= 96) { return decode_avx2(s, n, out, room); }
+        return decode_ssse3(s, n, out, room);
+    case pbbase64SSSE3:
+        if ((alphabet[62] != '+') || (alphabet[63] != '/')) { return 0; }
+        return decode_ssse3(s, n, out, room);
+#elif PBBASE64_NEON
+    case pbbase64NEON:
+        return decode_neon(s, n, out, room, decode_tab);
+#endif
+    default:
+        (void)s;
+        (void)n;
+        (void)out;
+        (void)room;
+        (void)decode_tab;
+        (void)alphabet;
+        return 0;
+    }
+}
+
+
+static int encode(enum pbbase64_variant          variant,
+                  pubnub_bymebl_t                data,
+                  char*                          s,
+                  size_t*                        n,
+                  struct pbbase64_options const* options)
 {
     size_t         i;
     char*          out    = s;
@@ -25,7 +538,10 @@ int pbbase64_encode(
 
     if (*n < pbbase64_char_array_size_for_encoding(length)) { return -1; }
 
-    for (i = 0; i < length; i += 3) {
+    i = encode_bulk(variant, in, length, out, options->alphabet);
+    in += i;
+    out += i / 3 * 4;
+    for (; i < length; i += 3) {
         uint8_t b = (in[0] & 0x0FC) >> 2;
         *out++    = options->alphabet[b];
         b         = (in[0] & 0x3) << 4;
@@ -60,6 +576,16 @@ int pbbase64_encode(
 }
 
 
+int pbbase64_encode(
+    pubnub_bymebl_t                data,
+    char*                          s,
+    size_t*                        n,
+    struct pbbase64_options const* options)
+{
+    return encode(best_variant(), data, s, n, options);
+}
+
+
 size_t pbbase64_encoded_length(size_t length)
 {
     return ((length + 2) / 3) * 4;
@@ -106,38 +632,17 @@ pubnub_bymebl_t pbbase64_encode_alloc_std(pubnub_bymebl_t data)
 }
 
 
-static uint8_t const decode_tab_C[256] = {
-    /*  00  01  02  03  04  05  06  07  08  09  0A  0B  0C  0D  0E  0F */
-    /*0*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*1*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*2*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*3*/ 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 64, 64, 64, 64, 64, 64,
-    /*4*/ 64, 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14,
-    /*5*/ 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 64, 64, 64, 64, 64,
-    /*6*/ 64, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-    /*7*/ 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64,
-    /*8*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*9*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*A*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*B*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*C*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*D*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*E*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
-    /*F*/ 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64
-};
-
-
 size_t pbbase64_decoded_length(size_t n)
 {
     return (n * 3 + 3) / 4;
 }
 
 
-int pbbase64_decode(
-    char const*                    s,
-    size_t                         n,
-    pubnub_bymebl_t*               data,
-    struct pbbase64_options const* options)
+static int decode(enum pbbase64_variant          variant,
+                  char const*                    s,
+                  size_t                         n,
+                  pubnub_bymebl_t*               data,
+                  struct pbbase64_options const* options)
 {
     size_t      i;
     char const* alphabet;
@@ -158,30 +663,40 @@ int pbbase64_decode(
     if (pbbase64_decoded_length(n) > data->size) { return -1; }
 
     memcpy(decode_tab, decode_tab_C, sizeof decode_tab);
-    decode_tab[(int)alphabet[62]] = 62;
-    decode_tab[(int)alphabet[63]] = 63;
-
-    for (i = 0; i < n; i += 4) {
-        uint8_t word[4];
-        word[0] = decode_tab[(int)*s++];
+    decode_tab[(uint8_t)alphabet[62]] = 62;
+    decode_tab[(uint8_t)alphabet[63]] = 63;
+
+    i = decode_bulk(variant, s, n, out, data->size, decode_tab, alphabet);
+    out += i / 4 * 3;
+    for (; i < n; i += 4) {
+        uint8_t     word[4];
+        char        tail[4];
+        char const* g = s + i;
+        if (n - i < 4) {
+            /* Don't read past the end, as if the string ended there */
+            memset(tail, '\0', sizeof tail);
+            memcpy(tail, g, n - i);
+            g = tail;
+        }
+        word[0] = decode_tab[(uint8_t)g[0]];
         if ((word[0] == 64) && !options->ignore_invalid_char) { return -12; }
-        word[1] = decode_tab[(int)*s++];
+        word[1] = decode_tab[(uint8_t)g[1]];
         if ((word[1] == 64) && !options->ignore_invalid_char) { return -13; }
         *out++  = (word[0] << 2) | (word[1] >> 4);
-        word[2] = decode_tab[(int)*s++];
-        word[3] = decode_tab[(int)*s++];
+        word[2] = decode_tab[(uint8_t)g[2]];
+        word[3] = decode_tab[(uint8_t)g[3]];
         if (word[2] < 64) {
             *out++ = (word[1] << 4) | (word[2] >> 2);
             if (word[3] < 64) { *out++ = (word[2] << 6) | word[3]; }
             else {
-                if ((s[-1] != options->separator) &&
+                if ((g[3] != options->separator) &&
                     !options->ignore_invalid_char) {
                     return -14;
                 }
             }
         }
         else {
-            if ((s[-2] != options->separator) &&
+            if ((g[2] != options->separator) &&
                 !options->ignore_invalid_char) {
                 return -15;
             }
@@ -194,6 +709,16 @@ int pbbase64_decode(
 }
 
 
+int pbbase64_decode(
+    char const*                    s,
+    size_t                         n,
+    pubnub_bymebl_t*               data,
+    struct pbbase64_options const* options)
+{
+    return decode(best_variant(), s, n, data, options);
+}
+
+
 int pbbase64_decode_str(
     char const*                    s,
     pubnub_bymebl_t*               data,
@@ -256,3 +781,38 @@ pubnub_bymebl_t pbbase64_decode_alloc_std_str(char const* s)
 {
     return pbbase64_decode_alloc_std(s, strlen(s));
 }
+
+
+bool pbbase64_has_variant(enum pbbase64_variant variant)
+{
+    if (pbbase64Scalar == variant) { return true; }
+#if PBBASE64_X86
+    return (variant != pbbase64NEON) && (variant <= best_variant());
+#else
+    return variant == best_variant();
+#endif
+}
+
+
+int pbbase64_encode_variant(
+    enum pbbase64_variant          variant,
+    pubnub_bymebl_t                data,
+    char*                          s,
+    size_t*                        n,
+    struct pbbase64_options const* options)
+{
+    PUBNUB_ASSERT_OPT(pbbase64_has_variant(variant));
+    return encode(variant, data, s, n, options);
+}
+
+
+int pbbase64_decode_variant(
+    enum pbbase64_variant          variant,
+    char const*                    s,
+    size_t                         n,
+    pubnub_bymebl_t*               data,
+    struct pbbase64_options const* options)
+{
+    PUBNUB_ASSERT_OPT(pbbase64_has_variant(variant));
+    return decode(variant, s, n, data, options);
+}
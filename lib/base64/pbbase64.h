@@ -28,6 +28,12 @@
 
     For output allocation - user may allocate or let the
     encoder/decoder do it for her.
+
+    Long data is encoded/decoded with vector instructions (SSSE3 or
+    AVX2 on x86, whichever the CPU has, NEON on ARM64), unless
+    PBBASE64_NO_SIMD is defined. Decoding with vector instructions is
+    done for the "+/" alphabets on x86 and for all on ARM64. Invalid
+    characters and padding are handled as without them.
  */
 
 #define COMMON_BASE64_ABC                                                      \
@@ -253,4 +259,38 @@ pubnub_bymebl_t pbbase64_decode_alloc_std(char const* s, size_t n);
 pubnub_bymebl_t pbbase64_decode_alloc_std_str(char const* s);
 
 
+/** Ways to encode/decode, for testing and benchmarking */
+enum pbbase64_variant {
+    /** Character at a time */
+    pbbase64Scalar,
+    /** 16 characters at a time, with SSSE3 */
+    pbbase64SSSE3,
+    /** 32 characters at a time, with AVX2 */
+    pbbase64AVX2,
+    /** 64 characters at a time, with NEON */
+    pbbase64NEON
+};
+
+/** Returns whether @p variant can be used on this CPU */
+bool pbbase64_has_variant(enum pbbase64_variant variant);
+
+/** Same as pbbase64_encode(), but encodes in the given @p variant
+    way, which has to be available.
+ */
+int pbbase64_encode_variant(enum pbbase64_variant          variant,
+                            pubnub_bymebl_t                data,
+                            char*                          s,
+                            size_t*                        n,
+                            struct pbbase64_options const* options);
+
+/** Same as pbbase64_decode(), but decodes in the given @p variant
+    way, which has to be available.
+ */
+int pbbase64_decode_variant(enum pbbase64_variant          variant,
+                            char const*                    s,
+                            size_t                         n,
+                            pubnub_bymebl_t*               data,
+                            struct pbbase64_options const* options);
+
+
 #endif /* !defined INC_PBBASE64 */
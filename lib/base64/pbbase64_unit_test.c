@@ -0,0 +1,162 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cgreen/include/cgreen/constraint_syntax_helpers.h"
+#include "cgreen/include/cgreen/constraint.h"
+#include "cgreen/include/cgreen/assertions.h"
+#include "cgreen/include/cgreen/filename.h"
+#include "cgreen/include/cgreen/cgreen.h"
+
+#include "lib/base64/pbbase64.h"
+
+
+// ----------------------------------
+//              Statics
+// ----------------------------------
+
+static uint8_t data[1024 + 8];
+static char    encoded[1400];
+static char    expected[1400];
+static uint8_t decoded[1100];
+
+static enum pbbase64_variant const m_variants[] = {
+    pbbase64SSSE3, pbbase64AVX2, pbbase64NEON
+};
+
+
+// ----------------------------------
+//            Tests setup
+// ----------------------------------
+
+Describe(pbbase64);
+
+BeforeEach(pbbase64)
+{
+    size_t i;
+
+    srand(11);
+    for (i = 0; i < sizeof data; ++i) {
+        data[i] = (uint8_t)rand();
+    }
+}
+
+AfterEach(pbbase64) {}
+
+
+/* Compares the encoding and decoding of the vector @p variant with
+   the scalar one, for data of @p length at @p offset with @p options.
+ */
+static void check_variant(enum pbbase64_variant          variant,
+                          size_t                         offset,
+                          size_t                         length,
+                          struct pbbase64_options const* options)
+{
+    pubnub_bymebl_t in = { data + offset, length };
+    pubnub_bymebl_t out;
+    size_t          n_expected = sizeof expected;
+    size_t          n          = sizeof encoded;
+
+    assert_that(pbbase64_encode_variant(
+                    pbbase64Scalar, in, expected, &n_expected, options),
+                is_equal_to(0));
+    assert_that(
+        pbbase64_encode_variant(variant, in, encoded, &n, options),
+        is_equal_to(0));
+    assert_that(n, is_equal_to(n_expected));
+    assert_that(encoded, is_equal_to_string(expected));
+
+    out.ptr  = decoded;
+    out.size = pbbase64_decoded_length(n);
+    assert_that(
+        pbbase64_decode_variant(variant, encoded, n, &out, options),
+        is_equal_to(0));
+    assert_that(out.size, is_equal_to(length));
+    assert_that(memcmp(decoded, data + offset, length), is_equal_to(0));
+}
+
+
+// ----------------------------------
+//              Tests
+// ----------------------------------
+
+Ensure(pbbase64, should_encode_and_decode_standard)
+{
+    pubnub_bymebl_t in = { (uint8_t*)"Make it so!", 11 };
+    pubnub_bymebl_t out;
+    size_t          n = sizeof encoded;
+
+    assert_that(pbbase64_encode_std(in, encoded, &n), is_equal_to(0));
+    assert_that(encoded, is_equal_to_string("TWFrZSBpdCBzbyE="));
+    assert_that(n, is_equal_to(16));
+
+    out.ptr  = decoded;
+    out.size = sizeof decoded;
+    assert_that(pbbase64_decode_std_str(encoded, &out), is_equal_to(0));
+    assert_that(out.size, is_equal_to(11));
+    assert_that(memcmp(decoded, "Make it so!", 11), is_equal_to(0));
+}
+
+Ensure(pbbase64, should_have_scalar_variant)
+{
+    assert_that(pbbase64_has_variant(pbbase64Scalar), is_true);
+}
+
+Ensure(pbbase64, variants_should_agree_for_all_lengths_and_alignments)
+{
+    struct pbbase64_options const std = PBBASE64_RFC3548_OPTIONS;
+    struct pbbase64_options const url = { PBBASE64_ENC_RFC4648,
+                                          PBBASE64_SEP_RFC4648,
+                                          0,
+                                          NULL,
+                                          false,
+                                          pbbase64_no_line_checksum };
+    size_t                        v;
+    size_t                        length;
+
+    for (v = 0; v < sizeof m_variants / sizeof m_variants[0]; ++v) {
+        if (!pbbase64_has_variant(m_variants[v])) { continue; }
+        for (length = 0; length <= 1024; length += (length < 200) ? 1 : 41) {
+            check_variant(m_variants[v], length % 8, length, &std);
+            check_variant(m_variants[v], length % 8, length, &url);
+        }
+    }
+}
+
+Ensure(pbbase64, variants_should_report_invalid_characters)
+{
+    struct pbbase64_options const std = PBBASE64_RFC3548_OPTIONS;
+    pubnub_bymebl_t               in  = { data, 300 };
+    size_t                        v;
+    size_t                        n = sizeof expected;
+
+    pbbase64_encode_std(in, expected, &n);
+    for (v = 0; v < sizeof m_variants / sizeof m_variants[0]; ++v) {
+        size_t pos;
+        if (!pbbase64_has_variant(m_variants[v])) { continue; }
+        for (pos = 0; pos < n; pos += 5) {
+            pubnub_bymebl_t out = { decoded, sizeof decoded };
+            int             expect;
+            memcpy(encoded, expected, n + 1);
+            encoded[pos] = '\x80';
+            expect       = pbbase64_decode_variant(
+                pbbase64Scalar, encoded, n, &out, &std);
+            assert_that(
+                pbbase64_decode_variant(m_variants[v], encoded, n, &out, &std),
+                is_equal_to(expect));
+        }
+    }
+}
+
+Ensure(pbbase64, should_not_decode_past_given_length)
+{
+    pubnub_bymebl_t out = { decoded, sizeof decoded };
+
+    /* As if the string ended after "TWFr" "ZQ" */
+    assert_that(pbbase64_decode_std("TWFrZQ==", 6, &out), is_equal_to(-15));
+    out.size = sizeof decoded;
+    assert_that(pbbase64_decode_std("TWFrZSBp", 4, &out), is_equal_to(0));
+    assert_that(out.size, is_equal_to(3));
+}
@@ -5,16 +5,41 @@
 #if !defined INC_PB_CRC32
 #define INC_PB_CRC32
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
 /* The standard CRC32 checksum(Cyclic Redundancy Checksum).
    Returns the checksum for (unpacked) @p data with given @p n_bytes length
    in octets.
+
+   Uses the CRC instructions of the CPU, if it has them (PCLMULQDQ on
+   x86, CRC32 on ARMv8), otherwise (or if PBCRC32_NO_HW is defined)
+   computes it 8 octets at a time (slicing-by-8).
  */ 
 uint32_t pbcrc32(const void *data, size_t n_bytes);
 
+/** Ways to compute the checksum, for testing and benchmarking */
+enum pbcrc32_variant {
+    /** Octet at a time, with one table */
+    pbcrc32Bytewise,
+    /** 8 octets at a time, with 8 tables */
+    pbcrc32Slice8,
+    /** With CPU instructions, if available */
+    pbcrc32Hardware
+};
+
+/** Returns whether @p variant can be used on this CPU */
+bool pbcrc32_has_variant(enum pbcrc32_variant variant);
+
+/** Same as pbcrc32(), but computed in the given @p variant way, which
+    has to be available.
+ */
+uint32_t pbcrc32_variant(
+    enum pbcrc32_variant variant,
+    const void*          data,
+    size_t               n_bytes);
+
 #endif /* INC_PB_CRC32 */
 
 #endif /* PUBNUB_USE_GZIP_COMPRESSION */
-
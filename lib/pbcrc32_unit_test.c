@@ -0,0 +1,81 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cgreen/include/cgreen/constraint_syntax_helpers.h"
+#include "cgreen/include/cgreen/constraint.h"
+#include "cgreen/include/cgreen/assertions.h"
+#include "cgreen/include/cgreen/filename.h"
+#include "cgreen/include/cgreen/cgreen.h"
+
+#include "lib/pbcrc32.h"
+
+
+// ----------------------------------
+//              Statics
+// ----------------------------------
+
+static unsigned char data[4096 + 16];
+
+
+// ----------------------------------
+//            Tests setup
+// ----------------------------------
+
+Describe(pbcrc32);
+
+BeforeEach(pbcrc32)
+{
+    size_t i;
+
+    srand(7);
+    for (i = 0; i < sizeof data; ++i) {
+        data[i] = (unsigned char)rand();
+    }
+}
+
+AfterEach(pbcrc32) {}
+
+
+// ----------------------------------
+//              Tests
+// ----------------------------------
+
+Ensure(pbcrc32, should_compute_standard_checksum)
+{
+    assert_that(pbcrc32("123456789", 9), is_equal_to(0xCBF43926));
+    assert_that(pbcrc32("a", 1), is_equal_to(0xE8B7BE43));
+    assert_that(
+        pbcrc32("The quick brown fox jumps over the lazy dog", 43),
+        is_equal_to(0x414FA339));
+}
+
+Ensure(pbcrc32, should_have_software_variants)
+{
+    assert_that(pbcrc32_has_variant(pbcrc32Bytewise), is_true);
+    assert_that(pbcrc32_has_variant(pbcrc32Slice8), is_true);
+}
+
+Ensure(pbcrc32, variants_should_agree_for_all_lengths_and_alignments)
+{
+    size_t length;
+    size_t offset;
+
+    for (length = 1; length <= 4096; length += (length < 300) ? 1 : 61) {
+        for (offset = 0; offset < 16; offset += 3) {
+            uint32_t const expect =
+                pbcrc32_variant(pbcrc32Bytewise, data + offset, length);
+            assert_that(
+                pbcrc32_variant(pbcrc32Slice8, data + offset, length),
+                is_equal_to(expect));
+            if (pbcrc32_has_variant(pbcrc32Hardware)) {
+                assert_that(
+                    pbcrc32_variant(pbcrc32Hardware, data + offset, length),
+                    is_equal_to(expect));
+            }
+            assert_that(pbcrc32(data + offset, length), is_equal_to(expect));
+        }
+    }
+}
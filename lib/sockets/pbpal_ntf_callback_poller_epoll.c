@@ -0,0 +1,272 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "lib/sockets/pbpal_ntf_callback_poller_epoll.h"
+
+#include "pubnub_get_native_socket.h"
+
+#include "core/pubnub_assert.h"
+#if PUBNUB_USE_LOGGER
+#include "core/pubnub_logger.h"
+#endif // PUBNUB_USE_LOGGER
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+/* Unlike poll() and select() based pollers, we don't keep any
+   (searchable) set of contexts here. The kernel keeps the set and
+   hands us back the context pointer we registered, while the socket
+   and events we registered with are kept in the context itself
+   (`pb->epoll`, which is registered iff its `events` are not 0). So,
+   all operations are O(1) and a poll costs only as much as there are
+   ready sockets.
+ */
+
+#if !defined(INVALID_SOCKET)
+#define INVALID_SOCKET -1
+#endif
+
+#if PUBNUB_EPOLL_EDGE_TRIGGERED
+#define PBPAL_EPOLL_TRIGGER EPOLLET
+#else
+#define PBPAL_EPOLL_TRIGGER 0
+#endif
+
+
+static int epoll_register(
+    struct pbpal_poll_data* data,
+    pubnub_t*               pb,
+    int                     sockt,
+    uint32_t                events)
+{
+    struct epoll_event ev;
+
+    ev.events   = events | PBPAL_EPOLL_TRIGGER;
+    ev.data.ptr = pb;
+    if (0 != epoll_ctl(data->epfd, EPOLL_CTL_ADD, sockt, &ev)) {
+        if (errno != EEXIST) {
+            PUBNUB_LOG_WARNING(
+                pb,
+                "epoll_ctl(ADD) failed for socket %d with error %d",
+                sockt,
+                errno);
+            return -1;
+        }
+        /* Same file description was already registered (socket
+           reused without us being told it was closed) */
+        if (0 != epoll_ctl(data->epfd, EPOLL_CTL_MOD, sockt, &ev)) {
+            return -1;
+        }
+    }
+    pb->epoll.socket = sockt;
+    pb->epoll.events = events;
+
+    return 0;
+}
+
+
+/* Only for a socket that is still open - for one that was closed,
+   the kernel already removed it from the epoll set and its number
+   might have been reused (by another context), so use
+   epoll_forget() instead.
+ */
+static void epoll_unregister(struct pbpal_poll_data* data, pubnub_t* pb)
+{
+    epoll_ctl(data->epfd, EPOLL_CTL_DEL, pb->epoll.socket, NULL);
+    pb->epoll.events = 0;
+    PUBNUB_ASSERT_OPT(data->size > 0);
+    --data->size;
+}
+
+
+static void epoll_forget(struct pbpal_poll_data* data, pubnub_t* pb)
+{
+    pb->epoll.events = 0;
+    PUBNUB_ASSERT_OPT(data->size > 0);
+    --data->size;
+}
+
+
+static int epoll_watch(
+    struct pbpal_poll_data* data,
+    pubnub_t*               pb,
+    uint32_t                events)
+{
+    struct epoll_event ev;
+
+    if (0 == pb->epoll.events) { return -1; }
+
+    /* Modifying the registration re-arms it, even if the events
+       didn't change, which is what makes edge-triggered mode usable
+       with our FSM: whenever it starts to wait, it gets a fresh
+       notification if the socket is already ready.
+     */
+    ev.events   = events | PBPAL_EPOLL_TRIGGER;
+    ev.data.ptr = pb;
+    if (0 != epoll_ctl(data->epfd, EPOLL_CTL_MOD, pb->epoll.socket, &ev)) {
+        return -1;
+    }
+    pb->epoll.events = events;
+
+    return 0;
+}
+
+
+struct pbpal_poll_data* pbpal_ntf_callback_poller_init(void)
+{
+    struct pbpal_poll_data* rslt;
+    struct epoll_event      ev;
+
+    rslt = (struct pbpal_poll_data*)malloc(sizeof *rslt);
+    if (NULL == rslt) { return NULL; }
+    rslt->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == rslt->epfd) {
+        free(rslt);
+        return NULL;
+    }
+    if (0 != pbpal_ntf_callback_wakeup_init(&rslt->wakeup)) {
+        close(rslt->epfd);
+        free(rslt);
+        return NULL;
+    }
+    /* Always level-triggered, it's drained when seen */
+    ev.events   = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (0 != epoll_ctl(rslt->epfd, EPOLL_CTL_ADD, rslt->wakeup.read_fd, &ev)) {
+        pbpal_ntf_callback_wakeup_deinit(&rslt->wakeup);
+        close(rslt->epfd);
+        free(rslt);
+        return NULL;
+    }
+    rslt->size = 0;
+
+    return rslt;
+}
+
+
+void pbpal_ntf_callback_save_socket(struct pbpal_poll_data* data, pubnub_t* pb)
+{
+    pbpal_native_socket_t sockt = pubnub_get_native_socket(pb);
+    if (INVALID_SOCKET == sockt) { return; }
+    if (pb->epoll.events != 0) {
+        /* Stale registration of a socket that was closed without
+           telling us (like the one used for DNS queries) */
+        epoll_forget(data, pb);
+    }
+    if (0 == epoll_register(data, pb, sockt, EPOLLOUT)) { ++data->size; }
+}
+
+
+void pbpal_ntf_callback_remove_socket(
+    struct pbpal_poll_data* data,
+    pubnub_t*               pb)
+{
+    if (0 == pb->epoll.events) {
+        PUBNUB_LOG_DEBUG(
+            pb,
+            "Unable to remove socket: %d not registered for polling.",
+            pubnub_get_native_socket(pb));
+        return;
+    }
+    epoll_unregister(data, pb);
+}
+
+
+void pbpal_ntf_callback_update_socket(
+    struct pbpal_poll_data* data,
+    pubnub_t*               pb)
+{
+    pbpal_native_socket_t sockt = pubnub_get_native_socket(pb);
+    if (sockt != INVALID_SOCKET) {
+        uint32_t events = EPOLLOUT;
+        if (pb->epoll.events != 0) {
+            /* The socket we have registered was closed (like the one
+               used for DNS queries) and the new one may well have
+               gotten the same number, so we always register anew.
+             */
+            events = pb->epoll.events;
+            epoll_forget(data, pb);
+        }
+        /* If the context wasn't registered before (no socket existed
+           at the time), this registers it now.
+         */
+        if (0 == epoll_register(data, pb, sockt, events)) {
+            ++data->size;
+            return;
+        }
+    }
+    PUBNUB_LOG_WARNING(
+        pb,
+        "Unable to update socket in poller: %d not registered for polling.",
+        sockt);
+}
+
+
+int pbpal_ntf_watch_out_events(struct pbpal_poll_data* data, pubnub_t* pbp)
+{
+    if (0 != epoll_watch(data, pbp, EPOLLOUT)) {
+        PUBNUB_LOG_WARNING(
+            pbp,
+            "Unable to watch for 'out' event: %d not registered for polling.",
+            pubnub_get_native_socket(pbp));
+        return -1;
+    }
+    return 0;
+}
+
+
+int pbpal_ntf_watch_in_events(struct pbpal_poll_data* data, pubnub_t* pbp)
+{
+    if (0 != epoll_watch(data, pbp, EPOLLIN)) {
+        PUBNUB_LOG_WARNING(
+            pbp,
+            "Unable to watch for 'in' event: %d not registered for polling.",
+            pubnub_get_native_socket(pbp));
+        return -1;
+    }
+    return 0;
+}
+
+
+int pbpal_ntf_poll_away(struct pbpal_poll_data* data, int ms)
+{
+    int rslt;
+    int i;
+
+    /* The wakeup is always registered, so even with no sockets, this
+       just waits (without using the CPU) for the timeout or wakeup.
+     */
+    rslt = epoll_wait(data->epfd, data->aevents, PBPAL_EPOLL_MAX_EVENTS, ms);
+    if (-1 == rslt) { return (EINTR == errno) ? 0 : -1; }
+    for (i = 0; i < rslt; ++i) {
+        pubnub_t* pb = (pubnub_t*)data->aevents[i].data.ptr;
+        if (NULL == pb) {
+            pbpal_ntf_callback_wakeup_drain(&data->wakeup);
+        }
+        else {
+            pbntf_requeue_for_processing(pb);
+        }
+    }
+
+    return rslt;
+}
+
+
+void pbpal_ntf_callback_poller_wakeup(struct pbpal_poll_data* data)
+{
+    pbpal_ntf_callback_wakeup_signal(&data->wakeup);
+}
+
+
+void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data)
+{
+    PUBNUB_ASSERT_OPT(data != NULL);
+    PUBNUB_ASSERT_OPT(*data != NULL);
+
+    close((*data)->epfd);
+    pbpal_ntf_callback_wakeup_deinit(&(*data)->wakeup);
+    free(*data);
+    *data = NULL;
+}
@@ -0,0 +1,36 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined(INC_PBPAL_NTF_CALLBACK_POLLER_EPOLL)
+#define      INC_PBPAL_NTF_CALLBACK_POLLER_EPOLL
+
+#include "core/pbpal_ntf_callback_poller.h"
+#include "lib/sockets/pbpal_ntf_callback_wakeup.h"
+
+#if !defined(__linux__)
+#error epoll based poller is available only on Linux
+#endif
+
+#include <sys/epoll.h>
+
+#include <stddef.h>
+
+
+/** Maximum number of ready sockets fetched from the kernel in one
+    epoll_wait() call. Sockets that are ready but didn't fit will be
+    reported on the next call, so this only affects the "batch size".
+ */
+#define PBPAL_EPOLL_MAX_EVENTS 64
+
+
+struct pbpal_poll_data {
+    /** The epoll instance file descriptor */
+    int epfd;
+    /** Number of contexts registered with the epoll instance */
+    size_t size;
+    /** Registered with the epoll instance with a NULL context */
+    struct pbpal_ntf_callback_wakeup wakeup;
+    /** Buffer for ready events, filled in by epoll_wait() */
+    struct epoll_event aevents[PBPAL_EPOLL_MAX_EVENTS];
+};
+
+
+#endif  /* !defined(INC_PBPAL_NTF_CALLBACK_POLLER_EPOLL) */
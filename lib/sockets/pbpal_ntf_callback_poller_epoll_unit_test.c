@@ -0,0 +1,426 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "pubnub_get_native_socket.h"
+#include "core/pbpal_ntf_callback_poller.h"
+#include "core/pubnub_assert.h"
+
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define attest assert_that
+#define equals is_equal_to
+#define differs is_not_equal_to
+
+/* Assert handler */
+static bool    m_expect_Assert;
+static jmp_buf m_Assert_exp_jmpbuf;
+
+void assert_handler(char const* s, const char* file, long i)
+{
+    printf("%s:%ld: Pubnub assert failed '%s'\n", file, i, s);
+    if (m_expect_Assert) {
+        m_expect_Assert = false;
+        longjmp(m_Assert_exp_jmpbuf, 1);
+    }
+}
+
+/* Track requeue calls */
+static pubnub_t* s_last_requeued;
+static int       s_requeue_count;
+
+int pbntf_requeue_for_processing(pubnub_t* pb)
+{
+    s_last_requeued = pb;
+    ++s_requeue_count;
+    return 0;
+}
+
+pbpal_native_socket_t pubnub_get_native_socket(pubnub_t* pb)
+{
+    if (NULL == pb) { return -1; }
+    return pb->pal.socket;
+}
+
+void pb_sleep_ms(unsigned long ms) { (void)ms; }
+
+
+Describe(pbpal_poller_epoll);
+
+BeforeEach(pbpal_poller_epoll) {
+    s_last_requeued = NULL;
+    s_requeue_count = 0;
+    m_expect_Assert = false;
+}
+
+AfterEach(pbpal_poller_epoll) {}
+
+
+Ensure(pbpal_poller_epoll, init_and_deinit)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    attest(data, differs(NULL));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+    attest(data == NULL);
+}
+
+
+Ensure(pbpal_poller_epoll, watch_fails_for_unregistered_context)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+
+    ctx.pal.socket = -1;
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(-1));
+    attest(pbpal_ntf_watch_out_events(data, &ctx), equals(-1));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, save_and_remove_socket)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(ctx.epoll.socket, equals(sv[0]));
+    attest(ctx.epoll.events, differs(0));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    attest(ctx.epoll.events, equals(0));
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(-1));
+
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, poll_away_detects_writable_socket)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    /* sv[0] should be immediately writable */
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, poll_away_detects_readable_socket)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    /* Write to sv[1] so sv[0] becomes readable */
+    attest(write(sv[1], "x", 1), equals(1));
+
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, multiple_sockets)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx1 = { 0 }, ctx2 = { 0 }, ctx3 = { 0 };
+    int sv1[2], sv2[2], sv3[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv3), equals(0));
+
+    ctx1.pal.socket = sv1[0];
+    ctx2.pal.socket = sv2[0];
+    ctx3.pal.socket = sv3[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx1);
+    pbpal_ntf_callback_save_socket(data, &ctx2);
+    pbpal_ntf_callback_save_socket(data, &ctx3);
+
+    /* Remove middle one */
+    pbpal_ntf_callback_remove_socket(data, &ctx2);
+
+    /* Poll — ctx1 and ctx3 should be writable */
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(2));
+    attest(s_requeue_count, equals(2));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx1);
+    pbpal_ntf_callback_remove_socket(data, &ctx3);
+    close(sv1[0]); close(sv1[1]);
+    close(sv2[0]); close(sv2[1]);
+    close(sv3[0]); close(sv3[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, update_socket_replaces_old_one)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv1[2], sv2[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+
+    ctx.pal.socket = sv1[0];
+    pbpal_ntf_callback_save_socket(data, &ctx);
+
+    /* Simulate socket change, like the PAL does it: the old one is
+       closed before the new one is made */
+    close(sv1[0]);
+    close(sv1[1]);
+    ctx.pal.socket = sv2[0];
+    pbpal_ntf_callback_update_socket(data, &ctx);
+    attest(ctx.epoll.socket, equals(sv2[0]));
+
+    /* Only the new socket should be reported */
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_requeue_count, equals(1));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv2[0]); close(sv2[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, update_socket_reopened_with_the_same_number)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv1[2], sv2[2];
+    int fd;
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    fd = sv1[0];
+    ctx.pal.socket = fd;
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+
+    /* Close it (like the DNS socket) and get a new one on the same
+       number, as the kernel is likely to give it */
+    close(sv1[0]);
+    close(sv1[1]);
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    if (sv2[0] != fd) {
+        attest(dup2(sv2[0], fd), equals(fd));
+        close(sv2[0]);
+        sv2[0] = fd;
+    }
+    pbpal_ntf_callback_update_socket(data, &ctx);
+    attest(ctx.epoll.socket, equals(fd));
+
+    /* The new socket must be watched, not the gone one */
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+    attest(write(sv2[1], "x", 1), equals(1));
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv2[0]);
+    close(sv2[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, update_socket_leaves_reused_number_to_its_owner)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx1 = { 0 }, ctx2 = { 0 };
+    int sv1[2], sv2[2], sv3[2];
+    int fd;
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    fd = sv1[0];
+    ctx1.pal.socket = fd;
+    pbpal_ntf_callback_save_socket(data, &ctx1);
+    close(sv1[0]);
+    close(sv1[1]);
+
+    /* Another context gets a socket on the number that was freed */
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    if (sv2[0] != fd) {
+        attest(dup2(sv2[0], fd), equals(fd));
+        close(sv2[0]);
+        sv2[0] = fd;
+    }
+    ctx2.pal.socket = fd;
+    pbpal_ntf_callback_save_socket(data, &ctx2);
+
+    /* The first context moves on to its new socket */
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv3), equals(0));
+    ctx1.pal.socket = sv3[0];
+    pbpal_ntf_callback_update_socket(data, &ctx1);
+
+    /* Both must be reported */
+    attest(pbpal_ntf_poll_away(data, 100), equals(2));
+    attest(s_requeue_count, equals(2));
+    attest(pbpal_ntf_watch_in_events(data, &ctx2), equals(0));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx1);
+    pbpal_ntf_callback_remove_socket(data, &ctx2);
+    close(sv2[0]); close(sv2[1]);
+    close(sv3[0]); close(sv3[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, update_socket_registers_unregistered_context)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_update_socket(data, &ctx);
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, save_after_socket_closed_behind_our_back)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv1[2], sv2[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    ctx.pal.socket = sv1[0];
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    close(sv1[0]);
+    close(sv1[1]);
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    ctx.pal.socket = sv2[0];
+    pbpal_ntf_callback_save_socket(data, &ctx);
+
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv2[0]);
+    close(sv2[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, works_with_high_fd_numbers)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+
+    int high_fd = dup2(sv[0], 1500);
+    attest(high_fd, equals(1500));
+    close(sv[0]);
+    ctx.pal.socket = high_fd;
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(high_fd);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, wakeup_ends_poll_away_without_sockets)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    time_t                  start;
+
+    /* Signalled before polling, so poll_away() should not wait */
+    pbpal_ntf_callback_poller_wakeup(data);
+    start = time(NULL);
+    pbpal_ntf_poll_away(data, 10000);
+    attest(time(NULL) - start < 2);
+    attest(s_requeue_count, equals(0));
+
+    /* The wakeup was consumed, so now it times out */
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_epoll, wakeup_does_not_hide_socket_events)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    pbpal_ntf_callback_poller_wakeup(data);
+    attest(pbpal_ntf_poll_away(data, 100) > 0);
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
@@ -31,6 +31,15 @@
 #define SOCKET_ERROR -1
 #endif
 
+/* WSAPoll() can't poll anything but sockets, so there's no wakeup on
+   Windows, we keep polling with (short) timeouts there.
+ */
+#if defined(_WIN32)
+#define PBPAL_POLL_WAKEUP_SLOTS 0
+#else
+#define PBPAL_POLL_WAKEUP_SLOTS 1
+#endif
+
 
 struct pbpal_poll_data* pbpal_ntf_callback_poller_init(void)
 {
@@ -41,6 +50,18 @@ struct pbpal_poll_data* pbpal_ntf_callback_poller_init(void)
     rslt->size = rslt->cap = 0;
     rslt->apoll            = NULL;
     rslt->apb              = NULL;
+#if !defined(_WIN32)
+    rslt->apoll = (struct pollfd*)malloc(sizeof rslt->apoll[0]);
+    if (NULL == rslt->apoll) {
+        free(rslt);
+        return NULL;
+    }
+    if (0 != pbpal_ntf_callback_wakeup_init(&rslt->wakeup)) {
+        free(rslt->apoll);
+        free(rslt);
+        return NULL;
+    }
+#endif
 
     return rslt;
 }
@@ -58,7 +79,8 @@ void pbpal_ntf_callback_save_socket(struct pbpal_poll_data* data, pubnub_t* pb)
     if (data->size == data->cap) {
         size_t const   newcap  = data->size + 2;
         struct pollfd* npalloc = (struct pollfd*)realloc(
-            data->apoll, sizeof data->apoll[0] * newcap);
+            data->apoll,
+            sizeof data->apoll[0] * (newcap + PBPAL_POLL_WAKEUP_SLOTS));
         pubnub_t** npapb = (pubnub_t**)realloc(
             data->apb, sizeof data->apb[0] * newcap);
         if (NULL == npalloc) {
@@ -182,27 +204,42 @@ int pbpal_ntf_poll_away(struct pbpal_poll_data* data, int ms)
 {
     int rslt;
 
+#if defined(_WIN32)
     if (0 == data->size) {
         pb_sleep_ms(1);
         return 0;
     }
+#else
+    /* The wakeup is polled after the sockets, so even with no
+       sockets, this just waits (without using the CPU) for the
+       timeout or wakeup.
+     */
+    data->apoll[data->size].fd      = data->wakeup.read_fd;
+    data->apoll[data->size].events  = POLLIN;
+    data->apoll[data->size].revents = 0;
+#endif
 
-    rslt = poll(data->apoll, data->size, ms);
+    rslt = poll(data->apoll, data->size + PBPAL_POLL_WAKEUP_SLOTS, ms);
     if (SOCKET_ERROR == rslt) {
-#if PUBNUB_USE_LOGGER
 #if defined(_WIN32)
-            int socket_error = WSAGetLastError();
+        int socket_error = WSAGetLastError();
 #else
-            int socket_error = errno;
+        int socket_error = errno;
+        if (EINTR == socket_error) { return 0; }
+#endif
+        PUBNUB_LOG_WARNING(
+            (data->size > 0) ? data->apb[0] : NULL,
+            "poll() failed with error %d (%u sockets polled)",
+            socket_error,
+            (unsigned)data->size);
+        (void)socket_error;
+        return -1;
+    }
+#if !defined(_WIN32)
+    if (data->apoll[data->size].revents != 0) {
+        pbpal_ntf_callback_wakeup_drain(&data->wakeup);
+    }
 #endif
-            PUBNUB_LOG_WARNING(
-                data->apb[0],
-                "poll() failed with error %d (%u sockets polled)",
-                socket_error,
-                (unsigned)data->size);
-#endif /* PUBNUB_USE_LOGGER */
-            return -1;
-        }
     if (rslt > 0) {
         size_t i;
         size_t apoll_size = data->size;
@@ -218,11 +255,26 @@ int pbpal_ntf_poll_away(struct pbpal_poll_data* data, int ms)
 }
 
 
+void pbpal_ntf_callback_poller_wakeup(struct pbpal_poll_data* data)
+{
+#if defined(_WIN32)
+    (void)data;
+#else
+    pbpal_ntf_callback_wakeup_signal(&data->wakeup);
+#endif
+}
+
+
 void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data)
 {
     PUBNUB_ASSERT_OPT(data != NULL);
     PUBNUB_ASSERT_OPT(*data != NULL);
 
+#if !defined(_WIN32)
+    pbpal_ntf_callback_wakeup_deinit(&(*data)->wakeup);
+#endif
+    free((*data)->apoll);
+    free((*data)->apb);
     free(*data);
     *data = NULL;
 }
@@ -15,14 +15,21 @@
 #include <poll.h>
 #define PBPAL_POLLFD struct pollfd
 
+#include "lib/sockets/pbpal_ntf_callback_wakeup.h"
+
 #endif
 
 
 struct pbpal_poll_data {
+    /** The sockets to poll. On POSIX, there is one more element
+        after the `size` sockets, for the wakeup. */
     PBPAL_POLLFD* apoll;
     size_t         size;
     size_t         cap;
     pubnub_t**     apb;
+#if !defined(_WIN32)
+    struct pbpal_ntf_callback_wakeup wakeup;
+#endif
 };
 
 
@@ -14,6 +14,7 @@
 #include <string.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -289,6 +290,47 @@ Ensure(pbpal_poller_poll, update_socket)
 }
 
 
+Ensure(pbpal_poller_poll, wakeup_ends_poll_away_without_sockets)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    time_t                  start;
+
+    /* Signalled before polling, so poll_away() should not wait */
+    pbpal_ntf_callback_poller_wakeup(data);
+    start = time(NULL);
+    pbpal_ntf_poll_away(data, 10000);
+    attest(time(NULL) - start < 2);
+    attest(s_requeue_count, equals(0));
+
+    /* The wakeup was consumed, so now it times out */
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_poll, wakeup_does_not_hide_socket_events)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    pbpal_ntf_callback_poller_wakeup(data);
+    attest(pbpal_ntf_poll_away(data, 100) > 0);
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
 Ensure(pbpal_poller_poll, high_fd_poll_connect_pattern)
 {
     /* This test directly mirrors the pattern used in pbpal_check_connect():
@@ -217,6 +217,15 @@ int pbpal_ntf_poll_away(struct pbpal_poll_data* data, int ms)
 }
 
 
+void pbpal_ntf_callback_poller_wakeup(struct pbpal_poll_data* data)
+{
+    /* No wakeup here, users of this poller have to poll with short
+       timeouts.
+     */
+    (void)data;
+}
+
+
 void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data)
 {
     PUBNUB_ASSERT_OPT(data != NULL);
@@ -0,0 +1,1132 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "lib/sockets/pbpal_ntf_callback_poller_uring.h"
+
+#include "pubnub_get_native_socket.h"
+
+#include "core/pubnub_assert.h"
+#if PUBNUB_USE_LOGGER
+#include "core/pubnub_logger.h"
+#endif // PUBNUB_USE_LOGGER
+
+#include <endian.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+/* Like the epoll poller, but instead of telling the kernel about every
+   change of what we watch for (one `epoll_ctl()` per change), we put
+   one-shot poll requests in the submission queue and submit all of
+   them, together with the wait for their completions, in one
+   `io_uring_enter()`. So, no matter how many contexts change what
+   they watch for, a poll costs one system call.
+
+   Since poll requests are one-shot, when one completes, we re-arm it
+   on the next poll, unless the context changed what it watches for in
+   the meantime. This is what makes it "level-triggered", like the
+   other pollers: a socket that is still ready is reported again.
+
+   Closing a socket doesn't end a poll request on it (io_uring holds a
+   reference to it), so we remove the request whenever the context is
+   removed, or its socket changes.
+
+   Data is sent and received with requests of their own, on the
+   poller's buffers of the context, which is requeued when they
+   complete (not on readiness, the poll request is not armed while
+   they are in flight). Receiving in a registered buffer is a
+   `READ_FIXED` linked after a poll request (the socket is
+   non-blocking, so, the read would fail with EAGAIN otherwise), other
+   requests are linked after one only if they did fail with EAGAIN.
+
+   Data to send may be put in the buffer while a send is in flight. If
+   that one is not submitted yet, it's made longer, otherwise the data
+   is sent when it completes. So, the pieces of a request that the
+   FSM sends one by one mostly go out together.
+
+   A context may be removed while its I/O requests are in flight. We
+   cancel them, but the kernel still owns the buffers until they
+   complete, so the slot is not reused until then.
+ */
+
+#if !defined(INVALID_SOCKET)
+#define INVALID_SOCKET -1
+#endif
+
+/** Request tag of the poll request for the wakeup */
+#define TAG_WAKEUP UINT64_MAX
+/** Request tag of requests whose completion we don't care about */
+#define TAG_IGNORE (UINT64_MAX - 1)
+
+/** Kinds of requests, in the top 4 bits of the request tag */
+enum request_kind {
+    /** Poll for readiness, also tagged with its sequence number */
+    KIND_POLL,
+    KIND_RECV,
+    KIND_SEND,
+    /** Poll linked ahead of a receive */
+    KIND_RECV_POLL,
+    /** Poll linked ahead of a send */
+    KIND_SEND_POLL
+};
+
+#define SEQ_MASK 0x0FFFFFFF
+
+#define TAG(seq, slot) ((((uint64_t)(seq) & SEQ_MASK) << 32) | (slot))
+#define IO_TAG(kind, slot) (((uint64_t)(kind) << 60) | (slot))
+#define TAG_KIND(tag) ((unsigned)((tag) >> 60))
+#define TAG_SLOT(tag) ((uint32_t)((tag) & 0xFFFFFFFF))
+#define TAG_SEQ(tag) ((uint32_t)((tag) >> 32) & SEQ_MASK)
+
+#define NO_SLOT UINT32_MAX
+
+
+static int uring_setup(unsigned entries, struct io_uring_params* p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+
+static int uring_enter(struct pbpal_poll_data* data,
+                       unsigned                to_submit,
+                       unsigned                min_complete,
+                       int                     ms)
+{
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec      ts;
+    unsigned                      flags = 0;
+    int                           rslt;
+
+    memset(&arg, 0, sizeof arg);
+    if (min_complete > 0) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        if (ms >= 0) {
+            ts.tv_sec  = ms / 1000;
+            ts.tv_nsec = (ms % 1000) * 1000000L;
+            arg.ts     = (uint64_t)(uintptr_t)&ts;
+        }
+    }
+    rslt = (int)syscall(__NR_io_uring_enter,
+                        data->ring_fd,
+                        to_submit,
+                        min_complete,
+                        flags,
+                        (flags & IORING_ENTER_EXT_ARG) ? &arg : NULL,
+                        (flags & IORING_ENTER_EXT_ARG) ? sizeof arg
+                                                       : (size_t)_NSIG / 8);
+    if (rslt > 0) { data->sq_submitted += (unsigned)rslt; }
+
+    return rslt;
+}
+
+
+static unsigned sq_pending(struct pbpal_poll_data const* data)
+{
+    return *data->sq_tail - data->sq_submitted;
+}
+
+
+/** Makes sure there are @p n free submission queue entries. If not,
+    submits what's in the queue, to make room.
+ */
+static bool reserve_sqes(struct pbpal_poll_data* data, unsigned n)
+{
+    unsigned const tail = *data->sq_tail;
+
+    if (tail + n - __atomic_load_n(data->sq_head, __ATOMIC_ACQUIRE)
+        > data->sq_entries) {
+        if (uring_enter(data, sq_pending(data), 0, 0) < 0) { return false; }
+        if (tail + n - __atomic_load_n(data->sq_head, __ATOMIC_ACQUIRE)
+            > data->sq_entries) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/** Returns the next submission queue entry, cleared. There has to be
+    room for it (see reserve_sqes()).
+ */
+static struct io_uring_sqe* next_sqe(struct pbpal_poll_data* data)
+{
+    unsigned const       tail = *data->sq_tail;
+    struct io_uring_sqe* sqe  = &data->sqes[tail & data->sq_mask];
+
+    memset(sqe, 0, sizeof *sqe);
+    __atomic_store_n(data->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    return sqe;
+}
+
+
+/** Returns the next free submission queue entry, cleared. If the
+    queue is full, submits what's in it, to make room.
+ */
+static struct io_uring_sqe* get_sqe(struct pbpal_poll_data* data)
+{
+    return reserve_sqes(data, 1) ? next_sqe(data) : NULL;
+}
+
+
+/** Whether the submission queue entry at @p at is not submitted yet */
+static bool unsubmitted(struct pbpal_poll_data const* data, unsigned at)
+{
+    return (int)(at - data->sq_submitted) >= 0;
+}
+
+
+/** Turns the (unsubmitted) submission queue entry at @p at into one
+    that does nothing
+ */
+static void make_nop(struct pbpal_poll_data* data, unsigned at)
+{
+    struct io_uring_sqe* sqe = &data->sqes[at & data->sq_mask];
+
+    sqe->opcode    = IORING_OP_NOP;
+    sqe->flags     = 0;
+    sqe->user_data = TAG_IGNORE;
+}
+
+
+static void prep_poll_add(struct io_uring_sqe* sqe,
+                          int                  fd,
+                          uint32_t             events,
+                          uint64_t             tag)
+{
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd     = fd;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    events = (events << 16) | (events >> 16);
+#endif
+    sqe->poll32_events = events;
+    sqe->user_data     = tag;
+}
+
+
+/** Puts the @p slot in the "re-arm" list, to be handled on the next
+    poll, if it's not there already
+ */
+static void to_rearm(struct pbpal_poll_data* data, uint32_t slot)
+{
+    struct pbpal_uring_slot* s = &data->slots[slot];
+
+    if (!s->rearm) {
+        s->rearm                         = true;
+        data->rearm[data->rearm_count++] = slot;
+    }
+}
+
+
+static bool io_in_flight(struct pbpal_uring_slot const* s)
+{
+    return (PBPAL_URING_IO_IN_FLIGHT == s->recv.state)
+           || (PBPAL_URING_IO_IN_FLIGHT == s->send.state);
+}
+
+
+/** Submits a poll request for the current events of context in
+    @p slot. If there's no room, puts it in the "re-arm" list, to
+    try again on the next poll. While the context's I/O requests are
+    in flight, their completion is what we wait for, so then nothing
+    is submitted.
+ */
+static void arm(struct pbpal_poll_data* data, uint32_t slot)
+{
+    struct pbpal_uring_slot* s  = &data->slots[slot];
+    pubnub_t*                pb = s->pb;
+    unsigned const           at = *data->sq_tail;
+    struct io_uring_sqe*     sqe;
+
+    PUBNUB_ASSERT_OPT(pb != NULL);
+    PUBNUB_ASSERT_OPT(0 == s->armed);
+
+    if (io_in_flight(s)) { return; }
+    sqe = get_sqe(data);
+    if (NULL == sqe) {
+        to_rearm(data, slot);
+        return;
+    }
+    s->seq = (s->seq + 1) & SEQ_MASK;
+    prep_poll_add(sqe, pb->uring.socket, pb->uring.events, TAG(s->seq, slot));
+    s->armed    = pb->uring.events;
+    s->armed_at = at;
+}
+
+
+/** Ends the poll request in flight for @p slot, if any. If it wasn't
+    submitted yet, it is "overwritten" to poll for nothing (which is
+    cheaper than removing it afterwards).
+ */
+static void disarm(struct pbpal_poll_data* data, uint32_t slot)
+{
+    struct pbpal_uring_slot* s = &data->slots[slot];
+    struct io_uring_sqe*     sqe;
+
+    if (0 == s->armed) { return; }
+    s->armed = 0;
+    if (unsubmitted(data, s->armed_at)) {
+        make_nop(data, s->armed_at);
+        return;
+    }
+    sqe = get_sqe(data);
+    if (NULL == sqe) {
+        /* The old sequence number will make us ignore it, we just
+           can't get rid of it right now. */
+        return;
+    }
+    sqe->opcode    = IORING_OP_POLL_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = TAG(s->seq, slot);
+    sqe->user_data = TAG_IGNORE;
+}
+
+
+/** Gets the I/O buffers of the @p slot, if it doesn't have them
+    already. Slots that have a place in the registered buffers use
+    it, others allocate their own.
+ */
+static int io_buf_get(struct pbpal_poll_data* data, uint32_t slot)
+{
+    struct pbpal_uring_slot* s = &data->slots[slot];
+
+    if (s->io_buf != NULL) { return 0; }
+    if ((data->fixed_bufs != NULL) && (slot < PBPAL_URING_FIXED_BUFFERS)) {
+        s->io_buf = data->fixed_bufs + slot * 2 * PBPAL_URING_IO_BUFFER_SIZE;
+        s->fixed  = data->fixed_registered ? 0 : -1;
+        return 0;
+    }
+    s->io_buf = (uint8_t*)malloc(2 * PBPAL_URING_IO_BUFFER_SIZE);
+    s->fixed  = -1;
+
+    return (NULL == s->io_buf) ? -1 : 0;
+}
+
+
+/** Submits the receive (or, if @p send, the send) of the context in
+    @p slot, as prepared in its I/O data. If there's no room in the
+    submission queue, puts it in the "re-arm" list, to be submitted
+    on the next poll.
+ */
+static void submit_io(struct pbpal_poll_data* data, uint32_t slot, bool send)
+{
+    struct pbpal_uring_slot* s  = &data->slots[slot];
+    struct pbpal_uring_io*   io = send ? &s->send : &s->recv;
+    bool const               fixed_read = !send && (s->fixed >= 0);
+    bool const               linked     = fixed_read || io->linked;
+    int                      sockt;
+    struct io_uring_sqe*     sqe;
+
+    PUBNUB_ASSERT_OPT(s->pb != NULL);
+    PUBNUB_ASSERT_OPT(io->len > io->pos);
+    sockt = s->pb->uring.socket;
+
+    disarm(data, slot);
+    if (!reserve_sqes(data, linked ? 2 : 1)) {
+        io->state = PBPAL_URING_IO_QUEUED;
+        to_rearm(data, slot);
+        return;
+    }
+    io->at = *data->sq_tail;
+    if (linked) {
+        sqe = next_sqe(data);
+        prep_poll_add(sqe,
+                      sockt,
+                      send ? POLLOUT : POLLIN,
+                      IO_TAG(send ? KIND_SEND_POLL : KIND_RECV_POLL, slot));
+        sqe->flags |= IOSQE_IO_LINK;
+    }
+    sqe     = next_sqe(data);
+    sqe->fd = sockt;
+    if (send) {
+        sqe->opcode    = IORING_OP_SEND;
+        sqe->addr      = (uintptr_t)(s->io_buf + PBPAL_URING_IO_BUFFER_SIZE
+                                + io->pos);
+        sqe->len       = io->len - io->pos;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = IO_TAG(KIND_SEND, slot);
+    }
+    else {
+        sqe->opcode = fixed_read ? IORING_OP_READ_FIXED : IORING_OP_RECV;
+        sqe->addr   = (uintptr_t)s->io_buf;
+        sqe->len    = io->len;
+        if (fixed_read) {
+            /* Sockets have no file position, use the "current" one */
+            sqe->off       = (uint64_t)-1;
+            sqe->buf_index = (uint16_t)s->fixed;
+        }
+        sqe->user_data = IO_TAG(KIND_RECV, slot);
+    }
+    io->linked = linked;
+    io->state  = PBPAL_URING_IO_IN_FLIGHT;
+    ++data->io_in_flight;
+}
+
+
+/** Submits a cancel of the request tagged @p tag */
+static void submit_cancel(struct pbpal_poll_data* data, uint64_t tag)
+{
+    struct io_uring_sqe* sqe = get_sqe(data);
+
+    if (NULL == sqe) {
+        /* It will complete some time, we just have to wait longer
+           to reuse the slot */
+        return;
+    }
+    sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    sqe->fd        = -1;
+    sqe->addr      = tag;
+    sqe->user_data = TAG_IGNORE;
+}
+
+
+/** Ends the receive (or, if @p send, the send) of the context in
+    @p slot. If it's in flight, it's cancelled, and we'll know it
+    ended when it completes.
+ */
+static void cancel_io(struct pbpal_poll_data* data, uint32_t slot, bool send)
+{
+    struct pbpal_uring_io* io = send ? &data->slots[slot].send
+                                     : &data->slots[slot].recv;
+
+    switch (io->state) {
+    case PBPAL_URING_IO_IN_FLIGHT:
+        if (unsubmitted(data, io->at)) {
+            make_nop(data, io->at);
+            if (io->linked) { make_nop(data, io->at + 1); }
+            PUBNUB_ASSERT_OPT(data->io_in_flight > 0);
+            --data->io_in_flight;
+            break;
+        }
+        /* The linked poll may be done and the request itself may be
+           waiting, so, cancel both */
+        if (io->linked) {
+            submit_cancel(
+                data, IO_TAG(send ? KIND_SEND_POLL : KIND_RECV_POLL, slot));
+        }
+        submit_cancel(data, IO_TAG(send ? KIND_SEND : KIND_RECV, slot));
+        return;
+    default:
+        break;
+    }
+    memset(io, 0, sizeof *io);
+}
+
+
+static int grow_slots(struct pbpal_poll_data* data)
+{
+    uint32_t const           cap = data->slots_cap ? 2 * data->slots_cap : 64;
+    struct pbpal_uring_slot* slots;
+    uint32_t*                rearm;
+    uint32_t                 i;
+
+    slots = (struct pbpal_uring_slot*)realloc(data->slots, cap * sizeof *slots);
+    if (NULL == slots) { return -1; }
+    data->slots = slots;
+    rearm       = (uint32_t*)realloc(data->rearm, cap * sizeof *rearm);
+    if (NULL == rearm) { return -1; }
+    data->rearm = rearm;
+
+    memset(slots + data->slots_cap, 0, (cap - data->slots_cap) * sizeof *slots);
+    for (i = data->slots_cap; i < cap; ++i) {
+        slots[i].next_free = (i + 1 < cap) ? i + 1 : data->free_slot;
+        slots[i].fixed     = -1;
+    }
+    data->free_slot = data->slots_cap;
+    data->slots_cap = cap;
+
+    return 0;
+}
+
+
+static void free_slot(struct pbpal_poll_data* data, uint32_t slot)
+{
+    data->slots[slot].draining  = false;
+    data->slots[slot].next_free = data->free_slot;
+    data->free_slot             = slot;
+}
+
+
+static int uring_register(struct pbpal_poll_data* data,
+                          pubnub_t*               pb,
+                          int                     sockt,
+                          uint32_t                events)
+{
+    uint32_t                 slot;
+    struct pbpal_uring_slot* s;
+
+    if ((NO_SLOT == data->free_slot) && (0 != grow_slots(data))) {
+        PUBNUB_LOG_WARNING(
+            pb, "Out of memory registering socket %d for polling", sockt);
+        return -1;
+    }
+    slot            = data->free_slot;
+    s               = &data->slots[slot];
+    data->free_slot = s->next_free;
+    s->pb           = pb;
+    s->armed        = 0;
+    memset(&s->recv, 0, sizeof s->recv);
+    memset(&s->send, 0, sizeof s->send);
+    pb->uring.socket = sockt;
+    pb->uring.events = events;
+    pb->uring.slot   = slot;
+    arm(data, slot);
+    ++data->size;
+
+    return 0;
+}
+
+
+static void uring_unregister(struct pbpal_poll_data* data, pubnub_t* pb)
+{
+    uint32_t const           slot = pb->uring.slot;
+    struct pbpal_uring_slot* s    = &data->slots[slot];
+
+    disarm(data, slot);
+    cancel_io(data, slot, false);
+    cancel_io(data, slot, true);
+    s->pb = NULL;
+    if (io_in_flight(s)) { s->draining = true; }
+    else {
+        free_slot(data, slot);
+    }
+    pb->uring.events = 0;
+    PUBNUB_ASSERT_OPT(data->size > 0);
+    --data->size;
+}
+
+
+static int uring_watch(struct pbpal_poll_data* data,
+                       pubnub_t*               pb,
+                       uint32_t                events)
+{
+    struct pbpal_uring_slot* s;
+
+    if (0 == pb->uring.events) { return -1; }
+    pb->uring.events = events;
+    s                = &data->slots[pb->uring.slot];
+    if (s->armed != events) {
+        disarm(data, pb->uring.slot);
+        arm(data, pb->uring.slot);
+    }
+
+    return 0;
+}
+
+
+static void unmap_rings(struct pbpal_poll_data* data)
+{
+    if (data->sqes != NULL) { munmap(data->sqes, data->sqes_size); }
+    if ((data->cq_ring != NULL) && (data->cq_ring != data->sq_ring)) {
+        munmap(data->cq_ring, data->cq_ring_size);
+    }
+    if (data->sq_ring != NULL) { munmap(data->sq_ring, data->sq_ring_size); }
+}
+
+
+static int map_rings(struct pbpal_poll_data* data, struct io_uring_params* p)
+{
+    unsigned* sq_array;
+    unsigned  i;
+
+    data->sq_ring_size = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+    data->cq_ring_size = p->cq_off.cqes
+                         + p->cq_entries * sizeof(struct io_uring_cqe);
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        if (data->cq_ring_size > data->sq_ring_size) {
+            data->sq_ring_size = data->cq_ring_size;
+        }
+    }
+    data->sq_ring = mmap(NULL,
+                         data->sq_ring_size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         data->ring_fd,
+                         IORING_OFF_SQ_RING);
+    if (MAP_FAILED == data->sq_ring) {
+        data->sq_ring = NULL;
+        return -1;
+    }
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        data->cq_ring = data->sq_ring;
+    }
+    else {
+        data->cq_ring = mmap(NULL,
+                             data->cq_ring_size,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             data->ring_fd,
+                             IORING_OFF_CQ_RING);
+        if (MAP_FAILED == data->cq_ring) {
+            data->cq_ring = NULL;
+            return -1;
+        }
+    }
+    data->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+    data->sqes      = (struct io_uring_sqe*)mmap(NULL,
+                                            data->sqes_size,
+                                            PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE,
+                                            data->ring_fd,
+                                            IORING_OFF_SQES);
+    if (MAP_FAILED == data->sqes) {
+        data->sqes = NULL;
+        return -1;
+    }
+
+    data->sq_head    = (unsigned*)((char*)data->sq_ring + p->sq_off.head);
+    data->sq_tail    = (unsigned*)((char*)data->sq_ring + p->sq_off.tail);
+    data->sq_mask    = *(unsigned*)((char*)data->sq_ring + p->sq_off.ring_mask);
+    data->sq_entries = p->sq_entries;
+    data->cq_head    = (unsigned*)((char*)data->cq_ring + p->cq_off.head);
+    data->cq_tail    = (unsigned*)((char*)data->cq_ring + p->cq_off.tail);
+    data->cq_mask    = *(unsigned*)((char*)data->cq_ring + p->cq_off.ring_mask);
+    data->cqes = (struct io_uring_cqe*)((char*)data->cq_ring + p->cq_off.cqes);
+
+    /* We always use the submission queue entries in order */
+    sq_array = (unsigned*)((char*)data->sq_ring + p->sq_off.array);
+    for (i = 0; i < p->sq_entries; ++i) {
+        sq_array[i] = i;
+    }
+    data->sq_submitted = *data->sq_tail;
+
+    return 0;
+}
+
+
+#define FIXED_BUFS_SIZE (PBPAL_URING_FIXED_BUFFERS * 2 * PBPAL_URING_IO_BUFFER_SIZE)
+
+/** Allocates the I/O buffers of the first slots and registers them
+    with the kernel, as one buffer. Neither is a must, I/O works
+    without them, just not as well.
+ */
+static void fixed_bufs_init(struct pbpal_poll_data* data)
+{
+    struct iovec iov;
+    void*        bufs = mmap(NULL,
+                      FIXED_BUFS_SIZE,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1,
+                      0);
+
+    if (MAP_FAILED == bufs) { return; }
+    data->fixed_bufs = (uint8_t*)bufs;
+    iov.iov_base     = bufs;
+    iov.iov_len      = FIXED_BUFS_SIZE;
+    data->fixed_registered = (0
+                              == syscall(__NR_io_uring_register,
+                                         data->ring_fd,
+                                         IORING_REGISTER_BUFFERS,
+                                         &iov,
+                                         1));
+}
+
+
+struct pbpal_poll_data* pbpal_ntf_callback_poller_init(void)
+{
+    struct pbpal_poll_data* rslt;
+    struct io_uring_params  p;
+
+    rslt = (struct pbpal_poll_data*)calloc(1, sizeof *rslt);
+    if (NULL == rslt) { return NULL; }
+    memset(&p, 0, sizeof p);
+    p.flags      = IORING_SETUP_CQSIZE;
+    p.cq_entries = PBPAL_URING_CQ_ENTRIES;
+    rslt->ring_fd = uring_setup(PBPAL_URING_SQ_ENTRIES, &p);
+    if (-1 == rslt->ring_fd) {
+        free(rslt);
+        return NULL;
+    }
+    /* We need timeouts on the wait for completions (Linux 5.11) */
+    if (!(p.features & IORING_FEAT_EXT_ARG) || (0 != map_rings(rslt, &p))) {
+        unmap_rings(rslt);
+        close(rslt->ring_fd);
+        free(rslt);
+        return NULL;
+    }
+    if (0 != pbpal_ntf_callback_wakeup_init(&rslt->wakeup)) {
+        unmap_rings(rslt);
+        close(rslt->ring_fd);
+        free(rslt);
+        return NULL;
+    }
+    fixed_bufs_init(rslt);
+    rslt->free_slot = NO_SLOT;
+
+    return rslt;
+}
+
+
+void pbpal_ntf_callback_save_socket(struct pbpal_poll_data* data, pubnub_t* pb)
+{
+    pbpal_native_socket_t sockt = pubnub_get_native_socket(pb);
+    if (INVALID_SOCKET == sockt) { return; }
+    if (pb->uring.events != 0) {
+        /* Stale registration of a socket that was closed without
+           telling us (like the one used for DNS queries) */
+        uring_unregister(data, pb);
+    }
+    uring_register(data, pb, sockt, POLLOUT);
+}
+
+
+void pbpal_ntf_callback_remove_socket(
+    struct pbpal_poll_data* data,
+    pubnub_t*               pb)
+{
+    if (0 == pb->uring.events) {
+        PUBNUB_LOG_DEBUG(
+            pb,
+            "Unable to remove socket: %d not registered for polling.",
+            pubnub_get_native_socket(pb));
+        return;
+    }
+    uring_unregister(data, pb);
+}
+
+
+void pbpal_ntf_callback_update_socket(
+    struct pbpal_poll_data* data,
+    pubnub_t*               pb)
+{
+    pbpal_native_socket_t sockt = pubnub_get_native_socket(pb);
+    if (sockt != INVALID_SOCKET) {
+        uint32_t events = POLLOUT;
+        if (pb->uring.events != 0) {
+            /* Even if it's the same number, the old socket may have
+               been closed and this is a new one, which the requests
+               in flight don't know about (they hold the old one) */
+            events = pb->uring.events;
+            uring_unregister(data, pb);
+        }
+        if (0 == uring_register(data, pb, sockt, events)) { return; }
+    }
+    PUBNUB_LOG_WARNING(
+        pb,
+        "Unable to update socket in poller: %d not registered for polling.",
+        sockt);
+}
+
+
+int pbpal_ntf_watch_out_events(struct pbpal_poll_data* data, pubnub_t* pbp)
+{
+    if (0 != uring_watch(data, pbp, POLLOUT)) {
+        PUBNUB_LOG_WARNING(
+            pbp,
+            "Unable to watch for 'out' event: %d not registered for polling.",
+            pubnub_get_native_socket(pbp));
+        return -1;
+    }
+    return 0;
+}
+
+
+int pbpal_ntf_watch_in_events(struct pbpal_poll_data* data, pubnub_t* pbp)
+{
+    if (0 != uring_watch(data, pbp, POLLIN)) {
+        PUBNUB_LOG_WARNING(
+            pbp,
+            "Unable to watch for 'in' event: %d not registered for polling.",
+            pubnub_get_native_socket(pbp));
+        return -1;
+    }
+    return 0;
+}
+
+
+/** Returns the slot of @p pb, with its I/O buffers, if it can do
+    completion based I/O: it's registered, with the socket it uses
+    now, and doesn't want to wait for I/O to complete (with blocking
+    I/O, the PAL waits in `send()`/`recv()` itself).
+ */
+static struct pbpal_uring_slot* io_slot(struct pbpal_poll_data* data,
+                                        pubnub_t*               pb)
+{
+    if ((0 == pb->uring.events)
+        || (pubnub_get_native_socket(pb) != pb->uring.socket)
+#if PUBNUB_BLOCKING_IO_SETTABLE
+        || pb->options.use_blocking_io
+#endif
+        || (0 != io_buf_get(data, pb->uring.slot))) {
+        return NULL;
+    }
+    return &data->slots[pb->uring.slot];
+}
+
+
+int pbpal_ntf_uring_send_buffer(struct pbpal_poll_data* data,
+                                pubnub_t*               pb,
+                                uint8_t**               buf)
+{
+    struct pbpal_uring_slot* s = io_slot(data, pb);
+
+    if (NULL == s) { return PBNTF_URING_NO_IO; }
+    if (s->send.res < 0) {
+        errno       = -s->send.res;
+        s->send.res = 0;
+        return -1;
+    }
+    if (PBPAL_URING_IO_BUFFER_SIZE == s->send.end) {
+        s->send.waiting = true;
+        errno           = EAGAIN;
+        return -1;
+    }
+    *buf = s->io_buf + PBPAL_URING_IO_BUFFER_SIZE + s->send.end;
+
+    return PBPAL_URING_IO_BUFFER_SIZE - s->send.end;
+}
+
+
+void pbpal_ntf_uring_send(struct pbpal_poll_data* data,
+                          pubnub_t*               pb,
+                          size_t                  n)
+{
+    struct pbpal_uring_io* io = &data->slots[pb->uring.slot].send;
+
+    PUBNUB_ASSERT_OPT(pb->uring.events != 0);
+    PUBNUB_ASSERT_OPT(io->end + n <= PBPAL_URING_IO_BUFFER_SIZE);
+
+    if (0 == n) { return; }
+    io->end += (uint32_t)n;
+    switch (io->state) {
+    case PBPAL_URING_IO_IDLE:
+        io->pos = 0;
+        io->len = io->end;
+        submit_io(data, pb->uring.slot, true);
+        break;
+    case PBPAL_URING_IO_QUEUED:
+        io->len = io->end;
+        break;
+    case PBPAL_URING_IO_IN_FLIGHT:
+        if (unsubmitted(data, io->at)) {
+            /* Not too late to send it with the request in flight */
+            unsigned const at = io->at + (io->linked ? 1 : 0);
+            data->sqes[at & data->sq_mask].len += (uint32_t)n;
+            io->len = io->end;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+
+int pbpal_ntf_uring_recv_buffer(struct pbpal_poll_data* data,
+                                pubnub_t*               pb,
+                                uint8_t const**         buf,
+                                size_t                  max)
+{
+    struct pbpal_uring_slot* s = io_slot(data, pb);
+    struct pbpal_uring_io*   io;
+
+    if (NULL == s) { return PBNTF_URING_NO_IO; }
+    io = &s->recv;
+    switch (io->state) {
+    case PBPAL_URING_IO_DONE:
+        if (io->res >= 0) {
+            /* End of the connection stays, like it does for recv() */
+            *buf = s->io_buf + io->pos;
+            return io->res - (int)io->pos;
+        }
+        errno = -io->res;
+        memset(io, 0, sizeof *io);
+        return -1;
+    case PBPAL_URING_IO_IDLE:
+        if (s->send.res < 0) {
+            /* The receive would fail for the same reason, or, worse,
+               wait for a response to a request that wasn't sent */
+            errno       = -s->send.res;
+            s->send.res = 0;
+            return -1;
+        }
+        PUBNUB_ASSERT_OPT(max > 0);
+        io->len = (max < PBPAL_URING_IO_BUFFER_SIZE)
+                      ? (uint32_t)max
+                      : PBPAL_URING_IO_BUFFER_SIZE;
+        submit_io(data, pb->uring.slot, false);
+        break;
+    default:
+        break;
+    }
+    errno = EAGAIN;
+
+    return -1;
+}
+
+
+void pbpal_ntf_uring_recv_consume(struct pbpal_poll_data* data,
+                                  pubnub_t*               pb,
+                                  size_t                  n)
+{
+    struct pbpal_uring_io* io = &data->slots[pb->uring.slot].recv;
+
+    PUBNUB_ASSERT_OPT(PBPAL_URING_IO_DONE == io->state);
+    PUBNUB_ASSERT_OPT(io->pos + n <= (uint32_t)io->res);
+
+    io->pos += (uint32_t)n;
+    if (io->pos == (uint32_t)io->res) { memset(io, 0, sizeof *io); }
+}
+
+
+/** Re-arms the poll requests that completed on the last poll (and the
+    ones we didn't have room for), for contexts that are still
+    registered and didn't change what they watch for. Submits the I/O
+    requests we didn't have room for.
+ */
+static void rearm_completed(struct pbpal_poll_data* data)
+{
+    uint32_t i;
+    uint32_t count = data->rearm_count;
+
+    data->rearm_count = 0;
+    for (i = 0; i < count; ++i) {
+        uint32_t const           slot = data->rearm[i];
+        struct pbpal_uring_slot* s    = &data->slots[slot];
+
+        s->rearm = false;
+        if (NULL == s->pb) { continue; }
+        if (PBPAL_URING_IO_QUEUED == s->recv.state) {
+            submit_io(data, slot, false);
+        }
+        if (PBPAL_URING_IO_QUEUED == s->send.state) {
+            submit_io(data, slot, true);
+        }
+        if (0 == s->armed) { arm(data, slot); }
+    }
+}
+
+
+static void arm_wakeup(struct pbpal_poll_data* data)
+{
+    struct io_uring_sqe* sqe;
+
+    if (data->wakeup_armed) { return; }
+    sqe = get_sqe(data);
+    if (NULL == sqe) { return; }
+    prep_poll_add(sqe, data->wakeup.read_fd, POLLIN, TAG_WAKEUP);
+    data->wakeup_armed = true;
+}
+
+
+/** Handles the completion of the receive (or, if @p send, the send)
+    of the context in @p slot, with the result @p res.
+    @return Whether the context was requeued for processing
+ */
+static bool io_completed(struct pbpal_poll_data* data,
+                         uint32_t                slot,
+                         bool                    send,
+                         int32_t                 res)
+{
+    struct pbpal_uring_slot* s  = &data->slots[slot];
+    struct pbpal_uring_io*   io = send ? &s->send : &s->recv;
+
+    PUBNUB_ASSERT_OPT(PBPAL_URING_IO_IN_FLIGHT == io->state);
+    PUBNUB_ASSERT_OPT(data->io_in_flight > 0);
+    --data->io_in_flight;
+
+    if (NULL == s->pb) {
+        /* Removed while in flight */
+        memset(io, 0, sizeof *io);
+        if (s->draining && !io_in_flight(s)) { free_slot(data, slot); }
+        return false;
+    }
+    if ((-EAGAIN == res) || (-EINTR == res)) {
+        /* Wasn't ready after all, wait until it is */
+        io->linked = true;
+        submit_io(data, slot, send);
+        return false;
+    }
+    if (send && (res > 0)) {
+        io->pos += (uint32_t)res;
+        io->linked = false;
+        if (io->pos < io->len) {
+            submit_io(data, slot, true);
+            return false;
+        }
+        if (io->end > io->len) {
+            /* Send what was put in the buffer in the meantime */
+            uint8_t* buf = s->io_buf + PBPAL_URING_IO_BUFFER_SIZE;
+            memmove(buf, buf + io->len, io->end - io->len);
+            io->end -= io->len;
+            io->pos = 0;
+            io->len = io->end;
+            submit_io(data, slot, true);
+            if (io->waiting) {
+                /* Now there's room for more */
+                io->waiting = false;
+                pbntf_requeue_for_processing(s->pb);
+                return true;
+            }
+            return false;
+        }
+    }
+    /* Poll for readiness again, if there's no more I/O */
+    to_rearm(data, slot);
+    if (!send) {
+        io->res   = res;
+        io->pos   = 0;
+        io->state = PBPAL_URING_IO_DONE;
+        pbntf_requeue_for_processing(s->pb);
+        return true;
+    }
+    io->res   = (res > 0) ? 0 : (0 == res) ? -EPIPE : res;
+    io->pos   = 0;
+    io->len   = 0;
+    io->end   = 0;
+    io->state = PBPAL_URING_IO_IDLE;
+    if (io->waiting || (io->res < 0)) {
+        io->waiting = false;
+        pbntf_requeue_for_processing(s->pb);
+        return true;
+    }
+
+    return false;
+}
+
+
+/** Handles all the completions available, without waiting.
+    @return Number of completions handled that requeued a context, or
+    were of the wakeup
+ */
+static int reap_completions(struct pbpal_poll_data* data)
+{
+    unsigned       head = *data->cq_head;
+    unsigned const tail = __atomic_load_n(data->cq_tail, __ATOMIC_ACQUIRE);
+    int            rslt = 0;
+
+    for (; head != tail; ++head) {
+        struct io_uring_cqe const* cqe = &data->cqes[head & data->cq_mask];
+        uint64_t const             tag = cqe->user_data;
+        struct pbpal_uring_slot*   s;
+
+        if (TAG_IGNORE == tag) { continue; }
+        if (TAG_WAKEUP == tag) {
+            pbpal_ntf_callback_wakeup_drain(&data->wakeup);
+            data->wakeup_armed = false;
+            ++rslt;
+            continue;
+        }
+        if (TAG_SLOT(tag) >= data->slots_cap) { continue; }
+        switch (TAG_KIND(tag)) {
+        case KIND_RECV:
+        case KIND_SEND:
+            rslt += io_completed(
+                data, TAG_SLOT(tag), KIND_SEND == TAG_KIND(tag), cqe->res);
+            continue;
+        case KIND_POLL:
+            break;
+        default:
+            /* A linked poll, if it failed, so will the request after it */
+            continue;
+        }
+        s = &data->slots[TAG_SLOT(tag)];
+        if ((NULL == s->pb) || (s->seq != TAG_SEQ(tag)) || (0 == s->armed)) {
+            /* Completion of a request we already gave up on */
+            continue;
+        }
+        s->armed = 0;
+        to_rearm(data, TAG_SLOT(tag));
+        /* Errors are reported too, the FSM will find out what's wrong */
+        pbntf_requeue_for_processing(s->pb);
+        ++rslt;
+    }
+    __atomic_store_n(data->cq_head, head, __ATOMIC_RELEASE);
+
+    return rslt;
+}
+
+
+int pbpal_ntf_poll_away(struct pbpal_poll_data* data, int ms)
+{
+    int rslt;
+
+    rearm_completed(data);
+    arm_wakeup(data);
+
+    /* Completions may be waiting already, if there were more than
+       we could handle at once, or if we submitted to make room */
+    rslt = reap_completions(data);
+    if (uring_enter(data, sq_pending(data), ((rslt > 0) || (0 == ms)) ? 0 : 1, ms)
+        < 0) {
+        switch (errno) {
+        case ETIME:
+        case EINTR:
+        case EAGAIN:
+        case EBUSY:
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    return rslt + reap_completions(data);
+}
+
+
+void pbpal_ntf_callback_poller_wakeup(struct pbpal_poll_data* data)
+{
+    pbpal_ntf_callback_wakeup_signal(&data->wakeup);
+}
+
+
+/** Cancels all the I/O requests in flight and waits (for a while)
+    for them to complete, as the kernel may write to their buffers
+    until they do.
+ */
+static void drain_io(struct pbpal_poll_data* data)
+{
+    uint32_t i;
+    int      tries;
+
+    for (i = 0; i < data->slots_cap; ++i) {
+        struct pbpal_uring_slot* s = &data->slots[i];
+        if (io_in_flight(s)) {
+            cancel_io(data, i, false);
+            cancel_io(data, i, true);
+            s->pb       = NULL;
+            s->draining = true;
+        }
+    }
+    for (tries = 0; (data->io_in_flight > 0) && (tries < 10); ++tries) {
+        uring_enter(data, sq_pending(data), 1, 100);
+        reap_completions(data);
+    }
+}
+
+
+void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data)
+{
+    uint32_t i;
+
+    PUBNUB_ASSERT_OPT(data != NULL);
+    PUBNUB_ASSERT_OPT(*data != NULL);
+
+    drain_io(*data);
+    /* Closing the ring cancels all the (other) requests in flight */
+    unmap_rings(*data);
+    close((*data)->ring_fd);
+    pbpal_ntf_callback_wakeup_deinit(&(*data)->wakeup);
+    for (i = 0; i < (*data)->slots_cap; ++i) {
+        uint8_t* buf = (*data)->slots[i].io_buf;
+        if ((buf != NULL)
+            && ((NULL == (*data)->fixed_bufs) || (i >= PBPAL_URING_FIXED_BUFFERS))) {
+            free(buf);
+        }
+    }
+    if ((*data)->fixed_bufs != NULL) {
+        munmap((*data)->fixed_bufs, FIXED_BUFS_SIZE);
+    }
+    free((*data)->slots);
+    free((*data)->rearm);
+    free(*data);
+    *data = NULL;
+}
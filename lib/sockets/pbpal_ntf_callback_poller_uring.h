@@ -0,0 +1,231 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined(INC_PBPAL_NTF_CALLBACK_POLLER_URING)
+#define      INC_PBPAL_NTF_CALLBACK_POLLER_URING
+
+#include "core/pbpal_ntf_callback_poller.h"
+#include "lib/sockets/pbpal_ntf_callback_wakeup.h"
+
+#if !defined(__linux__)
+#error io_uring based poller is available only on Linux
+#endif
+
+#include <linux/io_uring.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* Besides telling which sockets are ready (like the epoll poller
+   does), the io_uring poller does the sending and receiving of data
+   for the contexts it watches, with completion based requests. The
+   PALs (plain sockets and OpenSSL, which then does TLS in memory) put
+   the data to send in, and take received data out of, the poller's
+   buffer of the context, through pbntf_uring_send_buffer() and
+   friends, instead of calling `send()`/`recv()` themselves. All the
+   requests queued while processing contexts are submitted in the
+   poller's one `io_uring_enter()`, which also waits for completions.
+ */
+
+
+/** Number of entries of the submission queue. If more requests are
+    queued between two polls, they are submitted (without waiting)
+    to make room, so this only affects the "batch size".
+ */
+#define PBPAL_URING_SQ_ENTRIES 256
+
+/** Number of entries of the completion queue. Should be big enough
+    for the completions of all the requests in flight, though the
+    kernel (since 5.5) will not drop completions that don't fit.
+ */
+#define PBPAL_URING_CQ_ENTRIES 4096
+
+
+#if !defined(PBPAL_URING_IO_BUFFER_SIZE)
+/** Size of the buffer for receiving, and the one for sending, that
+    the poller has for each context it does I/O for. Data to send that
+    doesn't fit is sent in more requests, like what's received that
+    doesn't fit.
+ */
+#define PBPAL_URING_IO_BUFFER_SIZE 8192
+#endif
+
+#if !defined(PBPAL_URING_FIXED_BUFFERS)
+/** Number of contexts whose I/O buffers are registered with the
+    kernel (`IORING_REGISTER_BUFFERS`), so that it doesn't have to
+    map them on each request. Those buffers are allocated when the
+    poller is made. The I/O buffers of other contexts are allocated
+    when first needed, and used without registering. If the
+    registration fails (not allowed to lock that much memory), all of
+    them are used without registering.
+ */
+#define PBPAL_URING_FIXED_BUFFERS 32
+#endif
+
+
+/** State of the completion based receive or send of a context */
+enum pbpal_uring_io_state {
+    /** Nothing going on, the buffer is free (for send) or holds
+        nothing (for receive) */
+    PBPAL_URING_IO_IDLE,
+    /** To be submitted, on next poll, as there was no room in the
+        submission queue */
+    PBPAL_URING_IO_QUEUED,
+    /** Submitted (or in the submission queue), not completed yet */
+    PBPAL_URING_IO_IN_FLIGHT,
+    /** Completed (receive only), the result is not consumed yet */
+    PBPAL_URING_IO_DONE
+};
+
+
+/** Completion based receive or send of a context */
+struct pbpal_uring_io {
+    /** One of `enum pbpal_uring_io_state` */
+    uint8_t state;
+    /** Whether the context is waiting for this to complete */
+    bool waiting;
+    /** Result of the completed request: octets received, or negated
+        `errno`. For send, only the error, reported on next send. */
+    int32_t res;
+    /** Receive: octets of the result already consumed. Send: octets
+        of the buffer already sent. */
+    uint32_t pos;
+    /** Receive: octets to receive at most. Send: octets to send with
+        the request in flight. */
+    uint32_t len;
+    /** Send: octets in the buffer, those after `len` are sent when
+        the request in flight is done */
+    uint32_t end;
+    /** Position in the submission queue of the (first) request */
+    uint32_t at;
+    /** Whether the request is linked after a poll request for the
+        socket being ready, as it would fail with EAGAIN otherwise */
+    bool linked;
+};
+
+
+/** A "slot" of a registered context. The requests we submit carry
+    the index of the slot and a sequence number, instead of a pointer
+    to the context, because their completions may come after the
+    context was removed (and maybe freed).
+ */
+struct pbpal_uring_slot {
+    /** The context registered in this slot, NULL if slot is free */
+    pubnub_t* pb;
+    /** Sequence number of the last poll request submitted */
+    uint32_t seq;
+    /** Events of the poll request in flight, 0 if none */
+    uint32_t armed;
+    /** Position in the submission queue of the poll request in flight */
+    uint32_t armed_at;
+    /** Next free slot, if this one is free */
+    uint32_t next_free;
+    /** Whether this slot is in the "re-arm" list */
+    bool rearm;
+    /** Whether the context was removed, but some of its I/O requests
+        are still in flight, so the slot can't be reused yet */
+    bool draining;
+    /** Index of the registered buffer that `io_buf` is in, -1 if it's
+        not in one */
+    int fixed;
+    /** Receive buffer, followed by the send buffer, each of
+        #PBPAL_URING_IO_BUFFER_SIZE. NULL until first needed. */
+    uint8_t* io_buf;
+    struct pbpal_uring_io recv;
+    struct pbpal_uring_io send;
+};
+
+
+struct pbpal_poll_data {
+    /** The io_uring instance file descriptor */
+    int ring_fd;
+
+    /** Submission queue ring, mapped from the kernel */
+    void*                sq_ring;
+    size_t               sq_ring_size;
+    unsigned*            sq_head;
+    unsigned*            sq_tail;
+    unsigned             sq_mask;
+    unsigned             sq_entries;
+    struct io_uring_sqe* sqes;
+    size_t               sqes_size;
+    /** Value of the tail at the last submission to the kernel */
+    unsigned sq_submitted;
+
+    /** Completion queue ring, mapped from the kernel (may be the same
+        mapping as the submission queue ring) */
+    void*                cq_ring;
+    size_t               cq_ring_size;
+    unsigned*            cq_head;
+    unsigned*            cq_tail;
+    unsigned             cq_mask;
+    struct io_uring_cqe* cqes;
+
+    /** Slots of registered contexts */
+    struct pbpal_uring_slot* slots;
+    /** Number of allocated slots */
+    uint32_t slots_cap;
+    /** Head of the list of free slots */
+    uint32_t free_slot;
+    /** Slots whose poll request completed, to be re-armed on next poll */
+    uint32_t* rearm;
+    uint32_t  rearm_count;
+
+    /** I/O buffers of the first #PBPAL_URING_FIXED_BUFFERS slots,
+        NULL if they couldn't be allocated */
+    uint8_t* fixed_bufs;
+    /** Whether `fixed_bufs` are registered with the kernel */
+    bool fixed_registered;
+    /** Number of I/O requests (receive or send) in flight */
+    uint32_t io_in_flight;
+
+    /** Number of registered contexts */
+    size_t size;
+    /** Watched with a poll request of its own */
+    struct pbpal_ntf_callback_wakeup wakeup;
+    /** Whether poll request for the wakeup is in flight */
+    bool wakeup_armed;
+};
+
+
+/** Gives, in @p buf, the free part of the buffer to put the data to
+    send for @p pb in. Data put there while a previous send is not done
+    is sent after it.
+
+    @return The size of the free part, -1 on error (`errno` set; EAGAIN
+    if the buffer is full, or the error a previous send failed with),
+    or #PBNTF_URING_NO_IO if @p pb can't do completion based I/O
+ */
+int pbpal_ntf_uring_send_buffer(struct pbpal_poll_data* data,
+                                pubnub_t*               pb,
+                                uint8_t**               buf);
+
+/** Sends the first @p n octets of the buffer got from
+    pbpal_ntf_uring_send_buffer()
+ */
+void pbpal_ntf_uring_send(struct pbpal_poll_data* data,
+                          pubnub_t*               pb,
+                          size_t                  n);
+
+/** Gives, in @p buf, the data received for @p pb, if there is some.
+    If not, and it's not receiving already, starts receiving (at most
+    @p max octets, or as much as fits in the buffer).
+
+    @return The number of octets received, 0 if the connection was
+    closed, -1 on error (`errno` set; EAGAIN if receiving), or
+    #PBNTF_URING_NO_IO if @p pb can't do completion based I/O
+ */
+int pbpal_ntf_uring_recv_buffer(struct pbpal_poll_data* data,
+                                pubnub_t*               pb,
+                                uint8_t const**         buf,
+                                size_t                  max);
+
+/** Marks the first @p n octets of the data received for @p pb as
+    consumed
+ */
+void pbpal_ntf_uring_recv_consume(struct pbpal_poll_data* data,
+                                  pubnub_t*               pb,
+                                  size_t                  n);
+
+
+#endif  /* !defined(INC_PBPAL_NTF_CALLBACK_POLLER_URING) */
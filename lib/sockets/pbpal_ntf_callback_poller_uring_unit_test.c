@@ -0,0 +1,898 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "pubnub_get_native_socket.h"
+#include "lib/sockets/pbpal_ntf_callback_poller_uring.h"
+#include "core/pubnub_assert.h"
+
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define attest assert_that
+#define equals is_equal_to
+#define differs is_not_equal_to
+
+/* Assert handler */
+static bool    m_expect_Assert;
+static jmp_buf m_Assert_exp_jmpbuf;
+
+void assert_handler(char const* s, const char* file, long i)
+{
+    printf("%s:%ld: Pubnub assert failed '%s'\n", file, i, s);
+    if (m_expect_Assert) {
+        m_expect_Assert = false;
+        longjmp(m_Assert_exp_jmpbuf, 1);
+    }
+}
+
+/* Track requeue calls */
+static pubnub_t* s_last_requeued;
+static int       s_requeue_count;
+
+int pbntf_requeue_for_processing(pubnub_t* pb)
+{
+    s_last_requeued = pb;
+    ++s_requeue_count;
+    return 0;
+}
+
+pbpal_native_socket_t pubnub_get_native_socket(pubnub_t* pb)
+{
+    if (NULL == pb) { return -1; }
+    return pb->pal.socket;
+}
+
+void pb_sleep_ms(unsigned long ms) { (void)ms; }
+
+
+Describe(pbpal_poller_uring);
+
+BeforeEach(pbpal_poller_uring) {
+    s_last_requeued = NULL;
+    s_requeue_count = 0;
+    m_expect_Assert = false;
+}
+
+AfterEach(pbpal_poller_uring) {}
+
+
+Ensure(pbpal_poller_uring, init_and_deinit)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    attest(data, differs(NULL));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+    attest(data == NULL);
+}
+
+
+Ensure(pbpal_poller_uring, watch_fails_for_unregistered_context)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+
+    ctx.pal.socket = -1;
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(-1));
+    attest(pbpal_ntf_watch_out_events(data, &ctx), equals(-1));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, save_and_remove_socket)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(ctx.uring.socket, equals(sv[0]));
+    attest(ctx.uring.events, differs(0));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    attest(ctx.uring.events, equals(0));
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(-1));
+
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, poll_away_detects_writable_socket)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    /* sv[0] should be immediately writable */
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, poll_away_detects_readable_socket)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    /* Write to sv[1] so sv[0] becomes readable */
+    attest(write(sv[1], "x", 1), equals(1));
+
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, multiple_sockets)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx1 = { 0 }, ctx2 = { 0 }, ctx3 = { 0 };
+    int sv1[2], sv2[2], sv3[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv3), equals(0));
+
+    ctx1.pal.socket = sv1[0];
+    ctx2.pal.socket = sv2[0];
+    ctx3.pal.socket = sv3[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx1);
+    pbpal_ntf_callback_save_socket(data, &ctx2);
+    pbpal_ntf_callback_save_socket(data, &ctx3);
+
+    /* Remove middle one */
+    pbpal_ntf_callback_remove_socket(data, &ctx2);
+
+    /* Poll — ctx1 and ctx3 should be writable */
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(2));
+    attest(s_requeue_count, equals(2));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx1);
+    pbpal_ntf_callback_remove_socket(data, &ctx3);
+    close(sv1[0]); close(sv1[1]);
+    close(sv2[0]); close(sv2[1]);
+    close(sv3[0]); close(sv3[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, update_socket_replaces_old_one)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv1[2], sv2[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+
+    ctx.pal.socket = sv1[0];
+    pbpal_ntf_callback_save_socket(data, &ctx);
+
+    /* Simulate socket change, while the old one is still open */
+    ctx.pal.socket = sv2[0];
+    pbpal_ntf_callback_update_socket(data, &ctx);
+    attest(ctx.uring.socket, equals(sv2[0]));
+
+    /* Only the new socket should be reported */
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_requeue_count, equals(1));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv1[0]); close(sv1[1]);
+    close(sv2[0]); close(sv2[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, update_socket_registers_unregistered_context)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_update_socket(data, &ctx);
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, save_after_socket_closed_behind_our_back)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv1[2], sv2[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    ctx.pal.socket = sv1[0];
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    close(sv1[0]);
+    close(sv1[1]);
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    ctx.pal.socket = sv2[0];
+    pbpal_ntf_callback_save_socket(data, &ctx);
+
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv2[0]);
+    close(sv2[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, works_with_high_fd_numbers)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+
+    int high_fd = dup2(sv[0], 1500);
+    attest(high_fd, equals(1500));
+    close(sv[0]);
+    ctx.pal.socket = high_fd;
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+
+    int rslt = pbpal_ntf_poll_away(data, 100);
+    attest(rslt, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(high_fd);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, wakeup_ends_poll_away_without_sockets)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    time_t                  start;
+
+    /* Signalled before polling, so poll_away() should not wait */
+    pbpal_ntf_callback_poller_wakeup(data);
+    start = time(NULL);
+    pbpal_ntf_poll_away(data, 10000);
+    attest(time(NULL) - start < 2);
+    attest(s_requeue_count, equals(0));
+
+    /* The wakeup was consumed, so now it times out */
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, wakeup_does_not_hide_socket_events)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    pbpal_ntf_callback_poller_wakeup(data);
+    attest(pbpal_ntf_poll_away(data, 100) > 0);
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, ready_socket_is_reported_again)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    /* Poll requests are one-shot, but we must behave like poll() */
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_requeue_count, equals(2));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, removed_socket_is_not_reported)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    /* Poll request in flight, waiting for input */
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    attest(write(sv[1], "x", 1), equals(1));
+    attest(pbpal_ntf_poll_away(data, 10), equals(0));
+    attest(s_requeue_count, equals(0));
+
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, change_of_events_in_flight_is_respected)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv[2];
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    ctx.pal.socket = sv[0];
+
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    /* Submitted request waits for input, which never comes */
+    attest(pbpal_ntf_watch_out_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, more_sockets_than_submission_queue_entries)
+{
+    enum { N = PBPAL_URING_SQ_ENTRIES + 3 };
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t* ctx = (pubnub_t*)calloc(N, sizeof *ctx);
+    int (*sv)[2] = calloc(N, sizeof *sv);
+    int reported = 0;
+    int i;
+
+    for (i = 0; i < N; ++i) {
+        attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv[i]), equals(0));
+        ctx[i].pal.socket = sv[i][0];
+        pbpal_ntf_callback_save_socket(data, &ctx[i]);
+    }
+    for (i = 0; (i < 10) && (reported < N); ++i) {
+        reported += pbpal_ntf_poll_away(data, 100);
+    }
+    attest(reported, equals(N));
+    attest(s_requeue_count, equals(N));
+
+    for (i = 0; i < N; ++i) {
+        pbpal_ntf_callback_remove_socket(data, &ctx[i]);
+        close(sv[i][0]);
+        close(sv[i][1]);
+    }
+    free(sv);
+    free(ctx);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, update_socket_reopened_with_the_same_number)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    int sv1[2], sv2[2];
+    int fd;
+
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv1), equals(0));
+    fd = sv1[0];
+    ctx.pal.socket = fd;
+    pbpal_ntf_callback_save_socket(data, &ctx);
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    /* Close it (like the DNS socket) and get a new one on the same
+       number, as the kernel is likely to give it */
+    close(sv1[0]);
+    close(sv1[1]);
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv2), equals(0));
+    if (sv2[0] != fd) {
+        attest(dup2(sv2[0], fd), equals(fd));
+        close(sv2[0]);
+        sv2[0] = fd;
+    }
+    pbpal_ntf_callback_update_socket(data, &ctx);
+    attest(ctx.uring.socket, equals(fd));
+
+    /* The new socket must be watched, not the gone one (whose poll
+       request, holding it, would never complete) */
+    attest(pbpal_ntf_watch_in_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+    attest(write(sv2[1], "x", 1), equals(1));
+    attest(pbpal_ntf_poll_away(data, 100), equals(1));
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv2[0]);
+    close(sv2[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+/** Makes a (non-blocking, like the PALs' ones) socket pair and
+    registers the first socket for @p ctx
+ */
+static void io_setup(struct pbpal_poll_data* data, pubnub_t* ctx, int sv[2])
+{
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    attest(fcntl(sv[0], F_SETFL, O_NONBLOCK), equals(0));
+    ctx->pal.socket = sv[0];
+    pbpal_ntf_callback_save_socket(data, ctx);
+}
+
+
+static void io_teardown(struct pbpal_poll_data* data, pubnub_t* ctx, int sv[2])
+{
+    pbpal_ntf_callback_remove_socket(data, ctx);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+
+static int send_str(struct pbpal_poll_data* data, pubnub_t* ctx, char const* s)
+{
+    uint8_t* buf;
+    int      rslt = pbpal_ntf_uring_send_buffer(data, ctx, &buf);
+
+    if (rslt > 0) {
+        memcpy(buf, s, strlen(s));
+        pbpal_ntf_uring_send(data, ctx, strlen(s));
+    }
+    return rslt;
+}
+
+
+Ensure(pbpal_poller_uring, no_io_for_context_that_is_not_registered)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t* sbuf;
+    uint8_t const* rbuf;
+    int sv[2];
+
+    attest(pbpal_ntf_uring_send_buffer(data, &ctx, &sbuf),
+           equals(PBNTF_URING_NO_IO));
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &rbuf, 10),
+           equals(PBNTF_URING_NO_IO));
+
+    /* Nor for one that uses some other socket than the registered */
+    io_setup(data, &ctx, sv);
+    ctx.pal.socket = sv[1];
+    attest(pbpal_ntf_uring_send_buffer(data, &ctx, &sbuf),
+           equals(PBNTF_URING_NO_IO));
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &rbuf, 10),
+           equals(PBNTF_URING_NO_IO));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, send_is_done_by_the_poller)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    char got[16] = { 0 };
+    int sv[2];
+
+    io_setup(data, &ctx, sv);
+    attest(send_str(data, &ctx, "hello"), equals(PBPAL_URING_IO_BUFFER_SIZE));
+    /* Nothing is sent until the poll */
+    attest(recv(sv[1], got, sizeof got, MSG_DONTWAIT), equals(-1));
+
+    pbpal_ntf_poll_away(data, 100);
+    attest(recv(sv[1], got, sizeof got, MSG_DONTWAIT), equals(5));
+    attest(got, is_equal_to_string("hello"));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, sends_before_the_poll_go_out_together)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    char got[16] = { 0 };
+    int sv[2];
+
+    io_setup(data, &ctx, sv);
+    attest(send_str(data, &ctx, "abc"), equals(PBPAL_URING_IO_BUFFER_SIZE));
+    attest(send_str(data, &ctx, "def"), equals(PBPAL_URING_IO_BUFFER_SIZE - 3));
+    pbpal_ntf_poll_away(data, 100);
+    attest(recv(sv[1], got, sizeof got, MSG_DONTWAIT), equals(6));
+    attest(got, is_equal_to_string("abcdef"));
+    /* Nobody waited for the send */
+    attest(s_requeue_count, equals(0));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, send_while_sending_is_sent_after)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    char* msg = malloc(PBPAL_URING_IO_BUFFER_SIZE + 1);
+    char* got = calloc(1, PBPAL_URING_IO_BUFFER_SIZE + 1);
+    int sndbuf = 1024;
+    int have = 0;
+    int sv[2];
+    int i;
+
+    io_setup(data, &ctx, sv);
+    setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof sndbuf);
+    for (i = 0; i < PBPAL_URING_IO_BUFFER_SIZE - 3; ++i) {
+        msg[i] = 'a' + i % 26;
+    }
+    msg[PBPAL_URING_IO_BUFFER_SIZE - 3] = '\0';
+    send_str(data, &ctx, msg);
+    /* It doesn't fit in the socket buffer, so it's still in flight */
+    pbpal_ntf_poll_away(data, 0);
+    attest(send_str(data, &ctx, "xyz"), equals(3));
+    strcat(msg, "xyz");
+    attest(send_str(data, &ctx, "!"), equals(-1));
+    attest(errno, equals(EAGAIN));
+
+    for (i = 0; (i < 100) && (have < PBPAL_URING_IO_BUFFER_SIZE); ++i) {
+        int got_now;
+        pbpal_ntf_poll_away(data, 10);
+        got_now = recv(sv[1],
+                       got + have,
+                       PBPAL_URING_IO_BUFFER_SIZE - have,
+                       MSG_DONTWAIT);
+        if (got_now > 0) { have += got_now; }
+    }
+    attest(have, equals(PBPAL_URING_IO_BUFFER_SIZE));
+    attest(got, is_equal_to_string(msg));
+    /* Woken up when there was room again */
+    attest(s_requeue_count, is_greater_than(0));
+    attest(s_last_requeued, equals(&ctx));
+    attest(send_str(data, &ctx, "!"), is_greater_than(0));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+    free(got);
+    free(msg);
+}
+
+
+Ensure(pbpal_poller_uring, send_bigger_than_socket_buffer_is_completed)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    char* msg = malloc(PBPAL_URING_IO_BUFFER_SIZE + 1);
+    char* got = calloc(1, PBPAL_URING_IO_BUFFER_SIZE + 1);
+    int sndbuf = 1024;
+    int have = 0;
+    int sv[2];
+    int i;
+
+    io_setup(data, &ctx, sv);
+    setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof sndbuf);
+    for (i = 0; i < PBPAL_URING_IO_BUFFER_SIZE; ++i) {
+        msg[i] = 'a' + i % 26;
+    }
+    msg[PBPAL_URING_IO_BUFFER_SIZE] = '\0';
+    attest(send_str(data, &ctx, msg), equals(PBPAL_URING_IO_BUFFER_SIZE));
+
+    for (i = 0; (i < 100) && (have < PBPAL_URING_IO_BUFFER_SIZE); ++i) {
+        int got_now;
+        pbpal_ntf_poll_away(data, 10);
+        got_now = recv(sv[1],
+                       got + have,
+                       PBPAL_URING_IO_BUFFER_SIZE - have,
+                       MSG_DONTWAIT);
+        if (got_now > 0) { have += got_now; }
+    }
+    attest(have, equals(PBPAL_URING_IO_BUFFER_SIZE));
+    attest(got, is_equal_to_string(msg));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+    free(got);
+    free(msg);
+}
+
+
+Ensure(pbpal_poller_uring, send_error_is_reported)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t const* rbuf;
+    int sv[2];
+    int i;
+
+    io_setup(data, &ctx, sv);
+    close(sv[1]);
+    attest(send_str(data, &ctx, "lost"), equals(PBPAL_URING_IO_BUFFER_SIZE));
+    for (i = 0; (i < 10) && (0 == s_requeue_count); ++i) {
+        pbpal_ntf_poll_away(data, 100);
+    }
+    attest(s_requeue_count, equals(1));
+
+    /* Reported on next receive (or send), once */
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &rbuf, 10), equals(-1));
+    attest(errno, equals(EPIPE));
+    attest(send_str(data, &ctx, "more"), equals(PBPAL_URING_IO_BUFFER_SIZE));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, recv_is_done_by_the_poller)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t const* buf;
+    int sv[2];
+    int i;
+
+    io_setup(data, &ctx, sv);
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    attest(errno, equals(EAGAIN));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+    attest(s_requeue_count, equals(0));
+
+    attest(write(sv[1], "abc", 3), equals(3));
+    for (i = 0; (i < 10) && (0 == s_requeue_count); ++i) {
+        pbpal_ntf_poll_away(data, 100);
+    }
+    attest(s_requeue_count, equals(1));
+    attest(s_last_requeued, equals(&ctx));
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(3));
+    attest(memcmp(buf, "abc", 3), equals(0));
+    pbpal_ntf_uring_recv_consume(data, &ctx, 3);
+
+    /* All consumed, so, receiving again */
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    attest(errno, equals(EAGAIN));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, recv_gets_no_more_than_asked_for)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t const* buf;
+    int sv[2];
+    int i;
+
+    io_setup(data, &ctx, sv);
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 4), equals(-1));
+    attest(write(sv[1], "abcdefgh", 8), equals(8));
+    for (i = 0; (i < 10) && (0 == s_requeue_count); ++i) {
+        pbpal_ntf_poll_away(data, 100);
+    }
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 4), equals(4));
+    attest(memcmp(buf, "abcd", 4), equals(0));
+
+    /* What's not consumed stays */
+    pbpal_ntf_uring_recv_consume(data, &ctx, 1);
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 4), equals(3));
+    attest(memcmp(buf, "bcd", 3), equals(0));
+    pbpal_ntf_uring_recv_consume(data, &ctx, 3);
+
+    /* The rest is still in the socket */
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    for (i = 0; (i < 10) && (s_requeue_count < 2); ++i) {
+        pbpal_ntf_poll_away(data, 100);
+    }
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(4));
+    attest(memcmp(buf, "efgh", 4), equals(0));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, end_of_connection_is_received)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t const* buf;
+    int sv[2];
+    int i;
+
+    io_setup(data, &ctx, sv);
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    close(sv[1]);
+    for (i = 0; (i < 10) && (0 == s_requeue_count); ++i) {
+        pbpal_ntf_poll_away(data, 100);
+    }
+    attest(s_requeue_count, equals(1));
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(0));
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(0));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    close(sv[0]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, readiness_is_not_reported_while_receiving)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t const* buf;
+    int sv[2];
+
+    io_setup(data, &ctx, sv);
+    /* Writable, but we're waiting for the receive to complete */
+    attest(pbpal_ntf_watch_out_events(data, &ctx), equals(0));
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    attest(pbpal_ntf_poll_away(data, 10), equals(0));
+    attest(pbpal_ntf_poll_away(data, 10), equals(0));
+    attest(s_requeue_count, equals(0));
+
+    io_teardown(data, &ctx, sv);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, removed_context_with_recv_in_flight_is_not_requeued)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 }, other = { 0 };
+    uint8_t const* buf;
+    int sv[2], sv_other[2];
+
+    io_setup(data, &ctx, sv);
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    pbpal_ntf_callback_remove_socket(data, &ctx);
+    attest(write(sv[1], "abc", 3), equals(3));
+    pbpal_ntf_poll_away(data, 10);
+    pbpal_ntf_poll_away(data, 10);
+    attest(s_requeue_count, equals(0));
+    /* Cancelled, so, the data was not received */
+    attest(data->io_in_flight, equals(0));
+
+    /* And the slot can be used again */
+    io_setup(data, &other, sv_other);
+    attest(write(sv_other[1], "x", 1), equals(1));
+    attest(pbpal_ntf_uring_recv_buffer(data, &other, &buf, 100), equals(-1));
+    pbpal_ntf_poll_away(data, 100);
+    attest(s_last_requeued, equals(&other));
+    attest(pbpal_ntf_uring_recv_buffer(data, &other, &buf, 100), equals(1));
+
+    io_teardown(data, &other, sv_other);
+    close(sv[0]);
+    close(sv[1]);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, io_works_without_registered_buffers_too)
+{
+    enum { N = PBPAL_URING_FIXED_BUFFERS + 3 };
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t* ctx = (pubnub_t*)calloc(N, sizeof *ctx);
+    int (*sv)[2] = calloc(N, sizeof *sv);
+    uint8_t const* buf;
+    int i;
+
+    for (i = 0; i < N; ++i) {
+        io_setup(data, &ctx[i], sv[i]);
+        attest(pbpal_ntf_uring_recv_buffer(data, &ctx[i], &buf, 100),
+               equals(-1));
+        attest(write(sv[i][1], "y", 1), equals(1));
+    }
+    for (i = 0; (i < 10) && (s_requeue_count < N); ++i) {
+        pbpal_ntf_poll_away(data, 100);
+    }
+    attest(s_requeue_count, equals(N));
+    for (i = 0; i < N; ++i) {
+        attest(pbpal_ntf_uring_recv_buffer(data, &ctx[i], &buf, 100),
+               equals(1));
+        attest(buf[0], equals('y'));
+        io_teardown(data, &ctx[i], sv[i]);
+    }
+    free(sv);
+    free(ctx);
+    pbpal_ntf_callback_poller_deinit(&data);
+}
+
+
+Ensure(pbpal_poller_uring, deinit_with_io_in_flight)
+{
+    struct pbpal_poll_data* data = pbpal_ntf_callback_poller_init();
+    pubnub_t ctx = { 0 };
+    uint8_t const* buf;
+    int sv[2];
+
+    io_setup(data, &ctx, sv);
+    attest(pbpal_ntf_uring_recv_buffer(data, &ctx, &buf, 100), equals(-1));
+    attest(pbpal_ntf_poll_away(data, 1), equals(0));
+
+    pbpal_ntf_callback_poller_deinit(&data);
+    attest(data == NULL);
+    close(sv[0]);
+    close(sv[1]);
+}
@@ -0,0 +1,96 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "lib/sockets/pbpal_ntf_callback_wakeup.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+
+#if !defined(__linux__)
+static int set_nonblocking_cloexec(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if ((-1 == flags) || (-1 == fcntl(fd, F_SETFL, flags | O_NONBLOCK))) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+#endif
+
+
+int pbpal_ntf_callback_wakeup_init(struct pbpal_ntf_callback_wakeup* wakeup)
+{
+#if defined(__linux__)
+    wakeup->read_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (-1 == wakeup->read_fd) { return -1; }
+    wakeup->write_fd = wakeup->read_fd;
+#else
+    int fds[2];
+
+    if (0 != pipe(fds)) { return -1; }
+    if ((0 != set_nonblocking_cloexec(fds[0]))
+        || (0 != set_nonblocking_cloexec(fds[1]))) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    wakeup->read_fd  = fds[0];
+    wakeup->write_fd = fds[1];
+#endif
+
+    return 0;
+}
+
+
+void pbpal_ntf_callback_wakeup_signal(struct pbpal_ntf_callback_wakeup* wakeup)
+{
+    int const saved_errno = errno;
+#if defined(__linux__)
+    uint64_t const one = 1;
+    /* Can only fail if the counter would overflow, which means it's
+       already (very much) signalled.
+     */
+    while ((-1 == write(wakeup->write_fd, &one, sizeof one))
+           && (EINTR == errno)) {
+        continue;
+    }
+#else
+    /* If the pipe is full, it's already signalled, so, ignore errors */
+    while ((-1 == write(wakeup->write_fd, "", 1)) && (EINTR == errno)) {
+        continue;
+    }
+#endif
+    errno = saved_errno;
+}
+
+
+void pbpal_ntf_callback_wakeup_drain(struct pbpal_ntf_callback_wakeup* wakeup)
+{
+#if defined(__linux__)
+    uint64_t count;
+    while ((-1 == read(wakeup->read_fd, &count, sizeof count))
+           && (EINTR == errno)) {
+        continue;
+    }
+#else
+    char buf[64];
+    for (;;) {
+        ssize_t const n = read(wakeup->read_fd, buf, sizeof buf);
+        if ((n < 0) && (EINTR == errno)) { continue; }
+        if (n < (ssize_t)sizeof buf) { break; }
+    }
+#endif
+}
+
+
+void pbpal_ntf_callback_wakeup_deinit(struct pbpal_ntf_callback_wakeup* wakeup)
+{
+    if (wakeup->write_fd != wakeup->read_fd) { close(wakeup->write_fd); }
+    close(wakeup->read_fd);
+    wakeup->read_fd = wakeup->write_fd = -1;
+}
@@ -0,0 +1,49 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined(INC_PBPAL_NTF_CALLBACK_WAKEUP)
+#define      INC_PBPAL_NTF_CALLBACK_WAKEUP
+
+
+/** @file pbpal_ntf_callback_wakeup.h
+
+    A "wakeup" for a poller: a file descriptor that the poller watches
+    for "in" events together with the sockets, which any thread can
+    make ready, to get the poller out of its wait before the timeout
+    expires. On Linux, it's an `eventfd`, elsewhere it's a (non
+    blocking) "self-pipe".
+
+    Signals are "sticky" - once signalled, the wakeup stays ready
+    until drained, so a signal that comes before the poller starts to
+    wait is not lost. Many signals before a drain are "merged" into
+    one.
+ */
+
+
+struct pbpal_ntf_callback_wakeup {
+    /** The descriptor to watch for "in" events */
+    int read_fd;
+    /** The descriptor to signal through. Same as `read_fd` for
+        `eventfd` */
+    int write_fd;
+};
+
+
+/** Creates the wakeup descriptor(s) in @p wakeup.
+    @return 0: OK, -1: error (can't create)
+ */
+int pbpal_ntf_callback_wakeup_init(struct pbpal_ntf_callback_wakeup* wakeup);
+
+/** Makes the @p wakeup ready ("in" event). Thread-safe and async
+    signal safe.
+ */
+void pbpal_ntf_callback_wakeup_signal(struct pbpal_ntf_callback_wakeup* wakeup);
+
+/** Consumes all signals of the @p wakeup, so it's no longer ready.
+    Should be called by the poller when it sees @p wakeup is ready.
+ */
+void pbpal_ntf_callback_wakeup_drain(struct pbpal_ntf_callback_wakeup* wakeup);
+
+/** Closes the descriptor(s) of @p wakeup */
+void pbpal_ntf_callback_wakeup_deinit(struct pbpal_ntf_callback_wakeup* wakeup);
+
+
+#endif  /* !defined(INC_PBPAL_NTF_CALLBACK_WAKEUP) */
@@ -0,0 +1,203 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "core/pbpal_ntf_sync_wait.h"
+#include "core/pbpal.h"
+
+#include "core/pubnub_assert.h"
+#if PUBNUB_USE_LOGGER
+#include "core/pubnub_logger.h"
+#endif // PUBNUB_USE_LOGGER
+
+#include <errno.h>
+
+#if defined(_WIN32)
+/* Same as in the poll() based callback poller, this will do. */
+#define poll(fdarray, nfds, timeout) WSAPoll(fdarray, nfds, timeout)
+#else
+#include <poll.h>
+#endif
+
+
+/* WSAPoll() can't poll anything but sockets, so there's no wakeup on
+   Windows. There, we wait in slices, to see `pubnub_cancel()` soon
+   enough.
+ */
+#if defined(_WIN32)
+#define PBPAL_SYNC_WAIT_SLICE_MS 100
+#define PBPAL_SYNC_WAIT_SLOTS 1
+#else
+#define PBPAL_SYNC_WAIT_SLOTS 2
+#endif
+
+
+void pbpal_ntf_sync_wait_start(pubnub_t* pb)
+{
+#if PUBNUB_BLOCKING_IO_SETTABLE
+    pb->sync_wait.use_blocking_io = pb->options.use_blocking_io;
+    pb->options.use_blocking_io   = false;
+    if (pb->pal.socket != SOCKET_INVALID) { pbpal_set_blocking_io(pb); }
+#else
+    PUBNUB_UNUSED(pb);
+#endif
+}
+
+
+void pbpal_ntf_sync_wait_stop(pubnub_t* pb)
+{
+#if PUBNUB_BLOCKING_IO_SETTABLE
+    pb->options.use_blocking_io = pb->sync_wait.use_blocking_io;
+    if (pb->pal.socket != SOCKET_INVALID) { pbpal_set_blocking_io(pb); }
+#else
+    PUBNUB_UNUSED(pb);
+#endif
+}
+
+
+/** Returns whether the wait was interrupted already. If not, makes
+    sure it can be, from now on.
+ */
+static bool interrupted_or_armed(pubnub_t* pb)
+{
+    bool rslt;
+
+    pubnub_mutex_lock(pb->cancel_monitor);
+    rslt = pb->should_stop_await;
+#if !defined(_WIN32)
+    if (!rslt && (-1 == pb->sync_wait.wakeup.read_fd)) {
+        if (0 != pbpal_ntf_callback_wakeup_init(&pb->sync_wait.wakeup)) {
+            PUBNUB_LOG_WARNING(
+                pb, "Can't create sync wait wakeup, errno=%d", errno);
+            pb->sync_wait.wakeup.read_fd = -1;
+        }
+    }
+#endif
+    pubnub_mutex_unlock(pb->cancel_monitor);
+
+    return rslt;
+}
+
+
+int pbpal_ntf_sync_wait(pubnub_t* pb, int ms)
+{
+    struct pollfd apoll[PBPAL_SYNC_WAIT_SLOTS];
+    int           rslt;
+
+    PUBNUB_ASSERT_OPT(pb != NULL);
+
+    if (SOCKET_INVALID == pb->pal.socket) { return -1; }
+    if (interrupted_or_armed(pb)) { return 0; }
+
+    apoll[0].fd      = pb->pal.socket;
+    apoll[0].events  = pb->sync_wait.in ? POLLIN : POLLOUT;
+    apoll[0].revents = 0;
+#if defined(_WIN32)
+    if ((ms < 0) || (ms > PBPAL_SYNC_WAIT_SLICE_MS)) {
+        ms = PBPAL_SYNC_WAIT_SLICE_MS;
+    }
+#else
+    apoll[1].fd      = pb->sync_wait.wakeup.read_fd;
+    apoll[1].events  = POLLIN;
+    apoll[1].revents = 0;
+#endif
+
+    rslt = poll(apoll, PBPAL_SYNC_WAIT_SLOTS, ms);
+    if (SOCKET_ERROR == rslt) {
+#if !defined(_WIN32)
+        if (EINTR == errno) { return 0; }
+#endif
+        PUBNUB_LOG_WARNING(pb, "poll() failed while waiting for the socket");
+        return -1;
+    }
+#if !defined(_WIN32)
+    if (apoll[1].revents & POLLIN) {
+        pbpal_ntf_callback_wakeup_drain(&pb->sync_wait.wakeup);
+    }
+#endif
+
+    return 0;
+}
+
+
+int pbpal_ntf_sync_wait_any(pubnub_t* const*                  pbs,
+                            unsigned                          n,
+                            struct pbpal_ntf_callback_wakeup* wakeup,
+                            int                               ms)
+{
+    struct pollfd apoll[PBPAL_SYNC_WAIT_ANY_MAX + 1];
+    unsigned      nfds;
+    int           rslt;
+
+    PUBNUB_ASSERT_OPT((n > 0) && (n <= PBPAL_SYNC_WAIT_ANY_MAX));
+
+    for (nfds = 0; nfds < n; ++nfds) {
+        pubnub_t* pb = pbs[nfds];
+        bool      requeued;
+
+        pubnub_mutex_lock(pb->monitor);
+        requeued               = pb->sync_wait.requeued;
+        pb->sync_wait.requeued = false;
+        apoll[nfds].fd         = pb->pal.socket;
+        apoll[nfds].events     = pb->sync_wait.in ? POLLIN : POLLOUT;
+        apoll[nfds].revents    = 0;
+        pubnub_mutex_unlock(pb->monitor);
+
+        /* The FSM has more to do before it needs to wait */
+        if (requeued) { return 0; }
+        if (SOCKET_INVALID == apoll[nfds].fd) { return -1; }
+    }
+#if defined(_WIN32)
+    PUBNUB_UNUSED(wakeup);
+    if ((ms < 0) || (ms > PBPAL_SYNC_WAIT_SLICE_MS)) {
+        ms = PBPAL_SYNC_WAIT_SLICE_MS;
+    }
+#else
+    if ((wakeup != NULL) && (wakeup->read_fd != -1)) {
+        apoll[nfds].fd      = wakeup->read_fd;
+        apoll[nfds].events  = POLLIN;
+        apoll[nfds].revents = 0;
+        ++nfds;
+    }
+#endif
+
+    rslt = poll(apoll, nfds, ms);
+    if (SOCKET_ERROR == rslt) {
+#if !defined(_WIN32)
+        if (EINTR == errno) { return 0; }
+#endif
+        PUBNUB_LOG_WARNING(
+            pbs[0], "poll() failed while waiting for the sockets");
+        return -1;
+    }
+#if !defined(_WIN32)
+    if ((nfds > n) && (apoll[n].revents & POLLIN)) {
+        pbpal_ntf_callback_wakeup_drain(wakeup);
+    }
+#endif
+
+    return 0;
+}
+
+
+void pbpal_ntf_sync_wait_interrupt(pubnub_t* pb)
+{
+#if defined(_WIN32)
+    PUBNUB_UNUSED(pb);
+#else
+    if (pb->sync_wait.wakeup.read_fd != -1) {
+        pbpal_ntf_callback_wakeup_signal(&pb->sync_wait.wakeup);
+    }
+#endif
+}
+
+
+void pbpal_ntf_sync_wait_deinit(pubnub_t* pb)
+{
+#if defined(_WIN32)
+    PUBNUB_UNUSED(pb);
+#else
+    if (pb->sync_wait.wakeup.read_fd != -1) {
+        pbpal_ntf_callback_wakeup_deinit(&pb->sync_wait.wakeup);
+    }
+#endif
+}
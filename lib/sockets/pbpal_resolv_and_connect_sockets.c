@@ -219,6 +219,27 @@ static void prepare_port_and_hostname(
 #endif /* PUBNUB_PROXY_API */
 }
 
+
+#if PUBNUB_COALESCE_HTTP_REQUEST
+/* HTTP requests are put together before sending, so there is nothing
+   to gain from Nagle's algorithm - it would only hold a request sent
+   while the previous one is not acknowledged yet (like when
+   pipelining).
+ */
+static void set_tcp_nodelay(pb_socket_t skt)
+{
+#if defined(_WIN32)
+    const BOOL enabled = TRUE;
+    (void)setsockopt(
+        skt, IPPROTO_TCP, TCP_NODELAY, (const char*)&enabled, sizeof enabled);
+#else
+    const int enabled = 1;
+    (void)setsockopt(skt, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof enabled);
+#endif
+}
+#endif /* PUBNUB_COALESCE_HTTP_REQUEST */
+
+
 #ifdef PUBNUB_CALLBACK_API
 static void get_default_ipv4_dns_ip(
     pubnub_t*                   pb,
@@ -476,6 +497,9 @@ static enum pbpal_resolv_n_connect_result connect_TCP_socket(
     (void)setsockopt(*skt, SOL_SOCKET, SO_KEEPALIVE, &enabled, sizeof(enabled));
     pbpal_set_tcp_keepalive(pb);
 #endif /* !defined(_WIN32) */
+#if PUBNUB_COALESCE_HTTP_REQUEST
+    set_tcp_nodelay(*skt);
+#endif
     options->use_blocking_io = false;
     pbpal_set_socket_blocking_io(pb, *skt, options->use_blocking_io);
     socket_disable_SIGPIPE(pb, *skt);
@@ -954,6 +978,9 @@ enum pbpal_resolv_n_connect_result pbpal_resolv_and_connect(pubnub_t* pb)
                 sizeof(enabled));
             pbpal_set_tcp_keepalive(pb);
 #endif /* !defined(_WIN32) */
+#if PUBNUB_COALESCE_HTTP_REQUEST
+                set_tcp_nodelay(pb->pal.socket);
+#endif
 
                 pbpal_set_blocking_io(pb);
 #if PUBNUB_LOG_ENABLED(DEBUG)
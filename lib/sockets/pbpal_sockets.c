@@ -5,6 +5,9 @@
 #include "core/pubnub_ntf_sync.h"
 #include "core/pubnub_netcore.h"
 #include "core/pubnub_assert.h"
+#if PUBNUB_USE_CONNECTION_POOL
+#include "core/pbconn_pool.h"
+#endif
 #if defined(_WIN32) && defined(PUBNUB_CALLBACK_API)
 #include "windows/pbpal_dns_query_ex.h"
 #endif
@@ -27,6 +30,109 @@ static void buf_setup(pubnub_t* pb)
     pb->left = sizeof pb->core.http_buf / sizeof pb->core.http_buf[0];
 }
 
+
+#if PUBNUB_USE_IO_URING
+/** Sends like socket_send() does, but through the io_uring poller,
+    if @p pb can do that: copies as much as fits in the poller's
+    buffer, and it's sent from there.
+ */
+static int pal_send(pubnub_t* pb, void const* data, size_t n)
+{
+    uint8_t* buf;
+    int      rslt = pbntf_uring_send_buffer(pb, &buf);
+
+    if (PBNTF_URING_NO_IO == rslt) {
+        return socket_send(pb->pal.socket, (char*)data, n);
+    }
+    if (rslt > 0) {
+        if ((size_t)rslt > n) { rslt = (int)n; }
+        memcpy(buf, data, rslt);
+        pbntf_uring_send(pb, rslt);
+    }
+
+    return rslt;
+}
+
+
+/** Receives like socket_recv() does, but through the io_uring poller,
+    if @p pb can do that.
+ */
+static int pal_recv(pubnub_t* pb, void* data, size_t n)
+{
+    uint8_t const* buf;
+    int            rslt = pbntf_uring_recv_buffer(pb, &buf, n);
+
+    if (PBNTF_URING_NO_IO == rslt) {
+        return socket_recv(pb->pal.socket, (char*)data, n, 0);
+    }
+    if (rslt > 0) {
+        if ((size_t)rslt > n) { rslt = (int)n; }
+        memcpy(data, buf, rslt);
+        pbntf_uring_recv_consume(pb, rslt);
+    }
+
+    return rslt;
+}
+#else
+#define pal_send(pb, data, n) socket_send((pb)->pal.socket, (char*)(data), (n))
+#define pal_recv(pb, data, n)                                                  \
+    socket_recv((pb)->pal.socket, (char*)(data), (n), 0)
+#endif /* PUBNUB_USE_IO_URING */
+
+
+#if PUBNUB_RECEIVE_READ_AHEAD
+static void read_ahead_discard(pubnub_t* pb)
+{
+    pb->read_ahead_pos = pb->read_ahead_len = 0;
+}
+
+
+/** Receives into the (empty) read-ahead buffer of @p pb as much as
+    there is, up to its size. Returns the same as socket_recv().
+ */
+static int read_ahead_fill(pubnub_t* pb)
+{
+    int recvres;
+
+    PUBNUB_ASSERT_OPT(pb->read_ahead_pos == pb->read_ahead_len);
+    recvres = pal_recv(pb, pb->read_ahead, sizeof pb->read_ahead);
+    pb->read_ahead_pos = 0;
+    pb->read_ahead_len = (recvres > 0) ? (uint16_t)recvres : 0;
+    if (recvres > 0) {
+        PUBNUB_LOG_TRACE(pb, "%d bytes received (read ahead).", recvres);
+    }
+
+    return recvres;
+}
+
+
+/** Moves up to @p n octets from the read-ahead buffer of @p pb to
+    the read buffer (at `ptr`), as many as there are and fit. If
+    @p line, stops after the first newline.
+
+    @return The number of octets moved
+ */
+static unsigned read_ahead_take(pubnub_t* pb, unsigned n, bool line)
+{
+    uint8_t const* start = pb->read_ahead + pb->read_ahead_pos;
+    unsigned const avail = pb->read_ahead_len - pb->read_ahead_pos;
+
+    if (n > avail) { n = avail; }
+    if (n > pb->left) { n = pb->left; }
+    if (line) {
+        uint8_t const* nl = (uint8_t const*)memchr(start, '\n', n);
+        if (nl != NULL) { n = (unsigned)(nl - start) + 1; }
+    }
+    memcpy(pb->ptr, start, n);
+    pb->ptr += n;
+    pb->left -= n;
+    pb->read_ahead_pos += n;
+
+    return n;
+}
+#endif /* PUBNUB_RECEIVE_READ_AHEAD */
+
+
 #if !defined(PUBNUB_NTF_RUNTIME_SELECTION)
 static int pal_init(pubnub_t* pb)
 {
@@ -72,6 +178,9 @@ void pbpal_init(pubnub_t* pb)
     pb->pal.socket = SOCKET_INVALID;
     pb->sock_state = STATE_NONE;
     buf_setup(pb);
+#if PUBNUB_RECEIVE_READ_AHEAD
+    read_ahead_discard(pb);
+#endif
 #if PUBNUB_USE_MULTIPLE_ADDRESSES
     pbpal_multiple_addresses_reset_counters(&pb->spare_addresses);
 #endif
@@ -108,7 +217,7 @@ int pbpal_send_status(pubnub_t* pb)
 
     PUBNUB_ASSERT_OPT(pb->sock_state == STATE_SENDING_DATA);
 
-    rslt = socket_send(pb->pal.socket, (char*)pb->ptr, pb->len);
+    rslt = pal_send(pb, pb->ptr, pb->len);
     if (rslt <= 0) {
         rslt = (pbpal_handle_socket_error(rslt, pb, __FILE__, __LINE__) ==
                 PNR_IN_PROGRESS)
@@ -126,6 +235,9 @@ int pbpal_send_status(pubnub_t* pb)
         pb->ptr        = (uint8_t*)pb->core.http_buf;
         pb->unreadlen  = 0;
         pb->sock_state = STATE_NONE;
+#if PUBNUB_RECEIVE_READ_AHEAD
+        read_ahead_discard(pb);
+#endif
     }
 
     return rslt;
@@ -162,11 +274,25 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
 {
     PUBNUB_ASSERT_OPT(STATE_READ_LINE == pb->sock_state);
 
+#if PUBNUB_RECEIVE_READ_AHEAD
+    if (pb->read_ahead_pos == pb->read_ahead_len) {
+        int recvres = read_ahead_fill(pb);
+        if (recvres <= 0) {
+            return pbpal_handle_socket_error(recvres, pb, __FILE__, __LINE__);
+        }
+    }
+    if ((read_ahead_take(pb, pb->left, true) > 0) && ('\n' == pb->ptr[-1])) {
+        PUBNUB_LOG_TRACE(
+            pb, "Newline found. Line length: %d", pbpal_read_len(pb));
+        pb->sock_state = STATE_NONE;
+        return PNR_OK;
+    }
+#else
     if (pb->unreadlen == 0) {
         int recvres;
         PUBNUB_ASSERT_OPT(
             (char*)pb->ptr + pb->left == pb->core.http_buf + PUBNUB_BUF_MAXLEN);
-        recvres = socket_recv(pb->pal.socket, (char*)pb->ptr, pb->left, 0);
+        recvres = pal_recv(pb, pb->ptr, pb->left);
         if (recvres <= 0) {
             return pbpal_handle_socket_error(recvres, pb, __FILE__, __LINE__);
         }
@@ -204,6 +330,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
             return PNR_OK;
         }
     }
+#endif /* PUBNUB_RECEIVE_READ_AHEAD */
 
     if (pb->left == 0) {
         PUBNUB_LOG_ERROR(pb, "Read buffer full but newline not found.");
@@ -260,11 +387,36 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
 
     PUBNUB_ASSERT_OPT(STATE_READ == pb->sock_state);
 
+#if PUBNUB_RECEIVE_READ_AHEAD
+    if (pb->read_ahead_pos == pb->read_ahead_len) {
+        unsigned to_recv = pb->len;
+        if (to_recv > pb->left) { to_recv = pb->left; }
+        PUBNUB_ASSERT_OPT(to_recv > 0);
+        if (to_recv < sizeof pb->read_ahead) {
+            have_read = read_ahead_fill(pb);
+        }
+        else {
+            /* Reading ahead would only add a copy of what is to be
+               read anyway */
+            have_read = pal_recv(pb, pb->ptr, to_recv);
+            if (have_read > 0) {
+                PUBNUB_ASSERT_OPT(pb->left >= have_read);
+                pb->left -= have_read;
+                pb->len -= have_read;
+                pb->ptr += have_read;
+            }
+        }
+        if (have_read <= 0) {
+            return pbpal_handle_socket_error(have_read, pb, __FILE__, __LINE__);
+        }
+    }
+    pb->len -= read_ahead_take(pb, pb->len, false);
+#else
     if (0 == pb->unreadlen) {
         unsigned to_recv = pb->len;
         if (to_recv > pb->left) { to_recv = pb->left; }
         PUBNUB_ASSERT_OPT(to_recv > 0);
-        have_read = socket_recv(pb->pal.socket, (char*)pb->ptr, to_recv, 0);
+        have_read = pal_recv(pb, pb->ptr, to_recv);
         if (have_read <= 0) {
             return pbpal_handle_socket_error(have_read, pb, __FILE__, __LINE__);
         }
@@ -278,6 +430,7 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
 
     pb->len -= have_read;
     pb->ptr += have_read;
+#endif /* PUBNUB_RECEIVE_READ_AHEAD */
 
     if ((0 == pb->len) || (0 == pb->left)) {
         pb->sock_state = STATE_NONE;
@@ -305,6 +458,9 @@ void pbpal_forget(pubnub_t* pb)
 int pbpal_close(pubnub_t* pb)
 {
     pb->unreadlen = 0;
+#if PUBNUB_RECEIVE_READ_AHEAD
+    read_ahead_discard(pb);
+#endif
 #if defined(_WIN32) && defined(PUBNUB_CALLBACK_API)
     /* Cancel any pending DnsQueryEx queries. Must happen regardless of
        socket state because the DnsQueryEx path does not create a UDP
@@ -334,4 +490,48 @@ void pbpal_free(pubnub_t* pb)
         pbntf_lost_socket(pb);
         socket_close(pb->pal.socket);
     }
+#if PUBNUB_USE_IO_URING
+    else {
+        /* A poll request on a socket that was closed without telling
+           the poller (like the one for DNS queries) may still be in
+           flight, as io_uring keeps the socket alive, and it must not
+           complete for a context that's gone.
+         */
+        pbntf_lost_socket(pb);
+    }
+#endif
+}
+
+
+#if PUBNUB_USE_CONNECTION_POOL
+void pbpal_detach_connection(pubnub_t* pb, struct pbpal_pooled_connection* conn)
+{
+    conn->socket   = pb->pal.socket;
+    conn->tls      = NULL;
+    pb->pal.socket = SOCKET_INVALID;
+    pb->sock_state = STATE_NONE;
+}
+
+
+void pbpal_attach_connection(
+    pubnub_t*                             pb,
+    struct pbpal_pooled_connection const* conn)
+{
+    PUBNUB_ASSERT_OPT(SOCKET_INVALID == pb->pal.socket);
+    pb->pal.socket = conn->socket;
+    pb->sock_state = STATE_NONE;
+    pb->unreadlen  = 0;
+#if PUBNUB_RECEIVE_READ_AHEAD
+    read_ahead_discard(pb);
+#endif
+    /* Whoever had it before might have had different blocking I/O */
+    pbpal_set_blocking_io(pb);
+}
+
+
+void pbpal_close_detached_connection(struct pbpal_pooled_connection* conn)
+{
+    socket_close(conn->socket);
+    conn->socket = SOCKET_INVALID;
 }
+#endif /* PUBNUB_USE_CONNECTION_POOL */
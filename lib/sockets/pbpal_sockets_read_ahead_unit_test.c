@@ -0,0 +1,249 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "core/pbpal.h"
+#include "core/pubnub_assert.h"
+
+#include "cgreen/cgreen.h"
+#include "cgreen/mocks.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define attest assert_that
+#define equals is_equal_to
+#define streqs is_equal_to_string
+
+
+#if !PUBNUB_RECEIVE_READ_AHEAD
+#error Build this test with PUBNUB_RECEIVE_READ_AHEAD=1
+#endif
+
+
+/* What the sockets PAL uses from the rest of the library */
+
+int pbntf_init(pubnub_t* pb)
+{
+    (void)pb;
+    return 0;
+}
+
+void pbntf_lost_socket(pubnub_t* pb) { (void)pb; }
+
+#if PUBNUB_USE_MULTIPLE_ADDRESSES
+void pbpal_multiple_addresses_reset_counters(
+    struct pubnub_multi_addresses* spare_addresses)
+{
+    (void)spare_addresses;
+}
+#endif
+
+enum pubnub_res pbpal_handle_socket_error(
+    int         socket_result,
+    pubnub_t*   pb,
+    char const* file,
+    int         line)
+{
+    (void)pb;
+    (void)file;
+    (void)line;
+    if ((socket_result < 0) && socket_would_block()) { return PNR_IN_PROGRESS; }
+    return (0 == socket_result) ? PNR_TIMEOUT : PNR_IO_ERROR;
+}
+
+
+static pubnub_t* m_pb;
+
+/** The other end of the connection of `m_pb` */
+static int m_peer;
+
+
+/** Makes the peer send @p s (as one segment, if it fits) */
+static void peer_sends(char const* s)
+{
+    size_t const len = strlen(s);
+    attest(send(m_peer, s, len, 0), equals(len));
+}
+
+
+/** Maximum number of times to try to finish a read, as the
+    read-ahead buffer may be (re)filled a few times for it */
+#define MAX_TRIES 8
+
+
+/** Reads a line on `m_pb`, returning the result of the read */
+static enum pubnub_res read_line(void)
+{
+    enum pubnub_res rslt;
+    int             i = 0;
+
+    pbpal_start_read_line(m_pb);
+    do {
+        rslt = pbpal_line_read_status(m_pb);
+    } while ((PNR_IN_PROGRESS == rslt) && (++i < MAX_TRIES));
+
+    return rslt;
+}
+
+
+/** The line (or data) read last on `m_pb`, as a string */
+static char const* got(void)
+{
+    static char s[PUBNUB_BUF_MAXLEN + 1];
+    int const   len = pbpal_read_len(m_pb);
+
+    memcpy(s, m_pb->core.http_buf, len);
+    s[len] = '\0';
+    return s;
+}
+
+
+/** Reads @p n octets (the body) on `m_pb` */
+static enum pubnub_res read_body(size_t n)
+{
+    enum pubnub_res rslt;
+    int             i = 0;
+
+    pbpal_start_read(m_pb, n);
+    do {
+        rslt = pbpal_read_status(m_pb);
+    } while ((PNR_IN_PROGRESS == rslt) && (++i < MAX_TRIES));
+
+    return rslt;
+}
+
+
+Describe(pbpal_sockets_read_ahead);
+
+BeforeEach(pbpal_sockets_read_ahead)
+{
+    int sv[2];
+
+    m_pb = (pubnub_t*)calloc(1, sizeof *m_pb);
+    attest(m_pb != NULL);
+    pbpal_init(m_pb);
+    attest(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), equals(0));
+    attest(fcntl(sv[0], F_SETFL, O_NONBLOCK), equals(0));
+    m_pb->pal.socket = sv[0];
+    m_peer           = sv[1];
+}
+
+AfterEach(pbpal_sockets_read_ahead)
+{
+    pbpal_close(m_pb);
+    close(m_peer);
+    free(m_pb);
+    m_pb = NULL;
+}
+
+
+Ensure(pbpal_sockets_read_ahead, reads_lines_received_together)
+{
+    peer_sends("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n[]");
+
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("HTTP/1.1 200 OK\r\n"));
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("Content-Length: 2\r\n"));
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("\r\n"));
+    attest(read_body(2), equals(PNR_OK));
+    attest(got(), streqs("[]"));
+
+    /* All of it was taken */
+    attest(m_pb->read_ahead_pos, equals(m_pb->read_ahead_len));
+    attest(read_line(), equals(PNR_IN_PROGRESS));
+}
+
+
+Ensure(pbpal_sockets_read_ahead, reads_reply_split_across_reads)
+{
+    peer_sends("HTTP/1.1 2");
+    attest(read_line(), equals(PNR_IN_PROGRESS));
+
+    peer_sends("00 OK\r\nContent-Le");
+    attest(pbpal_line_read_status(m_pb), equals(PNR_OK));
+    attest(got(), streqs("HTTP/1.1 200 OK\r\n"));
+    attest(read_line(), equals(PNR_IN_PROGRESS));
+
+    peer_sends("ngth: 11\r\n\r\n[1,");
+    attest(pbpal_line_read_status(m_pb), equals(PNR_OK));
+    attest(got(), streqs("Content-Length: 11\r\n"));
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("\r\n"));
+    attest(read_body(11), equals(PNR_IN_PROGRESS));
+
+    peer_sends("\"a\",");
+    attest(pbpal_read_status(m_pb), equals(PNR_IN_PROGRESS));
+    peer_sends("\"b\"]");
+    attest(pbpal_read_status(m_pb), equals(PNR_OK));
+    attest(got(), streqs("[1,\"a\",\"b\"]"));
+}
+
+
+Ensure(pbpal_sockets_read_ahead, keeps_leftover_for_the_next_response)
+{
+    /* Two (pipelined) responses arrive together */
+    peer_sends("HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\n[1]"
+               "HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\n[2]");
+
+    attest(read_line(), equals(PNR_OK));
+    attest(read_line(), equals(PNR_OK));
+    attest(read_line(), equals(PNR_OK));
+    attest(read_body(3), equals(PNR_OK));
+    attest(got(), streqs("[1]"));
+
+    /* The peer is done, the second one is read from what's left */
+    shutdown(m_peer, SHUT_WR);
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("HTTP/1.1 200 OK\r\n"));
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("Content-Length: 3\r\n"));
+    attest(read_line(), equals(PNR_OK));
+    attest(read_body(3), equals(PNR_OK));
+    attest(got(), streqs("[2]"));
+
+    /* Only then does it get to the connection */
+    attest(read_line(), equals(PNR_TIMEOUT));
+}
+
+
+Ensure(pbpal_sockets_read_ahead, keeps_leftover_past_its_buffer)
+{
+    /* More than fits in the read-ahead buffer at once */
+    char reply[PUBNUB_READ_AHEAD_BUF_SIZE * 3];
+    char body[PUBNUB_READ_AHEAD_BUF_SIZE * 2];
+
+    memset(body, 'x', sizeof body - 1);
+    body[sizeof body - 1] = '\0';
+    snprintf(reply,
+             sizeof reply,
+             "HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n%sHTTP/1.1 204\r\n",
+             (unsigned)strlen(body),
+             body);
+    peer_sends(reply);
+
+    attest(read_line(), equals(PNR_OK));
+    attest(read_line(), equals(PNR_OK));
+    attest(read_line(), equals(PNR_OK));
+    attest(read_body(strlen(body)), equals(PNR_OK));
+    attest(got(), streqs(body));
+    attest(read_line(), equals(PNR_OK));
+    attest(got(), streqs("HTTP/1.1 204\r\n"));
+}
+
+
+Ensure(pbpal_sockets_read_ahead, drops_leftover_when_closed)
+{
+    peer_sends("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+
+    attest(read_line(), equals(PNR_OK));
+    attest(m_pb->read_ahead_pos < m_pb->read_ahead_len);
+    pbpal_close(m_pb);
+    attest(m_pb->read_ahead_pos, equals(0));
+    attest(m_pb->read_ahead_len, equals(0));
+}
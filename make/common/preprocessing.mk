@@ -22,6 +22,7 @@ DEFINES_COMMON = \
     $(OPTION_PREFIX)D PUBNUB_USE_ACTIONS_API=$(USE_ACTIONS_API)                       \
     $(OPTION_PREFIX)D PUBNUB_USE_ADVANCED_HISTORY=$(USE_ADVANCED_HISTORY)             \
     $(OPTION_PREFIX)D PUBNUB_USE_AUTO_HEARTBEAT=$(USE_AUTO_HEARTBEAT)                 \
+    $(OPTION_PREFIX)D PUBNUB_USE_CONNECTION_POOL=$(USE_CONNECTION_POOL)               \
     $(OPTION_PREFIX)D PUBNUB_USE_FETCH_HISTORY=$(USE_FETCH_HISTORY)                   \
     $(OPTION_PREFIX)D PUBNUB_USE_GRANT_TOKEN_API=$(USE_GRANT_TOKEN)                   \
     $(OPTION_PREFIX)D PUBNUB_USE_GZIP_COMPRESSION=$(USE_GZIP_COMPRESSION)             \
@@ -41,9 +42,11 @@ CPPFLAGS = $(strip $(CPPFLAGS_))
 
 # Preprocessing flags for PubNub library with callback interface.
 CALLBACK_CPPFLAGS_ = \
-	$(CPPFLAGS)                                                 \
-	$(OPTION_PREFIX)D PUBNUB_CALLBACK_API                       \
-	$(OPTION_PREFIX)D PUBNUB_SET_DNS_SERVERS=$(USE_DNS_SERVERS)
+	$(CPPFLAGS)                                                     \
+	$(OPTION_PREFIX)D PUBNUB_CALLBACK_API                           \
+	$(OPTION_PREFIX)D PUBNUB_SET_DNS_SERVERS=$(USE_DNS_SERVERS)     \
+	$(OPTION_PREFIX)D PUBNUB_USE_PIPELINING=$(USE_PIPELINING)       \
+	$(OPTION_PREFIX)D PUBNUB_USE_PUBLISH_QUEUE=$(USE_PUBLISH_QUEUE)
 CALLBACK_CPPFLAGS = $(strip $(CALLBACK_CPPFLAGS_))
 
 # Preprocessing flags for PubNub library with NTF runtime selection.
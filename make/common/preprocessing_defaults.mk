@@ -53,6 +53,20 @@ DEFAULT_USE_CRYPTO_API = 0
 # Whether message persistence feature should be enabled or not.
 DEFAULT_USE_FETCH_HISTORY = 1
 
+# Whether HTTP/1.1 request pipelining should be enabled or not.
+#
+# Important: This feature can be used ONLY for build with callback interface.
+DEFAULT_USE_PIPELINING = 0
+
+# Whether per-context publish queue should be enabled or not.
+#
+# Important: This feature can be used ONLY for build with callback interface.
+DEFAULT_USE_PUBLISH_QUEUE = 0
+
+# Whether HTTP keep-alive connections should be shared between contexts through
+# a process-wide pool or not.
+DEFAULT_USE_CONNECTION_POOL = 0
+
 # Whether grant token permissions feature should be enabled or not.
 DEFAULT_USE_GRANT_TOKEN = 0
 
@@ -62,6 +76,29 @@ DEFAULT_USE_GZIP_COMPRESSION = 1
 # Whether IPv6 connection should be supported or not.
 DEFAULT_USE_IPV6 = 1
 
+# Whether epoll should be used to watch sockets in callback interface or not.
+#
+# Important: This feature can be used ONLY on Linux.
+DEFAULT_USE_EPOLL = 0
+
+# Whether io_uring should be used to watch sockets in callback interface or not.
+#
+# Note: Data is sent and received with io_uring too, without a system call per
+# `send()`/`recv()`.
+#
+# Important: This feature can be used ONLY on Linux (5.11 or later) and not
+# together with `USE_EPOLL`.
+DEFAULT_USE_IO_URING = 0
+
+# Whether callback interface timers should use timing wheel or not.
+DEFAULT_USE_TIMER_WHEEL = 0
+
+# Number of polling threads used by callback interface.
+DEFAULT_CALLBACK_THREAD_COUNT = 1
+
+# Whether callback interface polling threads should be bound to CPUs or not.
+DEFAULT_CALLBACK_THREAD_AFFINITY = 0
+
 # Whether to use random IV for legacy crypto module or not.
 DEFAULT_USE_LEGACY_CRYPTO_RANDOM_IV = 1
 
@@ -39,7 +39,8 @@ CORE_SOURCE_FILES_POSIX = \
     ../posix/pb_sleep_ms.c                            \
     ../posix/pbtimespec_elapsed_ms.c                  \
     ../posix/posix_socket_blocking_io.c               \
-    ../posix/pubnub_generate_uuid_posix.c
+    ../posix/pubnub_generate_uuid_posix.c             \
+    ../lib/sockets/pbpal_ntf_callback_wakeup.c
 
 # `CORE_SOURCE_FILES` extension for Windows build.
 CORE_SOURCE_FILES_WINDOWS = \
@@ -112,9 +113,10 @@ CORE_OPENSSL_SOURCE_FILES_WINDOWS = \
 
 # Core source files for a synchronous PubNub C-core client version support.
 SYNC_CORE_SOURCE_FILES = \
-    ../core/pubnub_ntf_sync.c            \
-    ../core/pubnub_sync_subscribe_loop.c \
-    ../core/srand_from_pubnub_time.c
+    ../core/pubnub_ntf_sync.c                    \
+    ../core/pubnub_sync_subscribe_loop.c         \
+    ../core/srand_from_pubnub_time.c             \
+    ../lib/sockets/pbpal_ntf_sync_wait_sockets.c
 
 
 ###############################################################################
@@ -128,10 +130,26 @@ CALLBACK_CORE_SOURCE_FILES = \
     ../core/pbpal_ntf_callback_queue.c              \
     ../core/pubnub_callback_subscribe_loop.c        \
     ../core/pubnub_timer_list.c                     \
+    ../core/pubnub_timer_wheel.c                    \
     ../lib/pubnub_dns_codec.c                       \
-    ../lib/sockets/pbpal_adns_sockets.c             \
+    ../lib/sockets/pbpal_adns_sockets.c
+
+# `CALLBACK_CORE_SOURCE_FILES` extension with poll() based sockets poller.
+CALLBACK_CORE_POLL_SOURCE_FILES = \
     ../lib/sockets/pbpal_ntf_callback_poller_poll.c
 
+# `CALLBACK_CORE_SOURCE_FILES` extension with epoll() based sockets poller.
+#
+# Important: Can be used only on Linux.
+CALLBACK_CORE_EPOLL_SOURCE_FILES = \
+    ../lib/sockets/pbpal_ntf_callback_poller_epoll.c
+
+# `CALLBACK_CORE_SOURCE_FILES` extension with io_uring based sockets poller.
+#
+# Important: Can be used only on Linux (5.11 or later).
+CALLBACK_CORE_IO_URING_SOURCE_FILES = \
+    ../lib/sockets/pbpal_ntf_callback_poller_uring.c
+
 # `CALLBACK_CORE_SOURCE_FILES` extension without OpenSSL support used for all
 # platforms.
 CALLBACK_CORE_NON_OPENSSL_SOURCE_FILES =
@@ -268,6 +286,18 @@ DNS_SERVERS_SOURCE_FILES_POSIX = \
 DNS_SERVERS_SOURCE_FILES_WINDOWS = \
     ../windows/pubnub_dns_system_servers.c
 
+# HTTP/1.1 request pipelining feature source files.
+#
+# Important: Can be used only together with `PUBNUB_CALLBACK_API` flag.
+PIPELINING_SOURCE_FILES = \
+    ../core/pubnub_pipelining.c
+
+# Per-context publish queue feature source files.
+#
+# Important: Can be used only together with `PUBNUB_CALLBACK_API` flag.
+PUBLISH_QUEUE_SOURCE_FILES = \
+    ../core/pubnub_publish_queue.c
+
 # Windows OS DNS resolver (DnsQueryEx) support for callback API.
 # Falls back to the OS resolver when no custom DNS servers are configured.
 DNS_QUERY_EX_SOURCE_FILES_WINDOWS = \
@@ -292,6 +322,11 @@ FETCH_HISTORY_SOURCE_FILES = \
     ../core/pubnub_fetch_history.c
 
 
+# Shared HTTP keep-alive connection pool feature source files.
+CONNECTION_POOL_SOURCE_FILES = \
+    ../core/pubnub_connection_pool.c
+
+
 # Grant token permissions feature source files.
 GRANT_TOKEN_SOURCE_FILES = \
     ../core/pbcc_grant_token_api.c      \
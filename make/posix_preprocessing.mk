@@ -90,9 +90,23 @@ endif
 # Important: This feature can be used ONLY for build with callback interface.
 USE_DNS_SERVERS ?= $(USE_CALLBACK_API)
 
+# Whether HTTP/1.1 request pipelining should be enabled or not.
+#
+# Important: This feature can be used ONLY for build with callback interface.
+USE_PIPELINING ?= $(DEFAULT_USE_PIPELINING)
+
+# Whether per-context publish queue should be enabled or not.
+#
+# Important: This feature can be used ONLY for build with callback interface.
+USE_PUBLISH_QUEUE ?= $(DEFAULT_USE_PUBLISH_QUEUE)
+
 # Whether message persistence feature should be enabled or not.
 USE_FETCH_HISTORY ?= $(DEFAULT_USE_FETCH_HISTORY)
 
+# Whether HTTP keep-alive connections should be shared between contexts through
+# a process-wide pool or not.
+USE_CONNECTION_POOL ?= $(DEFAULT_USE_CONNECTION_POOL)
+
 # Whether grant token permissions feature should be enabled or not.
 #
 # Important: This feature can be used ONLY for build with OpenSSL.
@@ -111,6 +125,41 @@ USE_GZIP_COMPRESSION ?= $(DEFAULT_USE_GZIP_COMPRESSION)
 # Whether IPv6 connection should be supported or not.
 USE_IPV6 ?= $(DEFAULT_USE_IPV6)
 
+# Whether epoll should be used to watch sockets in callback interface or not.
+#
+# Important: This feature can be used ONLY on Linux.
+USE_EPOLL ?= $(DEFAULT_USE_EPOLL)
+ifeq ($(USE_EPOLL), 1)
+	ifneq ($(shell uname),Linux)
+    	$(error "You can't use epoll on non-Linux system!")
+	endif
+endif
+
+# Whether io_uring should be used to watch sockets in callback interface or not.
+#
+# Important: This feature can be used ONLY on Linux (5.11 or later) and not
+# together with `USE_EPOLL`.
+USE_IO_URING ?= $(DEFAULT_USE_IO_URING)
+ifeq ($(USE_IO_URING), 1)
+	ifneq ($(shell uname),Linux)
+    	$(error "You can't use io_uring on non-Linux system!")
+	endif
+	ifeq ($(USE_EPOLL), 1)
+    	$(error "You can't use both epoll and io_uring at the same time!")
+	endif
+endif
+
+# Whether callback interface timers should use timing wheel or not.
+USE_TIMER_WHEEL ?= $(DEFAULT_USE_TIMER_WHEEL)
+
+# Number of polling threads used by callback interface.
+CALLBACK_THREAD_COUNT ?= $(DEFAULT_CALLBACK_THREAD_COUNT)
+
+# Whether callback interface polling threads should be bound to CPUs or not.
+#
+# Note: Ignored on non-Linux systems.
+CALLBACK_THREAD_AFFINITY ?= $(DEFAULT_CALLBACK_THREAD_AFFINITY)
+
 # Whether to use random IV for legacy crypto module or not.
 #
 # Important: This feature can be used ONLY for build with OpenSSL.
@@ -238,7 +287,11 @@ PREREQUISITES = $^
 # Included public headers.
 INCLUDES_PLATFORM = -I../lib/base64
 
-DEFINES_PLATFORM =
+DEFINES_PLATFORM = -D PUBNUB_USE_EPOLL=$(USE_EPOLL) \
+    -D PUBNUB_USE_IO_URING=$(USE_IO_URING) \
+    -D PUBNUB_USE_TIMER_WHEEL=$(USE_TIMER_WHEEL) \
+    -D PUBNUB_CALLBACK_THREAD_COUNT=$(CALLBACK_THREAD_COUNT) \
+    -D PUBNUB_CALLBACK_THREAD_AFFINITY=$(CALLBACK_THREAD_AFFINITY)
 DEFINES_EXTERN_C =
 ifeq ($(WITH_CPP),1)
     ifeq ($(USE_EXTERN_API),1)
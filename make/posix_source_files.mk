@@ -17,6 +17,13 @@ SYNC_SOURCE_FILES = $(SYNC_CORE_SOURCE_FILES)
 
 # Source files for a call-back based PubNub C-core client version support.
 CALLBACK_SOURCE_FILES = $(CALLBACK_CORE_SOURCE_FILES)
+ifeq ($(USE_EPOLL), 1)
+    CALLBACK_SOURCE_FILES += $(CALLBACK_CORE_EPOLL_SOURCE_FILES)
+else ifeq ($(USE_IO_URING), 1)
+    CALLBACK_SOURCE_FILES += $(CALLBACK_CORE_IO_URING_SOURCE_FILES)
+else
+    CALLBACK_SOURCE_FILES += $(CALLBACK_CORE_POLL_SOURCE_FILES)
+endif
 
 # Source files for a ntf runtime selection based PubNub C-core client version support.
 NTF_RUNTIME_SELECTION_SOURCE_FILES = $(NTF_RUNTIME_SELECTION_CORE_SOURCE_FILES)
@@ -120,11 +127,30 @@ ifneq ($(filter 1,$(USE_DNS_SERVERS) $(USE_PROXY)),)
     endif
 endif
 
+# HTTP/1.1 request pipelining feature source files.
+#
+# Important: Can be used only together with `PUBNUB_CALLBACK_API` flag.
+ifeq ($(USE_PIPELINING), 1)
+    CALLBACK_SOURCE_FILES += $(PIPELINING_SOURCE_FILES)
+endif
+
+# Per-context publish queue feature source files.
+#
+# Important: Can be used only together with `PUBNUB_CALLBACK_API` flag.
+ifeq ($(USE_PUBLISH_QUEUE), 1)
+    CALLBACK_SOURCE_FILES += $(PUBLISH_QUEUE_SOURCE_FILES)
+endif
+
 # Single channel history feature source files.
 ifeq ($(USE_FETCH_HISTORY), 1)
     SOURCE_FILES += $(FETCH_HISTORY_SOURCE_FILES)
 endif
 
+# Shared HTTP keep-alive connection pool feature source files.
+ifeq ($(USE_CONNECTION_POOL), 1)
+    SOURCE_FILES += $(CONNECTION_POOL_SOURCE_FILES)
+endif
+
 # Grant token permissions feature source files.
 ifeq ($(and $(OPENSSL),$(USE_GRANT_TOKEN)), 1)
     SOURCE_FILES += $(GRANT_TOKEN_SOURCE_FILES)
@@ -143,11 +143,31 @@ USE_CRYPTO_API = $(DEFAULT_USE_CRYPTO_API)
 USE_DNS_SERVERS = $(USE_CALLBACK_API)
 !endif
 
+# Whether HTTP/1.1 request pipelining should be enabled or not.
+#
+# Important: This feature can be used ONLY for build with callback interface.
+!ifndef USE_PIPELINING
+USE_PIPELINING = $(DEFAULT_USE_PIPELINING)
+!endif
+
+# Whether per-context publish queue should be enabled or not.
+#
+# Important: This feature can be used ONLY for build with callback interface.
+!ifndef USE_PUBLISH_QUEUE
+USE_PUBLISH_QUEUE = $(DEFAULT_USE_PUBLISH_QUEUE)
+!endif
+
 # Whether message persistence feature should be enabled or not.
 !ifndef USE_FETCH_HISTORY
 USE_FETCH_HISTORY = $(DEFAULT_USE_FETCH_HISTORY)
 !endif
 
+# Whether HTTP keep-alive connections should be shared between contexts through
+# a process-wide pool or not.
+!ifndef USE_CONNECTION_POOL
+USE_CONNECTION_POOL = $(DEFAULT_USE_CONNECTION_POOL)
+!endif
+
 # Whether grant token permissions feature should be enabled or not.
 #
 # Important: This feature can be used ONLY for build with OpenSSL.
@@ -16,7 +16,7 @@ SOURCE_FILES_ = $(CORE_SOURCE_FILES) $(CORE_SOURCE_FILES_WINDOWS)
 SYNC_SOURCE_FILES_ = $(SYNC_CORE_SOURCE_FILES)
 
 # Source files for a call-back based PubNub C-core client version support.
-CALLBACK_SOURCE_FILES_ = $(CALLBACK_CORE_SOURCE_FILES)
+CALLBACK_SOURCE_FILES_ = $(CALLBACK_CORE_SOURCE_FILES) $(CALLBACK_CORE_POLL_SOURCE_FILES)
 
 # Source files for a ntf runtime selection based PubNub C-core client version support.
 NTF_RUNTIME_SELECTION_SOURCE_FILES_ = $(NTF_RUNTIME_SELECTION_CORE_SOURCE_FILES)
@@ -134,6 +134,24 @@ CALLBACK_SOURCE_FILES_ = \
 !endif
 !endif
 
+# HTTP/1.1 request pipelining feature source files.
+#
+# Important: Can be used only together with `PUBNUB_CALLBACK_API` flag.
+!if $(USE_PIPELINING)
+CALLBACK_SOURCE_FILES_ = \
+    $(CALLBACK_SOURCE_FILES_) \
+    $(PIPELINING_SOURCE_FILES)
+!endif
+
+# Per-context publish queue feature source files.
+#
+# Important: Can be used only together with `PUBNUB_CALLBACK_API` flag.
+!if $(USE_PUBLISH_QUEUE)
+CALLBACK_SOURCE_FILES_ = \
+    $(CALLBACK_SOURCE_FILES_) \
+    $(PUBLISH_QUEUE_SOURCE_FILES)
+!endif
+
 # Windows OS DNS resolver (DnsQueryEx) for callback API.
 CALLBACK_SOURCE_FILES_ = \
     $(CALLBACK_SOURCE_FILES_)              \
@@ -146,6 +164,13 @@ SOURCE_FILES_ = \
     $(FETCH_HISTORY_SOURCE_FILES)
 !endif
 
+# Shared HTTP keep-alive connection pool feature source files.
+!if $(USE_CONNECTION_POOL)
+SOURCE_FILES_ = \
+    $(SOURCE_FILES_)                \
+    $(CONNECTION_POOL_SOURCE_FILES)
+!endif
+
 # Grant token permissions feature source files.
 !if "$(OPENSSL)" == "1" && "$(USE_GRANT_TOKEN)" == "1"
 SOURCE_FILES_ = \
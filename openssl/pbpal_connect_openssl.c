@@ -320,7 +320,22 @@ enum pbpal_tls_result pbpal_start_tls(pubnub_t* pb)
             pb, "Hostname verification configured for: '%s'", hostname);
     }
     PUBNUB_LOG_TRACE(pb, "SSL configuration completed.");
+#if PUBNUB_USE_IO_URING
+    /* The io_uring poller does the I/O, OpenSSL does TLS in memory */
+    {
+        BIO* rbio = BIO_new(BIO_s_mem());
+        BIO* wbio = BIO_new(BIO_s_mem());
+        if ((NULL == rbio) || (NULL == wbio)) {
+            BIO_free(rbio);
+            BIO_free(wbio);
+            PUBNUB_LOG_ERROR(pb, "Memory BIO creation failed.");
+            return pbtlsResourceFailure;
+        }
+        SSL_set_bio(ssl, rbio, wbio);
+    }
+#else
     SSL_set_fd(ssl, pb->pal.socket);
+#endif
     PUBNUB_LOG_DEBUG(
         pb,
         pb->options.use_blocking_io ? "Using blocking IO"
@@ -337,6 +352,20 @@ enum pbpal_tls_result pbpal_start_tls(pubnub_t* pb)
     return pbpal_check_tls(pb);
 }
 
+/** Whether to wait for the socket of @p pb to be ready, while the
+    TLS handshake is in progress. Not with io_uring, the poller
+    receives all there is and OpenSSL doesn't touch the socket.
+ */
+static bool wait_for_socket(pubnub_t* pb)
+{
+#if PUBNUB_USE_IO_URING && defined(PUBNUB_NTF_RUNTIME_SELECTION)
+    return PNA_SYNC == pb->api_policy;
+#else
+    PUBNUB_UNUSED(pb);
+    return !PUBNUB_USE_IO_URING;
+#endif
+}
+
 /** Called after 'pbpal_start_tls()'. Does necessary arrangements called
    repeatedly, if necessary, until TLS/SSL platform connection is established,
    or failed to establish.
@@ -360,7 +389,7 @@ enum pbpal_tls_result pbpal_check_tls(pubnub_t* pb)
        does for TCP connect. In callback mode the socket is already ready
        when the FSM fires, so select() returns immediately. */
     if (PBS_WAIT_TLS_CONNECT == pb->state
-        && 0 != pb->pal.tls_connect_last_error) {
+        && 0 != pb->pal.tls_connect_last_error && wait_for_socket(pb)) {
         const bool want_read =
             (SSL_ERROR_WANT_READ == pb->pal.tls_connect_last_error);
 
@@ -399,7 +428,9 @@ enum pbpal_tls_result pbpal_check_tls(pubnub_t* pb)
     }
 
     bool needRead = false, needWrite = false;
-    rslt = SSL_connect(ssl);
+    do {
+        rslt = SSL_connect(ssl);
+    } while (pbpal_tls_pump(pb, rslt));
     rslt = pbpal_handle_socket_condition(
         rslt, pb, __FILE__, __LINE__, &needRead, &needWrite);
     if (PNR_OK != rslt) {
@@ -31,6 +31,13 @@ __inline int pubnub_InitCriticalSection(_Out_ LPCRITICAL_SECTION lpCS) {
 #define pbpal_thread_id() DONT_CALL_ME_ON_WINDOWS_
 #define pbpal_mutex_init_std(m) InitializeCriticalSection(&(m))
 
+typedef CONDITION_VARIABLE pbpal_cond_t;
+
+#define pbpal_cond_init(c) InitializeConditionVariable(&(c))
+#define pbpal_cond_wait(c, m) SleepConditionVariableCS(&(c), &(m), INFINITE)
+#define pbpal_cond_broadcast(c) WakeAllConditionVariable(&(c))
+#define pbpal_cond_destroy(c)
+
 #else
 
 #include <pthread.h>
@@ -66,6 +73,13 @@ typedef pthread_mutex_t pbpal_mutex_t;
 #define pbpal_thread_id() pthread_self()
 #define pbpal_mutex_init_std(m)  pthread_mutex_init(&(m), NULL)
 
+typedef pthread_cond_t pbpal_cond_t;
+
+#define pbpal_cond_init(c) pthread_cond_init(&(c), NULL)
+#define pbpal_cond_wait(c, m) pthread_cond_wait(&(c), &(m))
+#define pbpal_cond_broadcast(c) pthread_cond_broadcast(&(c))
+#define pbpal_cond_destroy(c) pthread_cond_destroy(&(c))
+
 #endif /* defined(_WIN32) */
 
 
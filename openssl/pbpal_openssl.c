@@ -7,6 +7,9 @@
 #include "core/pubnub_ntf_sync.h"
 #include "core/pubnub_netcore.h"
 #include "core/pubnub_assert.h"
+#if PUBNUB_USE_CONNECTION_POOL
+#include "core/pbconn_pool.h"
+#endif
 #if defined(_WIN32) && defined(PUBNUB_CALLBACK_API)
 #include "windows/pbpal_dns_query_ex.h"
 #endif
@@ -45,6 +48,206 @@ static void buf_setup(pubnub_t* pb)
 }
 
 
+#if PUBNUB_USE_IO_URING
+/** Sends like socket_send() does, but through the io_uring poller,
+    if @p pb can do that: copies as much as fits in the poller's
+    buffer, and it's sent from there.
+ */
+static int pal_send(pubnub_t* pb, void const* data, size_t n)
+{
+    uint8_t* buf;
+    int      rslt = pbntf_uring_send_buffer(pb, &buf);
+
+    if (PBNTF_URING_NO_IO == rslt) {
+        return socket_send(pb->pal.socket, (char*)data, n);
+    }
+    if (rslt > 0) {
+        if ((size_t)rslt > n) { rslt = (int)n; }
+        memcpy(buf, data, rslt);
+        pbntf_uring_send(pb, rslt);
+    }
+
+    return rslt;
+}
+
+
+/** Receives like socket_recv() does, but through the io_uring poller,
+    if @p pb can do that.
+ */
+static int pal_recv(pubnub_t* pb, void* data, size_t n)
+{
+    uint8_t const* buf;
+    int            rslt = pbntf_uring_recv_buffer(pb, &buf, n);
+
+    if (PBNTF_URING_NO_IO == rslt) {
+        return socket_recv(pb->pal.socket, (char*)data, n, 0);
+    }
+    if (rslt > 0) {
+        if ((size_t)rslt > n) { rslt = (int)n; }
+        memcpy(data, buf, rslt);
+        pbntf_uring_recv_consume(pb, rslt);
+    }
+
+    return rslt;
+}
+
+
+/* With io_uring, the poller does the sending and receiving, so,
+   OpenSSL does TLS in memory: it takes what was received from its
+   "read" BIO and puts what's to be sent in its "write" BIO (see
+   pbpal_start_tls()). We move the data between those and the
+   poller's buffers.
+ */
+
+/** Makes OpenSSL see the end of the connection, to fail the TLS
+    operation that's waiting for more data
+ */
+static void tls_set_eof(pubnub_t* pb)
+{
+    BIO_set_mem_eof_return(SSL_get_rbio(pb->pal.ssl), 0);
+}
+
+
+/** Sends as much of what OpenSSL has to send as the poller takes */
+static void tls_flush(pubnub_t* pb)
+{
+    BIO*  wbio = SSL_get_wbio(pb->pal.ssl);
+    char* data;
+    long  len;
+
+    while ((len = BIO_get_mem_data(wbio, &data)) > 0) {
+        uint8_t* buf;
+        int      n = pbntf_uring_send_buffer(pb, &buf);
+
+        if (PBNTF_URING_NO_IO == n) {
+            char discard[1024];
+            n = socket_send(pb->pal.socket, data, len);
+            for (len = n; len > 0; len -= sizeof discard) {
+                BIO_read(wbio,
+                         discard,
+                         (len < (long)sizeof discard) ? len : sizeof discard);
+            }
+        }
+        else if (n > 0) {
+            n = BIO_read(wbio, buf, (len < n) ? len : n);
+            pbntf_uring_send(pb, n);
+        }
+        if (n < 0) {
+            /* If busy, it's sent later, on the next TLS operation */
+            if (!socket_would_block()) { tls_set_eof(pb); }
+            return;
+        }
+    }
+}
+
+
+/** Gives OpenSSL what was received, if anything.
+    @return The same as socket_recv()
+ */
+static int tls_fill(pubnub_t* pb)
+{
+    BIO*           rbio = SSL_get_rbio(pb->pal.ssl);
+    uint8_t const* buf;
+    int            n = pbntf_uring_recv_buffer(pb, &buf, SIZE_MAX);
+
+    if (PBNTF_URING_NO_IO == n) {
+        uint8_t tmp[4096];
+        n = socket_recv(pb->pal.socket, (char*)tmp, sizeof tmp, 0);
+        if (n > 0) { BIO_write(rbio, tmp, n); }
+    }
+    else if (n > 0) {
+        BIO_write(rbio, buf, n);
+        pbntf_uring_recv_consume(pb, n);
+    }
+    if ((0 == n) || ((n < 0) && !socket_would_block())) { tls_set_eof(pb); }
+
+    return n;
+}
+
+
+bool pbpal_tls_pump(pubnub_t* pb, int rslt)
+{
+    bool const want_read =
+        (rslt <= 0) && (SSL_ERROR_WANT_READ == SSL_get_error(pb->pal.ssl, rslt));
+
+    tls_flush(pb);
+    if (!want_read) { return false; }
+    /* On end of connection, or error, OpenSSL has to see it */
+    return (tls_fill(pb) >= 0) || !socket_would_block();
+}
+#else
+#define pal_send(pb, data, n) socket_send((pb)->pal.socket, (char*)(data), (n))
+#define pal_recv(pb, data, n)                                                  \
+    socket_recv((pb)->pal.socket, (char*)(data), (n), 0)
+#endif /* PUBNUB_USE_IO_URING */
+
+
+#if PUBNUB_RECEIVE_READ_AHEAD
+static int receive(pubnub_t* pb, uint8_t* buf, unsigned n)
+{
+    int rslt;
+
+    if (NULL == pb->pal.ssl) { return pal_recv(pb, buf, n); }
+    do {
+        rslt = SSL_read(pb->pal.ssl, buf, n);
+    } while (pbpal_tls_pump(pb, rslt));
+
+    return rslt;
+}
+
+
+static void read_ahead_discard(pubnub_t* pb)
+{
+    pb->read_ahead_pos = pb->read_ahead_len = 0;
+}
+
+
+/** Receives into the (empty) read-ahead buffer of @p pb as much as
+    there is, up to its size. Returns the same as receive().
+ */
+static int read_ahead_fill(pubnub_t* pb)
+{
+    int recvres;
+
+    PUBNUB_ASSERT_OPT(pb->read_ahead_pos == pb->read_ahead_len);
+    recvres            = receive(pb, pb->read_ahead, sizeof pb->read_ahead);
+    pb->read_ahead_pos = 0;
+    pb->read_ahead_len = (recvres > 0) ? (uint16_t)recvres : 0;
+    if (recvres > 0) {
+        PUBNUB_LOG_TRACE(pb, "%d bytes received (read ahead).", recvres);
+    }
+
+    return recvres;
+}
+
+
+/** Moves up to @p n octets from the read-ahead buffer of @p pb to
+    the read buffer (at `ptr`), as many as there are and fit. If
+    @p line, stops after the first newline.
+
+    @return The number of octets moved
+ */
+static unsigned read_ahead_take(pubnub_t* pb, unsigned n, bool line)
+{
+    uint8_t const* start = pb->read_ahead + pb->read_ahead_pos;
+    unsigned const avail = pb->read_ahead_len - pb->read_ahead_pos;
+
+    if (n > avail) { n = avail; }
+    if (n > pb->left) { n = pb->left; }
+    if (line) {
+        uint8_t const* nl = (uint8_t const*)memchr(start, '\n', n);
+        if (nl != NULL) { n = (unsigned)(nl - start) + 1; }
+    }
+    memcpy(pb->ptr, start, n);
+    pb->ptr += n;
+    pb->left -= n;
+    pb->read_ahead_pos += n;
+
+    return n;
+}
+#endif /* PUBNUB_RECEIVE_READ_AHEAD */
+
+
 static int pal_init(pubnub_t* pb)
 {
 #if !defined(PUBNUB_NTF_RUNTIME_SELECTION)
@@ -95,6 +298,9 @@ void pbpal_init(pubnub_t* pb)
     pb->ssl_userPEMcert             = NULL;
     pb->sock_state                  = STATE_NONE;
     buf_setup(pb);
+#if PUBNUB_RECEIVE_READ_AHEAD
+    read_ahead_discard(pb);
+#endif
 #if PUBNUB_USE_MULTIPLE_ADDRESSES
     pbpal_multiple_addresses_reset_counters(&pb->spare_addresses);
 #endif
@@ -233,11 +439,11 @@ int pbpal_send_status(pubnub_t* pb)
 
     PUBNUB_ASSERT_OPT(pb->sock_state == STATE_SENDING_DATA);
 
-    if (NULL == ssl) {
-        rslt = socket_send(pb->pal.socket, (char*)pb->ptr, pb->len);
-    }
+    if (NULL == ssl) { rslt = pal_send(pb, pb->ptr, pb->len); }
     else {
-        rslt = SSL_write(ssl, pb->ptr, pb->len);
+        do {
+            rslt = SSL_write(ssl, pb->ptr, pb->len);
+        } while (pbpal_tls_pump(pb, rslt));
     }
 
     if (rslt <= 0) {
@@ -257,6 +463,9 @@ int pbpal_send_status(pubnub_t* pb)
         pb->ptr        = (uint8_t*)pb->core.http_buf;
         pb->unreadlen  = 0;
         pb->sock_state = STATE_NONE;
+#if PUBNUB_RECEIVE_READ_AHEAD
+        read_ahead_discard(pb);
+#endif
     }
 
     return rslt;
@@ -299,17 +508,30 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
        so, we need to call it in a loop to read �ll there is
     */
     for (;;) {
+#if PUBNUB_RECEIVE_READ_AHEAD
+        if (pb->read_ahead_pos == pb->read_ahead_len) {
+            int recvres = read_ahead_fill(pb);
+            if (recvres <= 0) {
+                return pbpal_handle_socket_condition(
+                    recvres, pb, __FILE__, __LINE__, NULL, NULL);
+            }
+        }
+        if ((read_ahead_take(pb, pb->left, true) > 0)
+            && ('\n' == pb->ptr[-1])) {
+            pb->sock_state = STATE_NONE;
+            return PNR_OK;
+        }
+#else
         if (pb->unreadlen == 0) {
             int recvres;
             PUBNUB_ASSERT_OPT(
                 (char*)pb->ptr + pb->left ==
                 pb->core.http_buf + PUBNUB_BUF_MAXLEN);
-            if (NULL == ssl) {
-                recvres =
-                    socket_recv(pb->pal.socket, (char*)pb->ptr, pb->left, 0);
-            }
+            if (NULL == ssl) { recvres = pal_recv(pb, pb->ptr, pb->left); }
             else {
-                recvres = SSL_read(ssl, (char*)pb->ptr, pb->left);
+                do {
+                    recvres = SSL_read(ssl, (char*)pb->ptr, pb->left);
+                } while (pbpal_tls_pump(pb, recvres));
             }
             if (recvres <= 0) {
                 return pbpal_handle_socket_condition(
@@ -333,6 +555,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
                 return PNR_OK;
             }
         }
+#endif /* PUBNUB_RECEIVE_READ_AHEAD */
 
         if (pb->left == 0) {
             PUBNUB_LOG_ERROR(pb, "Buffer is full but newline not found.");
@@ -391,16 +614,41 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
        so, we need to call it in a loop to read �ll there is
     */
     for (;;) {
-        if (0 == pb->unreadlen) {
+#if PUBNUB_RECEIVE_READ_AHEAD
+        if (pb->read_ahead_pos == pb->read_ahead_len) {
             unsigned to_recv = pb->len;
             if (to_recv > pb->left) { to_recv = pb->left; }
             PUBNUB_ASSERT_OPT(to_recv > 0);
-            if (NULL == ssl) {
-                have_read =
-                    socket_recv(pb->pal.socket, (char*)pb->ptr, to_recv, 0);
+            if (to_recv < sizeof pb->read_ahead) {
+                have_read = read_ahead_fill(pb);
             }
             else {
-                have_read = SSL_read(ssl, pb->ptr, to_recv);
+                /* Reading ahead would only add a copy of what is to be
+                   read anyway */
+                have_read = receive(pb, pb->ptr, to_recv);
+                if (have_read > 0) {
+                    PUBNUB_ASSERT_OPT(pb->left >= have_read);
+                    pb->left -= have_read;
+                    pb->len -= have_read;
+                    pb->ptr += have_read;
+                }
+            }
+            if (have_read <= 0) {
+                return pbpal_handle_socket_condition(
+                    have_read, pb, __FILE__, __LINE__, NULL, NULL);
+            }
+        }
+        pb->len -= read_ahead_take(pb, pb->len, false);
+#else
+        if (0 == pb->unreadlen) {
+            unsigned to_recv = pb->len;
+            if (to_recv > pb->left) { to_recv = pb->left; }
+            PUBNUB_ASSERT_OPT(to_recv > 0);
+            if (NULL == ssl) { have_read = pal_recv(pb, pb->ptr, to_recv); }
+            else {
+                do {
+                    have_read = SSL_read(ssl, pb->ptr, to_recv);
+                } while (pbpal_tls_pump(pb, have_read));
             }
             if (have_read <= 0) {
                 return pbpal_handle_socket_condition(
@@ -416,6 +664,7 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
 
         pb->len -= have_read;
         pb->ptr += have_read;
+#endif /* PUBNUB_RECEIVE_READ_AHEAD */
 
         if ((0 == pb->len) || (0 == pb->left)) {
             pb->sock_state = STATE_NONE;
@@ -444,10 +693,15 @@ void pbpal_forget(pubnub_t* pb)
 int pbpal_close(pubnub_t* pb)
 {
     pb->unreadlen = 0;
+#if PUBNUB_RECEIVE_READ_AHEAD
+    read_ahead_discard(pb);
+#endif
 #if defined(_WIN32) && defined(PUBNUB_CALLBACK_API)
     pbpal_os_dns_cancel(pb);
 #endif
     if (pb->pal.ssl != NULL) {
+        /* With io_uring, the "close notify" this makes is not sent,
+           as we're about to close the socket anyway */
         SSL_shutdown(pb->pal.ssl);
         SSL_free(pb->pal.ssl);
         pb->pal.ssl = NULL;
@@ -499,3 +753,49 @@ void pbpal_free(pubnub_t* pb)
         PUBNUB_ASSERT_OPT(NULL == pb->pal.session);
     }
 }
+
+
+#if PUBNUB_USE_CONNECTION_POOL
+/* The SSL object holds a reference to the SSL_CTX it was made with, so
+   it can outlive the context that made it. The session (for re-use)
+   stays with the context, as it's not about the connection per se.
+*/
+void pbpal_detach_connection(pubnub_t* pb, struct pbpal_pooled_connection* conn)
+{
+    conn->socket   = pb->pal.socket;
+    conn->tls      = pb->pal.ssl;
+    pb->pal.socket = SOCKET_INVALID;
+    pb->pal.ssl    = NULL;
+    pb->sock_state = STATE_NONE;
+}
+
+
+void pbpal_attach_connection(
+    pubnub_t*                             pb,
+    struct pbpal_pooled_connection const* conn)
+{
+    PUBNUB_ASSERT_OPT(SOCKET_INVALID == pb->pal.socket);
+    PUBNUB_ASSERT_OPT(NULL == pb->pal.ssl);
+    pb->pal.socket = conn->socket;
+    pb->pal.ssl    = (SSL*)conn->tls;
+    pb->sock_state = STATE_NONE;
+    pb->unreadlen  = 0;
+#if PUBNUB_RECEIVE_READ_AHEAD
+    read_ahead_discard(pb);
+#endif
+    /* Whoever had it before might have had different blocking I/O */
+    pbpal_set_blocking_io(pb);
+}
+
+
+void pbpal_close_detached_connection(struct pbpal_pooled_connection* conn)
+{
+    if (conn->tls != NULL) {
+        SSL_shutdown((SSL*)conn->tls);
+        SSL_free((SSL*)conn->tls);
+        conn->tls = NULL;
+    }
+    socket_close(conn->socket);
+    conn->socket = SOCKET_INVALID;
+}
+#endif /* PUBNUB_USE_CONNECTION_POOL */
@@ -59,6 +59,16 @@
 
 #endif
 
+#if PUBNUB_DYNAMIC_REPLY_BUFFER && !defined(PUBNUB_REPLY_BUFFER_KEEP_MAX)
+/** The dynamic reply buffer (and the one for decompressing replies)
+    is kept allocated from one transaction to the next, so that it
+    doesn't have to be allocated again for each reply. If it grew
+    larger than this, it's shrunk to this many octets when the next
+    transaction starts. To free it, use pubnub_trim_reply_buffer().
+*/
+#define PUBNUB_REPLY_BUFFER_KEEP_MAX 65536
+#endif
+
 /** This is the URL of the Pubnub server. Change only for testing
     purposes.
 */
@@ -96,6 +106,15 @@
 #define PUBNUB_PROXY_API 1
 #endif
 
+#if !defined(PUBNUB_SYNC_WAIT_FOR_SOCKET)
+/** If true (!=0), `pubnub_await()` of the sync interface waits for
+    the socket to be ready (or `pubnub_cancel()`) between the steps of
+    the transaction, instead of running them in a busy loop. This way,
+    a thread awaiting a (long-poll) subscribe doesn't use the CPU.
+    */
+#define PUBNUB_SYNC_WAIT_FOR_SOCKET 1
+#endif
+
 #if defined(PUBNUB_CALLBACK_API)
 /** The size of the stack (in kilobytes) for the "polling" thread, when using
     the callback interface. We don't need much, so, if you want to conserve
@@ -107,6 +126,73 @@
     */
 #define PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB 0
 
+#if !defined(PUBNUB_USE_EPOLL)
+/** If true (!=0), the "polling" thread of the callback interface will
+    use epoll() instead of poll() to watch the sockets. With many
+    contexts this is much cheaper, as its cost depends only on the
+    number of sockets that are ready. Available only on Linux.
+    */
+#define PUBNUB_USE_EPOLL 0
+#endif
+
+#if !defined(PUBNUB_EPOLL_EDGE_TRIGGERED)
+/** If true (!=0) and #PUBNUB_USE_EPOLL is used, sockets are watched in
+    edge-triggered mode, which saves the kernel from re-checking
+    sockets that were already reported, but not yet processed.
+    */
+#define PUBNUB_EPOLL_EDGE_TRIGGERED 0
+#endif
+
+#if !defined(PUBNUB_USE_IO_URING)
+/** If true (!=0), the "polling" thread of the callback interface will
+    use io_uring to watch the sockets. Like #PUBNUB_USE_EPOLL, but
+    all the changes of watched events and the wait itself are done in
+    a single system call per poll. Needs Linux 5.11 or later and can't
+    be used together with #PUBNUB_USE_EPOLL.
+
+    Data is sent and received with io_uring too, in buffers of the
+    poller (registered with the kernel, for the first contexts), so
+    it's submitted together with the poll and there's no system call
+    per `send()`/`recv()`. With OpenSSL, TLS goes through memory BIOs.
+    */
+#define PUBNUB_USE_IO_URING 0
+#endif
+
+#if !defined(PUBNUB_USE_TIMER_WHEEL)
+/** If true (!=0), the "polling" thread of the callback interface will
+    keep the (transaction and connect) timers in a hierarchical timing
+    wheel instead of a sorted list. Starting and stopping a timer is
+    then O(1) instead of O(n), which matters with many contexts.
+    */
+#define PUBNUB_USE_TIMER_WHEEL 0
+#endif
+
+#if !defined(PUBNUB_CALLBACK_THREAD_COUNT)
+/** The number of "polling" threads of the callback interface. Each
+    context is pinned to one of them (all its events, timers and
+    callbacks are handled by that thread), so contexts handled by
+    different threads are processed in parallel. Use 1 to have all
+    contexts handled by the same thread.
+    */
+#define PUBNUB_CALLBACK_THREAD_COUNT 1
+#endif
+
+#if !defined(PUBNUB_CALLBACK_THREAD_AFFINITY)
+/** If true (!=0), the Nth "polling" thread is bound to the CPU
+    `N % number_of_online_CPUs`. Available only on Linux, ignored
+    elsewhere.
+    */
+#define PUBNUB_CALLBACK_THREAD_AFFINITY 0
+#endif
+
+#if !defined(PUBNUB_CALLBACK_THREAD_NAME)
+/** Name prefix of the "polling" threads; the Nth thread is named
+    `PUBNUB_CALLBACK_THREAD_NAME-N` (truncated to 15 characters on
+    Linux). Define as an empty string to leave the names alone.
+    */
+#define PUBNUB_CALLBACK_THREAD_NAME "pubnub-cb"
+#endif
+
 #if !defined(PUBNUB_USE_IPV6)
 /** If true (!=0), enable support for Ipv6 network addresses */
 #define PUBNUB_USE_IPV6 1
@@ -147,6 +233,30 @@
 #define PUBNUB_MAX_DNS_ROTATION 3
 #endif /* !PUBNUB_USE_IPV6 */
 #endif /* PUBNUB_CHANGE_DNS_SERVERS */
+
+#if !defined(PUBNUB_USE_PIPELINING)
+/** If true (!=0), enable support for HTTP/1.1 request pipelining on
+    the keep-alive connection of a context. See pubnub_pipelining.h.
+*/
+#define PUBNUB_USE_PIPELINING 0
+#endif
+
+#if PUBNUB_USE_PIPELINING && !defined(PUBNUB_PIPELINE_DEPTH)
+/** Maximum number of requests queued on a context for pipelining */
+#define PUBNUB_PIPELINE_DEPTH 8
+#endif
+
+#if !defined(PUBNUB_USE_PUBLISH_QUEUE)
+/** If true (!=0), enable support for the per-context publish queue.
+    See pubnub_publish_queue.h.
+*/
+#define PUBNUB_USE_PUBLISH_QUEUE 0
+#endif
+
+#if PUBNUB_USE_PUBLISH_QUEUE && !defined(PUBNUB_PUBLISH_QUEUE_SIZE)
+/** Maximum number of publishes queued on a context */
+#define PUBNUB_PUBLISH_QUEUE_SIZE 32
+#endif
 #endif /* defined(PUBNUB_CALLBACK_API) */
 
 #if !defined(PUBNUB_RECEIVE_GZIP_RESPONSE)
@@ -154,6 +264,48 @@
 #define PUBNUB_RECEIVE_GZIP_RESPONSE 1
 #endif
 
+#if PUBNUB_RECEIVE_GZIP_RESPONSE && !defined(PUBNUB_RECEIVE_GZIP_STREAMING)
+/** If true (!=0), a compressed (gzip) response is inflated as it is
+    received, piece by piece, instead of after all of it is received
+    (into a second reply buffer). This takes some 43KB more memory
+    for the context (for the inflate state and its dictionary).
+*/
+#define PUBNUB_RECEIVE_GZIP_STREAMING 1
+#endif
+
+#if !defined(PUBNUB_COALESCE_HTTP_REQUEST)
+/** If true (!=0), the HTTP request (request line, headers and the
+    body, if not longer than #PUBNUB_COALESCE_BODY_MAXLEN) is put
+    together and sent at once (that is, with one `send()`, or in one
+    TLS record), if it fits in the HTTP buffer (after the URL). If
+    false, it's sent piece by piece.
+*/
+#define PUBNUB_COALESCE_HTTP_REQUEST 1
+#endif
+
+#if PUBNUB_COALESCE_HTTP_REQUEST && !defined(PUBNUB_COALESCE_BODY_MAXLEN)
+/** Longest body to send together with the rest of the HTTP request.
+    Longer ones are sent (not copied) right after it.
+*/
+#define PUBNUB_COALESCE_BODY_MAXLEN 4096
+#endif
+
+#if !defined(PUBNUB_RECEIVE_READ_AHEAD)
+/** If true (!=0), data is received from the connection in as large
+    pieces as there are (up to #PUBNUB_READ_AHEAD_BUF_SIZE), from
+    which HTTP response lines and (smaller) chunks of the body are
+    then taken, instead of receiving each of them on its own.
+*/
+#define PUBNUB_RECEIVE_READ_AHEAD 1
+#endif
+
+#if PUBNUB_RECEIVE_READ_AHEAD && !defined(PUBNUB_READ_AHEAD_BUF_SIZE)
+/** Size of the read-ahead buffer of a context, in octets. Must be
+    less than 64KB.
+*/
+#define PUBNUB_READ_AHEAD_BUF_SIZE 16384
+#endif
+
 #if !defined(PUBNUB_USE_GZIP_COMPRESSION)
 /** If true (!=0), enables support for compressed content data*/
 #define PUBNUB_USE_GZIP_COMPRESSION 1
@@ -162,6 +314,20 @@
 #if PUBNUB_USE_GZIP_COMPRESSION
 /* Maximum compressed message length allowed. Could be shortened by the user */
 #define PUBNUB_COMPRESSED_MAXLEN 32000
+
+/** Default gzip compression level of a context, like in zlib: 1
+    (fastest) to 9 (best), 10 is the best miniz can do (slow). 0
+    turns compression off. Can be changed at runtime with
+    pubnub_set_gzip_compression().
+ */
+#define PUBNUB_GZIP_COMPRESSION_LEVEL 6
+
+/** Default minimal length of a message (in octets) for it to be
+    compressed. Shorter ones are not even tried, as the gzip framing
+    alone (18 octets) makes it unlikely they would get any shorter.
+    Can be changed at runtime with pubnub_set_gzip_min_size().
+ */
+#define PUBNUB_GZIP_MIN_MESSAGE_SIZE 64
 #endif
 
 /** The maximum length (in characters) of the host name of the proxy
@@ -192,6 +358,16 @@
 #define PUBNUB_USE_SUBSCRIBE_V2 1
 #endif
 
+#if PUBNUB_USE_SUBSCRIBE_V2 && !defined(PUBNUB_SUBSCRIBE_V2_STREAMING)
+/** If true (!=0), messages in a subscribe V2 response are parsed
+    as the response is received and given, one by one, to the
+    callback set with pubnub_subscribe_v2_set_message_callback() (if
+    any), keeping in the reply buffer only the message being received,
+    instead of the whole response.
+*/
+#define PUBNUB_SUBSCRIBE_V2_STREAMING 1
+#endif
+
 #if !defined(PUBNUB_USE_ADVANCED_HISTORY)
 /** If true (!=0) will enable using the advanced history API, which
     provides more data about (unread) messages. */
@@ -246,6 +422,22 @@
 #define PUBNUB_ADVANCED_KEEP_ALIVE 1
 #endif
 
+#if !defined(PUBNUB_USE_CONNECTION_POOL)
+/** If true (!=0), HTTP keep-alive connections are shared between the
+    contexts, through a process-wide pool, instead of each context
+    keeping its own. See pubnub_connection_pool.h.
+*/
+#define PUBNUB_USE_CONNECTION_POOL 0
+#endif
+
+#if PUBNUB_USE_CONNECTION_POOL && !defined(PUBNUB_CONNECTION_POOL_SIZE)
+/** Maximum number of idle connections kept in the connection pool.
+    When it's full, the connection idle the longest is closed to make
+    room for a new one.
+*/
+#define PUBNUB_CONNECTION_POOL_SIZE 16
+#endif
+
 #define PUBNUB_MAX_URL_PARAMS 12
 
 #ifndef PUBNUB_RAND_INIT_VECTOR
@@ -165,5 +165,17 @@ int snprintf(char* buffer, size_t n, const char* format, ...);
 
 #include "core/pubnub_internal_common.h"
 
+#if PUBNUB_USE_IO_URING
+/** Moves the data of the TLS connection of @p pb between OpenSSL's
+    memory BIOs and the io_uring poller, after a TLS operation which
+    returned @p rslt.
+    @return Whether to retry the operation, as there's more data for
+    it to read
+ */
+bool pbpal_tls_pump(pubnub_t* pb, int rslt);
+#else
+#define pbpal_tls_pump(pb, rslt) false
+#endif
+
 
 #endif /* !defined INC_PUBNUB_INTERNAL */
@@ -216,6 +216,26 @@ MAYBE_INLINE void pbntf_start_transaction_timer_callback(pubnub_t* pb)
 }
 
 
+#if PUBNUB_USE_RETRY_CONFIGURATION
+void pbntf_start_wait_retry_timer(pubnub_t* pb, int delay_ms)
+{
+    EnterCriticalSection(&m_watcher.timerlock);
+    pbpal_remove_timer_safe(pb, &m_watcher.timer_head);
+    m_watcher.timer_head =
+        pubnub_timer_list_add(m_watcher.timer_head, pb, delay_ms);
+    LeaveCriticalSection(&m_watcher.timerlock);
+}
+
+
+void pbntf_stop_wait_retry_timer(pubnub_t* pb)
+{
+    EnterCriticalSection(&m_watcher.timerlock);
+    pbpal_remove_timer_safe(pb, &m_watcher.timer_head);
+    LeaveCriticalSection(&m_watcher.timerlock);
+}
+#endif // PUBNUB_USE_RETRY_CONFIGURATION
+
+
 MAYBE_INLINE void pbntf_update_socket_callback(pubnub_t* pb)
 {
     EnterCriticalSection(&m_watcher.mutw);
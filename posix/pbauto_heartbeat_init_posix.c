@@ -4,8 +4,32 @@
 
 #include <pubnub_internal.h>
 
+#include "posix/monotonic_clock_get_time.h"
+
 #include <pthread.h>
 
+
+/** Initializes the `timer_cond` of @p m_watcher. On Darwin, there is no
+    way to make a condition use the monotonic clock, but there is a
+    relative time wait, which we use instead.
+ */
+static int init_timer_cond(struct HeartbeatWatcherData* m_watcher)
+{
+#if defined(__APPLE__)
+    return pthread_cond_init(&m_watcher->timer_cond, NULL);
+#else
+    pthread_condattr_t attr;
+    int                rslt = pthread_condattr_init(&attr);
+
+    if (rslt != 0) { return rslt; }
+    rslt = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (0 == rslt) { rslt = pthread_cond_init(&m_watcher->timer_cond, &attr); }
+    pthread_condattr_destroy(&attr);
+
+    return rslt;
+#endif
+}
+
 static int create_heartbeat_watcher_thread(
     pubnub_t*                    pb,
     struct HeartbeatWatcherData* m_watcher)
@@ -115,12 +139,33 @@ int pbauto_heartbeat_init(pubnub_t* pb, struct HeartbeatWatcherData* m_watcher)
         pubnub_mutex_destroy(m_watcher->stoplock);
         return -1;
     }
+    rslt = init_timer_cond(m_watcher);
+    if (rslt != 0) {
+        PUBNUB_LOG_ERROR(
+            pb,
+            "Timer's condition initialization failed with error code: %d",
+            rslt);
+        pthread_mutexattr_destroy(&attr);
+        pubnub_mutex_destroy(m_watcher->mutw);
+        pubnub_mutex_destroy(m_watcher->timerlock);
+        pubnub_mutex_destroy(m_watcher->stoplock);
+        return -1;
+    }
+#if PBAUTO_HEARTBEAT_WAIT_FOR_SOCKETS
+    if (pbpal_ntf_callback_wakeup_init(&m_watcher->wakeup) != 0) {
+        PUBNUB_LOG_WARNING(
+            pb, "Can't create the wakeup of the auto heartbeat watcher");
+        m_watcher->wakeup.read_fd = -1;
+    }
+#endif
     m_watcher->stop_heartbeat_watcher_thread = false;
+    m_watcher->wakeup_pending                = false;
     rslt = create_heartbeat_watcher_thread(pb, m_watcher);
     if (rslt != 0) {
         PUBNUB_LOG_ERROR(
             pb, "Polling thread create failed with error code: %d", rslt);
         pthread_mutexattr_destroy(&attr);
+        pthread_cond_destroy(&m_watcher->timer_cond);
         pubnub_mutex_destroy(m_watcher->mutw);
         pubnub_mutex_destroy(m_watcher->timerlock);
         pubnub_mutex_destroy(m_watcher->stoplock);
@@ -130,4 +175,36 @@ int pbauto_heartbeat_init(pubnub_t* pb, struct HeartbeatWatcherData* m_watcher)
     return 0;
 }
 
+
+void pbauto_heartbeat_wait(struct HeartbeatWatcherData* m_watcher, int ms)
+{
+    struct timespec ts;
+
+    if (ms < 0) {
+        pthread_cond_wait(&m_watcher->timer_cond, &m_watcher->timerlock);
+        return;
+    }
+#if defined(__APPLE__)
+    ts.tv_sec  = ms / UNIT_IN_MILLI;
+    ts.tv_nsec = (ms % UNIT_IN_MILLI) * MILLI_IN_NANO;
+    pthread_cond_timedwait_relative_np(
+        &m_watcher->timer_cond, &m_watcher->timerlock, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += ms / UNIT_IN_MILLI;
+    ts.tv_nsec += (ms % UNIT_IN_MILLI) * MILLI_IN_NANO;
+    if (ts.tv_nsec >= UNIT_IN_NANO) {
+        ++ts.tv_sec;
+        ts.tv_nsec -= UNIT_IN_NANO;
+    }
+    pthread_cond_timedwait(&m_watcher->timer_cond, &m_watcher->timerlock, &ts);
+#endif
+}
+
+
+void pbauto_heartbeat_signal(struct HeartbeatWatcherData* m_watcher)
+{
+    pthread_cond_signal(&m_watcher->timer_cond);
+}
+
 #endif
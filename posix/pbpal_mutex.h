@@ -38,6 +38,13 @@ typedef pthread_mutex_t pbpal_mutex_t;
 #define pbpal_mutex_init_static_recursive(m) \
     pthread_once(&m##_once_, m##_init_fn_)
 
+typedef pthread_cond_t pbpal_cond_t;
+
+#define pbpal_cond_init(c) pthread_cond_init(&(c), NULL)
+#define pbpal_cond_wait(c, m) pthread_cond_wait(&(c), &(m))
+#define pbpal_cond_broadcast(c) pthread_cond_broadcast(&(c))
+#define pbpal_cond_destroy(c) pthread_cond_destroy(&(c))
+
 
 #endif /*!defined INC_PBPAL_MUTEX*/
 
@@ -18,7 +18,9 @@ int pbpal_set_socket_blocking_io(
         flags & O_NONBLOCK ? "non-blocking" : "blocking",
         flags);
     if (-1 == flags) { flags = 0; }
-    fcntl((int)socket, F_SETFL, flags | (use_blocking_io ? 0 : O_NONBLOCK));
+    fcntl((int)socket,
+          F_SETFL,
+          use_blocking_io ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
 
     flags = fcntl((int)socket, F_GETFL, 0);
     PUBNUB_LOG_TRACE(
@@ -1,4 +1,8 @@
 /* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* For pthread_setaffinity_np() and pthread_setname_np() */
+#define _GNU_SOURCE
+#endif
 #include "core/pubnub_ntf_callback.h"
 
 #include "posix/monotonic_clock_get_time.h"
@@ -6,19 +10,42 @@
 
 #include <pubnub_internal.h>
 #include "core/pubnub_assert.h"
+#include "core/pubnub_atomic.h"
 #include "core/pubnub_timer_list.h"
+#include "core/pubnub_timer_wheel.h"
 #include "core/pbpal.h"
 
+#if PUBNUB_USE_EPOLL
+#include "lib/sockets/pbpal_ntf_callback_poller_epoll.h"
+#elif PUBNUB_USE_IO_URING
+#include "lib/sockets/pbpal_ntf_callback_poller_uring.h"
+#else
 #include "lib/sockets/pbpal_ntf_callback_poller_poll.h"
+#endif
 #include "core/pbpal_ntf_callback_queue.h"
 #include "core/pbpal_ntf_callback_handle_timer_list.h"
 
 #include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
 
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 
+/** Data of one socket watcher ("shard"). Each has its own thread,
+    poller, queue and timer list, so contexts of different watchers
+    don't contend for anything.
+
+    The watcher thread waits in the poller (holding `mutw`) until
+    there is some socket event, or the next timer expires. Anything
+    that needs the watcher's attention before that (queueing a
+    context, starting a timer, getting `mutw`, stopping) wakes it up.
+ */
 struct SocketWatcherData {
     struct pbpal_poll_data* poll    pubnub_guarded_by(mutw);
     bool stop_socket_watcher_thread pubnub_guarded_by(stoplock);
@@ -27,13 +54,136 @@ struct SocketWatcherData {
     pthread_mutex_t                 stoplock;
     pthread_t                       thread_id;
 #if PUBNUB_TIMERS_API
+#if PUBNUB_USE_TIMER_WHEEL
+    struct pubnub_timer_wheel timers pubnub_guarded_by(timerlock);
+#else
     pubnub_t* timer_head pubnub_guarded_by(timerlock);
+#endif
 #endif
     struct pbpal_ntf_callback_queue queue;
+    /** Number of (other) threads waiting to lock `mutw` */
+    volatile long mutw_waiters;
+    /** Index of this watcher in #m_watcher */
+    unsigned index;
 };
 
 
-static struct SocketWatcherData m_watcher;
+static struct SocketWatcherData m_watcher[PUBNUB_CALLBACK_THREAD_COUNT];
+
+
+/** Returns the watcher that handles the context @p pb. It depends
+    only on the address of the context, so, it never changes during
+    the life of the context and needs no bookkeeping. Contexts are
+    (much) bigger than any allocator overhead, so dividing by their
+    size spreads consecutively allocated ones evenly.
+ */
+static struct SocketWatcherData* watcher_of(pubnub_t const* pb)
+{
+#if PUBNUB_CALLBACK_THREAD_COUNT > 1
+    uintptr_t const n = (uintptr_t)pb / sizeof *pb;
+    return &m_watcher[n % PUBNUB_CALLBACK_THREAD_COUNT];
+#else
+    (void)pb;
+    return &m_watcher[0];
+#endif
+}
+
+
+/** Wakes up the @p watcher thread, if it's waiting in the poller.
+    There's no need for that on the watcher thread itself.
+ */
+static void watcher_wakeup(struct SocketWatcherData* watcher)
+{
+    if (!pthread_equal(pthread_self(), watcher->thread_id)) {
+        pbpal_ntf_callback_poller_wakeup(watcher->poll);
+    }
+}
+
+
+/** Locks the poller of the @p watcher. If the watcher thread holds
+    the lock while waiting in the poller, wakes it up, so that we
+    don't have to wait for the poller to time out.
+ */
+static void poller_lock(struct SocketWatcherData* watcher)
+{
+    if (0 == pthread_mutex_trylock(&watcher->mutw)) { return; }
+    pubnub_atomic_add(&watcher->mutw_waiters, 1);
+    pbpal_ntf_callback_poller_wakeup(watcher->poll);
+    pthread_mutex_lock(&watcher->mutw);
+    pubnub_atomic_add(&watcher->mutw_waiters, -1);
+}
+
+
+/** Starts (or restarts) the timer of the context @p pb, handled by
+    the @p watcher, to expire in @p timeout_ms.
+ */
+static void timer_start(struct SocketWatcherData* watcher,
+                        pubnub_t*                 pb,
+                        int                       timeout_ms)
+{
+    pthread_mutex_lock(&watcher->timerlock);
+#if PUBNUB_USE_TIMER_WHEEL
+    pubnub_timer_wheel_add(&watcher->timers, pb, timeout_ms);
+#else
+    pbpal_remove_timer_safe(pb, &watcher->timer_head);
+    watcher->timer_head =
+        pubnub_timer_list_add(watcher->timer_head, pb, timeout_ms);
+#endif
+    pthread_mutex_unlock(&watcher->timerlock);
+
+    /* It might expire before the watcher's current poll times out */
+    watcher_wakeup(watcher);
+}
+
+
+/** Stops the timer of the context @p pb, handled by the @p watcher,
+    if it's running.
+ */
+static void timer_stop(struct SocketWatcherData* watcher, pubnub_t* pb)
+{
+    pthread_mutex_lock(&watcher->timerlock);
+#if PUBNUB_USE_TIMER_WHEEL
+    pubnub_timer_wheel_remove(&watcher->timers, pb);
+#else
+    pbpal_remove_timer_safe(pb, &watcher->timer_head);
+#endif
+    pthread_mutex_unlock(&watcher->timerlock);
+}
+
+
+/** Handles the timers of the @p watcher, after @p elapsed_ms */
+static void timers_elapsed(struct SocketWatcherData* watcher, int elapsed_ms)
+{
+    pthread_mutex_lock(&watcher->timerlock);
+#if PUBNUB_USE_TIMER_WHEEL
+    pbntf_handle_timer_wheel(elapsed_ms, &watcher->timers);
+#else
+    pbntf_handle_timer_list(elapsed_ms, &watcher->timer_head);
+#endif
+    pthread_mutex_unlock(&watcher->timerlock);
+}
+
+
+/** Returns the time until the next timer of the @p watcher expires,
+    in ms, or -1 if there are no timers.
+ */
+static int timers_next_expiry(struct SocketWatcherData* watcher)
+{
+    int rslt;
+
+    pthread_mutex_lock(&watcher->timerlock);
+#if PUBNUB_USE_TIMER_WHEEL
+    rslt = pubnub_timer_wheel_next_expiry(&watcher->timers);
+#else
+    rslt = (NULL == watcher->timer_head) ? -1
+           : (watcher->timer_head->timeout_left_ms > 0)
+               ? watcher->timer_head->timeout_left_ms
+               : 0;
+#endif
+    pthread_mutex_unlock(&watcher->timerlock);
+
+    return rslt;
+}
 
 
 #if defined(PUBNUB_NTF_RUNTIME_SELECTION)
@@ -49,49 +199,87 @@ static struct SocketWatcherData m_watcher;
 
 MAYBE_INLINE int pbntf_watch_in_events_callback(pubnub_t* pbp)
 {
-    return pbpal_ntf_watch_in_events(m_watcher.poll, pbp);
+    struct SocketWatcherData* watcher = watcher_of(pbp);
+    int                       rslt;
+
+    poller_lock(watcher);
+    rslt = pbpal_ntf_watch_in_events(watcher->poll, pbp);
+    pthread_mutex_unlock(&watcher->mutw);
+
+    return rslt;
 }
 
 
 MAYBE_INLINE int pbntf_watch_out_events_callback(pubnub_t* pbp)
 {
-    return pbpal_ntf_watch_out_events(m_watcher.poll, pbp);
+    struct SocketWatcherData* watcher = watcher_of(pbp);
+    int                       rslt;
+
+    poller_lock(watcher);
+    rslt = pbpal_ntf_watch_out_events(watcher->poll, pbp);
+    pthread_mutex_unlock(&watcher->mutw);
+
+    return rslt;
+}
+
+
+static void set_thread_name(struct SocketWatcherData* watcher)
+{
+    char name[16];
+
+    if ('\0' == PUBNUB_CALLBACK_THREAD_NAME[0]) { return; }
+    snprintf(name,
+             sizeof name,
+             "%s-%u",
+             PUBNUB_CALLBACK_THREAD_NAME,
+             watcher->index);
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), name);
+#elif defined(__APPLE__)
+    pthread_setname_np(name);
+#endif
 }
 
 
 void* socket_watcher_thread(void* arg)
 {
-    const int       max_poll_ms = 100;
-    struct timespec prev_timspec;
+    struct SocketWatcherData* watcher = (struct SocketWatcherData*)arg;
+    struct timespec           prev_timspec;
+
+    set_thread_name(watcher);
     monotonic_clock_get_time(&prev_timspec);
 
     for (;;) {
-        struct timespec timspec;
-        bool            stop_thread;
+        int  poll_ms = -1;
+        bool stop_thread;
 
-        pthread_mutex_lock(&m_watcher.stoplock);
-        stop_thread = m_watcher.stop_socket_watcher_thread;
-        pthread_mutex_unlock(&m_watcher.stoplock);
+        pthread_mutex_lock(&watcher->stoplock);
+        stop_thread = watcher->stop_socket_watcher_thread;
+        pthread_mutex_unlock(&watcher->stoplock);
         if (stop_thread) { break; }
 
-        pbpal_ntf_callback_process_queue(&m_watcher.queue);
-
-        monotonic_clock_get_time(&timspec);
-
-        pthread_mutex_lock(&m_watcher.mutw);
-        pbpal_ntf_poll_away(m_watcher.poll, max_poll_ms);
-        pthread_mutex_unlock(&m_watcher.mutw);
-
         if (PUBNUB_TIMERS_API) {
-            int elapsed = pbtimespec_elapsed_ms(prev_timspec, timspec);
-            if (elapsed > 0) {
-                pthread_mutex_lock(&m_watcher.timerlock);
-                pbntf_handle_timer_list(elapsed, &m_watcher.timer_head);
-                pthread_mutex_unlock(&m_watcher.timerlock);
+            struct timespec timspec;
+            int             elapsed;
 
+            monotonic_clock_get_time(&timspec);
+            elapsed = pbtimespec_elapsed_ms(prev_timspec, timspec);
+            if (elapsed > 0) {
+                timers_elapsed(watcher, elapsed);
                 prev_timspec = timspec;
             }
         }
+
+        pbpal_ntf_callback_process_queue(&watcher->queue);
+
+        if (PUBNUB_TIMERS_API) { poll_ms = timers_next_expiry(watcher); }
+
+        pthread_mutex_lock(&watcher->mutw);
+        /* If someone is waiting for the lock, let them have it */
+        if (0 == pubnub_atomic_load(&watcher->mutw_waiters)) {
+            pbpal_ntf_poll_away(watcher->poll, poll_ms);
+        }
+        pthread_mutex_unlock(&watcher->mutw);
     }
 
     return NULL;
@@ -100,15 +288,30 @@ void* socket_watcher_thread(void* arg)
 
 void pubnub_stop(void)
 {
+    unsigned i;
+
     pbauto_heartbeat_stop();
 
-    pthread_mutex_lock(&m_watcher.stoplock);
-    m_watcher.stop_socket_watcher_thread = true;
-    pthread_mutex_unlock(&m_watcher.stoplock);
+    for (i = 0; i < PUBNUB_CALLBACK_THREAD_COUNT; ++i) {
+        pthread_mutex_lock(&m_watcher[i].stoplock);
+        m_watcher[i].stop_socket_watcher_thread = true;
+        pthread_mutex_unlock(&m_watcher[i].stoplock);
+        if (m_watcher[i].poll != NULL) { watcher_wakeup(&m_watcher[i]); }
+    }
 }
 
 
-MAYBE_INLINE int pbntf_init_callback(pubnub_t* pb)
+static void watcher_deinit(struct SocketWatcherData* watcher)
+{
+    pthread_mutex_destroy(&watcher->mutw);
+    pthread_mutex_destroy(&watcher->timerlock);
+    pthread_mutex_destroy(&watcher->stoplock);
+    pbpal_ntf_callback_queue_deinit(&watcher->queue);
+    pbpal_ntf_callback_poller_deinit(&watcher->poll);
+}
+
+
+static int watcher_init(pubnub_t* pb, struct SocketWatcherData* watcher)
 {
     int                 rslt;
     pthread_mutexattr_t attr;
@@ -128,7 +331,7 @@ MAYBE_INLINE int pbntf_init_callback(pubnub_t* pb)
         pthread_mutexattr_destroy(&attr);
         return -1;
     }
-    rslt = pthread_mutex_init(&m_watcher.stoplock, &attr);
+    rslt = pthread_mutex_init(&watcher->stoplock, &attr);
     if (rslt != 0) {
         PUBNUB_LOG_ERROR(
             pb,
@@ -137,103 +340,152 @@ MAYBE_INLINE int pbntf_init_callback(pubnub_t* pb)
         pthread_mutexattr_destroy(&attr);
         return -1;
     }
-    rslt = pthread_mutex_init(&m_watcher.mutw, &attr);
+    rslt = pthread_mutex_init(&watcher->mutw, &attr);
     if (rslt != 0) {
         PUBNUB_LOG_ERROR(
             pb, "Mutex initialization failed with error code: %d", rslt);
         pthread_mutexattr_destroy(&attr);
-        pthread_mutex_destroy(&m_watcher.stoplock);
+        pthread_mutex_destroy(&watcher->stoplock);
         return -1;
     }
-    rslt = pthread_mutex_init(&m_watcher.timerlock, &attr);
+    rslt = pthread_mutex_init(&watcher->timerlock, &attr);
+    pthread_mutexattr_destroy(&attr);
     if (rslt != 0) {
         PUBNUB_LOG_ERROR(
             pb,
             "Timer's mutex initialization failed with error code: %d",
             rslt);
-        pthread_mutexattr_destroy(&attr);
-        pthread_mutex_destroy(&m_watcher.mutw);
-        pthread_mutex_destroy(&m_watcher.stoplock);
+        pthread_mutex_destroy(&watcher->mutw);
+        pthread_mutex_destroy(&watcher->stoplock);
         return -1;
     }
 
-    m_watcher.poll = pbpal_ntf_callback_poller_init();
-    if (NULL == m_watcher.poll) {
-        pthread_mutexattr_destroy(&attr);
-        pthread_mutex_destroy(&m_watcher.mutw);
-        pthread_mutex_destroy(&m_watcher.timerlock);
-        pthread_mutex_destroy(&m_watcher.stoplock);
+    watcher->poll = pbpal_ntf_callback_poller_init();
+    if (NULL == watcher->poll) {
+        pthread_mutex_destroy(&watcher->mutw);
+        pthread_mutex_destroy(&watcher->timerlock);
+        pthread_mutex_destroy(&watcher->stoplock);
         return -1;
     }
-    pbpal_ntf_callback_queue_init(&m_watcher.queue);
-    m_watcher.stop_socket_watcher_thread = false;
+    pbpal_ntf_callback_queue_init(&watcher->queue);
+    watcher->mutw_waiters = 0;
+#if PUBNUB_TIMERS_API && PUBNUB_USE_TIMER_WHEEL
+    pubnub_timer_wheel_init(&watcher->timers);
+#endif
+    watcher->stop_socket_watcher_thread = false;
+
+    return 0;
+}
 
+
+static void set_thread_affinity(pubnub_t*                 pb,
+                                struct SocketWatcherData* watcher)
+{
+#if PUBNUB_CALLBACK_THREAD_AFFINITY && defined(__linux__)
+    long      cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t set;
+    int       rslt;
+
+    if (cpus < 1) { return; }
+    CPU_ZERO(&set);
+    CPU_SET(watcher->index % (unsigned)cpus, &set);
+    rslt = pthread_setaffinity_np(watcher->thread_id, sizeof set, &set);
+    if (rslt != 0) {
+        PUBNUB_LOG_WARNING(
+            pb,
+            "Binding polling thread #%u to CPU failed with error code: %d",
+            watcher->index,
+            rslt);
+    }
+#else
+    (void)pb;
+    (void)watcher;
+#endif
+}
+
+
+static int watcher_start(pubnub_t* pb, struct SocketWatcherData* watcher)
+{
+    int rslt;
 #if defined(PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB) &&                           \
     (PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB > 0)
-    {
-        pthread_attr_t thread_attr;
-
-        rslt = pthread_attr_init(&thread_attr);
-        if (rslt != 0) {
-            PUBNUB_LOG_ERROR(
-                pb,
-                "Thread attributes initialization failed with error code: %d",
-                rslt);
-            pthread_mutexattr_destroy(&attr);
-            pthread_mutex_destroy(&m_watcher.mutw);
-            pthread_mutex_destroy(&m_watcher.timerlock);
-            pthread_mutex_destroy(&m_watcher.stoplock);
-            pbpal_ntf_callback_queue_deinit(&m_watcher.queue);
-            pbpal_ntf_callback_poller_deinit(&m_watcher.poll);
-            return -1;
-        }
-        rslt = pthread_attr_setstacksize(
-            &thread_attr, PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB * 1024);
-        if (rslt != 0) {
-            PUBNUB_LOG_ERROR(
-                pb,
-                "Thread stack size change to %d kb failed with error code: %d",
-                PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB,
-                error);
-            pthread_mutexattr_destroy(&attr);
-            pthread_mutex_destroy(&m_watcher.mutw);
-            pthread_mutex_destroy(&m_watcher.timerlock);
-            pthread_mutex_destroy(&m_watcher.stoplock);
-            pthread_attr_destroy(&thread_attr);
-            pbpal_ntf_callback_queue_deinit(&m_watcher.queue);
-            pbpal_ntf_callback_poller_deinit(&m_watcher.poll);
-            return -1;
-        }
-        rslt = pthread_create(
-            &m_watcher.thread_id, &thread_attr, socket_watcher_thread, NULL);
-        if (rslt != 0) {
-            PUBNUB_LOG_ERROR(
-                pb, "Polling thread create failed with error code: %d", rslt);
-            pthread_mutexattr_destroy(&attr);
-            pthread_mutex_destroy(&m_watcher.mutw);
-            pthread_mutex_destroy(&m_watcher.timerlock);
-            pthread_mutex_destroy(&m_watcher.stoplock);
-            pthread_attr_destroy(&thread_attr);
-            pbpal_ntf_callback_queue_deinit(&m_watcher.queue);
-            pbpal_ntf_callback_poller_deinit(&m_watcher.poll);
-            return -1;
-        }
+    pthread_attr_t thread_attr;
+
+    rslt = pthread_attr_init(&thread_attr);
+    if (rslt != 0) {
+        PUBNUB_LOG_ERROR(
+            pb,
+            "Thread attributes initialization failed with error code: %d",
+            rslt);
+        return -1;
+    }
+    rslt = pthread_attr_setstacksize(
+        &thread_attr, PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB * 1024);
+    if (rslt != 0) {
+        PUBNUB_LOG_ERROR(
+            pb,
+            "Thread stack size change to %d kb failed with error code: %d",
+            PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB,
+            rslt);
+        pthread_attr_destroy(&thread_attr);
+        return -1;
     }
+#endif
+    /* The thread checks its own ID (to skip needless wakeups), it
+       locks `stoplock` before that, so, holding it here makes sure
+       the thread sees the ID set.
+     */
+    pthread_mutex_lock(&watcher->stoplock);
+#if defined(PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB) &&                           \
+    (PUBNUB_CALLBACK_THREAD_STACK_SIZE_KB > 0)
+    rslt = pthread_create(
+        &watcher->thread_id, &thread_attr, socket_watcher_thread, watcher);
+    pthread_attr_destroy(&thread_attr);
 #else
     rslt = pthread_create(
-        &m_watcher.thread_id, NULL, socket_watcher_thread, NULL);
+        &watcher->thread_id, NULL, socket_watcher_thread, watcher);
+#endif
+    pthread_mutex_unlock(&watcher->stoplock);
     if (rslt != 0) {
         PUBNUB_LOG_ERROR(
             pb, "Polling thread create failed with error code: %d", rslt);
-        pthread_mutexattr_destroy(&attr);
-        pthread_mutex_destroy(&m_watcher.mutw);
-        pthread_mutex_destroy(&m_watcher.timerlock);
-        pthread_mutex_destroy(&m_watcher.stoplock);
-        pbpal_ntf_callback_queue_deinit(&m_watcher.queue);
-        pbpal_ntf_callback_poller_deinit(&m_watcher.poll);
         return -1;
     }
-#endif
+    set_thread_affinity(pb, watcher);
+
+    return 0;
+}
+
+
+MAYBE_INLINE int pbntf_init_callback(pubnub_t* pb)
+{
+    unsigned i;
+
+    for (i = 0; i < PUBNUB_CALLBACK_THREAD_COUNT; ++i) {
+        struct SocketWatcherData* watcher = &m_watcher[i];
+
+        watcher->index = i;
+        if (0 != watcher_init(pb, watcher)) { break; }
+        if (0 != watcher_start(pb, watcher)) {
+            watcher_deinit(watcher);
+            break;
+        }
+    }
+    if (i < PUBNUB_CALLBACK_THREAD_COUNT) {
+        /* Don't leave a partial set of watchers behind, contexts
+           would be pinned to those that don't exist.
+         */
+        while (i-- > 0) {
+            pthread_mutex_lock(&m_watcher[i].stoplock);
+            m_watcher[i].stop_socket_watcher_thread = true;
+            pthread_mutex_unlock(&m_watcher[i].stoplock);
+            /* With no timers running, it waits in the poller for good */
+            watcher_wakeup(&m_watcher[i]);
+            pthread_join(m_watcher[i].thread_id, NULL);
+            watcher_deinit(&m_watcher[i]);
+        }
+        return -1;
+    }
 
     return 0;
 }
@@ -241,27 +493,37 @@ MAYBE_INLINE int pbntf_init_callback(pubnub_t* pb)
 
 MAYBE_INLINE int pbntf_enqueue_for_processing_callback(pubnub_t* pb)
 {
-    return pbpal_ntf_callback_enqueue_for_processing(&m_watcher.queue, pb);
+    struct SocketWatcherData* watcher = watcher_of(pb);
+    int const rslt = pbpal_ntf_callback_enqueue_for_processing(&watcher->queue,
+                                                               pb);
+    if (rslt > 0) { watcher_wakeup(watcher); }
+
+    return rslt;
 }
 
 
 MAYBE_INLINE int pbntf_requeue_for_processing_callback(pubnub_t* pb)
 {
-    return pbpal_ntf_callback_requeue_for_processing(&m_watcher.queue, pb);
+    struct SocketWatcherData* watcher = watcher_of(pb);
+    int const rslt = pbpal_ntf_callback_requeue_for_processing(&watcher->queue,
+                                                               pb);
+    /* If it was already queued, whoever queued it did the wakeup */
+    if (rslt > 0) { watcher_wakeup(watcher); }
+
+    return rslt;
 }
 
 
 MAYBE_INLINE int pbntf_got_socket_callback(pubnub_t* pb)
 {
-    pthread_mutex_lock(&m_watcher.mutw);
-    pbpal_ntf_callback_save_socket(m_watcher.poll, pb);
-    pthread_mutex_unlock(&m_watcher.mutw);
+    struct SocketWatcherData* watcher = watcher_of(pb);
+
+    poller_lock(watcher);
+    pbpal_ntf_callback_save_socket(watcher->poll, pb);
+    pthread_mutex_unlock(&watcher->mutw);
 
     if (PUBNUB_TIMERS_API) {
-        pthread_mutex_lock(&m_watcher.timerlock);
-        m_watcher.timer_head = pubnub_timer_list_add(
-            m_watcher.timer_head, pb, pb->transaction_timeout_ms);
-        pthread_mutex_unlock(&m_watcher.timerlock);
+        timer_start(watcher, pb, pb->transaction_timeout_ms);
     }
 
     return +1;
@@ -270,48 +532,119 @@ MAYBE_INLINE int pbntf_got_socket_callback(pubnub_t* pb)
 
 MAYBE_INLINE void pbntf_lost_socket_callback(pubnub_t* pb)
 {
-    pthread_mutex_lock(&m_watcher.mutw);
-    pbpal_ntf_callback_remove_socket(m_watcher.poll, pb);
-    pthread_mutex_unlock(&m_watcher.mutw);
+    struct SocketWatcherData* watcher = watcher_of(pb);
 
-    pbpal_ntf_callback_remove_from_queue(&m_watcher.queue, pb);
+    poller_lock(watcher);
+    pbpal_ntf_callback_remove_socket(watcher->poll, pb);
+    pthread_mutex_unlock(&watcher->mutw);
 
-    pthread_mutex_lock(&m_watcher.timerlock);
-    pbpal_remove_timer_safe(pb, &m_watcher.timer_head);
-    pthread_mutex_unlock(&m_watcher.timerlock);
+    pbpal_ntf_callback_remove_from_queue(&watcher->queue, pb);
+
+    timer_stop(watcher, pb);
 }
 
 
 MAYBE_INLINE void pbntf_start_wait_connect_timer_callback(pubnub_t* pb)
 {
+    struct SocketWatcherData* watcher = watcher_of(pb);
+
     if (PUBNUB_TIMERS_API) {
-        pthread_mutex_lock(&m_watcher.timerlock);
-        pbpal_remove_timer_safe(pb, &m_watcher.timer_head);
-        m_watcher.timer_head = pubnub_timer_list_add(
-            m_watcher.timer_head, pb, pb->wait_connect_timeout_ms);
-        pthread_mutex_unlock(&m_watcher.timerlock);
+        timer_start(watcher, pb, pb->wait_connect_timeout_ms);
     }
 }
 
 
 MAYBE_INLINE void pbntf_start_transaction_timer_callback(pubnub_t* pb)
 {
+    struct SocketWatcherData* watcher = watcher_of(pb);
+
     if (PUBNUB_TIMERS_API) {
-        pthread_mutex_lock(&m_watcher.timerlock);
-        pbpal_remove_timer_safe(pb, &m_watcher.timer_head);
-        m_watcher.timer_head = pubnub_timer_list_add(
-            m_watcher.timer_head, pb, pb->transaction_timeout_ms);
-        pthread_mutex_unlock(&m_watcher.timerlock);
+        timer_start(watcher, pb, pb->transaction_timeout_ms);
     }
 }
 
 
+#if PUBNUB_USE_RETRY_CONFIGURATION
+void pbntf_start_wait_retry_timer(pubnub_t* pb, int delay_ms)
+{
+    timer_start(watcher_of(pb), pb, delay_ms);
+}
+
+
+void pbntf_stop_wait_retry_timer(pubnub_t* pb)
+{
+    timer_stop(watcher_of(pb), pb);
+}
+#endif // PUBNUB_USE_RETRY_CONFIGURATION
+
+
 MAYBE_INLINE void pbntf_update_socket_callback(pubnub_t* pb)
 {
-    pthread_mutex_lock(&m_watcher.mutw);
-    pbpal_ntf_callback_update_socket(m_watcher.poll, pb);
-    pthread_mutex_unlock(&m_watcher.mutw);
+    struct SocketWatcherData* watcher = watcher_of(pb);
+
+    poller_lock(watcher);
+    pbpal_ntf_callback_update_socket(watcher->poll, pb);
+    pthread_mutex_unlock(&watcher->mutw);
+}
+
+
+#if PUBNUB_USE_IO_URING
+/* The requests are put in the submission queue here, but submitted
+   by the watcher thread, on its next poll. If it's waiting in the
+   poller, getting the lock wakes it up, so that's right away.
+ */
+
+int pbntf_uring_send_buffer(pubnub_t* pb, uint8_t** buf)
+{
+    struct SocketWatcherData* watcher = watcher_of(pb);
+    int                       rslt;
+
+#if defined(PUBNUB_NTF_RUNTIME_SELECTION)
+    if (pb->api_policy != PNA_CALLBACK) { return PBNTF_URING_NO_IO; }
+#endif
+    poller_lock(watcher);
+    rslt = pbpal_ntf_uring_send_buffer(watcher->poll, pb, buf);
+    pthread_mutex_unlock(&watcher->mutw);
+
+    return rslt;
+}
+
+
+void pbntf_uring_send(pubnub_t* pb, size_t n)
+{
+    struct SocketWatcherData* watcher = watcher_of(pb);
+
+    poller_lock(watcher);
+    pbpal_ntf_uring_send(watcher->poll, pb, n);
+    pthread_mutex_unlock(&watcher->mutw);
+}
+
+
+int pbntf_uring_recv_buffer(pubnub_t* pb, uint8_t const** buf, size_t max)
+{
+    struct SocketWatcherData* watcher = watcher_of(pb);
+    int                       rslt;
+
+#if defined(PUBNUB_NTF_RUNTIME_SELECTION)
+    if (pb->api_policy != PNA_CALLBACK) { return PBNTF_URING_NO_IO; }
+#endif
+    poller_lock(watcher);
+    rslt = pbpal_ntf_uring_recv_buffer(watcher->poll, pb, buf, max);
+    pthread_mutex_unlock(&watcher->mutw);
+
+    return rslt;
+}
+
+
+void pbntf_uring_recv_consume(pubnub_t* pb, size_t n)
+{
+    struct SocketWatcherData* watcher = watcher_of(pb);
+
+    poller_lock(watcher);
+    pbpal_ntf_uring_recv_consume(watcher->poll, pb, n);
+    pthread_mutex_unlock(&watcher->mutw);
 }
+#endif /* PUBNUB_USE_IO_URING */
 
 #if !defined(PUBNUB_NTF_RUNTIME_SELECTION)
 
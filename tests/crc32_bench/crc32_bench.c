@@ -0,0 +1,99 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+/**
+ * @file crc32_bench.c
+ * @brief Microbenchmark of the CRC32 (gzip framing) variants.
+ *
+ * Checks that all the variants of `pbcrc32` available on this CPU
+ * compute the same checksum and measures their throughput on
+ * payloads of various sizes.
+ *
+ * Build (GCC/Clang, from the repository root):
+ *   cc -O2 -o crc32_bench -D PUBNUB_USE_GZIP_COMPRESSION=1 \
+ *     -I. -Icore -Iposix \
+ *     tests/crc32_bench/crc32_bench.c lib/pbcrc32.c core/pubnub_assert_std.c
+ *
+ * Build (MSVC):
+ *   cl /nologo /O2 /Fe:crc32_bench.exe /DPUBNUB_USE_GZIP_COMPRESSION=1 ^
+ *     /I. /Icore /Iwindows ^
+ *     tests\crc32_bench\crc32_bench.c lib\pbcrc32.c core\pubnub_assert_std.c
+ *
+ * Run:
+ *   crc32_bench [total MB per measurement, default 256]
+ * Exit code: number of checksum mismatches (0 = all agree)
+ */
+
+#include "lib/pbcrc32.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+static char const* const m_variant_name[] = { "bytewise",
+                                              "slice-by-8",
+                                              "hardware" };
+
+static size_t const m_sizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536 };
+
+
+int main(int argc, char* argv[])
+{
+    size_t const   max_size = 65536;
+    size_t const   total    = ((argc > 1) ? (size_t)atoi(argv[1]) : 256) << 20;
+    unsigned char* data     = (unsigned char*)malloc(max_size + 8);
+    int            failures = 0;
+    size_t         i;
+
+    if (NULL == data) {
+        printf("Out of memory\n");
+        return -1;
+    }
+    srand(42);
+    for (i = 0; i < max_size + 8; ++i) {
+        data[i] = (unsigned char)rand();
+    }
+
+    printf("%8s", "size");
+    for (i = 0; i < 3; ++i) {
+        printf(" %14s", m_variant_name[i]);
+    }
+    printf("   (MB/s)\n");
+
+    for (i = 0; i < sizeof m_sizes / sizeof m_sizes[0]; ++i) {
+        size_t const   size   = m_sizes[i];
+        size_t const   rounds = total / size;
+        uint32_t const expect = pbcrc32_variant(pbcrc32Bytewise, data, size);
+        int            v;
+
+        printf("%8lu", (unsigned long)size);
+        for (v = pbcrc32Bytewise; v <= pbcrc32Hardware; ++v) {
+            enum pbcrc32_variant const variant = (enum pbcrc32_variant)v;
+            volatile uint32_t          sink    = 0;
+            clock_t                    start;
+            double                     secs;
+            size_t                     r;
+
+            if (!pbcrc32_has_variant(variant)) {
+                printf(" %14s", "n/a");
+                continue;
+            }
+            if (pbcrc32_variant(variant, data, size) != expect) {
+                printf(" %14s", "MISMATCH");
+                ++failures;
+                continue;
+            }
+            start = clock();
+            for (r = 0; r < rounds; ++r) {
+                /* Varying alignment, as in real life */
+                sink ^= pbcrc32_variant(variant, data + (r & 7), size);
+            }
+            secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+            (void)sink;
+            printf(" %14.0f", (secs > 0) ? (double)total / secs / 1e6 : 0.0);
+        }
+        printf("\n");
+    }
+    free(data);
+
+    return failures;
+}
@@ -15,8 +15,10 @@ int pbauto_heartbeat_init(pubnub_t* pb, struct HeartbeatWatcherData* m_watcher)
     InitializeCriticalSection(&m_watcher->stoplock);
     InitializeCriticalSection(&m_watcher->mutw);
     InitializeCriticalSection(&m_watcher->timerlock);
+    InitializeConditionVariable(&m_watcher->timer_cond);
 
     m_watcher->stop_heartbeat_watcher_thread = false;
+    m_watcher->wakeup_pending                = false;
 
     m_watcher->thread_handle = (HANDLE)_beginthread(
         pbauto_heartbeat_watcher_thread,
@@ -35,4 +37,19 @@ int pbauto_heartbeat_init(pubnub_t* pb, struct HeartbeatWatcherData* m_watcher)
     return 0;
 }
 
+
+void pbauto_heartbeat_wait(struct HeartbeatWatcherData* m_watcher, int ms)
+{
+    SleepConditionVariableCS(
+        &m_watcher->timer_cond,
+        &m_watcher->timerlock,
+        (ms < 0) ? INFINITE : (DWORD)ms);
+}
+
+
+void pbauto_heartbeat_signal(struct HeartbeatWatcherData* m_watcher)
+{
+    WakeConditionVariable(&m_watcher->timer_cond);
+}
+
 #endif /* PUBNUB_USE_AUTO_HEARTBEAT */
@@ -28,6 +28,13 @@ __inline int pubnub_InitCriticalSection(_Out_ LPCRITICAL_SECTION lpCS) {
 #define pbpal_mutex_static_recursive_decl_and_init(m) pbpal_mutex_static_decl_and_init(m)
 #define pbpal_mutex_init_static_recursive(m) pbpal_mutex_init_static(m)
 
+typedef CONDITION_VARIABLE pbpal_cond_t;
+
+#define pbpal_cond_init(c) InitializeConditionVariable(&(c))
+#define pbpal_cond_wait(c, m) SleepConditionVariableCS(&(c), &(m), INFINITE)
+#define pbpal_cond_broadcast(c) WakeAllConditionVariable(&(c))
+#define pbpal_cond_destroy(c)
+
 
 #endif /*!defined INC_PBPAL_MUTEX*/
 